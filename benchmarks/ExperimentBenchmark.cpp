@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Runs the A/B experiment scheduler against a mock city where enacting the ordinance
+// lowers the congestion and raises the commercial demand, and checks that the
+// experiment report detects both changes.
+//
+// The monthly values have random noise, the confidence intervals of the two arms
+// must not overlap once enough periods have been measured. The city is reloaded in
+// the middle of a period, the schedule must continue to follow the calendar.
+
+#include "BenchmarkArguments.h"
+#include "MockRuntime.h"
+#include "ParknRideOrdinance.h"
+#include "TrafficTuningCoordinator.h"
+#include "cISC4City.h"
+#include "cISC4Simulator.h"
+#include "cRZBaseString.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t kParticipantID = 0x8b8d3b1a;
+	constexpr uint32_t kCommercialServiceLowWealthDemand = 0x3110;
+
+	struct BenchmarkOptions
+	{
+		uint32_t years = 20;
+		uint32_t periodMonths = 12;
+		uint32_t washoutMonths = 1;
+	};
+
+	// Sets the traffic and demand for the next month, the ordinance removes a quarter of the congestion.
+	void SimulateCity(
+		MockRuntime& runtime,
+		const std::vector<uint8_t>& baseCongestion,
+		bool ordinanceOn,
+		std::mt19937& random)
+	{
+		std::normal_distribution<double> noise(0.0, 0.05);
+
+		const double congestionScale = (ordinanceOn ? 0.75 : 1.0) + noise(random);
+		std::vector<uint8_t>& congestion = runtime.GetTrafficSimulator().GetMockCongestionMap()->GetValues();
+
+		for (size_t i = 0; i < congestion.size(); i++)
+		{
+			congestion[i] = static_cast<uint8_t>(std::min(255.0, baseCongestion[i] * congestionScale));
+		}
+
+		const double demand = (ordinanceOn ? 1050.0 : 1000.0) + (noise(random) * 500.0);
+		runtime.GetDemandSimulator().GetMockDemand(kCommercialServiceLowWealthDemand).SetDemandValue(static_cast<float>(demand));
+	}
+
+	// Simulates one month and checks that the ordinance is only toggled at the end of a calendar period
+	// that has the arm of its current state.
+	bool SimulateMonth(
+		MockRuntime& runtime,
+		ParknRideOrdinance& ordinance,
+		const std::vector<uint8_t>& baseCongestion,
+		uint32_t periodMonths,
+		std::mt19937& random,
+		uint32_t& toggleCount)
+	{
+		runtime.AdvanceSimDate(30);
+		SimulateCity(runtime, baseCongestion, ordinance.IsOn(), random);
+
+		long year = 0;
+		long month = 0;
+		long day = 0;
+		long dayOfYear = 0;
+		long weekDay = 0;
+
+		runtime.GetCity()->GetSimulator()->GetSimDate(year, month, day, dayOfYear, weekDay);
+
+		const uint32_t calendarMonth = static_cast<uint32_t>((year * 12) + (month - 1));
+		const bool periodArmOn = ((calendarMonth / periodMonths) % 2) != 0;
+		const bool periodEnded = (calendarMonth % periodMonths) == (periodMonths - 1);
+
+		const bool wasOn = ordinance.IsOn();
+		ordinance.Simulate();
+		runtime.Tick();
+
+		// A second call in the same month must not toggle the ordinance again.
+		const bool isOn = ordinance.IsOn();
+		ordinance.Simulate();
+
+		if (ordinance.IsOn() != isOn)
+		{
+			std::fprintf(stderr, "The ordinance was toggled twice in month %u.\n", calendarMonth);
+			return false;
+		}
+
+		const bool expectedToggle = periodEnded && wasOn == periodArmOn;
+
+		if ((wasOn != isOn) != expectedToggle)
+		{
+			std::fprintf(stderr, "The ordinance toggle in month %u does not match the schedule.\n", calendarMonth);
+			return false;
+		}
+
+		if (expectedToggle)
+		{
+			toggleCount++;
+		}
+
+		return true;
+	}
+
+	void PrintMetric(const ExperimentScheduler& scheduler, ExperimentScheduler::Metric metric)
+	{
+		std::printf(
+			"  %-24s enacted %9.3f +/- %-7.3f repealed %9.3f +/- %.3f\n",
+			ExperimentScheduler::GetMetricName(metric),
+			scheduler.GetMean(metric, true),
+			scheduler.GetConfidenceInterval(metric, true),
+			scheduler.GetMean(metric, false),
+			scheduler.GetConfidenceInterval(metric, false));
+	}
+
+	bool IsSeparated(const ExperimentScheduler& scheduler, ExperimentScheduler::Metric metric, bool enactedIsHigher)
+	{
+		const double enactedLow = scheduler.GetMean(metric, true) - scheduler.GetConfidenceInterval(metric, true);
+		const double enactedHigh = scheduler.GetMean(metric, true) + scheduler.GetConfidenceInterval(metric, true);
+		const double repealedLow = scheduler.GetMean(metric, false) - scheduler.GetConfidenceInterval(metric, false);
+		const double repealedHigh = scheduler.GetMean(metric, false) + scheduler.GetConfidenceInterval(metric, false);
+
+		return enactedIsHigher ? enactedLow > repealedHigh : enactedHigh < repealedLow;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--years", "n", "The simulated years", options.years);
+	arguments.AddValue("--period", "months", "The months in each experiment period", options.periodMonths);
+	arguments.AddValue("--washout", "months", "The unmeasured months at the start of each period", options.washoutMonths, 0);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	MockRuntimeOptions runtimeOptions;
+	runtimeOptions.messageCostNanoseconds = 0;
+	runtimeOptions.trafficSimulatorShutdownCostNanoseconds = 0;
+	runtimeOptions.trafficSimulatorInitCostNanoseconds = 0;
+	runtimeOptions.trafficSimulatorMessageCostNanoseconds = 0;
+
+	MockRuntime runtime(runtimeOptions);
+
+	TrafficTuningCoordinator coordinator;
+	coordinator.RegisterParticipant(kParticipantID, cRZBaseString("ExperimentBenchmark"));
+
+	ParknRideOrdinance ordinance;
+	ordinance.SetTuningCoordinator(&coordinator, kParticipantID);
+	ordinance.SetImpactReportMonths(0);
+	ordinance.SetExperimentSchedule(options.periodMonths, options.washoutMonths);
+
+	cISC4City* pCity = runtime.LoadCity();
+
+	std::mt19937 random(0x5ab7e1);
+	std::uniform_int_distribution<int> percentages(0, 99);
+	std::uniform_int_distribution<int> values(40, 240);
+
+	std::vector<uint8_t> baseCongestion(runtime.GetTrafficSimulator().GetMockCongestionMap()->GetValues().size());
+
+	for (uint8_t& value : baseCongestion)
+	{
+		value = percentages(random) < 30 ? static_cast<uint8_t>(values(random)) : 0;
+	}
+
+	if (!ordinance.PostCityInit(pCity))
+	{
+		std::fprintf(stderr, "PostCityInit failed.\n");
+		return 1;
+	}
+
+	ordinance.SetAvailable(true);
+	ordinance.UpdateCarCanReachDestination(/*calledFromPostCityInit*/true);
+	runtime.Tick();
+
+	const ExperimentScheduler& scheduler = ordinance.GetExperimentScheduler();
+	const uint32_t months = options.years * 12;
+	uint32_t expectedToggles = 0;
+	bool succeeded = true;
+
+	for (uint32_t i = 0; i < months && succeeded; i++)
+	{
+		succeeded = SimulateMonth(runtime, ordinance, baseCongestion, options.periodMonths, random, expectedToggles);
+	}
+
+	if (succeeded && scheduler.GetToggleCount() != expectedToggles)
+	{
+		std::fprintf(stderr, "Expected %u toggles, found %u.\n", expectedToggles, scheduler.GetToggleCount());
+		succeeded = false;
+	}
+
+	if (succeeded)
+	{
+		std::printf(
+			"%u years, %u month periods (%u enacted, %u repealed), mean +/- 95%% CI:\n",
+			options.years,
+			options.periodMonths,
+			scheduler.GetCompletedPeriods(true),
+			scheduler.GetCompletedPeriods(false));
+
+		PrintMetric(scheduler, ExperimentScheduler::AverageCongestion);
+		PrintMetric(scheduler, ExperimentScheduler::CongestedTracts);
+		PrintMetric(scheduler, ExperimentScheduler::CommercialServiceLowWealthDemand);
+
+		if (scheduler.GetCompletedPeriods(true) >= 5 && scheduler.GetCompletedPeriods(false) >= 5)
+		{
+			succeeded = IsSeparated(scheduler, ExperimentScheduler::AverageCongestion, /*enactedIsHigher*/false)
+				&& IsSeparated(scheduler, ExperimentScheduler::CommercialServiceLowWealthDemand, /*enactedIsHigher*/true);
+
+			if (!succeeded)
+			{
+				std::fprintf(stderr, "The experiment did not detect the simulated ordinance effects.\n");
+			}
+		}
+	}
+
+	// A one month period ends in the same Simulate call that it started in, so it cannot be interrupted.
+	if (succeeded && options.periodMonths > 1)
+	{
+		// A player toggle discards the current period.
+		runtime.AdvanceSimDate(30);
+		ordinance.Simulate();
+		ordinance.SetOn(!ordinance.IsOn());
+		runtime.AdvanceSimDate(30);
+		ordinance.Simulate();
+
+		if (scheduler.GetDiscardedPeriods() != 1)
+		{
+			std::fprintf(stderr, "The period with a player toggle was not discarded.\n");
+			succeeded = false;
+		}
+	}
+
+	if (succeeded)
+	{
+		// Reload the city in the middle of a period, the periods after it must still follow the calendar.
+		ordinance.PreCityShutdown(pCity);
+		runtime.UnloadCity();
+		pCity = runtime.LoadCity();
+
+		if (!ordinance.PostCityInit(pCity))
+		{
+			std::fprintf(stderr, "PostCityInit failed after the reload.\n");
+			succeeded = false;
+		}
+
+		uint32_t reloadToggles = 0;
+
+		for (uint32_t i = 0; i < options.periodMonths * 3 && succeeded; i++)
+		{
+			succeeded = SimulateMonth(runtime, ordinance, baseCongestion, options.periodMonths, random, reloadToggles);
+		}
+
+		if (succeeded && scheduler.GetCompletedPeriods(true) + scheduler.GetCompletedPeriods(false) == 0)
+		{
+			std::fprintf(stderr, "No period was measured after the reload.\n");
+			succeeded = false;
+		}
+	}
+
+	ordinance.PreCityShutdown(pCity);
+	runtime.UnloadCity();
+
+	return succeeded ? 0 : 1;
+}
@@ -0,0 +1,243 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Checks the impact report that the ordinance writes after it is toggled, and
+// measures the cost and memory use of keeping a report for every toggle.
+//
+// Enacting the ordinance moves the mock congestion map towards lower values and
+// increases the traffic that arrives at the transit switches, so the report must
+// show less congestion and more transit switch usage.
+
+#include "BenchmarkArguments.h"
+#include "MockRuntime.h"
+#include "ParknRideOrdinance.h"
+#include "RidershipMeter.h"
+#include "Settings.h"
+#include "Stopwatch.h"
+#include "TrafficTuningCoordinator.h"
+#include "TransitSwitchIndex.h"
+#include "cRZBaseString.h"
+#include <cstdio>
+#include <random>
+
+namespace
+{
+	constexpr uint32_t kParticipantID = 0x8b8d3b1a;
+	constexpr uint32_t kBusTravelType = 2;
+	constexpr uint32_t kTransitSwitchCapacity = 1000;
+
+	struct BenchmarkOptions
+	{
+		uint32_t cityCellCount = 256;
+		uint32_t reportMonths = 12;
+		uint32_t toggles = 1000;
+		uint32_t transitSwitches = 200;
+	};
+
+	void FillTrafficMap(MockSimGrid<uint8_t>* map, std::mt19937& random)
+	{
+		std::uniform_int_distribution<int> percentages(0, 99);
+		std::uniform_int_distribution<int> values(64, 255);
+
+		for (uint8_t& value : map->GetValues())
+		{
+			value = percentages(random) < 30 ? static_cast<uint8_t>(values(random)) : 0;
+		}
+	}
+
+	void SetTransitSwitchTraffic(MockTrafficSimulator& trafficSimulator, uint32_t count, uint32_t arrived)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			trafficSimulator.SetTransitSwitchTraffic(i, kBusTravelType, kTransitSwitchCapacity, arrived);
+		}
+	}
+
+	void SimulateMonth(MockRuntime& runtime, ParknRideOrdinance& ordinance)
+	{
+		runtime.AdvanceSimDate(30);
+		runtime.Tick();
+		ordinance.Simulate();
+	}
+
+	bool CheckEnactmentReport(const BenchmarkOptions& options, MockRuntime& runtime, ParknRideOrdinance& ordinance)
+	{
+		MockTrafficSimulator& trafficSimulator = runtime.GetTrafficSimulator();
+
+		ordinance.SetOn(true);
+		runtime.Tick();
+
+		// The ordinance reduces the congestion, and more trips use the transit switches.
+		for (uint8_t& value : trafficSimulator.GetMockCongestionMap()->GetValues())
+		{
+			value = static_cast<uint8_t>((value * 3) / 4);
+		}
+
+		trafficSimulator.SetEquilibrium(1.0);
+		SetTransitSwitchTraffic(trafficSimulator, options.transitSwitches, 600);
+
+		for (uint32_t i = 0; i < options.reportMonths; i++)
+		{
+			SimulateMonth(runtime, ordinance);
+		}
+
+		const std::vector<ImpactReport>& reports = ordinance.GetImpactReporter().GetReports();
+
+		if (reports.size() != 1 || !reports[0].complete || reports[0].monthCount != options.reportMonths)
+		{
+			std::fprintf(stderr, "The enactment report was not completed after %u months.\n", options.reportMonths);
+			return false;
+		}
+
+		const ImpactReport& report = reports[0];
+
+		std::printf(
+			"enacted: congestion %.2f -> %.2f, trip length %.2f -> %.2f, transit switch usage %.1f%% -> %.1f%%\n",
+			report.before.GetAverageCongestion(),
+			report.after.GetAverageCongestion(),
+			report.before.GetAverageTripLength(),
+			report.after.GetAverageTripLength(),
+			report.before.GetTransitSwitchUsage() * 100.0,
+			report.after.GetTransitSwitchUsage() * 100.0);
+
+		const bool expectedDirection = report.after.GetAverageCongestion() < report.before.GetAverageCongestion()
+			&& report.after.GetCongestionShareAtLeast(8) < report.before.GetCongestionShareAtLeast(8)
+			&& report.before.GetTransitSwitchUsage() == 0.4
+			&& report.after.GetTransitSwitchUsage() == 0.6;
+
+		if (!expectedDirection)
+		{
+			std::fprintf(stderr, "The enactment report does not match the simulated traffic change.\n");
+		}
+
+		return expectedDirection;
+	}
+
+	bool MeasureToggles(const BenchmarkOptions& options, MockRuntime& runtime, ParknRideOrdinance& ordinance)
+	{
+		Stopwatch toggleTime;
+		Stopwatch monthTime;
+
+		for (uint32_t i = 0; i < options.toggles; i++)
+		{
+			monthTime.Start();
+			SimulateMonth(runtime, ordinance);
+			monthTime.Stop();
+
+			toggleTime.Start();
+			ordinance.SetOn(!ordinance.IsOn());
+			toggleTime.Stop();
+
+			runtime.Tick();
+		}
+
+		const std::vector<ImpactReport>& reports = ordinance.GetImpactReporter().GetReports();
+
+		// Every toggle interrupts the previous report after one month.
+		if (reports.size() != options.toggles)
+		{
+			std::fprintf(stderr, "Expected %u reports, found %zu.\n", options.toggles, reports.size());
+			return false;
+		}
+
+		std::printf(
+			"%u toggles: %zu bytes per report, %zu KB for all reports, toggle %.1f us, simulate month %.1f us\n",
+			options.toggles,
+			sizeof(ImpactReport),
+			(reports.size() * sizeof(ImpactReport)) / 1024,
+			static_cast<double>(toggleTime.ElapsedMicroseconds()) / options.toggles,
+			static_cast<double>(monthTime.ElapsedMicroseconds()) / options.toggles);
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--city-size", "cells", "The city width in cells", options.cityCellCount);
+	arguments.AddValue("--months", "n", "The months that each report covers", options.reportMonths);
+	arguments.AddValue("--toggles", "n", "The number of monthly toggles to measure", options.toggles);
+	arguments.AddValue("--transit-switches", "n", "The number of transit switch lots", options.transitSwitches);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	// The traffic simulator restart cost is measured by ToggleLatencyBenchmark.
+	MockRuntimeOptions runtimeOptions;
+	runtimeOptions.cityCellCount = options.cityCellCount;
+	runtimeOptions.messageCostNanoseconds = 0;
+	runtimeOptions.trafficSimulatorShutdownCostNanoseconds = 0;
+	runtimeOptions.trafficSimulatorInitCostNanoseconds = 0;
+	runtimeOptions.trafficSimulatorMessageCostNanoseconds = 0;
+
+	MockRuntime runtime(runtimeOptions);
+
+	TrafficTuningCoordinator coordinator;
+	coordinator.RegisterParticipant(kParticipantID, cRZBaseString("ImpactReportBenchmark"));
+
+	ParknRideOrdinance ordinance;
+	ordinance.SetTuningCoordinator(&coordinator, kParticipantID);
+	ordinance.SetImpactReportMonths(options.reportMonths);
+
+	cISC4City* pCity = runtime.LoadCity();
+	MockTrafficSimulator& trafficSimulator = runtime.GetTrafficSimulator();
+
+	std::mt19937 random(0x1e4ac7);
+	FillTrafficMap(trafficSimulator.GetMockCongestionMap(), random);
+	FillTrafficMap(trafficSimulator.GetMockTripLengthMap(), random);
+	trafficSimulator.SetEquilibrium(1.0);
+
+	for (uint32_t i = 0; i < options.transitSwitches; i++)
+	{
+		trafficSimulator.AddTransitSwitch();
+	}
+
+	SetTransitSwitchTraffic(trafficSimulator, options.transitSwitches, 400);
+
+	// The meter reads every switch on each simulated day, so the summaries have the current usage.
+	Settings settings;
+	settings.transitSwitchesPerDay = options.transitSwitches;
+
+	TransitSwitchIndex index;
+	RidershipMeter meter;
+
+	if (!index.Build(pCity) || !meter.Start(pCity, &index, settings) || !ordinance.PostCityInit(pCity))
+	{
+		std::fprintf(stderr, "PostCityInit failed.\n");
+		return 1;
+	}
+
+	ordinance.SetAvailable(true);
+	ordinance.SetTransitSwitchIndex(&index);
+	ordinance.UpdateCarCanReachDestination(/*calledFromPostCityInit*/true);
+	runtime.Tick();
+
+	bool succeeded = CheckEnactmentReport(options, runtime, ordinance);
+
+	if (succeeded)
+	{
+		succeeded = MeasureToggles(options, runtime, ordinance);
+	}
+
+	ordinance.PreCityShutdown(pCity);
+	meter.Stop();
+	index.Clear();
+	runtime.UnloadCity();
+
+	return succeeded ? 0 : 1;
+}
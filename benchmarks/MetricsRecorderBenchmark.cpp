@@ -0,0 +1,268 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Records simulated months with the metrics recorder, reads the file back and checks
+// that every value round-trips, then reports the cost of recording one month.
+//
+// The recorder is closed and reopened half way through to check appending to an
+// existing file, and a partially written block is appended to the file to check
+// that it is discarded when the file is reopened.
+
+#include "BenchmarkArguments.h"
+#include "BenchmarkStatistics.h"
+#include "MetricsFileReader.h"
+#include "MetricsRecorder.h"
+#include "MockRuntime.h"
+#include "Stopwatch.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using namespace MetricsFileFormat;
+
+	struct BenchmarkOptions
+	{
+		uint32_t months = 240;
+		uint32_t cityCellCount = 256;
+	};
+
+	struct ExpectedRow
+	{
+		int32_t year;
+		int32_t month;
+		bool ordinanceOn;
+		bool carRestrictionActive;
+		float tripScale;
+		float lastMonthlyIncome;
+		float freightScalingFactor;
+		std::array<uint32_t, 1 + CongestionBucketCount> congestion;
+	};
+
+	void ChangeTraffic(MockSimGrid<uint8_t>* map, std::mt19937& random)
+	{
+		std::uniform_int_distribution<int> percentages(0, 99);
+		std::uniform_int_distribution<int> values(0, 255);
+
+		for (uint8_t& value : map->GetValues())
+		{
+			if (percentages(random) < 10)
+			{
+				value = static_cast<uint8_t>(values(random));
+			}
+		}
+	}
+
+	ExpectedRow GetExpectedRow(MockRuntime& runtime, bool ordinanceOn, bool carRestrictionActive)
+	{
+		ExpectedRow expected{};
+
+		long year = 0;
+		long month = 0;
+		long day = 0;
+		long dayOfYear = 0;
+		long weekDay = 0;
+		runtime.GetCity()->GetSimulator()->GetSimDate(year, month, day, dayOfYear, weekDay);
+
+		MockTrafficSimulator& trafficSimulator = runtime.GetTrafficSimulator();
+
+		expected.year = static_cast<int32_t>(year);
+		expected.month = static_cast<int32_t>(month);
+		expected.ordinanceOn = ordinanceOn;
+		expected.carRestrictionActive = carRestrictionActive;
+		expected.tripScale = trafficSimulator.GetTripScale();
+		expected.lastMonthlyIncome = trafficSimulator.GetLastMonthlyIncome();
+		expected.freightScalingFactor = trafficSimulator.GetFreightScalingFactor();
+
+		for (uint8_t value : trafficSimulator.GetMockCongestionMap()->GetValues())
+		{
+			expected.congestion[value == 0 ? 0 : 1 + (value >> CongestionBucketShift)]++;
+		}
+
+		return expected;
+	}
+
+	bool VerifyRows(const std::filesystem::path& path, const std::vector<ExpectedRow>& expectedRows)
+	{
+		MetricsFileReader reader;
+
+		if (!reader.Open(path))
+		{
+			std::fprintf(stderr, "Failed to read the metrics file.\n");
+			return false;
+		}
+
+		if (reader.GetColumnCount() != ColumnCount || reader.GetRowCount() != expectedRows.size())
+		{
+			std::fprintf(
+				stderr,
+				"The file has %zu columns and %zu rows, expected %u columns and %zu rows.\n",
+				reader.GetColumnCount(),
+				reader.GetRowCount(),
+				ColumnCount,
+				expectedRows.size());
+			return false;
+		}
+
+		for (size_t row = 0; row < expectedRows.size(); row++)
+		{
+			const ExpectedRow& expected = expectedRows[row];
+
+			bool matches = reader.GetInt32(Year, row) == expected.year
+				&& reader.GetInt32(Month, row) == expected.month
+				&& reader.GetUInt32(OrdinanceOn, row) == (expected.ordinanceOn ? 1U : 0U)
+				&& reader.GetUInt32(CarRestrictionActive, row) == (expected.carRestrictionActive ? 1U : 0U)
+				&& reader.GetFloat(TripScale, row) == expected.tripScale
+				&& reader.GetFloat(LastMonthlyIncome, row) == expected.lastMonthlyIncome
+				&& reader.GetFloat(FreightScalingFactor, row) == expected.freightScalingFactor;
+
+			for (uint32_t i = 0; matches && i < expected.congestion.size(); i++)
+			{
+				matches = reader.GetUInt32(CongestionZero + i, row) == expected.congestion[i];
+			}
+
+			if (!matches)
+			{
+				std::fprintf(stderr, "Row %zu does not match the recorded values.\n", row);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void AppendIncompleteBlock(const std::filesystem::path& path)
+	{
+		std::ofstream stream(path, std::ios::binary | std::ios::app);
+
+		const std::array<uint32_t, 5> garbage = { 1, 0xdeadbeef, 2, 3, 4 };
+		stream.write(reinterpret_cast<const char*>(garbage.data()), sizeof(garbage));
+	}
+
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--months", "n", "The number of simulation months to record", options.months);
+	arguments.AddValue("--city-size", "cells", "The city width in cells", options.cityCellCount);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	const std::filesystem::path path = std::filesystem::temp_directory_path() / "MetricsRecorderBenchmark.pnrmetrics";
+
+	std::error_code ec;
+	std::filesystem::remove(path, ec);
+
+	MockRuntimeOptions runtimeOptions;
+	runtimeOptions.cityCellCount = options.cityCellCount;
+
+	MockRuntime runtime(runtimeOptions);
+	cISC4City* pCity = runtime.LoadCity();
+	MockTrafficSimulator& trafficSimulator = runtime.GetTrafficSimulator();
+
+	std::mt19937 random(0x3e7a11);
+	std::uniform_real_distribution<float> statistics(0.0f, 1000.0f);
+
+	MetricsRecorder recorder;
+
+	if (!recorder.Open(path))
+	{
+		std::fprintf(stderr, "Failed to create the metrics file.\n");
+		return 1;
+	}
+
+	std::vector<ExpectedRow> expectedRows;
+	std::vector<int64_t> samples;
+	expectedRows.reserve(options.months);
+	samples.reserve(options.months);
+
+	bool succeeded = true;
+
+	for (uint32_t i = 0; i < options.months && succeeded; i++)
+	{
+		if (i == options.months / 2)
+		{
+			recorder.Close();
+			AppendIncompleteBlock(path);
+
+			if (!recorder.Open(path) || recorder.GetRowCount() != expectedRows.size())
+			{
+				std::fprintf(stderr, "Failed to reopen the metrics file.\n");
+				succeeded = false;
+				break;
+			}
+		}
+
+		runtime.AdvanceSimDate(30);
+		ChangeTraffic(trafficSimulator.GetMockCongestionMap(), random);
+		trafficSimulator.SetMonthlyStatistics(statistics(random), -statistics(random), statistics(random) / 1000.0f);
+
+		const bool ordinanceOn = (i / 12) % 2 == 1;
+		const bool carRestrictionActive = ordinanceOn && (i % 3) != 0;
+
+		Stopwatch stopwatch;
+		stopwatch.Start();
+
+		const bool recorded = recorder.Record(pCity, ordinanceOn, carRestrictionActive);
+
+		stopwatch.Stop();
+
+		// The second call in the same month must not add a row.
+		if (!recorded || recorder.Record(pCity, ordinanceOn, carRestrictionActive))
+		{
+			std::fprintf(stderr, "Month %u was not recorded exactly once.\n", i);
+			succeeded = false;
+			break;
+		}
+
+		expectedRows.push_back(GetExpectedRow(runtime, ordinanceOn, carRestrictionActive));
+		samples.push_back(stopwatch.ElapsedMicroseconds());
+	}
+
+	recorder.Close();
+	runtime.UnloadCity();
+
+	if (succeeded)
+	{
+		succeeded = VerifyRows(path, expectedRows);
+	}
+
+	if (succeeded)
+	{
+		std::sort(samples.begin(), samples.end());
+
+		std::printf(
+			"%u months, %ux%u city, %llu byte file: record p50 %lld us, p99 %lld us, max %lld us\n",
+			options.months,
+			options.cityCellCount,
+			options.cityCellCount,
+			static_cast<unsigned long long>(std::filesystem::file_size(path, ec)),
+			static_cast<long long>(BenchmarkStatistics::GetPercentile(samples, 0.50)),
+			static_cast<long long>(BenchmarkStatistics::GetPercentile(samples, 0.99)),
+			static_cast<long long>(samples.back()));
+	}
+
+	std::filesystem::remove(path, ec);
+
+	return succeeded ? 0 : 1;
+}
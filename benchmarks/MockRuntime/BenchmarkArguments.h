@@ -0,0 +1,210 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdint.h>
+#include <vector>
+
+// Parses the command line options of a benchmark and prints its usage text.
+//
+// An option is either a flag, or a name that is followed by an integer value within a range.
+// The values that the options are bound to when they are added are listed as the defaults.
+class BenchmarkArguments
+{
+public:
+
+	static constexpr int64_t DefaultMaximum = std::numeric_limits<int32_t>::max();
+	static constexpr int64_t NoMaximum = std::numeric_limits<int64_t>::max();
+
+	/**
+	 * @brief Adds an option that is followed by an integer value.
+	 * @param name The option name, including the leading dashes.
+	 * @param valueName The name of the value in the usage text, for example n or ns.
+	 * @param description The description in the usage text, without a trailing period.
+	 * @param value The variable that receives the value, its current value is the default.
+	 * @param minimum The smallest value that is accepted.
+	 * @param maximum The largest value that is accepted.
+	 */
+	template <typename T>
+	void AddValue(
+		const char* name,
+		const char* valueName,
+		const char* description,
+		T& value,
+		int64_t minimum = 1,
+		int64_t maximum = DefaultMaximum)
+	{
+		options.push_back(Option
+		{
+			name,
+			valueName,
+			description,
+			static_cast<int64_t>(value),
+			minimum,
+			maximum,
+			[&value](int64_t parsed) { value = static_cast<T>(parsed); },
+		});
+	}
+
+	/**
+	 * @brief Adds an option without a value that sets a flag.
+	 * @param name The option name, including the leading dashes.
+	 * @param description The description in the usage text, without a trailing period.
+	 * @param value The variable that is set to true when the option is present.
+	 */
+	void AddFlag(const char* name, const char* description, bool& value)
+	{
+		options.push_back(Option
+		{
+			name,
+			nullptr,
+			description,
+			0,
+			0,
+			0,
+			[&value](int64_t) { value = true; },
+		});
+	}
+
+	/**
+	 * @brief Parses the command line.
+	 * @return True on success; otherwise, false if an option is unknown, is missing its value,
+	 * or the value is not an integer within the range of the option.
+	 */
+	bool Parse(int argc, char** argv) const
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const Option* option = FindOption(argv[i]);
+
+			if (!option)
+			{
+				return false;
+			}
+
+			int64_t value = 0;
+
+			if (option->valueName)
+			{
+				if (i + 1 >= argc || !ParseInteger(argv[++i], value) || value < option->minimum || value > option->maximum)
+				{
+					return false;
+				}
+			}
+
+			option->assign(value);
+		}
+
+		return true;
+	}
+
+	void PrintUsage(const char* program) const
+	{
+		std::printf("Usage: %s", program);
+
+		size_t width = 0;
+
+		for (const Option& option : options)
+		{
+			if (option.valueName)
+			{
+				std::printf(" [%s <%s>]", option.name, option.valueName);
+			}
+			else
+			{
+				std::printf(" [%s]", option.name);
+			}
+
+			width = std::max(width, GetSyntaxLength(option));
+		}
+
+		std::printf("\n");
+
+		for (const Option& option : options)
+		{
+			const int padding = static_cast<int>(width - GetSyntaxLength(option)) + 3;
+
+			if (option.valueName)
+			{
+				std::printf(
+					"  %s <%s>%*s%s (default %lld).\n",
+					option.name,
+					option.valueName,
+					padding,
+					"",
+					option.description,
+					static_cast<long long>(option.defaultValue));
+			}
+			else
+			{
+				std::printf("  %s%*s%s.\n", option.name, padding, "", option.description);
+			}
+		}
+	}
+
+private:
+
+	struct Option
+	{
+		const char* name;
+		// Null for a flag.
+		const char* valueName;
+		const char* description;
+		int64_t defaultValue;
+		int64_t minimum;
+		int64_t maximum;
+		std::function<void(int64_t)> assign;
+	};
+
+	const Option* FindOption(const char* name) const
+	{
+		for (const Option& option : options)
+		{
+			if (std::strcmp(option.name, name) == 0)
+			{
+				return &option;
+			}
+		}
+
+		return nullptr;
+	}
+
+	static bool ParseInteger(const char* text, int64_t& value)
+	{
+		char* end = nullptr;
+		errno = 0;
+		const long long parsed = std::strtoll(text, &end, 10);
+
+		if (end == text || *end != '\0' || errno == ERANGE)
+		{
+			return false;
+		}
+
+		value = parsed;
+		return true;
+	}
+
+	static size_t GetSyntaxLength(const Option& option)
+	{
+		return std::strlen(option.name) + (option.valueName ? std::strlen(option.valueName) + 3 : 0);
+	}
+
+	std::vector<Option> options;
+};
@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// The statistics that the benchmarks report for their timing samples.
+namespace BenchmarkStatistics
+{
+	/**
+	 * @brief Gets the nearest-rank percentile of the samples.
+	 * @param sortedSamples The samples in ascending order, there must be at least one.
+	 * @param percentile The percentile, from 0 to 1.
+	 */
+	inline int64_t GetPercentile(const std::vector<int64_t>& sortedSamples, double percentile)
+	{
+		const size_t index = static_cast<size_t>(percentile * static_cast<double>(sortedSamples.size() - 1) + 0.5);
+
+		return sortedSamples[index];
+	}
+}
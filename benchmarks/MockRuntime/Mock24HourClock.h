@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockUnknown.h"
+#include "cISC424HourClock.h"
+
+// A cISC424HourClock that is set by the benchmark instead of advancing with the game.
+class Mock24HourClock final : public MockUnknown<cISC424HourClock>
+{
+public:
+
+	uint32_t GetHour(void) override
+	{
+		return hour;
+	}
+
+	uint32_t SetHour(uint32_t dwHour) override
+	{
+		hour = dwHour % 24;
+		return hour;
+	}
+
+	uint32_t GetMinute(void) override
+	{
+		return minute;
+	}
+
+	uint32_t SetMinute(uint32_t dwMinute) override
+	{
+		minute = dwMinute % 60;
+		return minute;
+	}
+
+	float GetTimePercentage(void) override
+	{
+		return static_cast<float>((hour * 60) + minute) / (24.0f * 60.0f);
+	}
+
+	bool IsNight(void) override
+	{
+		return hour < 6 || hour >= 20;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool Init(void) override { return true; }
+	bool Shutdown(void) override { return true; }
+	int32_t SetVisualTimeMode(int32_t nTimeMode) override { return 0; }
+	int32_t GetVisualTimeMode(void) override { return 0; }
+	int32_t SetTimePercentage(float& fPercentage) override { return 0; }
+	float GetVisualTimePercentage(void) override { return GetTimePercentage(); }
+	uint32_t GetVisualHour(void) override { return hour; }
+	uint32_t GetVisualMinute(void) override { return minute; }
+	uint32_t GetSeconds(void) override { return 0; }
+	uint32_t SetSeconds(uint32_t dwSeconds) override { return 0; }
+	uint32_t GetVisualSeconds(void) override { return 0; }
+	uint32_t GetEventHour(bool bUnknown) override { return hour; }
+	uint32_t GetTimeMagnification(float& fMagnificationOut) override { return 0; }
+	uint32_t SetTimeMagnification(float fMagnification) override { return 0; }
+	uint32_t GetTimeMagnificationMinMax(float& fMinOut, float& fMaxOut) override { return 0; }
+	bool SetTimeMagnificationMinMax(float fMin, float fMax) override { return false; }
+	bool Pause(bool bUnknown) override { return false; }
+	bool IsPaused(void) override { return false; }
+	bool HiddenPause(bool bUnknown) override { return false; }
+	bool IsHiddenPaused(void) override { return false; }
+	void EnableDayNightTransitionNotifications(bool bToggle) override {}
+
+private:
+
+	uint32_t hour = 0;
+	uint32_t minute = 0;
+};
@@ -0,0 +1,39 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockUnknown.h"
+#include "cIGZAllocatorService.h"
+#include <cstdlib>
+
+// A cIGZAllocatorService implementation that uses the C runtime heap, the game
+// containers that the traffic simulator fills (e.g. ilist) allocate through it.
+class MockAllocatorService final : public MockUnknown<cIGZAllocatorService>
+{
+public:
+
+	void* Allocate(uint32_t dwSize) override
+	{
+		return std::malloc(dwSize);
+	}
+
+	bool Deallocate(void* pData) override
+	{
+		std::free(pData);
+		return true;
+	}
+
+	void* Reallocate(void* pData, uint32_t dwNewSize) override
+	{
+		return std::realloc(pData, dwNewSize);
+	}
+};
@@ -0,0 +1,23 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <stdint.h>
+
+namespace MockCost
+{
+	/**
+	 * @brief Busy-waits for the specified time, this simulates the cost of a game call.
+	 * @param nanoseconds The time to wait, in nanoseconds.
+	 */
+	void Spin(int64_t nanoseconds);
+}
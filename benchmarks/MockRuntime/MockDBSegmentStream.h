@@ -0,0 +1,307 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockUnknown.h"
+#include "cISC4DBSegmentIStream.h"
+#include "cISC4DBSegmentOStream.h"
+#include "cIGZString.h"
+#include "cIGZVariant.h"
+#include <cstring>
+#include <vector>
+
+// A DB segment stream that writes to and reads from a byte buffer, which allows the
+// save game serialization of the plugin objects to be round-tripped without the game.
+// The variants are written as their type, element count and raw values, only the
+// numeric types and the Float32 and Uint32 arrays are supported. The strings are
+// written as their length followed by the characters.
+class MockDBSegmentStream final : public cISC4DBSegmentOStream, public cISC4DBSegmentIStream
+{
+public:
+
+	MockDBSegmentStream() : buffer(), readPosition(0), refCount(0)
+	{
+	}
+
+	const std::vector<uint8_t>& GetBuffer() const
+	{
+		return buffer;
+	}
+
+	// Starts reading from the beginning of the buffer.
+	void Rewind()
+	{
+		readPosition = 0;
+	}
+
+	bool IsAtEnd() const
+	{
+		return readPosition == buffer.size();
+	}
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override
+	{
+		if (riid == GZIID_cISC4DBSegmentOStream)
+		{
+			*ppvObj = static_cast<cISC4DBSegmentOStream*>(this);
+			AddRef();
+			return true;
+		}
+		else if (riid == GZIID_cISC4DBSegmentIStream)
+		{
+			*ppvObj = static_cast<cISC4DBSegmentIStream*>(this);
+			AddRef();
+			return true;
+		}
+
+		return false;
+	}
+
+	uint32_t AddRef() override
+	{
+		return ++refCount;
+	}
+
+	uint32_t Release() override
+	{
+		if (refCount > 0)
+		{
+			--refCount;
+		}
+
+		return refCount;
+	}
+
+	// cIGZOStream
+
+	void Flush(void) override {}
+	bool SetSint8(int8_t cValue) override { return Write(&cValue, sizeof(cValue)); }
+	bool SetUint8(uint8_t ucValue) override { return Write(&ucValue, sizeof(ucValue)); }
+	bool SetSint16(int16_t sValue) override { return Write(&sValue, sizeof(sValue)); }
+	bool SetUint16(uint16_t usValue) override { return Write(&usValue, sizeof(usValue)); }
+	bool SetSint32(int32_t lValue) override { return Write(&lValue, sizeof(lValue)); }
+	bool SetUint32(uint32_t ulValue) override { return Write(&ulValue, sizeof(ulValue)); }
+	bool SetSint64(int64_t llValue) override { return Write(&llValue, sizeof(llValue)); }
+	bool SetUint64(uint64_t ullValue) override { return Write(&ullValue, sizeof(ullValue)); }
+	bool SetFloat32(float fValue) override { return Write(&fValue, sizeof(fValue)); }
+	bool SetFloat64(double dValue) override { return Write(&dValue, sizeof(dValue)); }
+	bool SetRZCharStr(char const* pszData) override { return false; }
+	bool SetGZStr(cIGZString const& szData) override
+	{
+		const uint32_t length = szData.Strlen();
+
+		return SetUint32(length) && Write(szData.Data(), length);
+	}
+
+	bool SetGZSerializable(cIGZSerializable const& sData) override { return false; }
+	bool SetVoid(void const* pData, uint32_t dwSize) override { return Write(pData, dwSize); }
+
+	// cIGZIStream
+
+	bool Skip(uint32_t dwBytes) override
+	{
+		if (buffer.size() - readPosition < dwBytes)
+		{
+			return false;
+		}
+
+		readPosition += dwBytes;
+		return true;
+	}
+
+	bool GetSint8(int8_t& cValueOut) override { return Read(&cValueOut, sizeof(cValueOut)); }
+	bool GetUint8(uint8_t& ucValueOut) override { return Read(&ucValueOut, sizeof(ucValueOut)); }
+	bool GetSint16(int16_t& sValueOut) override { return Read(&sValueOut, sizeof(sValueOut)); }
+	bool GetUint16(uint16_t& usValueOut) override { return Read(&usValueOut, sizeof(usValueOut)); }
+	bool GetSint32(int32_t& lValueOut) override { return Read(&lValueOut, sizeof(lValueOut)); }
+	bool GetUint32(uint32_t& ulValueOut) override { return Read(&ulValueOut, sizeof(ulValueOut)); }
+	bool GetSint64(int64_t& llValueOut) override { return Read(&llValueOut, sizeof(llValueOut)); }
+	bool GetUint64(uint64_t& ullValueOut) override { return Read(&ullValueOut, sizeof(ullValueOut)); }
+	bool GetFloat32(float& fValueOut) override { return Read(&fValueOut, sizeof(fValueOut)); }
+	bool GetFloat64(double& dValueOut) override { return Read(&dValueOut, sizeof(dValueOut)); }
+	bool GetRZCharStr(char* pszDataOut, uint32_t dwMaxBytes) override { return false; }
+	bool GetGZStr(cIGZString& szDataOut) override
+	{
+		uint32_t length = 0;
+
+		if (!GetUint32(length) || buffer.size() - readPosition < length)
+		{
+			return false;
+		}
+
+		szDataOut.FromChar(reinterpret_cast<const char*>(buffer.data() + readPosition), length);
+		readPosition += length;
+		return true;
+	}
+
+	bool GetGZSerializable(cIGZSerializable& sDataOut) override { return false; }
+	bool GetVoid(void* pDataOut, uint32_t dwSize) override { return Read(pDataOut, dwSize); }
+
+	// The error code, user data and segment methods are shared by both interfaces.
+
+	int32_t GetError(void) override { return 0; }
+	int32_t SetUserData(cIGZVariant* pData) override { return 0; }
+	int32_t GetUserData(void) override { return 0; }
+	bool Open(cISC4DBSegment* pSegment, cGZPersistResourceKey const& sKey, bool bUnknown) override { return true; }
+	bool Close(void) override { return true; }
+	bool IsOpen(void) override { return true; }
+	int32_t GetRecord(void) override { return 0; }
+	int32_t GetSegment(void) override { return 0; }
+
+	// cISC4DBSegmentOStream
+
+	bool WriteGZSerializable(cIGZSerializable const* pSegment) override { return false; }
+	bool WriteResKey(cGZPersistResourceKey const& sKey) override { return false; }
+
+	bool WriteVariant(cIGZVariant const& sVariant) override
+	{
+		const uint16_t type = sVariant.GetType();
+		const uint32_t count = sVariant.GetCount();
+
+		if (!SetUint16(type) || !SetUint32(count))
+		{
+			return false;
+		}
+
+		switch (type)
+		{
+		case cIGZVariant::Type::Bool:
+			return SetUint8(sVariant.GetValBool() ? 1 : 0);
+		case cIGZVariant::Type::Uint8:
+			return SetUint8(sVariant.GetValUint8());
+		case cIGZVariant::Type::Uint32:
+			return SetUint32(sVariant.GetValUint32());
+		case cIGZVariant::Type::Sint32:
+			return SetSint32(sVariant.GetValSint32());
+		case cIGZVariant::Type::Float32:
+			return SetFloat32(sVariant.GetValFloat32());
+		case cIGZVariant::Type::Float64:
+			return SetFloat64(sVariant.GetValFloat64());
+		case cIGZVariant::Type::Uint32Array:
+			return Write(sVariant.RefUint32(), count * sizeof(uint32_t));
+		case cIGZVariant::Type::Float32Array:
+			return Write(sVariant.RefFloat32(), count * sizeof(float));
+		default:
+			return false;
+		}
+	}
+
+	// cISC4DBSegmentIStream
+
+	bool ReadGZSerializable(cIGZSerializable** ppSegmentOut) override { return false; }
+	bool ReadResKey(cGZPersistResourceKey& sKeyOut) override { return false; }
+
+	bool ReadVariant(cIGZVariant& sVariantOut) override
+	{
+		uint16_t type = 0;
+		uint32_t count = 0;
+
+		if (!GetUint16(type) || !GetUint32(count))
+		{
+			return false;
+		}
+
+		bool result = false;
+
+		switch (type)
+		{
+		case cIGZVariant::Type::Bool:
+		{
+			uint8_t value = 0;
+			result = GetUint8(value);
+			sVariantOut.SetValBool(value != 0);
+			break;
+		}
+		case cIGZVariant::Type::Uint8:
+		{
+			uint8_t value = 0;
+			result = GetUint8(value);
+			sVariantOut.SetValUint8(value);
+			break;
+		}
+		case cIGZVariant::Type::Uint32:
+		{
+			uint32_t value = 0;
+			result = GetUint32(value);
+			sVariantOut.SetValUint32(value);
+			break;
+		}
+		case cIGZVariant::Type::Sint32:
+		{
+			int32_t value = 0;
+			result = GetSint32(value);
+			sVariantOut.SetValSint32(value);
+			break;
+		}
+		case cIGZVariant::Type::Float32:
+		{
+			float value = 0.0f;
+			result = GetFloat32(value);
+			sVariantOut.SetValFloat32(value);
+			break;
+		}
+		case cIGZVariant::Type::Float64:
+		{
+			double value = 0.0;
+			result = GetFloat64(value);
+			sVariantOut.SetValFloat64(value);
+			break;
+		}
+		case cIGZVariant::Type::Uint32Array:
+		{
+			std::vector<uint32_t> values(count);
+			result = Read(values.data(), count * sizeof(uint32_t));
+			sVariantOut.RefUint32(values.data(), count);
+			break;
+		}
+		case cIGZVariant::Type::Float32Array:
+		{
+			std::vector<float> values(count);
+			result = Read(values.data(), count * sizeof(float));
+			sVariantOut.RefFloat32(values.data(), count);
+			break;
+		}
+		}
+
+		return result;
+	}
+
+private:
+
+	bool Write(const void* data, size_t size)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		buffer.insert(buffer.end(), bytes, bytes + size);
+
+		return true;
+	}
+
+	bool Read(void* data, size_t size)
+	{
+		if (buffer.size() - readPosition < size)
+		{
+			return false;
+		}
+
+		if (size > 0)
+		{
+			std::memcpy(data, buffer.data() + readPosition, size);
+			readPosition += size;
+		}
+
+		return true;
+	}
+
+	std::vector<uint8_t> buffer;
+	size_t readPosition;
+	uint32_t refCount;
+};
@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockUnknown.h"
+#include "cISC4Demand.h"
+#include "cISC4DemandSimulator.h"
+#include "SC4Percentage.h"
+#include <map>
+
+// A cISC4Demand that returns a configurable demand value.
+class MockDemand final : public MockUnknown<cISC4Demand>
+{
+public:
+
+	float QueryDemandValue() const override
+	{
+		return demandValue;
+	}
+
+	bool SetDemandValue(float value) override
+	{
+		demandValue = value;
+		return true;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool Init() override { return true; }
+	bool Shutdown() override { return true; }
+	bool SimulationBegin() override { return true; }
+	uint32_t GetId() const override { return 0; }
+	bool SetId(uint32_t id) override { return false; }
+	float QuerySupplyValue() const override { return 0; }
+	float QueryNewSupply() const override { return 0; }
+	float QueryNewDemand() const override { return 0; }
+	float QueryActiveDemandValue() const override { return 0; }
+	float QueryEconomyModifier() const override { return 0; }
+	float QueryActiveDemandMax() const override { return 0; }
+	float QueryActiveDemandMin() const override { return 0; }
+	void* AddToSupplyValue(float value) override { return nullptr; }
+	void* AddToDemandValue(float value) override { return nullptr; }
+	bool SetSupplyValue(float value) override { return false; }
+	bool SetActiveDemandMax(float value) override { return false; }
+	bool SetActiveDemandMin(float value) override { return false; }
+	float GetEconomyModifier() const override { return 0; }
+	bool SetEconomyModifier() override { return false; }
+	float GetTaxModifier() const override { return 0; }
+	bool SetTaxModifier(float value) override { return false; }
+	SC4Percentage GetDemandCap() const override { return SC4Percentage(); }
+	bool SetDemandCap(const SC4Percentage& demandCap) override { return false; }
+	uint32_t GetRegionUse() override { return 0; }
+	bool SetRegionUse(uint32_t param_1) override { return false; }
+	float EndOfCycle() override { return 0; }
+	void DebugLockValue(float value) override {}
+	void DebugUnlockValue() override {}
+	bool DebugIsValueLocked() override { return false; }
+
+private:
+
+	float demandValue = 0.0f;
+};
+
+// A cISC4DemandSimulator that creates a MockDemand for every type that is queried.
+class MockDemandSimulator final : public MockUnknown<cISC4DemandSimulator>
+{
+public:
+
+	cISC4Demand* GetDemand(uint32_t type) override
+	{
+		return &demands[type];
+	}
+
+	MockDemand& GetMockDemand(uint32_t type)
+	{
+		return demands[type];
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool Init() override { return true; }
+	bool Shutdown() override { return true; }
+	uint32_t GetSimulatorType() override { return 0; }
+	void UpdateOccupantEffects(SC4Percentage unknown1, SC4Percentage const& unknown2, SC4Percentage const& unknown3) override {}
+	void CalculateJobsPerUnitOfDemand(float* jobsArray, uint32_t exemplarInstanceLow, uint32_t exemplarInstanceHigh) override {}
+	uint32_t GetJobsBySensus(uint32_t type) override { return 0; }
+	float GetNeutralTaxRate() override { return 0; }
+	void GetLocalPopulationSummary(std::map<uint32_t, int32_t>& map) const override {}
+
+private:
+
+	std::map<uint32_t, MockDemand> demands;
+};
@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockUnknown.h"
+#include "cIGZFrameWork.h"
+#include "cIGZSystemService.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+// A cIGZFrameWork implementation that provides the mock game services, and
+// runs the tick services that the plugin registers.
+class MockFrameWork final : public MockUnknown<cIGZFrameWork>
+{
+public:
+
+	/**
+	 * @brief Registers a game service that the plugin can access through cRZSysServPtr.
+	 * @param srvid The service ID.
+	 * @param pService The service.
+	 */
+	void RegisterGameService(uint32_t srvid, cIGZUnknown* pService)
+	{
+		gameServices[srvid] = pService;
+	}
+
+	bool AddSystemService(cIGZSystemService* pService) override
+	{
+		return pService != nullptr;
+	}
+
+	bool RemoveSystemService(cIGZSystemService* pService) override
+	{
+		return RemoveFromTick(pService);
+	}
+
+	bool GetSystemService(uint32_t srvid, uint32_t riid, void** ppService) override
+	{
+		const auto it = gameServices.find(srvid);
+
+		if (it != gameServices.end() && it->second)
+		{
+			return it->second->QueryInterface(riid, ppService);
+		}
+
+		return false;
+	}
+
+	bool AddHook(cIGZFrameWorkHooks* pHooks) override
+	{
+		return true;
+	}
+
+	bool RemoveHook(cIGZFrameWorkHooks* pHooks) override
+	{
+		return true;
+	}
+
+	bool AddToTick(cIGZSystemService* pService) override
+	{
+		if (pService && std::find(tickServices.begin(), tickServices.end(), pService) == tickServices.end())
+		{
+			tickServices.push_back(pService);
+		}
+
+		return pService != nullptr;
+	}
+
+	bool RemoveFromTick(cIGZSystemService* pService) override
+	{
+		const auto it = std::find(tickServices.begin(), tickServices.end(), pService);
+
+		if (it != tickServices.end())
+		{
+			tickServices.erase(it);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool OnTick(uint32_t dwTimeElapsed) override
+	{
+		// The services may remove themselves from the tick list.
+		const std::vector<cIGZSystemService*> services(tickServices);
+
+		for (cIGZSystemService* pService : services)
+		{
+			pService->OnTick();
+		}
+
+		return true;
+	}
+
+	FrameworkState GetState(void) override
+	{
+		return kStatePostAppInit;
+	}
+
+	cIGZApp* const Application(void) override
+	{
+		return nullptr;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool EnumSystemServices(void* enumerator, cIGZUnknown* pUnknown, uint32_t dwUnknown) override { return false; }
+	bool AddToOnIdle(cIGZSystemService* pService) override { return false; }
+	bool RemoveFromOnIdle(cIGZSystemService* pService) override { return false; }
+	int32_t GetOnIdleInterval(void) override { return 0; }
+	bool SetOnIdleInterval(int32_t nInterval) override { return false; }
+	bool OnIdle(void) override { return false; }
+	bool IsTickEnabled(void) override { return false; }
+	cIGZFrameWork* ToggleTick(bool bTick) override { return nullptr; }
+	int32_t Quit(int32_t nQuitReason) override { return 0; }
+	void AbortiveQuit(int32_t nQuitReason) override {}
+	char* CommandLine(void) override { return nullptr; }
+	bool IsInstall(void) override { return false; }
+	cIGZCOM* GetCOMObject(void) override { return nullptr; }
+	void* GetDebugStream(void) override { return nullptr; }
+	int32_t DefaultDebugStream(void) override { return 0; }
+	int32_t DebugStream(void) override { return 0; }
+	bool SetDebugStream(void* pIGZDebugStream) override { return false; }
+	bool SetDebugLevel(int32_t nLevel) override { return false; }
+	int32_t GetDebugLevel(void) override { return 0; }
+	int32_t StdOut(void) override { return 0; }
+	int32_t StdErr(void) override { return 0; }
+	int32_t StdIn(void) override { return 0; }
+	void* GetStream(void) override { return nullptr; }
+	bool SetStream(int32_t nUnknown, cIGZUnknown* pUnknown) override { return false; }
+	bool SetApplication(cIGZApp* const pIGZApp) override { return false; }
+	void ReportException(char const* szExcText) override {}
+	cIGZExceptionNotification* ExceptionNotificationObj(void) override { return nullptr; }
+
+private:
+
+	std::unordered_map<uint32_t, cIGZUnknown*> gameServices;
+	std::vector<cIGZSystemService*> tickServices;
+};
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockCost.h"
+#include "MockUnknown.h"
+#include "cIGZMessageServer.h"
+#include "cIGZMessageServer2.h"
+
+// A message server with a configurable queue depth and per-message processing cost.
+// The queue is filled by MockSimulator when the game is paused, which simulates the
+// pause notifications that the other game systems receive.
+class MockMessageServer final : public MockUnknown<cIGZMessageServer>
+{
+public:
+
+	void SetMessageCost(int64_t nanoseconds)
+	{
+		messageCostNanoseconds = nanoseconds;
+	}
+
+	void Enqueue(uint32_t messageCount)
+	{
+		queueSize += messageCount;
+	}
+
+	uint64_t GetProcessedMessageCount() const
+	{
+		return processedMessageCount;
+	}
+
+	bool OnTick(int unknown1) override
+	{
+		if (queueSize > 0)
+		{
+			MockCost::Spin(messageCostNanoseconds);
+			queueSize--;
+			processedMessageCount++;
+		}
+
+		return true;
+	}
+
+	uint32_t GetMessageQueueSize(void) override
+	{
+		return queueSize;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool MessageSend(cGZMessage const& sMessage) override { return false; }
+	bool MessagePost(cGZMessage const& sMessage, bool bHighPriority) override { return false; }
+	bool AddNotification(cIGZMessageTarget* pTarget, uint32_t dwMessageID) override { return false; }
+	bool RemoveNotification(cIGZMessageTarget* pTarget, uint32_t dwMessageID) override { return false; }
+	bool GeneralMessagePostToTarget(cGZMessage const& sMessage, cIGZMessageTarget* pTarget) override { return false; }
+	bool CancelGeneralMessagePostsToTarget(cIGZMessageTarget* pTarget) override { return false; }
+	cIGZMessageServer* SetAlwaysClearQueueOnTick(bool bToggle) override { return nullptr; }
+
+private:
+
+	int64_t messageCostNanoseconds = 0;
+	uint32_t queueSize = 0;
+	uint64_t processedMessageCount = 0;
+};
+
+// The cIGZMessageServer2 counterpart of MockMessageServer.
+class MockMessageServer2 final : public MockUnknown<cIGZMessageServer2>
+{
+public:
+
+	void SetMessageCost(int64_t nanoseconds)
+	{
+		messageCostNanoseconds = nanoseconds;
+	}
+
+	void Enqueue(uint32_t messageCount)
+	{
+		queueSize += messageCount;
+	}
+
+	uint64_t GetProcessedMessageCount() const
+	{
+		return processedMessageCount;
+	}
+
+	bool OnTick(int unknown1) override
+	{
+		if (queueSize > 0)
+		{
+			MockCost::Spin(messageCostNanoseconds);
+			queueSize--;
+			processedMessageCount++;
+		}
+
+		return true;
+	}
+
+	uint32_t GetMessageQueueSize(void) override
+	{
+		return queueSize;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool MessageSend(cIGZMessage2* pMessage) override { return false; }
+	bool MessagePost(cIGZMessage2* pMessage, bool bHighPriority) override { return false; }
+	bool AddNotification(cIGZMessageTarget2* pTarget, uint32_t dwMessageID) override { return false; }
+	bool RemoveNotification(cIGZMessageTarget2* pTarget, uint32_t dwMessageID) override { return false; }
+	bool GeneralMessagePostToTarget(cIGZMessage2* pMessage, cIGZMessageTarget2* pTarget) override { return false; }
+	bool CancelGeneralMessagePostsToTarget(cIGZMessageTarget2* pTarget) override { return false; }
+	cIGZMessageServer2* SetAlwaysClearQueueOnTick(bool bToggle) override { return nullptr; }
+	uint32_t GetRefCount(void) override { return 0; }
+	cIGZMessage2* CreateMessage(uint32_t clsid, uint32_t msgid, void** ppData) override { return nullptr; }
+
+private:
+
+	int64_t messageCostNanoseconds = 0;
+	uint32_t queueSize = 0;
+	uint64_t processedMessageCount = 0;
+};
@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockUnknown.h"
+#include "OrdinancePropertyHolder.h"
+#include "SC4Rect.h"
+#include "cISC4Occupant.h"
+
+// A cISC4Occupant that provides a property holder, a type and a location, the traffic
+// simulator uses it to identify the transit switch lots.
+class MockOccupant final : public MockUnknown<cISC4Occupant>
+{
+public:
+
+	explicit MockOccupant(int32_t type = 0)
+		: type(type), hasCells(false), cells{}
+	{
+	}
+
+	void SetBoundingCityCells(long topLeftX, long topLeftZ, long bottomRightX, long bottomRightZ)
+	{
+		cells.topLeftX = topLeftX;
+		cells.topLeftY = topLeftZ;
+		cells.bottomRightX = bottomRightX;
+		cells.bottomRightY = bottomRightZ;
+		hasCells = true;
+	}
+
+	cISCPropertyHolder* AsPropertyHolder(void) override
+	{
+		return &propertyHolder;
+	}
+
+	int32_t GetType(void) override
+	{
+		return type;
+	}
+
+	bool GetBoundingCityCells(SC4Rect<long>& sRect) override
+	{
+		if (hasCells)
+		{
+			sRect = cells;
+		}
+
+		return hasCells;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool Init(void) override { return true; }
+	bool Shutdown(void) override { return true; }
+	bool IsInitialized(void) override { return true; }
+	bool GetPosition(cS3DVector3* pVector) override { return false; }
+	bool SetPosition(cS3DVector3 const* pVector) override { return false; }
+	cS3DVector3* GetBoundingBox(cS3DVector3* pTopLeftVec, cS3DVector3* pBottomRightVec) override { return nullptr; }
+	uint32_t SetRemovalFlags(uint32_t dwFlags) override { return 0; }
+	uint32_t UnsetRemovalFlags(uint32_t dwFlags) override { return 0; }
+	bool CanRemove(uint32_t dwFlags) override { return false; }
+	bool PostOccupantMessage(uint32_t dwMessageID, uint32_t dwData) override { return false; }
+	uint32_t GetHighlight(void) override { return 0; }
+	bool SetHighlight(uint32_t dwHighlight, bool bSendMessageNow) override { return false; }
+	uint8_t SetVisibility(bool bVisible, bool bSendMessage) override { return 0; }
+	cISC43DPlaceableObject* GetPlaceableObject(void) override { return nullptr; }
+	cISC43DPlaceableObject* GetOrCreatePlaceableObject(void) override { return nullptr; }
+	cISC43DPlaceableObject* SetPlaceableObject(cISC43DPlaceableObject* pObject) override { return nullptr; }
+	bool IsOccupantGroup(uint32_t dwGroup) override { return false; }
+	bool AddOccupantGroup(uint32_t dwGroup) override { return false; }
+	bool GetOccupantGroups(std::set<uint32_t>& sGroups) override { return false; }
+	bool GetOccupantManagerBBox(uint8_t* cBoxArray) override { return false; }
+	bool SetOccupantManagerBBox(uint8_t* cBoxArray) override { return false; }
+	bool GetLotTag(uint32_t& dwLotTag) override { return false; }
+	bool SetLotTag(uint32_t dwLotTag) override { return false; }
+	uint32_t SetFlag(uint32_t dwFlags) override { return 0; }
+	cISC4Occupant* SetAllFlags(uint32_t dwFlags) override { return nullptr; }
+	uint32_t ClearFlag(uint32_t dwFlags) override { return 0; }
+	bool IsFlagSet(uint32_t dwFlags) override { return false; }
+	uint32_t GetFlags(void) override { return 0; }
+
+private:
+
+	OrdinancePropertyHolder propertyHolder;
+	int32_t type;
+	bool hasCells;
+	SC4Rect<long> cells;
+};
@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockUnknown.h"
+#include "cGZPersistResourceKey.h"
+#include "cIGZPersistResourceManager.h"
+#include "cISCPropertyHolder.h"
+
+// A cIGZPersistResourceManager implementation that serves a single exemplar.
+// The exemplar is returned from GetResource, which models the game's resource
+// cache: every caller receives the same in-memory copy.
+class MockPersistResourceManager final : public MockUnknown<cIGZPersistResourceManager>
+{
+public:
+
+	/**
+	 * @brief Sets the exemplar that is returned for the specified resource key.
+	 * @param key The resource key.
+	 * @param pExemplar The exemplar properties.
+	 */
+	void SetExemplar(const cGZPersistResourceKey& key, cISCPropertyHolder* pExemplar)
+	{
+		exemplarKey = key;
+		this->pExemplar = pExemplar;
+	}
+
+	uint32_t GetResourceLookupCount() const
+	{
+		return resourceLookupCount;
+	}
+
+	uint32_t GetPrivateResourceLookupCount() const
+	{
+		return privateResourceLookupCount;
+	}
+
+	bool GetResource(cGZPersistResourceKey const& resKey, uint32_t riid, void** ppvObj, uint32_t unknown1, cIGZUnknown* unknown2) override
+	{
+		resourceLookupCount++;
+
+		if (pExemplar
+			&& resKey.type == exemplarKey.type
+			&& resKey.group == exemplarKey.group
+			&& resKey.instance == exemplarKey.instance)
+		{
+			return pExemplar->QueryInterface(riid, ppvObj);
+		}
+
+		return false;
+	}
+
+	bool GetPrivateResource(cGZPersistResourceKey const& resKey, uint32_t riid, void** ppvObj, uint32_t unknown1, cIGZUnknown* unknown2) override
+	{
+		// The mock runtime does not provide any LTEXT resources.
+		privateResourceLookupCount++;
+		return false;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool GetNewResource(cGZPersistResourceKey const& resKey, uint32_t riid, void** ppvObj, uint32_t unknown1, cIGZUnknown* unknown2) override { return false; }
+	bool GetNewResource(uint32_t unknown1, uint32_t unknown2, void** unknown3, uint32_t unknown4, cIGZUnknown* unknown5) override { return false; }
+	bool RegisterResource(cGZPersistResourceKey const& key, cIGZPersistResource& resource) override { return false; }
+	bool RegisterResource(cIGZPersistResource* resource) override { return false; }
+	bool UnregisterResource(cGZPersistResourceKey const& key) override { return false; }
+	bool HasRegisteredResource(cGZPersistResourceKey const& key) override { return false; }
+	bool Save(cGZPersistResourceKey const& key, cIGZPersistDBSegment* dbSegment) override { return false; }
+	bool Save(cIGZPersistResourceKeyList* list, cIGZPersistDBSegment* dbSegment) override { return false; }
+	bool SaveResource(cIGZPersistResource* resource, cGZPersistResourceKey const& key, cIGZPersistDBSegment* dbSegment) override { return false; }
+	bool TestForKey(cGZPersistResourceKey const& key) override { return false; }
+	uint32_t GetResourceList(cIGZPersistResourceKeyList** ppResourceList, cIGZPersistResourceKeyFilter* filter) override { return 0; }
+	uint32_t GetResourceListForType(cIGZPersistResourceKeyList** ppResourceList, uint32_t unknown1) override { return 0; }
+	uint32_t GetAvailableResourceList(cIGZPersistResourceKeyList** ppResourceList, cIGZPersistResourceKeyFilter* filter) override { return 0; }
+	uint32_t GetAvailableResourceListForType(cIGZPersistResourceKeyList** ppResourceList, uint32_t unknown1) override { return 0; }
+	bool RegisterObjectFactory(uint32_t unknown1, uint32_t unknown2, cIGZPersistResourceFactory* factory) override { return false; }
+	bool UnregisterObjectFactory(cIGZPersistResourceFactory* factory) override { return false; }
+	bool FindObjectFactory(cIGZPersistResource* unknown1, cIGZPersistResourceFactory** unknown2) override { return false; }
+	bool FindObjectFactory(cIGZPersistResourceFactory** unknown2) override { return false; }
+	bool FindObjectFactory(uint32_t unknown1, cIGZPersistResourceFactory** ppFactory) override { return false; }
+	uint32_t GetFactoryCount() override { return 0; }
+	cIGZPersistResourceFactory* GetFactoryByIndex(uint32_t index) override { return nullptr; }
+	bool RegisterDBSegment(cIGZPersistDBSegment& segment) override { return false; }
+	bool RegisterDBSegmentFront(cIGZPersistDBSegment& segment) override { return false; }
+	bool RegisterDBSegmentBack(cIGZPersistDBSegment& segment) override { return false; }
+	bool UnregisterDBSegment(cIGZPersistDBSegment& segment) override { return false; }
+	bool TestDBSegment(cIGZPersistDBSegment& segment) override { return false; }
+	bool FindDBSegment(cGZPersistResourceKey const& key, cIGZPersistDBSegment** ppSegment) override { return false; }
+	bool FindDBSegment(uint32_t unknown1, cIGZPersistDBSegment** ppSegment) override { return false; }
+	uint32_t GetSegmentCount() override { return 0; }
+	cIGZPersistDBSegment* GetSegmentByIndex(uint32_t unknown1) override { return nullptr; }
+	uint32_t EnumerateDBSegments(cIGZPersistDBSegment** unknown1, uint32_t* unknown2) override { return 0; }
+	bool EnumerateDBSegments(EnumerateDBSegmentsCallback* pCallback, cIGZPersistDBSegment* unknown2) override { return false; }
+	bool OpenDBRecord(cGZPersistResourceKey const& key, cIGZPersistDBRecord** unknown2, bool unknown3) override { return false; }
+	bool CloseDBRecord(cGZPersistResourceKey const& key, cIGZPersistDBRecord** unknown2) override { return false; }
+	bool AddCacheStrategy(cIGZPersistCacheStrategy* cacheStrategy) override { return false; }
+	bool RemoveCacheStrategy(cIGZPersistCacheStrategy* cacheStrategy) override { return false; }
+	bool IsGarbageCollectionActive() override { return false; }
+	void SetGarbageCollectionActive(bool value) override {}
+	void ForceGarbageCollection() override {}
+
+private:
+
+	cGZPersistResourceKey exemplarKey;
+	cISCPropertyHolder* pExemplar = nullptr;
+	uint32_t resourceLookupCount = 0;
+	uint32_t privateResourceLookupCount = 0;
+};
@@ -0,0 +1,212 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "MockRuntime.h"
+#include "MockCost.h"
+#include "Platform.h"
+#include "TrafficSimulatorTuning.h"
+#include "cRZBaseVariant.h"
+#include "cRZCOMDllDirector.h"
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+	constexpr uint32_t kSC4AppServiceID = 102;
+	constexpr uint32_t kSimulatorServiceID = 1184196185;
+	constexpr uint32_t kMessageServerServiceID = 1678128007;
+	constexpr uint32_t kMessageServer2ServiceID = 83526747;
+	constexpr uint32_t kPersistResourceManagerServiceID = 90935406;
+	constexpr uint32_t kAllocatorServiceID = 988069539;
+
+	// The DLL director that provides RZGetFrameWork for the benchmark executables.
+	class MockDllDirector final : public cRZCOMDllDirector
+	{
+	public:
+
+		uint32_t GetDirectorID() const override
+		{
+			return 0x5a1ed0c4;
+		}
+
+		void SetFrameWork(cIGZFrameWork* pFrameWork)
+		{
+			mpFrameWork = pFrameWork;
+		}
+	};
+
+	MockDllDirector& GetMockDllDirector()
+	{
+		static MockDllDirector sDirector;
+		return sDirector;
+	}
+}
+
+cRZCOMDllDirector* RZGetCOMDllDirector()
+{
+	return &GetMockDllDirector();
+}
+
+void MockCost::Spin(int64_t nanoseconds)
+{
+	if (nanoseconds <= 0)
+	{
+		return;
+	}
+
+	const int64_t start = Platform::GetTimestamp();
+	const int64_t duration = static_cast<int64_t>(
+		static_cast<double>(nanoseconds) * static_cast<double>(Platform::GetTimestampFrequency()) / 1e9);
+
+	while ((Platform::GetTimestamp() - start) < duration)
+	{
+	}
+}
+
+MockRuntime::MockRuntime(const MockRuntimeOptions& options)
+	: options(options)
+{
+	// The game's traffic simulator tuning exemplar allows every travel type to reach its destination,
+	// the precompiled override restricts cars.
+	bool canReachDestination[TrafficSimulatorTuning::kTravelTypeCount];
+	std::fill(std::begin(canReachDestination), std::end(canReachDestination), true);
+
+	if (options.precompiledTuningOverride)
+	{
+		canReachDestination[TrafficSimulatorTuning::kCarTravelTypeIndex] = false;
+		trafficTuningExemplar.AddProperty(
+			TrafficSimulatorTuning::kParknRideOverrideVersion,
+			TrafficSimulatorTuning::kOverrideVersion,
+			false);
+	}
+
+	cRZBaseVariant canReachDestinationVariant;
+	canReachDestinationVariant.RefBool(canReachDestination, TrafficSimulatorTuning::kTravelTypeCount);
+	trafficTuningExemplar.AddProperty(TrafficSimulatorTuning::kTravelTypeCanReachDestination, &canReachDestinationVariant, false);
+
+	resourceManager.SetExemplar(
+		cGZPersistResourceKey(TrafficSimulatorTuning::kType, TrafficSimulatorTuning::kGroup, TrafficSimulatorTuning::kInstance),
+		&trafficTuningExemplar);
+
+	messageServer.SetMessageCost(options.messageCostNanoseconds);
+	messageServer2.SetMessageCost(options.messageCostNanoseconds);
+	simulator.SetPauseMessageQueueDepth(&messageServer, &messageServer2, options.messageQueueDepth);
+	const int32_t trafficMapTractCount = static_cast<int32_t>(options.cityCellCount >> options.trafficMapTractShift);
+	trafficSimulator.CreateMaps(trafficMapTractCount, trafficMapTractCount, options.trafficMapTractShift);
+	trafficSimulator.SetCosts(
+		options.trafficSimulatorShutdownCostNanoseconds,
+		options.trafficSimulatorInitCostNanoseconds,
+		options.trafficSimulatorMessageCostNanoseconds);
+
+	frameWork.RegisterGameService(kSC4AppServiceID, &app);
+	frameWork.RegisterGameService(kSimulatorServiceID, &simulator);
+	frameWork.RegisterGameService(kMessageServerServiceID, &messageServer);
+	frameWork.RegisterGameService(kMessageServer2ServiceID, &messageServer2);
+	frameWork.RegisterGameService(kPersistResourceManagerServiceID, &resourceManager);
+	frameWork.RegisterGameService(kAllocatorServiceID, &allocatorService);
+
+	GetMockDllDirector().SetFrameWork(&frameWork);
+}
+
+MockRuntime::~MockRuntime()
+{
+	GetMockDllDirector().SetFrameWork(nullptr);
+}
+
+cISC4City* MockRuntime::LoadCity()
+{
+	city = std::make_unique<MockSC4City>(
+		&simulator,
+		&residentialSimulator,
+		&trafficSimulator,
+		&demandSimulator,
+		&clock,
+		options.cityCellCount);
+	app.SetCity(city.get());
+
+	return city.get();
+}
+
+void MockRuntime::UnloadCity()
+{
+	app.SetCity(nullptr);
+	city.reset();
+}
+
+cISC4City* MockRuntime::GetCity() const
+{
+	return city.get();
+}
+
+void MockRuntime::Tick()
+{
+	frameWork.OnTick(0);
+}
+
+void MockRuntime::AdvanceSimDate(int32_t days)
+{
+	for (int32_t i = 0; i < days; i++)
+	{
+		simulator.SetSimDateNumber(simulator.GetSimDateNumber() + 1);
+		trafficSimulator.SimulateDay();
+	}
+}
+
+MockTrafficSimulator& MockRuntime::GetTrafficSimulator()
+{
+	return trafficSimulator;
+}
+
+MockDemandSimulator& MockRuntime::GetDemandSimulator()
+{
+	return demandSimulator;
+}
+
+Mock24HourClock& MockRuntime::Get24HourClock()
+{
+	return clock;
+}
+
+MockResidentialSimulator& MockRuntime::GetResidentialSimulator()
+{
+	return residentialSimulator;
+}
+
+cISCPropertyHolder* MockRuntime::GetTrafficTuningExemplar()
+{
+	return &trafficTuningExemplar;
+}
+
+uint32_t MockRuntime::GetTrafficSimulatorRestartCount() const
+{
+	return trafficSimulator.GetRestartCount();
+}
+
+uint32_t MockRuntime::GetTrafficSimulatorMessageCount() const
+{
+	return trafficSimulator.GetMessageCount();
+}
+
+uint32_t MockRuntime::GetHiddenPauseCount() const
+{
+	return simulator.GetHiddenPauseCount();
+}
+
+uint32_t MockRuntime::GetResourceLookupCount() const
+{
+	return resourceManager.GetResourceLookupCount();
+}
+
+uint64_t MockRuntime::GetProcessedMessageCount() const
+{
+	return messageServer.GetProcessedMessageCount() + messageServer2.GetProcessedMessageCount();
+}
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Mock24HourClock.h"
+#include "MockAllocatorService.h"
+#include "MockDemand.h"
+#include "MockFrameWork.h"
+#include "MockMessageServers.h"
+#include "MockPersistResourceManager.h"
+#include "MockSC4App.h"
+#include "MockSimulators.h"
+#include "OrdinancePropertyHolder.h"
+#include <memory>
+
+struct MockRuntimeOptions
+{
+	// The number of messages that a hidden pause queues in each message server.
+	uint32_t messageQueueDepth = 50;
+	// The time that the message servers spend processing one message.
+	int64_t messageCostNanoseconds = 2000;
+	// The time that the traffic simulator spends in Shutdown.
+	int64_t trafficSimulatorShutdownCostNanoseconds = 200000;
+	// The time that the traffic simulator spends in Init.
+	int64_t trafficSimulatorInitCostNanoseconds = 2000000;
+	// The time that the traffic simulator spends processing a message.
+	int64_t trafficSimulatorMessageCostNanoseconds = 100000;
+	// The width and height of the city, in cells.
+	uint32_t cityCellCount = 256;
+	// The number of bits that a cell coordinate is shifted by to get the traffic map tract coordinate.
+	int32_t trafficMapTractShift = 1;
+	// The game loads the precompiled tuning override that the BuildTuningOverride tool writes.
+	bool precompiledTuningOverride = false;
+};
+
+// An in-process stand-in for the parts of the SC4 runtime that the plugin uses.
+//
+// The runtime installs a mock framework that provides the simulator, message server,
+// resource manager and application services through the usual cRZSysServPtr lookups.
+// The costs of the game calls are simulated with busy-waits, which allows the
+// plugin code paths to be benchmarked without SimCity 4.
+class MockRuntime
+{
+public:
+
+	explicit MockRuntime(const MockRuntimeOptions& options);
+	~MockRuntime();
+
+	MockRuntime(const MockRuntime&) = delete;
+	MockRuntime& operator=(const MockRuntime&) = delete;
+
+	/**
+	 * @brief Creates a new city and makes it the active city.
+	 * @return The city.
+	 */
+	cISC4City* LoadCity();
+
+	/**
+	 * @brief Removes the active city.
+	 */
+	void UnloadCity();
+
+	cISC4City* GetCity() const;
+
+	/**
+	 * @brief Runs one frame of the framework tick services.
+	 */
+	void Tick();
+
+	/**
+	 * @brief Advances the simulation date by the specified number of days.
+	 * The traffic simulator maps are updated once per day.
+	 */
+	void AdvanceSimDate(int32_t days);
+
+	MockTrafficSimulator& GetTrafficSimulator();
+	MockDemandSimulator& GetDemandSimulator();
+	Mock24HourClock& Get24HourClock();
+	MockResidentialSimulator& GetResidentialSimulator();
+
+	/**
+	 * @brief Gets the cached traffic simulator tuning exemplar that the plugin edits.
+	 * @return The exemplar properties.
+	 */
+	cISCPropertyHolder* GetTrafficTuningExemplar();
+
+	uint32_t GetTrafficSimulatorRestartCount() const;
+	uint32_t GetTrafficSimulatorMessageCount() const;
+	uint32_t GetHiddenPauseCount() const;
+	uint32_t GetResourceLookupCount() const;
+	uint64_t GetProcessedMessageCount() const;
+
+private:
+
+	MockRuntimeOptions options;
+	OrdinancePropertyHolder trafficTuningExemplar;
+	MockFrameWork frameWork;
+	MockAllocatorService allocatorService;
+	MockMessageServer messageServer;
+	MockMessageServer2 messageServer2;
+	MockPersistResourceManager resourceManager;
+	MockSC4App app;
+	MockSimulator simulator;
+	MockResidentialSimulator residentialSimulator;
+	MockTrafficSimulator trafficSimulator;
+	MockDemandSimulator demandSimulator;
+	Mock24HourClock clock;
+	std::unique_ptr<MockSC4City> city;
+};
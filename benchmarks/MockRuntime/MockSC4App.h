@@ -0,0 +1,271 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockUnknown.h"
+#include "cISC4App.h"
+#include "cISC4City.h"
+
+class MockSC4City final : public MockUnknown<cISC4City>
+{
+public:
+
+	MockSC4City(
+		cISC4Simulator* pSimulator,
+		cISC4ResidentialSimulator* pResidentialSimulator,
+		cISC4TrafficSimulator* pTrafficSimulator,
+		cISC4DemandSimulator* pDemandSimulator,
+		cISC424HourClock* pClock,
+		uint32_t cellCount)
+		: pSimulator(pSimulator),
+		  pResidentialSimulator(pResidentialSimulator),
+		  pTrafficSimulator(pTrafficSimulator),
+		  pDemandSimulator(pDemandSimulator),
+		  pClock(pClock),
+		  cellCount(cellCount)
+	{
+	}
+
+	cISC4Simulator* GetSimulator(void) override
+	{
+		return pSimulator;
+	}
+
+	cISC4ResidentialSimulator* GetResidentialSimulator(void) override
+	{
+		return pResidentialSimulator;
+	}
+
+	cISC4TrafficSimulator* GetTrafficSimulator(void) override
+	{
+		return pTrafficSimulator;
+	}
+
+	cISC4DemandSimulator* GetDemandSimulator(void) override
+	{
+		return pDemandSimulator;
+	}
+
+	cISC424HourClock* Get24HourClock(void) override
+	{
+		return pClock;
+	}
+
+	uint32_t CellCountX(void) override
+	{
+		return cellCount;
+	}
+
+	uint32_t CellCountZ(void) override
+	{
+		return cellCount;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool Init(void) override { return false; }
+	bool Shutdown(void) override { return false; }
+	uint32_t GetCitySerialNumber(void) override { return 0; }
+	cISC4City* SetCitySerialNumber(uint32_t dwSerial) override { return nullptr; }
+	uint32_t GetNewOccupantSerialNumber(void) override { return 0; }
+	bool GetOriginalLanguageAndCountry(uint32_t& dwLanguage, uint32_t& dwCountry) override { return false; }
+	bool GetLastLanguageAndCountry(uint32_t& dwLanguage, uint32_t& dwCountry) override { return false; }
+	bool GetCitySaveFilePath(cIGZString& szPath) override { return false; }
+	bool SetCitySaveFilePath(cIGZString const& szPath) override { return false; }
+	bool GetCityName(cIGZString& szPath) override { return false; }
+	bool SetCityName(cIGZString const& szPath) override { return false; }
+	bool GetCityNameChanged(void) override { return false; }
+	cISC4City* SetCityNameChanged(bool bToggle) override { return nullptr; }
+	bool GetMayorName(cIGZString& szName) override { return false; }
+	bool SetMayorName(cIGZString const& szName) override { return false; }
+	bool GetCityDescription(cIGZString& szDescription) override { return false; }
+	bool SetCityDescription(cIGZString const& szDescription) override { return false; }
+	uint32_t GetBirthDate(void) override { return 0; }
+	cISC4City* SetBirthDate(uint32_t dwDate) override { return nullptr; }
+	bool GetEstablished(void) override { return false; }
+	bool SetEstablished(bool bEstablished) override { return false; }
+	int32_t GetDifficultyLevel(void) override { return 0; }
+	cISC4City* SetDifficultyLevel(int32_t dwLevel) override { return nullptr; }
+	intptr_t GetWorldPosition(float& fX, float& fZ) override { return 0; }
+	cISC4City* SetWorldPosition(float fX, float fZ) override { return nullptr; }
+	float GetWorldBaseElevation(void) override { return 0; }
+	cISC4City* SetWorldBaseElevation(float fElevation) override { return nullptr; }
+	int32_t GetWorldHemisphere(void) override { return 0; }
+	intptr_t GetDemolitionUtility(void) override { return 0; }
+	cISC4HistoryWarehouse* GetHistoryWarehouse(void) override { return nullptr; }
+	cISC4LotManager* GetLotManager(void) override { return nullptr; }
+	cISC4OccupantManager* GetOccupantManager(void) override { return nullptr; }
+	intptr_t GetPropManager(void) override { return 0; }
+	intptr_t GetZoneManager(void) override { return 0; }
+	cISC4LotConfigurationManager* GetLotConfigurationManager(void) override { return nullptr; }
+	cISC4NetworkManager* GetNetworkManager(void) override { return nullptr; }
+	intptr_t GetDispatchManager(void) override { return 0; }
+	intptr_t GetTrafficNetwork(void) override { return 0; }
+	intptr_t GetPropDeveloper(void) override { return 0; }
+	intptr_t GetNetworkLotManager(void) override { return 0; }
+	intptr_t GetVehicleManager(void) override { return 0; }
+	intptr_t GetPedestrianManager(void) override { return 0; }
+	intptr_t GetAircraftManager(void) override { return 0; }
+	intptr_t GetWatercraftManager(void) override { return 0; }
+	intptr_t GetAutomataControllerManager(void) override { return 0; }
+	intptr_t GetAutomataScriptSystem(void) override { return 0; }
+	intptr_t GetCitySituationManager(void) override { return 0; }
+	intptr_t GetAuraSimulator(void) override { return 0; }
+	cISC4BudgetSimulator* GetBudgetSimulator(void) override { return nullptr; }
+	cISC4BuildingDevelopmentSimulator* GetBuildingDevelopmentSimulator(void) override { return nullptr; }
+	intptr_t GetCommercialSimulator(void) override { return 0; }
+	intptr_t GetCrimeSimulator(void) override { return 0; }
+	intptr_t GetFireProtectionSimulator(void) override { return 0; }
+	intptr_t GetFlammabilitySimulator(void) override { return 0; }
+	intptr_t GetFloraSimulator(void) override { return 0; }
+	intptr_t GetIndustrialSimulator(void) override { return 0; }
+	intptr_t GetLandValueSimulator(void) override { return 0; }
+	intptr_t GetNeighborsSimulator(void) override { return 0; }
+	cISC4OrdinanceSimulator* GetOrdinanceSimulator(void) override { return nullptr; }
+	intptr_t GetPlumbingSimulator(void) override { return 0; }
+	cISC4PoliceSimulator* GetPoliceSimulator(void) override { return nullptr; }
+	cISC4PollutionSimulator* GetPollutionSimulator(void) override { return nullptr; }
+	intptr_t GetPowerSimulator(void) override { return 0; }
+	intptr_t GetWeatherSimulator(void) override { return 0; }
+	intptr_t GetMySimAgentSimulator(void) override { return 0; }
+	cISC4DisasterLayer* GetDisasterLayer(void) override { return nullptr; }
+	intptr_t GetCivicBuildingSimulator(void) override { return 0; }
+	intptr_t GetParkManager(void) override { return 0; }
+	cISC4LotManager* GetZoneDeveloper(void) override { return nullptr; }
+	intptr_t GetSeaportDeveloper(void) override { return 0; }
+	intptr_t GetAirportDeveloper(void) override { return 0; }
+	intptr_t GetLandfillDeveloper(void) override { return 0; }
+	cISC4LotDeveloper* GetLotDeveloper(void) override { return nullptr; }
+	cISC4TractDeveloper* GetTractDeveloper(void) override { return nullptr; }
+	cISC4AdvisorSystem* GetAdvisorSystem(void) override { return nullptr; }
+	cISC4TutorialSystem* GetTutorialSystem(void) override { return nullptr; }
+	intptr_t GetSurfaceWater(void) override { return 0; }
+	intptr_t GetTerrain(void) override { return 0; }
+	intptr_t GetEffectsManager(void) override { return 0; }
+	uint32_t GetCitySizeType(void) override { return 0; }
+	bool SetSize(float fX, float fZ) override { return false; }
+	float SizeX(void) override { return 0; }
+	float SizeZ(void) override { return 0; }
+	float CellWidthX(void) override { return 0; }
+	float CellWidthZ(void) override { return 0; }
+	int32_t PositionToCell(float fX, float fZ, int& cX, int& cZ) override { return 0; }
+	int32_t CellCornerToPosition(int cX, int cZ, float& fX, float& fZ) override { return 0; }
+	int32_t CellCenterToPosition(int cX, int cZ, float& fX, float& fZ) override { return 0; }
+	bool LocationIsInBounds(float fX, float fZ) override { return false; }
+	bool CellIsInBounds(int cX, int cZ) override { return false; }
+	bool CellCornerIsInBounds(int cX, int cZ) override { return false; }
+	void ToggleSimulationMode(void) override {}
+	bool IsInCityTimeSimulationMode(void) override { return false; }
+	int32_t EnableSave(void) override { return 0; }
+	int32_t DisableSave(void) override { return 0; }
+	bool IsSaveDisabled(void) override { return false; }
+	cISC4City* UIIncreaseLockCount(void) override { return nullptr; }
+	int32_t UIDecreaseLockCount(void) override { return 0; }
+	int32_t UIGetLockCount(void) override { return 0; }
+	bool SaveObliterated(cIGZPersistDBSegment* pSegment) override { return false; }
+
+private:
+
+	cISC4Simulator* pSimulator;
+	cISC4ResidentialSimulator* pResidentialSimulator;
+	cISC4TrafficSimulator* pTrafficSimulator;
+	cISC4DemandSimulator* pDemandSimulator;
+	cISC424HourClock* pClock;
+	uint32_t cellCount;
+};
+
+class MockSC4App final : public MockUnknown<cISC4App>
+{
+public:
+
+	void SetCity(cISC4City* pCity)
+	{
+		this->pCity = pCity;
+	}
+
+	cISC4City* GetCity(void) override
+	{
+		return pCity;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool OnIdle(void) override { return false; }
+	bool RunMessageServerPump(uint32_t dwMinMessages, uint32_t dwMaxMessages, uint32_t dwMaxTime) override { return false; }
+	bool RunMessageServer2Pump(uint32_t dwMinMessages, uint32_t dwMaxMessages, uint32_t dwMaxTime) override { return false; }
+	bool RequestNewCity(intptr_t pCity) override { return false; }
+	bool RequestLoadCity(void) override { return false; }
+	bool RequestCloseCity(bool bShowConfirmPrompt) override { return false; }
+	bool RequestSaveCity(bool bShowNotif, bool bFastSave) override { return false; }
+	bool RequestQuit(bool bShowDialog, bool bSaveFirst) override { return false; }
+	bool RequestQuitFromRegion(bool bShowDialog) override { return false; }
+	bool RequestGoToRegionView(bool bShowDialog) override { return false; }
+	bool LoadCity(cIGZString& szString, intptr_t pCityOut) override { return false; }
+	bool CloseCity(void) override { return false; }
+	bool SaveCity(bool bFastSave) override { return false; }
+	bool SaveCity(cIGZString const& szName, bool bFastSave) override { return false; }
+	bool SavePreferences(void) override { return false; }
+	bool EnableFullGamePauseOnAppFocusLoss(bool bEnable) override { return false; }
+	bool ApplyVideoPreferences(intptr_t const sPreferences) override { return false; }
+	bool GetAutoVideoPreferences(intptr_t pPreferencesOut) override { return false; }
+	bool GetDebugFunctionalityEnabled(void) override { return false; }
+	cISC4App* SetDebugFunctionalityEnabled(bool bEnabled) override { return nullptr; }
+	bool GetPopupDialogsEnabled(void) override { return false; }
+	cISC4App* SetPopupDialogsEnabled(bool bEnabled) override { return nullptr; }
+	int32_t GetAppState(void) override { return 0; }
+	cIGZWin* GetMainWindow(void) override { return nullptr; }
+	bool GetAppName(cIGZString& szNameOut) override { return false; }
+	bool GetAppIniFileName(cIGZString& szPathOut) override { return false; }
+	bool GetAppIniFilePath(cIGZString& szPathOut) override { return false; }
+	bool GetAppPreferencesFileName(cIGZString& szPathOut) override { return false; }
+	bool GetAppPreferencesFilePath(cIGZString& szPathOut) override { return false; }
+	cISC4FeatureManager* GetFeatureManager(void) override { return nullptr; }
+	cIGZCheatCodeManager* GetCheatCodeManager(void) override { return nullptr; }
+	cISC4Nation* GetNation(void) override { return nullptr; }
+	cISC4Region* GetRegion(void) override { return nullptr; }
+	cISC4RegionalCity* GetRegionalCity(void) override { return nullptr; }
+	intptr_t GetPreferences(void) override { return 0; }
+	intptr_t GetNewCitySpecification(void) override { return 0; }
+	intptr_t GetDebugConsole(void) override { return 0; }
+	intptr_t GetGimexFactory(void) override { return 0; }
+	intptr_t GetStringDetokenizer(void) override { return 0; }
+	intptr_t GetWinLocationSaver(void) override { return 0; }
+	cISC4RenderProperties* GetRenderProperties(void) override { return nullptr; }
+	intptr_t GetGlyphTextureManager(void) override { return 0; }
+	intptr_t GetLuaInterpreter(void) override { return 0; }
+	intptr_t GetTutorialRegistry(void) override { return 0; }
+	bool IsRunFirstTimeAfterInstall(void) override { return false; }
+	bool GetAppDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetCDAppDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetDataDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetCDDataDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetPluginDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetCDPluginDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetSkuSpecificDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetUserDataDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetUserPluginDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetRegionsDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetMySimDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetAlbumDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetHTTPCacheDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetTempDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetExceptionReportsDirectory(cIGZString& szPathOut) override { return false; }
+	bool GetTestScriptDirectory(cIGZString& szPathOut) override { return false; }
+	bool AddDynamicLibraryByName(cIGZString const& sName, cIGZString* pBasePath, bool bIgnoreINI) override { return false; }
+	bool AddDynamicLibraryByPath(cIGZString const& sPath, bool bIgnoreINI) override { return false; }
+	bool RegisterShutdownCallbackFunction(ShutdownCallback pfCallback, void* pUnknown) override { return false; }
+	bool UnregisterShutdownCallbackFunction(ShutdownCallback pfCallback, void* pUnknown) override { return false; }
+
+private:
+
+	cISC4City* pCity = nullptr;
+};
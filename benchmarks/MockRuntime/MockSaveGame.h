@@ -0,0 +1,192 @@
+#pragma once
+#include "DBPFFile.h"
+#include "MockDBSegmentStream.h"
+#include "OrdinanceBase.h"
+#include "QFSCompression.h"
+#include "cIGZSerializable.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+// Builds synthetic SimCity 4 save games for the benchmarks of the offline tools.
+namespace MockSaveGame
+{
+	struct Entry
+	{
+		DBPFFile::ResourceKey key;
+		std::vector<uint8_t> data;
+		// The entry is QFS compressed when the file is built.
+		bool compressed;
+	};
+
+	inline void AppendUint32(std::vector<uint8_t>& buffer, uint32_t value)
+	{
+		const size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(value));
+		std::memcpy(buffer.data() + offset, &value, sizeof(value));
+	}
+
+	inline void WriteUint32(std::vector<uint8_t>& buffer, size_t offset, uint32_t value)
+	{
+		std::memcpy(buffer.data() + offset, &value, sizeof(value));
+	}
+
+	// Builds a DBPF 1.0 file with a 7.0 index, the compressed entries are listed in the directory entry.
+	inline std::vector<uint8_t> BuildDBPF(const std::vector<Entry>& entries)
+	{
+		std::vector<uint8_t> compressedData;
+
+		std::vector<uint8_t> file(96, 0);
+		std::memcpy(file.data(), "DBPF", 4);
+		WriteUint32(file, 4, 1);
+		WriteUint32(file, 32, 7);
+
+		std::vector<uint8_t> index;
+		std::vector<uint8_t> directory;
+
+		for (const Entry& entry : entries)
+		{
+			AppendUint32(index, entry.key.type);
+			AppendUint32(index, entry.key.group);
+			AppendUint32(index, entry.key.instance);
+			AppendUint32(index, static_cast<uint32_t>(file.size()));
+
+			if (entry.compressed)
+			{
+				QFSCompression::Compress(entry.data.data(), entry.data.size(), compressedData);
+
+				AppendUint32(index, static_cast<uint32_t>(compressedData.size()));
+				AppendUint32(directory, entry.key.type);
+				AppendUint32(directory, entry.key.group);
+				AppendUint32(directory, entry.key.instance);
+				AppendUint32(directory, static_cast<uint32_t>(entry.data.size()));
+				file.insert(file.end(), compressedData.begin(), compressedData.end());
+			}
+			else
+			{
+				AppendUint32(index, static_cast<uint32_t>(entry.data.size()));
+				file.insert(file.end(), entry.data.begin(), entry.data.end());
+			}
+		}
+
+		uint32_t entryCount = static_cast<uint32_t>(entries.size());
+
+		if (!directory.empty())
+		{
+			AppendUint32(index, DBPFFile::DirectoryKey.type);
+			AppendUint32(index, DBPFFile::DirectoryKey.group);
+			AppendUint32(index, DBPFFile::DirectoryKey.instance);
+			AppendUint32(index, static_cast<uint32_t>(file.size()));
+			AppendUint32(index, static_cast<uint32_t>(directory.size()));
+			file.insert(file.end(), directory.begin(), directory.end());
+			entryCount++;
+		}
+
+		WriteUint32(file, 36, entryCount);
+		WriteUint32(file, 40, static_cast<uint32_t>(file.size()));
+		WriteUint32(file, 44, static_cast<uint32_t>(index.size()));
+		file.insert(file.end(), index.begin(), index.end());
+
+		return file;
+	}
+
+	// Writes the ordinance state the same way as the game, using the cIGZSerializable interface.
+	inline bool SerializeOrdinance(OrdinanceBase& ordinance, std::vector<uint8_t>& data)
+	{
+		cIGZSerializable* pSerializable = nullptr;
+
+		if (!ordinance.QueryInterface(GZIID_cIGZSerializable, reinterpret_cast<void**>(&pSerializable)))
+		{
+			return false;
+		}
+
+		MockDBSegmentStream stream;
+		const bool result = pSerializable->Write(static_cast<cISC4DBSegmentOStream&>(stream));
+		pSerializable->Release();
+
+		if (result)
+		{
+			data = stream.GetBuffer();
+		}
+
+		return result;
+	}
+
+	inline std::vector<uint8_t> CreateRandomData(std::mt19937& random, size_t size)
+	{
+		std::uniform_int_distribution<uint32_t> byteDistribution(0, 255);
+		std::vector<uint8_t> data(size);
+
+		for (uint8_t& value : data)
+		{
+			value = static_cast<uint8_t>(byteDistribution(random));
+		}
+
+		return data;
+	}
+
+	// Creates data that is shaped like the simulator records of a save game: fixed size
+	// records with IDs, coordinates and flags that change a little from one record to the next.
+	inline std::vector<uint8_t> CreateRecordData(std::mt19937& random, size_t size)
+	{
+		std::uniform_int_distribution<uint32_t> stepDistribution(0, 3);
+		std::vector<uint8_t> data;
+		data.reserve(size + 16);
+
+		uint32_t id = random();
+		uint32_t x = 0;
+		uint32_t z = 0;
+
+		while (data.size() < size)
+		{
+			id += 1;
+			x += stepDistribution(random);
+			z += stepDistribution(random);
+
+			AppendUint32(data, id);
+			AppendUint32(data, x);
+			AppendUint32(data, z);
+			AppendUint32(data, stepDistribution(random) == 0 ? 0x10 : 0);
+		}
+
+		data.resize(size);
+		return data;
+	}
+
+	// Creates a binary exemplar with a single Boolean array property.
+	inline std::vector<uint8_t> CreateBoolArrayExemplar(uint32_t propertyID, const std::vector<bool>& values)
+	{
+		std::vector<uint8_t> data(8);
+		std::memcpy(data.data(), "EQZB1###", 8);
+
+		// The parent cohort and the property count.
+		AppendUint32(data, 0);
+		AppendUint32(data, 0);
+		AppendUint32(data, 0);
+		AppendUint32(data, 1);
+
+		AppendUint32(data, propertyID);
+		data.push_back(0x00);
+		data.push_back(0x0b);
+		data.push_back(0x80);
+		data.push_back(0x00);
+		data.push_back(0x00);
+		AppendUint32(data, static_cast<uint32_t>(values.size()));
+
+		for (bool value : values)
+		{
+			data.push_back(value ? 1 : 0);
+		}
+
+		return data;
+	}
+
+	inline bool WriteFile(const std::filesystem::path& path, const std::vector<uint8_t>& data)
+	{
+		std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+
+		return static_cast<bool>(stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size())));
+	}
+}
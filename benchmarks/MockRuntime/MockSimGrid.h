@@ -0,0 +1,216 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockUnknown.h"
+#include "cISC4SimGrid.h"
+#include <algorithm>
+#include <vector>
+
+// A cISC4SimGrid implementation that stores the tract values in a row-major buffer,
+// which is the layout that SimGridView expects from GetGridData.
+// The rectangle queries visit every tract, like the game's implementation.
+template<typename T>
+class MockSimGrid final : public MockUnknown<cISC4SimGrid<T>>
+{
+public:
+
+	MockSimGrid(int32_t countX, int32_t countZ, int32_t tractShift)
+		: values(static_cast<size_t>(countX) * static_cast<size_t>(countZ)),
+		  countX(countX),
+		  countZ(countZ),
+		  tractShift(tractShift),
+		  instanceID(0)
+	{
+	}
+
+	std::vector<T>& GetValues()
+	{
+		return values;
+	}
+
+	bool Init(void) override
+	{
+		return true;
+	}
+
+	bool Shutdown(void) override
+	{
+		return true;
+	}
+
+	uint32_t GetInstanceID(void) override
+	{
+		return instanceID;
+	}
+
+	bool SetInstanceID(uint32_t dwInstanceID) override
+	{
+		instanceID = dwInstanceID;
+		return true;
+	}
+
+	T GetCellValue(int32_t nCellX, int32_t nCellZ) override
+	{
+		return GetTractValue(nCellX >> tractShift, nCellZ >> tractShift);
+	}
+
+	T GetAverageValueInCellRect(int32_t nTopLeftX, int32_t nTopLeftZ, int32_t nBottomRightX, int32_t nBottomRightZ) override
+	{
+		return GetAverageValueInTractRect(
+			nTopLeftX >> tractShift,
+			nTopLeftZ >> tractShift,
+			nBottomRightX >> tractShift,
+			nBottomRightZ >> tractShift);
+	}
+
+	bool SetTractSize(int32_t nSize) override
+	{
+		return false;
+	}
+
+	int32_t GetTractSize(void) override
+	{
+		return 1 << tractShift;
+	}
+
+	int32_t GetTractShift(void) override
+	{
+		return tractShift;
+	}
+
+	int32_t GetTractCountX(void) override
+	{
+		return countX;
+	}
+
+	int32_t GetTractCountZ(void) override
+	{
+		return countZ;
+	}
+
+	float GetTractWidthX(void) override
+	{
+		return static_cast<float>(GetTractSize()) * 16.0f;
+	}
+
+	float GetTractWidthZ(void) override
+	{
+		return static_cast<float>(GetTractSize()) * 16.0f;
+	}
+
+	float GetOneOverTractWidthX(void) override
+	{
+		return 1.0f / GetTractWidthX();
+	}
+
+	float GetOneOverTractWidthZ(void) override
+	{
+		return 1.0f / GetTractWidthZ();
+	}
+
+	bool TractIsInBounds(uint32_t dwTractX, uint32_t dwTractZ) override
+	{
+		return dwTractX < static_cast<uint32_t>(countX) && dwTractZ < static_cast<uint32_t>(countZ);
+	}
+
+	bool PositionToTract(float fPosX, float fPosZ, int32_t& nTractX, int32_t& nTractZ) override
+	{
+		nTractX = static_cast<int32_t>(fPosX * GetOneOverTractWidthX());
+		nTractZ = static_cast<int32_t>(fPosZ * GetOneOverTractWidthZ());
+
+		return TractIsInBounds(nTractX, nTractZ);
+	}
+
+	bool TractCornerToPosition(int32_t nTractX, int32_t nTractZ, float& fPosX, float& fPosZ) override
+	{
+		fPosX = static_cast<float>(nTractX) * GetTractWidthX();
+		fPosZ = static_cast<float>(nTractZ) * GetTractWidthZ();
+
+		return TractIsInBounds(nTractX, nTractZ);
+	}
+
+	bool TractCenterToPosition(int32_t nTractX, int32_t nTractZ, float& fPosX, float& fPosZ) override
+	{
+		fPosX = (static_cast<float>(nTractX) + 0.5f) * GetTractWidthX();
+		fPosZ = (static_cast<float>(nTractZ) + 0.5f) * GetTractWidthZ();
+
+		return TractIsInBounds(nTractX, nTractZ);
+	}
+
+	T GetTractValue(int32_t nTractX, int32_t nTractZ) override
+	{
+		if (!TractIsInBounds(nTractX, nTractZ))
+		{
+			return T();
+		}
+
+		return values[(static_cast<size_t>(nTractZ) * countX) + nTractX];
+	}
+
+	T GetAverageValueInTractRect(int32_t nTopLeftX, int32_t nTopLeftZ, int32_t nBottomRightX, int32_t nBottomRightZ) override
+	{
+		nTopLeftX = std::max(nTopLeftX, 0);
+		nTopLeftZ = std::max(nTopLeftZ, 0);
+		nBottomRightX = std::min(nBottomRightX, countX - 1);
+		nBottomRightZ = std::min(nBottomRightZ, countZ - 1);
+
+		if (nTopLeftX > nBottomRightX || nTopLeftZ > nBottomRightZ)
+		{
+			return T();
+		}
+
+		uint64_t sum = 0;
+
+		for (int32_t z = nTopLeftZ; z <= nBottomRightZ; z++)
+		{
+			for (int32_t x = nTopLeftX; x <= nBottomRightX; x++)
+			{
+				sum += values[(static_cast<size_t>(z) * countX) + x];
+			}
+		}
+
+		const uint64_t area = static_cast<uint64_t>(nBottomRightX - nTopLeftX + 1) * static_cast<uint64_t>(nBottomRightZ - nTopLeftZ + 1);
+
+		return static_cast<T>(sum / area);
+	}
+
+	intptr_t GetGridData(void) override
+	{
+		return reinterpret_cast<intptr_t>(values.data());
+	}
+
+	bool SetTractValue(int32_t nTractX, int32_t nTractZ, T value) override
+	{
+		if (!TractIsInBounds(nTractX, nTractZ))
+		{
+			return false;
+		}
+
+		values[(static_cast<size_t>(nTractZ) * countX) + nTractX] = value;
+		return true;
+	}
+
+	bool SetTractValues(T value) override
+	{
+		std::fill(values.begin(), values.end(), value);
+		return true;
+	}
+
+private:
+
+	std::vector<T> values;
+	int32_t countX;
+	int32_t countZ;
+	int32_t tractShift;
+	uint32_t instanceID;
+};
@@ -0,0 +1,588 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MockCost.h"
+#include "MockMessageServers.h"
+#include "MockOccupant.h"
+#include "MockSimGrid.h"
+#include "MockUnknown.h"
+#include "cISC4ResidentialSimulator.h"
+#include "cISC4Simulator.h"
+#include "cISC4TrafficSimulator.h"
+#include "SC4Percentage.h"
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+// A cISC4Simulator implementation that tracks the hidden pause state.
+// Pausing the game queues the configured number of messages in the message
+// servers, which the plugin then has to process.
+class MockSimulator final : public MockUnknown<cISC4Simulator>
+{
+public:
+
+	void SetPauseMessageQueueDepth(MockMessageServer* pMessageServer, MockMessageServer2* pMessageServer2, uint32_t depth)
+	{
+		this->pMessageServer = pMessageServer;
+		this->pMessageServer2 = pMessageServer2;
+		pauseMessageQueueDepth = depth;
+	}
+
+	void SetSimDateNumber(int32_t value)
+	{
+		simDateNumber = value;
+	}
+
+	uint32_t GetHiddenPauseCount() const
+	{
+		return hiddenPauseCount;
+	}
+
+	bool HiddenPause(void) override
+	{
+		hiddenPauseCount++;
+
+		if (pMessageServer)
+		{
+			pMessageServer->Enqueue(pauseMessageQueueDepth);
+		}
+
+		if (pMessageServer2)
+		{
+			pMessageServer2->Enqueue(pauseMessageQueueDepth);
+		}
+
+		return true;
+	}
+
+	bool HiddenResume(void) override
+	{
+		if (hiddenPauseDepth() == 0)
+		{
+			return false;
+		}
+
+		hiddenResumeCount++;
+		return true;
+	}
+
+	bool IsHiddenPaused(void) override
+	{
+		return hiddenPauseDepth() != 0;
+	}
+
+	int32_t GetSimDateNumber(void) override
+	{
+		return simDateNumber;
+	}
+
+	void GetSimDate(long& year, long& month, long& day, long& dayOfYear, long& weekDay) override
+	{
+		// The mock calendar uses 30 day months.
+		year = simDateNumber / 360;
+		month = ((simDateNumber / 30) % 12) + 1;
+		day = (simDateNumber % 30) + 1;
+		dayOfYear = simDateNumber % 360;
+		weekDay = simDateNumber % 7;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool Init(void) override { return false; }
+	bool Shutdown(void) override { return false; }
+	bool GetSimStartDate(cIGZDate& sDate) override { return false; }
+	cIGZDate* GetSimDate(void) override { return nullptr; }
+	bool Pause(void) override { return false; }
+	bool EmergencyPause(void) override { return false; }
+	bool Resume(void) override { return false; }
+	bool EmergencyResume(void) override { return false; }
+	bool IsPaused(void) override { return false; }
+	bool IsEmergencyPaused(void) override { return false; }
+	bool IsAnyPaused(void) override { return false; }
+	bool AddAgent(cIGZMessageTarget2* pAgent, uint32_t dwAgentType, cIGZString const& szAgentName, uint32_t dwUnknownFlags) override { return false; }
+	bool RemoveAgent(cIGZMessageTarget2* pAgent, uint32_t dwAgentType) override { return false; }
+	bool RemoveAgent(cIGZMessageTarget2* pAgent) override { return false; }
+	bool RemoveAllAgents(void) override { return false; }
+	bool RemoveAllAgents(uint32_t dwAgentType) override { return false; }
+	bool EnumerateAgentsByName(std::vector<cIGZString>& sAgents) override { return false; }
+	bool GetAgentEnabled(cIGZString const& szAgentName) override { return false; }
+	bool SetAgentEnabled(cIGZString const& szAgentName, bool bEnabled) override { return false; }
+	int32_t GetSimSpeed(void) override { return 0; }
+	bool SetSimSpeed(int32_t lSpeed) override { return false; }
+	int32_t GetSimTime(void) override { return 0; }
+	bool SetSimTime(int32_t lTime) override { return false; }
+	bool SetMaxMillisecondsPerTick(uint32_t dwTime) override { return false; }
+	float GetAnimationTimeDilation(void) override { return 0; }
+	bool SetCityEstablished(bool bEstablished) override { return false; }
+
+private:
+
+	uint32_t hiddenPauseDepth() const
+	{
+		return hiddenPauseCount - hiddenResumeCount;
+	}
+
+	MockMessageServer* pMessageServer = nullptr;
+	MockMessageServer2* pMessageServer2 = nullptr;
+	uint32_t pauseMessageQueueDepth = 0;
+	uint32_t hiddenPauseCount = 0;
+	uint32_t hiddenResumeCount = 0;
+	int32_t simDateNumber = 0;
+};
+
+class MockResidentialSimulator final : public MockUnknown<cISC4ResidentialSimulator>
+{
+public:
+
+	void SetPopulation(int32_t value)
+	{
+		population = value;
+	}
+
+	void SetPopulationQueryCost(int64_t nanoseconds)
+	{
+		populationQueryCostNanoseconds = nanoseconds;
+	}
+
+	uint32_t GetPopulationQueryCount() const
+	{
+		return populationQueryCount;
+	}
+
+	int32_t GetPopulation(void) override
+	{
+		populationQueryCount++;
+		MockCost::Spin(populationQueryCostNanoseconds);
+
+		return population;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	bool Init(void) override { return false; }
+	bool Shutdown(void) override { return false; }
+	intptr_t GetProximityMap(uint8_t cWealthType) override { return 0; }
+	bool SchoolIsOnStrike(void) override { return false; }
+	bool HealthIsOnStrike(void) override { return false; }
+	bool EndSchoolStrike(void) override { return false; }
+	bool EndHealthStrike(void) override { return false; }
+	float ChanceOfSchoolStrike(void) override { return 0; }
+	float ChanceOfHealthStrike(void) override { return 0; }
+	float GetSchoolSystemRating(void) override { return 0; }
+	float GetHealthSystemRating(void) override { return 0; }
+	bool GetSchoolSystemTotals(std::list<int32_t> const& sData) override { return false; }
+	bool GetHospitalSystemTotals(std::list<int32_t> const& sData) override { return false; }
+	int32_t GetTotalCityEducationUpkeepCost(void) override { return 0; }
+	int32_t GetTotalCityHealthUpkeepCost(void) override { return 0; }
+	bool SetOccupantFundingPercentages(cISC4Occupant* pOccupant, SC4Percentage const& sSchoolFunding, SC4Percentage const& sHealthFunding, bool bUnknown) override { return false; }
+	bool GetOccupantFundingPercentages(cISC4Occupant* pOccupant, SC4Percentage& sSchoolFunding, SC4Percentage& sHealthFunding, bool bUnknown) override { return false; }
+	bool GetAverageEQGrid(cISC4SimGrid<float>*& pGrid, float* fMin, float* fMax) override { return false; }
+	bool GetAverageHQGrid(cISC4SimGrid<float>*& pGrid, float* fMin, float* fMax) override { return false; }
+	bool GetEQGrids(cISC4SimGrid<float>*& pGrid, cISC4SimGrid<float>* pUnknown1, cISC4SimGrid<float>* pUnknown2) override { return false; }
+	bool GetHQGrids(cISC4SimGrid<float>*& pGrid, cISC4SimGrid<float>* pUnknown1, cISC4SimGrid<float>* pUnknown2) override { return false; }
+	bool GetPopulationGrids(cISC4SimGrid<uint16_t>*& pGrid, cISC4SimGrid<uint16_t>* pUnknown1, cISC4SimGrid<uint16_t>* pUnknown2) override { return false; }
+	bool GetSchoolQueryData(cISC4Occupant* pOccupant, intptr_t pQueryData) override { return false; }
+	bool GetHospitalQueryData(cISC4Occupant* pOccupant, intptr_t pQueryData) override { return false; }
+	bool EstimateCurrentOccupantCapacity(cISC4Occupant* pOccupant, uint32_t& dwUnknown1, uint32_t& dwUnknown2) override { return false; }
+	int32_t GetCellLifeExpectancy(uint32_t dwCellX, uint32_t dwCellZ) override { return 0; }
+	float GetCellWorkforcePercent(uint32_t dwCellX, uint32_t dwCellZ) override { return 0; }
+	float GetGlobalWorkforcePercent(void) override { return 0; }
+	float GetGlobalEQ(void) override { return 0; }
+	float GetGlobalHQ(void) override { return 0; }
+	float GetGlobalLE(void) override { return 0; }
+	float GetCellEQ(uint32_t dwCellX, uint32_t dwCellZ) override { return 0; }
+	float GetCellHQ(uint32_t dwCellX, uint32_t dwCellZ) override { return 0; }
+	float GetCellEQByWealth(uint32_t dwCellX, uint32_t dwCellZ, uint8_t cWealthType) override { return 0; }
+	float GetCellHQByWealth(uint32_t dwCellX, uint32_t dwCellZ, uint8_t cWealthType) override { return 0; }
+	int32_t GetSchoolAverageGradeMap(void) override { return 0; }
+	int32_t GetHospitalAverageGradeMap(void) override { return 0; }
+	int32_t GetAverageAgeMap(void) override { return 0; }
+	int32_t GetAverageNewAgeByWealth(uint8_t cWealthType) override { return 0; }
+	bool GetEQMinAndMaxCellCoords(uint32_t& dwMinCellX, uint32_t& dwMinCellZ, uint32_t& dwMaxCellX, uint32_t& dwMaxCellZ, float& fMin, float& fMax) override { return false; }
+	bool GetHQMinAndMaxCellCoords(uint32_t& dwMinCellX, uint32_t& dwMinCellZ, uint32_t& dwMaxCellX, uint32_t& dwMaxCellZ, float& fMin, float& fMax) override { return false; }
+	bool GetOccupantCoverage(cISC4Occupant* pOccupant, SC4Percentage const& sEffectiveness, float& fRangeX, float& fRangeZ) override { return false; }
+	int32_t GetSchoolBuildingCount(void) override { return 0; }
+	bool GetSchoolBuildings(std::list<cISC4Occupant*>& sBuildings, std::vector<uint32_t>& sUnknown) override { return false; }
+	int32_t GetHospitalBuildingCount(void) override { return 0; }
+	bool GetHospitalBuildings(std::list<cISC4Occupant*>& sBuildings, std::vector<uint32_t>& sUnknown) override { return false; }
+	int32_t GetMaxEQ(void) override { return 0; }
+	int32_t GetMaxHQ(void) override { return 0; }
+	bool GetGlobalAutoBudgetForSchools(void) override { return false; }
+	bool SetGlobalAutoBudgetForSchools(bool bEnable) override { return false; }
+	bool GetGlobalAutoBudgetForHospitals(void) override { return false; }
+	bool SetGlobalAutoBudgetForHospitals(bool bEnable) override { return false; }
+	bool GetAutoBudget(void) override { return false; }
+	bool SetAutoBudget(bool bEnable) override { return false; }
+	bool EstimateIdealFunding(cISC4Occupant* pOccupant, SC4Percentage& sFunding) override { return false; }
+	void ToggleTractTracking(int32_t nUnknown1, int32_t nUnknown2) override {}
+
+private:
+
+	int32_t population = 0;
+	int64_t populationQueryCostNanoseconds = 0;
+	uint32_t populationQueryCount = 0;
+};
+
+// A cISC4TrafficSimulator implementation with configurable restart and message costs.
+class MockTrafficSimulator final : public MockUnknown<cISC4TrafficSimulator>
+{
+public:
+
+	void SetCosts(int64_t shutdownNanoseconds, int64_t initNanoseconds, int64_t messageNanoseconds)
+	{
+		shutdownCostNanoseconds = shutdownNanoseconds;
+		initCostNanoseconds = initNanoseconds;
+		messageCostNanoseconds = messageNanoseconds;
+	}
+
+	uint32_t GetRestartCount() const
+	{
+		return restartCount;
+	}
+
+	uint32_t GetMessageCount() const
+	{
+		return messageCount;
+	}
+
+	/**
+	 * @brief Creates the traffic maps.
+	 * @param tractCountX The number of tracts in the X direction.
+	 * @param tractCountZ The number of tracts in the Z direction.
+	 * @param tractShift The number of bits that a cell coordinate is shifted by to get the tract coordinate.
+	 */
+	void CreateMaps(int32_t tractCountX, int32_t tractCountZ, int32_t tractShift)
+	{
+		airPollutingTrafficMap = std::make_unique<MockSimGrid<uint8_t>>(tractCountX, tractCountZ, tractShift);
+		commercialTrafficMap = std::make_unique<MockSimGrid<uint8_t>>(tractCountX, tractCountZ, tractShift);
+		congestionMap = std::make_unique<MockSimGrid<uint8_t>>(tractCountX, tractCountZ, tractShift);
+		tripLengthMap = std::make_unique<MockSimGrid<uint8_t>>(tractCountX, tractCountZ, tractShift);
+	}
+
+	/**
+	 * @brief Stores the current traffic map values as the values that the simulation converges to.
+	 * @param recoveryRate The fraction of the difference that is recovered each simulation day.
+	 */
+	void SetEquilibrium(double recoveryRate)
+	{
+		this->recoveryRate = recoveryRate;
+		congestionEquilibrium = congestionMap->GetValues();
+		tripLengthEquilibrium = tripLengthMap->GetValues();
+	}
+
+	/**
+	 * @brief Scales the values that the simulation converges to, which models a change
+	 * in the city's traffic.
+	 * @param percentage The new equilibrium as a percentage of the current one.
+	 */
+	void ScaleEquilibrium(uint32_t percentage)
+	{
+		for (uint8_t& value : congestionEquilibrium)
+		{
+			value = static_cast<uint8_t>(std::min<uint32_t>((value * percentage) / 100, 255));
+		}
+
+		for (uint8_t& value : tripLengthEquilibrium)
+		{
+			value = static_cast<uint8_t>(std::min<uint32_t>((value * percentage) / 100, 255));
+		}
+	}
+
+	const std::vector<uint8_t>& GetCongestionEquilibrium() const
+	{
+		return congestionEquilibrium;
+	}
+
+	/**
+	 * @brief Moves the traffic maps towards their equilibrium values, which models
+	 * the traffic simulator rebuilding its maps after a restart.
+	 */
+	void SimulateDay()
+	{
+		SimulateDay(congestionMap->GetValues(), congestionEquilibrium);
+		SimulateDay(tripLengthMap->GetValues(), tripLengthEquilibrium);
+	}
+
+	/**
+	 * @brief Sets the values that the monthly traffic statistics methods return.
+	 */
+	void SetMonthlyStatistics(float tripScale, float lastMonthlyIncome, float freightScalingFactor)
+	{
+		this->tripScale = tripScale;
+		this->lastMonthlyIncome = lastMonthlyIncome;
+		this->freightScalingFactor = freightScalingFactor;
+	}
+
+	/**
+	 * @brief Adds a transit switch lot without capacity or traffic.
+	 * @return The index of the transit switch.
+	 */
+	size_t AddTransitSwitch()
+	{
+		transitSwitches.push_back(TransitSwitch{ std::make_unique<MockOccupant>(kBuildingOccupantType), {}, {} });
+		transitSwitchIndices.emplace(transitSwitches.back().occupant->AsPropertyHolder(), transitSwitches.size() - 1);
+		return transitSwitches.size() - 1;
+	}
+
+	/**
+	 * @brief Removes a transit switch lot, the indices of the following transit switches move down by one.
+	 */
+	void RemoveTransitSwitch(size_t index)
+	{
+		transitSwitches.erase(transitSwitches.begin() + static_cast<ptrdiff_t>(index));
+		transitSwitchIndices.clear();
+
+		for (size_t i = 0; i < transitSwitches.size(); i++)
+		{
+			transitSwitchIndices.emplace(transitSwitches[i].occupant->AsPropertyHolder(), i);
+		}
+	}
+
+	size_t GetTransitSwitchCount() const
+	{
+		return transitSwitches.size();
+	}
+
+	MockOccupant& GetTransitSwitchOccupant(size_t index)
+	{
+		return *transitSwitches[index].occupant;
+	}
+
+	// The number of GetTransitSwitches calls.
+	uint32_t GetTransitSwitchListCount() const
+	{
+		return transitSwitchListCount;
+	}
+
+	/**
+	 * @brief Sets the trip capacity and the traffic that arrived at a transit switch for one travel type.
+	 */
+	void SetTransitSwitchTraffic(size_t index, uint32_t travelType, uint32_t capacity, uint32_t arrived)
+	{
+		TransitSwitch& transitSwitch = transitSwitches[index];
+
+		transitSwitch.capacity[travelType] = capacity;
+		transitSwitch.arrived[travelType] = arrived;
+	}
+
+	// Sets the cost of each GetMaxTripCapacity and GetTrafficArrived call.
+	void SetTransitSwitchQueryCost(int64_t nanoseconds)
+	{
+		transitSwitchQueryCostNanoseconds = nanoseconds;
+	}
+
+	MockSimGrid<uint8_t>* GetMockCongestionMap() const
+	{
+		return congestionMap.get();
+	}
+
+	MockSimGrid<uint8_t>* GetMockTripLengthMap() const
+	{
+		return tripLengthMap.get();
+	}
+
+	bool Init() override
+	{
+		MockCost::Spin(initCostNanoseconds);
+		restartCount++;
+		return true;
+	}
+
+	bool Shutdown() override
+	{
+		MockCost::Spin(shutdownCostNanoseconds);
+
+		// The traffic simulator discards its traffic data when it is shut down.
+		for (MockSimGrid<uint8_t>* map : { airPollutingTrafficMap.get(), commercialTrafficMap.get(), congestionMap.get(), tripLengthMap.get() })
+		{
+			if (map)
+			{
+				map->SetTractValues(0);
+			}
+		}
+
+		return true;
+	}
+
+	intptr_t GetAirPollutingTrafficMap() const override
+	{
+		return GetMapPointer(airPollutingTrafficMap.get());
+	}
+
+	intptr_t GetCommercialTrafficMap() const override
+	{
+		return GetMapPointer(commercialTrafficMap.get());
+	}
+
+	intptr_t GetCongestionMap() const override
+	{
+		return GetMapPointer(congestionMap.get());
+	}
+
+	intptr_t GetTripLengthMap() const override
+	{
+		return GetMapPointer(tripLengthMap.get());
+	}
+
+	float GetTripScale() const override
+	{
+		return tripScale;
+	}
+
+	float GetLastMonthlyIncome() override
+	{
+		return lastMonthlyIncome;
+	}
+
+	float GetFreightScalingFactor() override
+	{
+		return freightScalingFactor;
+	}
+
+	bool GetTransitSwitches(ilist<cISC4Occupant*>& occupants) override
+	{
+		transitSwitchListCount++;
+
+		for (const TransitSwitch& transitSwitch : transitSwitches)
+		{
+			occupants.push_back(transitSwitch.occupant.get());
+		}
+
+		return true;
+	}
+
+	uint32_t GetMaxTripCapacity(cISCPropertyHolder* propertyHolder, uint32_t travelType) override
+	{
+		MockCost::Spin(transitSwitchQueryCostNanoseconds);
+
+		const TransitSwitch* pTransitSwitch = FindTransitSwitch(propertyHolder);
+
+		return pTransitSwitch && travelType < kTravelTypeCount ? pTransitSwitch->capacity[travelType] : 0;
+	}
+
+	uint32_t GetTrafficArrived(cISCPropertyHolder* propertyHolder, uint32_t travelType) override
+	{
+		MockCost::Spin(transitSwitchQueryCostNanoseconds);
+
+		const TransitSwitch* pTransitSwitch = FindTransitSwitch(propertyHolder);
+
+		return pTransitSwitch && travelType < kTravelTypeCount ? pTransitSwitch->arrived[travelType] : 0;
+	}
+
+	bool DoMessage(cIGZMessage2* pMessage) override
+	{
+		MockCost::Spin(messageCostNanoseconds);
+		messageCount++;
+		return true;
+	}
+
+	// The remaining methods are not used by the plugin.
+
+	uint32_t GetSimulatorType() override { return 0; }
+	bool CreatePathFinder(cISC4PathFinder** pathFinder) override { return false; }
+	bool SetupPathFinderForLot(cISC4PathFinder* pathFinder, cISC4Lot* lot) override { return false; }
+	intptr_t GetBackgroundTraffic(int unknown1, int unknown2) override { return 0; }
+	int64_t GetTrafficEdgeDensity(uint8_t unknown1, uint32_t travelType, bool unknown3) override { return 0; }
+	float GetTripScaleForDisplay() const override { return 0; }
+	bool IsRoadDamaged(int unknown1, int unknown2) override { return false; }
+	bool CheckRailAccident(int unknown1, int unknown2) override { return false; }
+	bool SetMaxTripCapacity(cISCPropertyHolder* unknown1, uint32_t unknown2, uint32_t unknown3) override { return false; }
+	uint32_t GetDesiredLotInsertionPoint() override { return 0; }
+	uint32_t GetCapacity(uint32_t networkType, int unknown2, int unknown3) override { return 0; }
+	float GetTravelTimeRatio(long unknown1, long unknown2, uint32_t travelType) override { return 0; }
+	uint32_t GetConnectionCount(uint32_t networkType, int unknown2, int unknown3) override { return 0; }
+	bool GetTravelStrategyPercentages(uint32_t wealthType, std::vector<SC4Percentage> unknown2) override { return false; }
+	int32_t GetFerryRouteBetweenTiles(long unknown1, long unknown2, long unknown3, long unknown4) override { return 0; }
+	bool GetAllFerryRoutes(std::list<std::vector<uint8_t>>& unknown1) override { return false; }
+	bool GetFerryRoutesInUse(std::list<FerryRouteInfo>& unknown1) override { return false; }
+	uint32_t GetFerryTerminalCount(uint32_t ferryType) override { return 0; }
+	bool GetWaterRoute(long unknown1, long unknown2, long unknown3, long unknown4, std::vector<uint8_t>& unknown5) override { return false; }
+	intptr_t GetTrafficStats() override { return 0; }
+	bool GetTransitSwitchQueryData(uint32_t unknown1, uint32_t unknown2, TransitSwitchQueryData& data) override { return false; }
+	bool AreLotsConnected(cISC4Lot* unknown1, cISC4Lot* unknown2) const override { return false; }
+	uint32_t GetConnectedOccupantCount(cISC4Lot* unknown1, uint32_t unknown2) const override { return 0; }
+	uint32_t GetConnectedDestinationCount(cISC4Lot* unknown1, int unknown2) const override { return 0; }
+	bool GetSubnetworksForLot(cISC4Lot* unknown1, std::vector<uint32_t>& unknown2) override { return false; }
+	bool GetSubnetworksInRectangle(SC4Rect<int> const& rect, std::vector<uint32_t>& unknown2) override { return false; }
+	bool GetSubnetworksInRegion(intptr_t cellRegion, std::vector<uint32_t>& unknown2) override { return false; }
+	bool GetOccupantCountForAllSubnetworks(uint32_t unknown1, std::vector<uint32_t>& unknown2) override { return false; }
+
+private:
+
+	static constexpr uint32_t kTravelTypeCount = 9;
+	static constexpr int32_t kBuildingOccupantType = 0x278128A0;
+
+	struct TransitSwitch
+	{
+		std::unique_ptr<MockOccupant> occupant;
+		std::array<uint32_t, kTravelTypeCount> capacity;
+		std::array<uint32_t, kTravelTypeCount> arrived;
+	};
+
+	const TransitSwitch* FindTransitSwitch(cISCPropertyHolder* propertyHolder) const
+	{
+		const auto it = transitSwitchIndices.find(propertyHolder);
+
+		return it != transitSwitchIndices.end() ? &transitSwitches[it->second] : nullptr;
+	}
+
+	void SimulateDay(std::vector<uint8_t>& values, const std::vector<uint8_t>& equilibrium) const
+	{
+		if (values.size() != equilibrium.size())
+		{
+			return;
+		}
+
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			const int difference = static_cast<int>(equilibrium[i]) - static_cast<int>(values[i]);
+
+			if (difference != 0)
+			{
+				int step = static_cast<int>(static_cast<double>(difference) * recoveryRate);
+
+				if (step == 0)
+				{
+					step = difference > 0 ? 1 : -1;
+				}
+
+				values[i] = static_cast<uint8_t>(values[i] + step);
+			}
+		}
+	}
+
+	static intptr_t GetMapPointer(MockSimGrid<uint8_t>* map)
+	{
+		return reinterpret_cast<intptr_t>(static_cast<cISC4SimGrid<uint8_t>*>(map));
+	}
+
+	std::unique_ptr<MockSimGrid<uint8_t>> airPollutingTrafficMap;
+	std::unique_ptr<MockSimGrid<uint8_t>> commercialTrafficMap;
+	std::unique_ptr<MockSimGrid<uint8_t>> congestionMap;
+	std::unique_ptr<MockSimGrid<uint8_t>> tripLengthMap;
+	std::vector<TransitSwitch> transitSwitches;
+	std::unordered_map<cISCPropertyHolder*, size_t> transitSwitchIndices;
+	uint32_t transitSwitchListCount = 0;
+	int64_t transitSwitchQueryCostNanoseconds = 0;
+	std::vector<uint8_t> congestionEquilibrium;
+	std::vector<uint8_t> tripLengthEquilibrium;
+	double recoveryRate = 0.0;
+	float tripScale = 0.0f;
+	float lastMonthlyIncome = 0.0f;
+	float freightScalingFactor = 0.0f;
+	int64_t shutdownCostNanoseconds = 0;
+	int64_t initCostNanoseconds = 0;
+	int64_t messageCostNanoseconds = 0;
+	uint32_t restartCount = 0;
+	uint32_t messageCount = 0;
+};
@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZUnknown.h"
+
+// Provides the cIGZUnknown reference counting for the mock game objects.
+// The mock objects are owned by MockRuntime, so the reference count is only
+// tracked to allow leaks to be detected.
+template <typename T>
+class MockUnknown : public T
+{
+public:
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override
+	{
+		// The mock objects only implement a single interface.
+		AddRef();
+		*ppvObj = static_cast<T*>(this);
+
+		return true;
+	}
+
+	uint32_t AddRef() override
+	{
+		return ++refCount;
+	}
+
+	uint32_t Release() override
+	{
+		if (refCount > 0)
+		{
+			--refCount;
+		}
+
+		return refCount;
+	}
+
+	uint32_t GetRefCount() const
+	{
+		return refCount;
+	}
+
+private:
+
+	uint32_t refCount = 0;
+};
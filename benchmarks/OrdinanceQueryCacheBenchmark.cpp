@@ -0,0 +1,221 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Measures how often the GetCurrentMonthlyIncome and CheckConditions values are reused
+// within a simulation day, and compares the cost with computing them on every call.
+//
+// The program exits with a non-zero status if a reused value differs from the computed
+// value, or if the hit and miss counts differ from the expected number of queries.
+
+#include "BenchmarkArguments.h"
+#include "MockRuntime.h"
+#include "OrdinanceBase.h"
+#include "Stopwatch.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	constexpr int32_t kDaysPerMonth = 30;
+
+	struct BenchmarkOptions
+	{
+		uint32_t months = 24;
+		uint32_t queriesPerDay = 20;
+		uint32_t populationQueryCost = 200;
+	};
+
+	// Exposes the uncached calculations so that the benchmark can compare them with the cached values.
+	class BenchmarkOrdinance final : public OrdinanceBase
+	{
+	public:
+
+		BenchmarkOrdinance()
+			: OrdinanceBase(
+				0x4b2d7a13,
+				"Benchmark Ordinance",
+				"An ordinance that is only used by the benchmark.",
+				0,
+				0,
+				-100,
+				0.05f,
+				false)
+		{
+		}
+
+		int64_t CalculateUncachedMonthlyIncome()
+		{
+			return CalculateMonthlyIncome();
+		}
+
+		bool EvaluateUncachedConditions()
+		{
+			return EvaluateConditions();
+		}
+	};
+
+	bool RunBenchmark(const BenchmarkOptions& options)
+	{
+		MockRuntime runtime(MockRuntimeOptions{});
+		cISC4City* pCity = runtime.LoadCity();
+		MockResidentialSimulator& residentialSimulator = runtime.GetResidentialSimulator();
+
+		residentialSimulator.SetPopulation(50000);
+		residentialSimulator.SetPopulationQueryCost(options.populationQueryCost);
+
+		BenchmarkOrdinance ordinance;
+		ordinance.SetEnabled(true);
+
+		if (!ordinance.PostCityInit(pCity))
+		{
+			std::fprintf(stderr, "PostCityInit failed.\n");
+			return false;
+		}
+
+		ordinance.SetAvailable(true);
+		ordinance.SetOn(true);
+
+		const uint32_t populationQueriesBefore = residentialSimulator.GetPopulationQueryCount();
+		const uint64_t days = static_cast<uint64_t>(options.months) * kDaysPerMonth;
+
+		// The stopwatches accumulate the time of the query loops over all days.
+		Stopwatch cachedTime;
+		Stopwatch uncachedTime;
+
+		for (uint32_t month = 0; month < options.months; month++)
+		{
+			for (int32_t day = 0; day < kDaysPerMonth; day++)
+			{
+				runtime.AdvanceSimDate(1);
+				residentialSimulator.SetPopulation(residentialSimulator.GetPopulation() + 25);
+
+				const int64_t expectedIncome = ordinance.CalculateUncachedMonthlyIncome();
+				const bool expectedConditions = ordinance.EvaluateUncachedConditions();
+
+				cachedTime.Start();
+
+				for (uint32_t i = 0; i < options.queriesPerDay; i++)
+				{
+					const int64_t income = ordinance.GetCurrentMonthlyIncome();
+					const bool conditions = ordinance.CheckConditions();
+
+					if (income != expectedIncome || conditions != expectedConditions)
+					{
+						std::fprintf(
+							stderr,
+							"Day %u: the cached income is %lld and the conditions are %d, expected %lld and %d.\n",
+							month * kDaysPerMonth + day,
+							static_cast<long long>(income),
+							conditions,
+							static_cast<long long>(expectedIncome),
+							expectedConditions);
+						return false;
+					}
+				}
+
+				cachedTime.Stop();
+				uncachedTime.Start();
+
+				for (uint32_t i = 0; i < options.queriesPerDay; i++)
+				{
+					ordinance.CalculateUncachedMonthlyIncome();
+					ordinance.EvaluateUncachedConditions();
+				}
+
+				uncachedTime.Stop();
+			}
+
+			ordinance.Simulate();
+		}
+
+		const OrdinanceBase::QueryCacheStatistics& statistics = ordinance.GetQueryCacheStatistics();
+
+		// Each day computes the values once, and each Simulate call computes the income again.
+		const uint64_t expectedIncomeMisses = days + options.months;
+		const uint64_t expectedHits = days * (options.queriesPerDay - 1);
+
+		if (statistics.incomeMisses != expectedIncomeMisses
+			|| statistics.incomeHits != expectedHits
+			|| statistics.conditionMisses != days
+			|| statistics.conditionHits != expectedHits)
+		{
+			std::fprintf(
+				stderr,
+				"Unexpected query cache statistics: income hits=%llu, misses=%llu, conditions hits=%llu, misses=%llu.\n",
+				static_cast<unsigned long long>(statistics.incomeHits),
+				static_cast<unsigned long long>(statistics.incomeMisses),
+				static_cast<unsigned long long>(statistics.conditionHits),
+				static_cast<unsigned long long>(statistics.conditionMisses));
+			return false;
+		}
+
+		// The uncached loop and the expected values query the population once per call,
+		// the remaining queries were made by the cache misses.
+		const uint32_t populationQueries = residentialSimulator.GetPopulationQueryCount() - populationQueriesBefore;
+
+		std::printf(
+			"%u months, %u queries per day: income hits=%llu, misses=%llu, conditions hits=%llu, misses=%llu (%.1f%% hit rate)\n",
+			options.months,
+			options.queriesPerDay,
+			static_cast<unsigned long long>(statistics.incomeHits),
+			static_cast<unsigned long long>(statistics.incomeMisses),
+			static_cast<unsigned long long>(statistics.conditionHits),
+			static_cast<unsigned long long>(statistics.conditionMisses),
+			100.0 * static_cast<double>(statistics.incomeHits) / static_cast<double>(statistics.incomeHits + statistics.incomeMisses));
+		std::printf(
+			"Population queries %u, cached %lld us, uncached %lld us (%.1fx faster)\n",
+			populationQueries,
+			static_cast<long long>(cachedTime.ElapsedMicroseconds()),
+			static_cast<long long>(uncachedTime.ElapsedMicroseconds()),
+			static_cast<double>(uncachedTime.ElapsedMicroseconds()) / static_cast<double>(std::max<int64_t>(cachedTime.ElapsedMicroseconds(), 1)));
+
+		// Enacting or repealing the ordinance must not reuse the values from earlier in the day.
+		const uint64_t missesBeforeToggle = statistics.incomeMisses;
+		ordinance.GetCurrentMonthlyIncome();
+		ordinance.SetOn(false);
+		ordinance.GetCurrentMonthlyIncome();
+
+		if (statistics.incomeMisses != missesBeforeToggle + 1)
+		{
+			std::fprintf(stderr, "SetOn did not invalidate the query cache.\n");
+			return false;
+		}
+
+		ordinance.PreCityShutdown(pCity);
+		runtime.UnloadCity();
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--months", "n", "The number of simulated months", options.months);
+	arguments.AddValue("--queries-per-day", "n", "The number of income and conditions queries per day", options.queriesPerDay);
+	arguments.AddValue(
+		"--population-cost",
+		"ns",
+		"The cost of a residential simulator population query",
+		options.populationQueryCost);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	return RunBenchmark(options) ? 0 : 1;
+}
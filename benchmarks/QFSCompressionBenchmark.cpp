@@ -0,0 +1,344 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Checks the QFS decompressor in QFSCompression.cpp against the byte-at-a-time reference
+// decoder, then measures the decompression speed of both.
+//
+// The fuzz tests round-trip data of several shapes through the compressor, and decode
+// mutated, truncated and random command streams with both decoders. The program exits with
+// a non-zero status if a round-trip fails or if the decoders do not agree on the result.
+
+#include "BenchmarkArguments.h"
+#include "QFSCompression.h"
+#include "Stopwatch.h"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		uint32_t megabytes = 64;
+		uint32_t entrySize = 256 * 1024;
+		uint32_t fuzzIterations = 5000;
+		bool verifyOnly = false;
+	};
+
+	enum class DataShape : uint32_t
+	{
+		Random = 0,
+		Text,
+		Runs,
+		SaveRecords,
+		Count
+	};
+
+	const char* GetShapeName(DataShape shape)
+	{
+		switch (shape)
+		{
+		case DataShape::Random:
+			return "random";
+		case DataShape::Text:
+			return "text";
+		case DataShape::Runs:
+			return "runs";
+		case DataShape::SaveRecords:
+			return "save records";
+		default:
+			return "unknown";
+		}
+	}
+
+	void AppendUint32(std::vector<uint8_t>& data, uint32_t value)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+		data.insert(data.end(), bytes, bytes + sizeof(value));
+	}
+
+	std::vector<uint8_t> CreateData(DataShape shape, size_t size, std::mt19937& random)
+	{
+		std::vector<uint8_t> data;
+		data.reserve(size + 64);
+
+		switch (shape)
+		{
+		case DataShape::Random:
+			while (data.size() < size)
+			{
+				AppendUint32(data, random());
+			}
+			break;
+		case DataShape::Text:
+		{
+			static const std::array<const char*, 12> words =
+			{
+				"park ", "and ", "ride ", "transit ", "switch ", "commute ",
+				"the ", "car ", "bus ", "subway ", "congestion ", "ordinance ",
+			};
+
+			std::uniform_int_distribution<size_t> wordDistribution(0, words.size() - 1);
+
+			while (data.size() < size)
+			{
+				const char* word = words[wordDistribution(random)];
+				data.insert(data.end(), word, word + std::strlen(word));
+			}
+			break;
+		}
+		case DataShape::Runs:
+		{
+			// Byte runs and short repeating patterns, which produce overlapping matches
+			// with offsets below 8.
+			std::uniform_int_distribution<uint32_t> lengthDistribution(1, 300);
+			std::uniform_int_distribution<uint32_t> periodDistribution(1, 7);
+
+			while (data.size() < size)
+			{
+				const uint32_t period = periodDistribution(random);
+				const uint32_t length = lengthDistribution(random);
+				const uint32_t pattern = random();
+
+				for (uint32_t i = 0; i < length; i++)
+				{
+					data.push_back(static_cast<uint8_t>(pattern >> ((i % period) % 4 * 8)) + static_cast<uint8_t>((i % period) / 4));
+				}
+			}
+			break;
+		}
+		case DataShape::SaveRecords:
+		default:
+		{
+			std::uniform_int_distribution<uint32_t> stepDistribution(0, 3);
+			uint32_t id = random();
+			uint32_t x = 0;
+			uint32_t z = 0;
+
+			while (data.size() < size)
+			{
+				id += 1;
+				x += stepDistribution(random);
+				z += stepDistribution(random);
+
+				AppendUint32(data, id);
+				AppendUint32(data, x);
+				AppendUint32(data, z);
+				AppendUint32(data, stepDistribution(random) == 0 ? 0x10 : 0);
+			}
+			break;
+		}
+		}
+
+		data.resize(size);
+		return data;
+	}
+
+	// Decodes the data with both decoders, they must agree on the result and the output.
+	bool DecodersAgree(const std::vector<uint8_t>& compressed, size_t outputSize, bool& decoded)
+	{
+		std::vector<uint8_t> fastOutput(outputSize);
+		std::vector<uint8_t> referenceOutput(outputSize);
+
+		const bool fastResult = QFSCompression::Decompress(compressed.data(), compressed.size(), fastOutput.data(), fastOutput.size());
+		const bool referenceResult = QFSCompression::DecompressReference(compressed.data(), compressed.size(), referenceOutput.data(), referenceOutput.size());
+
+		decoded = fastResult;
+
+		return fastResult == referenceResult && (!fastResult || fastOutput == referenceOutput);
+	}
+
+	bool RunFuzzTests(const BenchmarkOptions& options)
+	{
+		std::mt19937 random(0x0f5c0046);
+		std::uniform_int_distribution<uint32_t> shapeDistribution(0, static_cast<uint32_t>(DataShape::Count) - 1);
+		std::uniform_int_distribution<uint32_t> sizeDistribution(0, 70000);
+		std::vector<uint8_t> compressed;
+		uint32_t mutationsDecoded = 0;
+		uint32_t mutationsRejected = 0;
+
+		for (uint32_t i = 0; i < options.fuzzIterations; i++)
+		{
+			const DataShape shape = static_cast<DataShape>(shapeDistribution(random));
+			const std::vector<uint8_t> original = CreateData(shape, sizeDistribution(random), random);
+
+			if (!QFSCompression::Compress(original.data(), original.size(), compressed))
+			{
+				std::fprintf(stderr, "Iteration %u: %zu bytes of %s data could not be compressed.\n", i, original.size(), GetShapeName(shape));
+				return false;
+			}
+
+			std::vector<uint8_t> output;
+			std::vector<uint8_t> referenceOutput(original.size());
+
+			if (!QFSCompression::Decompress(compressed.data(), compressed.size(), output)
+				|| output != original
+				|| !QFSCompression::DecompressReference(compressed.data(), compressed.size(), referenceOutput.data(), referenceOutput.size())
+				|| referenceOutput != original)
+			{
+				std::fprintf(stderr, "Iteration %u: %zu bytes of %s data did not round-trip.\n", i, original.size(), GetShapeName(shape));
+				return false;
+			}
+
+			// Mutate the command stream, the header is kept so that both decoders run.
+			std::vector<uint8_t> mutated = compressed;
+			const size_t headerSize = 9;
+
+			if (mutated.size() > headerSize)
+			{
+				std::uniform_int_distribution<size_t> positionDistribution(headerSize, mutated.size() - 1);
+				const uint32_t mutationCount = 1 + (random() % 4);
+
+				for (uint32_t j = 0; j < mutationCount; j++)
+				{
+					mutated[positionDistribution(random)] = static_cast<uint8_t>(random());
+				}
+
+				if (random() % 4 == 0)
+				{
+					mutated.resize(positionDistribution(random));
+				}
+			}
+
+			bool decoded = false;
+
+			if (!DecodersAgree(mutated, original.size(), decoded))
+			{
+				std::fprintf(stderr, "Iteration %u: the decoders disagree on a mutated %s stream.\n", i, GetShapeName(shape));
+				return false;
+			}
+
+			decoded ? mutationsDecoded++ : mutationsRejected++;
+
+			// A random command stream after a valid header.
+			std::vector<uint8_t> noise(compressed.begin(), compressed.begin() + headerSize);
+			const std::vector<uint8_t> commands = CreateData(DataShape::Random, random() % 512, random);
+			noise.insert(noise.end(), commands.begin(), commands.end());
+
+			if (!DecodersAgree(noise, original.size(), decoded))
+			{
+				std::fprintf(stderr, "Iteration %u: the decoders disagree on a random command stream.\n", i);
+				return false;
+			}
+		}
+
+		std::printf(
+			"Fuzz tests passed: %u round-trips, %u mutated streams decoded and %u rejected by both decoders.\n",
+			options.fuzzIterations,
+			mutationsDecoded,
+			mutationsRejected);
+
+		return true;
+	}
+
+	bool MeasureShape(const BenchmarkOptions& options, DataShape shape)
+	{
+		std::mt19937 random(0x0f5c1046 + static_cast<uint32_t>(shape));
+		const uint64_t totalSize = static_cast<uint64_t>(options.megabytes) * 1024 * 1024;
+		const uint32_t entryCount = static_cast<uint32_t>((totalSize + options.entrySize - 1) / options.entrySize);
+
+		std::vector<std::vector<uint8_t>> entries(entryCount);
+		uint64_t compressedSize = 0;
+
+		for (std::vector<uint8_t>& entry : entries)
+		{
+			const std::vector<uint8_t> original = CreateData(shape, options.entrySize, random);
+
+			QFSCompression::Compress(original.data(), original.size(), entry);
+			compressedSize += entry.size();
+		}
+
+		std::vector<uint8_t> output(options.entrySize);
+		Stopwatch fastTime;
+		Stopwatch referenceTime;
+
+		fastTime.Start();
+
+		for (const std::vector<uint8_t>& entry : entries)
+		{
+			if (!QFSCompression::Decompress(entry.data(), entry.size(), output.data(), output.size()))
+			{
+				std::fprintf(stderr, "Failed to decompress the %s data.\n", GetShapeName(shape));
+				return false;
+			}
+		}
+
+		fastTime.Stop();
+		referenceTime.Start();
+
+		for (const std::vector<uint8_t>& entry : entries)
+		{
+			QFSCompression::DecompressReference(entry.data(), entry.size(), output.data(), output.size());
+		}
+
+		referenceTime.Stop();
+
+		const double megabytes = static_cast<double>(entryCount) * options.entrySize / (1024.0 * 1024.0);
+		const double fastSeconds = static_cast<double>(fastTime.ElapsedMicroseconds()) / 1000000.0;
+		const double referenceSeconds = static_cast<double>(referenceTime.ElapsedMicroseconds()) / 1000000.0;
+
+		std::printf(
+			"%-14s ratio %5.1f%%  fast %7.0f MB/s  reference %7.0f MB/s\n",
+			GetShapeName(shape),
+			100.0 * static_cast<double>(compressedSize) / (static_cast<double>(entryCount) * options.entrySize),
+			fastSeconds > 0.0 ? megabytes / fastSeconds : 0.0,
+			referenceSeconds > 0.0 ? megabytes / referenceSeconds : 0.0);
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--megabytes", "n", "The uncompressed size of the data of each shape", options.megabytes);
+	arguments.AddValue(
+		"--entry-size",
+		"bytes",
+		"The uncompressed size of each entry, at most 16 MB",
+		options.entrySize,
+		1,
+		0xffffff);
+	arguments.AddValue("--fuzz-iterations", "n", "The number of fuzz test iterations", options.fuzzIterations);
+	arguments.AddFlag("--verify-only", "Run the fuzz tests without the measurements", options.verifyOnly);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	if (!RunFuzzTests(options))
+	{
+		return 1;
+	}
+
+	if (!options.verifyOnly)
+	{
+		std::printf("Decompression speed of the uncompressed output:\n");
+
+		for (uint32_t i = 0; i < static_cast<uint32_t>(DataShape::Count); i++)
+		{
+			if (!MeasureShape(options, static_cast<DataShape>(i)))
+			{
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,273 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Writes a region folder of synthetic save games with different sizes, scans it with one
+// worker thread and with several, and checks that both scans report the ordinance state
+// and the traffic simulator tuning overrides that were written.
+//
+// The program exits with a non-zero status if a result differs from the expected state.
+
+#include "BenchmarkArguments.h"
+#include "MockRuntime.h"
+#include "MockSaveGame.h"
+#include "ParknRideOrdinance.h"
+#include "RegionScanner.h"
+#include "TrafficSimulatorTuning.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		uint32_t cities = 200;
+		uint32_t threads = 4;
+		uint32_t maxEntries = 200;
+	};
+
+	struct ExpectedCity
+	{
+		bool enacted;
+		bool trafficTuningOverride;
+	};
+
+	// A car restriction in the traffic simulator tuning exemplar, as a player would add to a save game.
+	std::vector<bool> GetOverrideValues()
+	{
+		std::vector<bool> values(TrafficSimulatorTuning::kTravelTypeCount, true);
+		values[TrafficSimulatorTuning::kCarTravelTypeIndex] = false;
+
+		return values;
+	}
+
+	bool WriteRegion(
+		const BenchmarkOptions& options,
+		const std::filesystem::path& folder,
+		const std::vector<uint8_t>& enactedState,
+		const std::vector<uint8_t>& repealedState,
+		std::vector<ExpectedCity>& expectedCities)
+	{
+		std::mt19937 random(0x5ca40047);
+		std::uniform_int_distribution<uint32_t> entryCountDistribution(10, options.maxEntries);
+		std::uniform_int_distribution<uint32_t> entrySizeDistribution(1024, 16384);
+
+		// The cities are split over two subfolders to check that the scan is recursive.
+		std::error_code ec;
+		std::filesystem::create_directories(folder / "Tiles", ec);
+
+		for (uint32_t city = 0; city < options.cities; city++)
+		{
+			const ExpectedCity expected{ (city % 3) == 0, (city % 5) == 0 };
+			const uint32_t entryCount = entryCountDistribution(random);
+			std::vector<MockSaveGame::Entry> entries;
+
+			for (uint32_t i = 0; i < entryCount; i++)
+			{
+				const bool compressed = (i % 2) == 0;
+				const size_t size = entrySizeDistribution(random);
+
+				entries.push_back(MockSaveGame::Entry
+				{
+					DBPFFile::ResourceKey{ 0x2990c1e5 + (i % 7), 0x0e9a5a4c, i },
+					compressed ? MockSaveGame::CreateRecordData(random, size) : MockSaveGame::CreateRandomData(random, size),
+					compressed,
+				});
+			}
+
+			const std::vector<uint8_t>& state = expected.enacted ? enactedState : repealedState;
+			MockSaveGame::Entry& ordinanceEntry = entries[entryCount / 2];
+			ordinanceEntry.data.insert(ordinanceEntry.data.end(), state.begin(), state.end());
+
+			if (expected.trafficTuningOverride)
+			{
+				entries.push_back(MockSaveGame::Entry
+				{
+					DBPFFile::ResourceKey
+					{
+						TrafficSimulatorTuning::kType,
+						TrafficSimulatorTuning::kGroup,
+						TrafficSimulatorTuning::kInstance,
+					},
+					MockSaveGame::CreateBoolArrayExemplar(TrafficSimulatorTuning::kTravelTypeCanReachDestination, GetOverrideValues()),
+					true,
+				});
+			}
+
+			char name[64]{};
+			std::snprintf(name, sizeof(name), "City - Synthetic %03u.sc4", city);
+
+			const std::filesystem::path path = ((city % 2) == 0 ? folder : folder / "Tiles") / name;
+
+			if (!MockSaveGame::WriteFile(path, MockSaveGame::BuildDBPF(entries)))
+			{
+				std::fprintf(stderr, "Failed to write %s.\n", path.string().c_str());
+				return false;
+			}
+
+			expectedCities.push_back(expected);
+		}
+
+		return true;
+	}
+
+	bool CheckResults(
+		const std::vector<std::filesystem::path>& paths,
+		const std::vector<RegionScanner::CityResult>& results,
+		const std::vector<ExpectedCity>& expectedCities)
+	{
+		if (results.size() != expectedCities.size())
+		{
+			std::fprintf(stderr, "The scan found %zu save games, expected %zu.\n", results.size(), expectedCities.size());
+			return false;
+		}
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const RegionScanner::CityResult& result = results[i];
+			// The paths are sorted by name, the city number is at the end of the file name.
+			const uint32_t city = static_cast<uint32_t>(std::atoi(paths[i].stem().string().c_str() + std::strlen("City - Synthetic ")));
+			const ExpectedCity& expected = expectedCities[city];
+
+			if (!result.readable
+				|| !result.ordinance.found
+				|| result.ordinance.state.on != expected.enacted
+				|| result.trafficTuning.present != expected.trafficTuningOverride
+				|| result.trafficTuning.valid != expected.trafficTuningOverride
+				|| (expected.trafficTuningOverride && result.trafficTuning.travelTypeCanReachDestination != GetOverrideValues()))
+			{
+				std::fprintf(stderr, "%s does not have the expected state.\n", result.path.string().c_str());
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool RunBenchmark(const BenchmarkOptions& options, const std::filesystem::path& folder)
+	{
+		MockRuntime runtime(MockRuntimeOptions{});
+		cISC4City* pCity = runtime.LoadCity();
+
+		ParknRideOrdinance ordinance;
+		ordinance.SetEnabled(true);
+
+		if (!ordinance.PostCityInit(pCity))
+		{
+			std::fprintf(stderr, "PostCityInit failed.\n");
+			return false;
+		}
+
+		ordinance.SetAvailable(true);
+
+		std::vector<uint8_t> repealedState;
+		std::vector<uint8_t> enactedState;
+
+		const bool serialized = MockSaveGame::SerializeOrdinance(ordinance, repealedState);
+		ordinance.SetOn(true);
+
+		if (!serialized || !MockSaveGame::SerializeOrdinance(ordinance, enactedState))
+		{
+			std::fprintf(stderr, "The ordinance could not be serialized.\n");
+			return false;
+		}
+
+		std::vector<ExpectedCity> expectedCities;
+
+		if (!WriteRegion(options, folder, enactedState, repealedState, expectedCities))
+		{
+			return false;
+		}
+
+		std::vector<std::filesystem::path> paths;
+
+		if (!RegionScanner::FindSaveGames(folder, paths))
+		{
+			std::fprintf(stderr, "Failed to list the save games.\n");
+			return false;
+		}
+
+		RegionScanner singleThreadScanner(1);
+		RegionScanner parallelScanner(options.threads);
+		std::vector<RegionScanner::CityResult> singleThreadResults;
+		std::vector<RegionScanner::CityResult> parallelResults;
+
+		singleThreadScanner.Scan(paths, singleThreadResults);
+		parallelScanner.Scan(paths, parallelResults);
+
+		if (!CheckResults(paths, singleThreadResults, expectedCities) || !CheckResults(paths, parallelResults, expectedCities))
+		{
+			return false;
+		}
+
+		// Both scans must produce the same summary.
+		std::ostringstream singleThreadJson;
+		std::ostringstream parallelJson;
+		RegionScanner::WriteJson(singleThreadJson, singleThreadResults);
+		RegionScanner::WriteJson(parallelJson, parallelResults);
+
+		if (singleThreadJson.str() != parallelJson.str())
+		{
+			std::fprintf(stderr, "The single thread and parallel summaries differ.\n");
+			return false;
+		}
+
+		const RegionScanner::Statistics& single = singleThreadScanner.GetStatistics();
+		const RegionScanner::Statistics& parallel = parallelScanner.GetStatistics();
+
+		std::printf(
+			"Scanned %zu synthetic save games (%.1f MB).\n"
+			"1 thread: %lld ms\n"
+			"%u threads: %lld ms, %llu save games stolen, %u hardware threads\n",
+			paths.size(),
+			static_cast<double>(single.totalBytes) / (1024.0 * 1024.0),
+			static_cast<long long>(single.elapsedMilliseconds),
+			parallel.threadCount,
+			static_cast<long long>(parallel.elapsedMilliseconds),
+			static_cast<unsigned long long>(parallel.stolenItems),
+			std::thread::hardware_concurrency());
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--cities", "n", "The number of save games", options.cities);
+	arguments.AddValue("--threads", "n", "The number of threads of the parallel scan", options.threads);
+	arguments.AddValue("--max-entries", "n", "The most entries in a save game, at least 10", options.maxEntries, 10);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	const std::filesystem::path folder = std::filesystem::temp_directory_path() / "RegionScannerBenchmark";
+
+	std::error_code ec;
+	std::filesystem::remove_all(folder, ec);
+	std::filesystem::create_directories(folder, ec);
+
+	const bool succeeded = RunBenchmark(options, folder);
+
+	std::filesystem::remove_all(folder, ec);
+
+	return succeeded ? 0 : 1;
+}
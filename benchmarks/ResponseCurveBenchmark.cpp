@@ -0,0 +1,375 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Compares the response curve lookup tables in ResponseCurve.cpp with interpolating
+// between the control points, and checks that the curve effects of an ordinance
+// property holder survive a save game round-trip.
+//
+// The program exits with a non-zero status if a table value differs from the control
+// point interpolation by more than 1% of the curve's value range, or if the curves read
+// from the saved data differ from the curves that were written.
+
+#include "BenchmarkArguments.h"
+#include "MockDBSegmentStream.h"
+#include "OrdinancePropertyHolder.h"
+#include "ResponseCurve.h"
+#include "Stopwatch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		uint32_t evaluations = 1000000;
+		uint32_t randomCurves = 1000;
+	};
+
+	struct NamedCurve
+	{
+		const char* name;
+		std::vector<float> controlPoints;
+	};
+
+	// Curves with the shapes that the game's exemplars use.
+	std::vector<NamedCurve> CreateExemplarCurves()
+	{
+		return std::vector<NamedCurve>
+		{
+			{ "linear", { 0.0f, 0.0f, 100.0f, 1.0f } },
+			{ "distance falloff", { 0.0f, 100.0f, 16.0f, 80.0f, 48.0f, 25.0f, 128.0f, 0.0f } },
+			{ "effectiveness vs. funding", { 0.0f, 0.0f, 0.5f, 0.4f, 1.0f, 1.0f, 1.25f, 1.1f, 2.0f, 1.15f } },
+			{ "step", { 0.0f, 0.0f, 10.0f, 0.0f, 10.5f, 1.0f, 20.0f, 1.0f } },
+		};
+	}
+
+	std::vector<float> CreateRandomCurve(std::mt19937& random)
+	{
+		std::uniform_int_distribution<uint32_t> pointCounts(2, 8);
+		std::uniform_real_distribution<float> starts(-1000.0f, 1000.0f);
+		std::uniform_real_distribution<float> spans(1.0f, 5000.0f);
+		std::uniform_real_distribution<float> values(-500.0f, 500.0f);
+
+		const uint32_t pointCount = pointCounts(random);
+		const float startX = starts(random);
+		const float span = spans(random);
+
+		// The control points are spread evenly with some jitter, which keeps the intervals
+		// at least 1/16 of the curve width like the hand-made exemplar curves.
+		std::vector<float> controlPoints;
+		controlPoints.reserve(pointCount * 2);
+
+		for (uint32_t i = 0; i < pointCount; i++)
+		{
+			float position = static_cast<float>(i) / static_cast<float>(pointCount - 1);
+
+			if (i > 0 && i + 1 < pointCount)
+			{
+				std::uniform_real_distribution<float> jitter(-0.25f, 0.25f);
+				position += jitter(random) / static_cast<float>(pointCount - 1);
+			}
+
+			controlPoints.push_back(startX + position * span);
+			controlPoints.push_back(values(random));
+		}
+
+		return controlPoints;
+	}
+
+	float GetValueRange(const std::vector<float>& controlPoints)
+	{
+		float minY = controlPoints[1];
+		float maxY = controlPoints[1];
+
+		for (size_t i = 3; i < controlPoints.size(); i += 2)
+		{
+			minY = std::min(minY, controlPoints[i]);
+			maxY = std::max(maxY, controlPoints[i]);
+		}
+
+		return maxY - minY;
+	}
+
+	// Returns the largest difference between the table and the control point interpolation,
+	// as a fraction of the curve's value range.
+	double MeasureMaxError(const ResponseCurve& curve, uint32_t samples)
+	{
+		const std::vector<float>& controlPoints = curve.GetControlPoints();
+		const float minX = controlPoints.front();
+		const float maxX = controlPoints[controlPoints.size() - 2];
+		const float width = maxX - minX;
+		const float range = GetValueRange(controlPoints);
+
+		double maxError = 0.0;
+
+		for (uint32_t i = 0; i <= samples; i++)
+		{
+			// The samples include a margin on both sides to check the clamping.
+			const float x = minX - 0.1f * width + (1.2f * width * static_cast<float>(i)) / static_cast<float>(samples);
+			const double error = std::fabs(static_cast<double>(curve.Evaluate(x)) - curve.EvaluateControlPoints(x));
+
+			maxError = std::max(maxError, range > 0.0f ? error / range : error);
+		}
+
+		return maxError;
+	}
+
+	bool CheckAccuracy(const BenchmarkOptions& options, std::mt19937& random)
+	{
+		constexpr double MaxRelativeError = 0.01;
+		constexpr uint32_t SamplesPerCurve = 4096;
+
+		for (const NamedCurve& item : CreateExemplarCurves())
+		{
+			ResponseCurve curve;
+
+			if (!curve.SetControlPoints(item.controlPoints.data(), static_cast<uint32_t>(item.controlPoints.size() / 2)))
+			{
+				std::fprintf(stderr, "The %s curve was rejected.\n", item.name);
+				return false;
+			}
+
+			const double maxError = MeasureMaxError(curve, SamplesPerCurve);
+
+			std::printf("%-26s max error %.4f%% of the value range\n", item.name, maxError * 100.0);
+
+			if (maxError > MaxRelativeError)
+			{
+				std::fprintf(stderr, "The %s curve table error is over %.1f%%.\n", item.name, MaxRelativeError * 100.0);
+				return false;
+			}
+		}
+
+		double maxRandomError = 0.0;
+
+		for (uint32_t i = 0; i < options.randomCurves; i++)
+		{
+			const std::vector<float> controlPoints = CreateRandomCurve(random);
+			ResponseCurve curve;
+
+			if (!curve.SetControlPoints(controlPoints.data(), static_cast<uint32_t>(controlPoints.size() / 2)))
+			{
+				std::fprintf(stderr, "Random curve %u was rejected.\n", i);
+				return false;
+			}
+
+			maxRandomError = std::max(maxRandomError, MeasureMaxError(curve, SamplesPerCurve));
+		}
+
+		std::printf("%u random curves: max error %.4f%% of the value range\n", options.randomCurves, maxRandomError * 100.0);
+
+		if (maxRandomError > MaxRelativeError)
+		{
+			std::fprintf(stderr, "The random curve table error is over %.1f%%.\n", MaxRelativeError * 100.0);
+			return false;
+		}
+
+		// Unsorted control points must be rejected.
+		const float unsorted[] = { 0.0f, 1.0f, 10.0f, 2.0f, 5.0f, 3.0f };
+		ResponseCurve rejected;
+
+		if (rejected.SetControlPoints(unsorted, 3) || !rejected.IsEmpty())
+		{
+			std::fprintf(stderr, "A curve with unsorted control points was accepted.\n");
+			return false;
+		}
+
+		return true;
+	}
+
+	void MeasureSpeed(const BenchmarkOptions& options, std::mt19937& random)
+	{
+		const NamedCurve item = CreateExemplarCurves()[2];
+		ResponseCurve curve;
+		curve.SetControlPoints(item.controlPoints.data(), static_cast<uint32_t>(item.controlPoints.size() / 2));
+
+		std::uniform_real_distribution<float> inputs(-0.25f, 2.25f);
+		std::vector<float> xValues(options.evaluations);
+
+		for (float& x : xValues)
+		{
+			x = inputs(random);
+		}
+
+		// The sums keep the compiler from removing the loops.
+		double controlPointSum = 0.0;
+		Stopwatch controlPointTime;
+		controlPointTime.Start();
+
+		for (const float x : xValues)
+		{
+			controlPointSum += curve.EvaluateControlPoints(x);
+		}
+
+		controlPointTime.Stop();
+
+		double tableSum = 0.0;
+		Stopwatch tableTime;
+		tableTime.Start();
+
+		for (const float x : xValues)
+		{
+			tableSum += curve.Evaluate(x);
+		}
+
+		tableTime.Stop();
+
+		const int64_t controlPointMicroseconds = controlPointTime.ElapsedMicroseconds();
+		const int64_t tableMicroseconds = tableTime.ElapsedMicroseconds();
+
+		std::printf(
+			"%u evaluations of a %zu point curve: control points %lld us, table %lld us (%.1fx faster), sums %.1f / %.1f\n",
+			options.evaluations,
+			item.controlPoints.size() / 2,
+			static_cast<long long>(controlPointMicroseconds),
+			static_cast<long long>(tableMicroseconds),
+			static_cast<double>(controlPointMicroseconds) / static_cast<double>(std::max<int64_t>(tableMicroseconds, 1)),
+			controlPointSum,
+			tableSum);
+	}
+
+	bool CurvesMatch(const ResponseCurve* pExpected, const ResponseCurve* pActual)
+	{
+		if (!pExpected || !pActual || pExpected->GetControlPoints() != pActual->GetControlPoints())
+		{
+			return false;
+		}
+
+		const std::vector<float>& controlPoints = pExpected->GetControlPoints();
+		const float minX = controlPoints.front();
+		const float maxX = controlPoints[controlPoints.size() - 2];
+
+		for (uint32_t i = 0; i <= 100; i++)
+		{
+			const float x = minX + (maxX - minX) * static_cast<float>(i) / 100.0f;
+
+			if (pExpected->Evaluate(x) != pActual->Evaluate(x))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool CheckSerialization()
+	{
+		constexpr uint32_t kScalarEffect = 0x1000;
+		constexpr uint32_t kFirstCurveEffect = 0x2000;
+		constexpr uint32_t kSecondCurveEffect = 0x2001;
+
+		const std::vector<NamedCurve> curves = CreateExemplarCurves();
+
+		OrdinancePropertyHolder original;
+		original.AddProperty(kScalarEffect, 1.5f);
+
+		if (!original.AddCurveProperty(kFirstCurveEffect, curves[1].controlPoints.data(), static_cast<uint32_t>(curves[1].controlPoints.size() / 2))
+			|| !original.AddCurveProperty(kSecondCurveEffect, curves[2].controlPoints.data(), static_cast<uint32_t>(curves[2].controlPoints.size() / 2)))
+		{
+			std::fprintf(stderr, "AddCurveProperty failed.\n");
+			return false;
+		}
+
+		MockDBSegmentStream stream;
+
+		if (!original.Write(static_cast<cISC4DBSegmentOStream&>(stream)))
+		{
+			std::fprintf(stderr, "The property holder could not be written.\n");
+			return false;
+		}
+
+		OrdinancePropertyHolder loaded;
+		stream.Rewind();
+
+		if (!loaded.Read(static_cast<cISC4DBSegmentIStream&>(stream)) || !stream.IsAtEnd())
+		{
+			std::fprintf(stderr, "The property holder could not be read.\n");
+			return false;
+		}
+
+		float scalarValue = 0.0f;
+
+		if (!loaded.GetFloatValue(kScalarEffect, scalarValue) || scalarValue != 1.5f)
+		{
+			std::fprintf(stderr, "The scalar effect was not restored.\n");
+			return false;
+		}
+
+		if (!CurvesMatch(original.GetCurve(kFirstCurveEffect), loaded.GetCurve(kFirstCurveEffect))
+			|| !CurvesMatch(original.GetCurve(kSecondCurveEffect), loaded.GetCurve(kSecondCurveEffect)))
+		{
+			std::fprintf(stderr, "The curve effects were not restored.\n");
+			return false;
+		}
+
+		// Removing a curve property must also remove its table.
+		if (!loaded.RemoveProperty(kFirstCurveEffect) || loaded.GetCurve(kFirstCurveEffect) || !loaded.GetCurve(kSecondCurveEffect))
+		{
+			std::fprintf(stderr, "RemoveProperty did not remove the curve.\n");
+			return false;
+		}
+
+		// A holder without curves is written in the original format.
+		OrdinancePropertyHolder scalarOnly;
+		scalarOnly.AddProperty(kScalarEffect, 1.5f);
+
+		MockDBSegmentStream scalarStream;
+		scalarOnly.Write(static_cast<cISC4DBSegmentOStream&>(scalarStream));
+
+		uint32_t version = 0;
+		std::memcpy(&version, scalarStream.GetBuffer().data(), sizeof(version));
+
+		if (version != 1)
+		{
+			std::fprintf(stderr, "A holder without curves was written as version %u.\n", version);
+			return false;
+		}
+
+		std::printf(
+			"Serialization: %zu bytes with 2 curves, %zu bytes without curves\n",
+			stream.GetBuffer().size(),
+			scalarStream.GetBuffer().size());
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--evaluations", "n", "The number of curve evaluations that are timed", options.evaluations);
+	arguments.AddValue("--random-curves", "n", "The number of random curves that are checked", options.randomCurves);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	std::mt19937 random(0xc0e);
+
+	if (!CheckAccuracy(options, random) || !CheckSerialization())
+	{
+		return 1;
+	}
+
+	MeasureSpeed(options, random);
+
+	return 0;
+}
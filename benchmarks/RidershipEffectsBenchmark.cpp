@@ -0,0 +1,332 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Checks that the ordinance effect values follow the transit ridership and congestion relief,
+// and measures the cost of the monthly effect update.
+//
+// Each simulated month moves more trips to the transit switches and lowers the congestion,
+// the effect values must match the strength that the benchmark computes from the mock maps.
+// The update must write the existing property values without allocating memory.
+
+#include "BenchmarkArguments.h"
+#include "CongestionMonitor.h"
+#include "MockRuntime.h"
+#include "ParknRideOrdinance.h"
+#include "RidershipMeter.h"
+#include "Settings.h"
+#include "Stopwatch.h"
+#include "TrafficTuningCoordinator.h"
+#include "TransitSwitchIndex.h"
+#include "cRZBaseString.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+namespace
+{
+	std::atomic<uint64_t> allocationCount(0);
+}
+
+void* operator new(size_t size)
+{
+	allocationCount++;
+
+	void* ptr = std::malloc(size > 0 ? size : 1);
+
+	if (!ptr)
+	{
+		throw std::bad_alloc();
+	}
+
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+namespace
+{
+	constexpr uint32_t kParticipantID = 0x4d1f70a2;
+	constexpr uint32_t kBusTravelType = 2;
+	constexpr uint32_t kTransitSwitchCapacity = 1000;
+	constexpr uint32_t kCommercialDemandEffect = 0x2a633000;
+	constexpr uint32_t kHealthQuotientBoostEffect = 0xe91b3aee;
+
+	struct BenchmarkOptions
+	{
+		uint32_t cityCellCount = 256;
+		uint32_t months = 120;
+		uint32_t transitSwitches = 200;
+	};
+
+	void FillCongestionMap(MockSimGrid<uint8_t>* map, std::mt19937& random)
+	{
+		std::uniform_int_distribution<int> percentages(0, 99);
+		std::uniform_int_distribution<int> values(64, 255);
+
+		for (uint8_t& value : map->GetValues())
+		{
+			value = percentages(random) < 30 ? static_cast<uint8_t>(values(random)) : 0;
+		}
+	}
+
+	double GetAverage(const std::vector<uint8_t>& values)
+	{
+		uint64_t sum = 0;
+
+		for (uint8_t value : values)
+		{
+			sum += value;
+		}
+
+		return values.empty() ? 0.0 : static_cast<double>(sum) / static_cast<double>(values.size());
+	}
+
+	// The strength that the ordinance is expected to use, see ParknRideOrdinance::GetEffectStrength.
+	float GetExpectedStrength(uint32_t arrived, double baselineCongestion, double averageCongestion)
+	{
+		const double ridership = std::min((static_cast<double>(arrived) / kTransitSwitchCapacity) / 0.5, 1.0);
+		const double relief = std::clamp(((baselineCongestion - averageCongestion) / baselineCongestion) / 0.25, 0.0, 1.0);
+
+		return static_cast<float>((ridership + relief) * 0.5);
+	}
+
+	float GetFloatProperty(ParknRideOrdinance& ordinance, uint32_t propertyID)
+	{
+		float value = 0.0f;
+		cISCProperty* pProperty = ordinance.GetMiscProperties()->GetProperty(propertyID);
+
+		if (pProperty)
+		{
+			pProperty->GetPropertyValue()->GetValFloat32(value);
+			pProperty->Release();
+		}
+
+		return value;
+	}
+
+	struct MonthlyCost
+	{
+		int64_t microseconds;
+		uint64_t allocations;
+	};
+
+	MonthlyCost SimulateMonth(MockRuntime& runtime, ParknRideOrdinance& ordinance)
+	{
+		runtime.AdvanceSimDate(30);
+		runtime.Tick();
+
+		Stopwatch stopwatch;
+		const uint64_t allocationsBefore = allocationCount;
+
+		stopwatch.Start();
+		ordinance.Simulate();
+		stopwatch.Stop();
+
+		return MonthlyCost{ stopwatch.ElapsedMicroseconds(), allocationCount - allocationsBefore };
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--city-size", "cells", "The city width and height in cells", options.cityCellCount);
+	arguments.AddValue("--months", "n", "The simulated months with the ordinance enacted, at least 2", options.months, 2);
+	arguments.AddValue("--transit-switches", "n", "The transit switches in the city", options.transitSwitches);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	MockRuntimeOptions runtimeOptions;
+	runtimeOptions.cityCellCount = options.cityCellCount;
+	runtimeOptions.messageCostNanoseconds = 0;
+	runtimeOptions.trafficSimulatorShutdownCostNanoseconds = 0;
+	runtimeOptions.trafficSimulatorInitCostNanoseconds = 0;
+	runtimeOptions.trafficSimulatorMessageCostNanoseconds = 0;
+
+	MockRuntime runtime(runtimeOptions);
+
+	TrafficTuningCoordinator coordinator;
+	coordinator.RegisterParticipant(kParticipantID, cRZBaseString("RidershipEffectsBenchmark"));
+
+	ParknRideOrdinance ordinance;
+	ordinance.SetTuningCoordinator(&coordinator, kParticipantID);
+	ordinance.SetImpactReportMonths(0);
+
+	cISC4City* pCity = runtime.LoadCity();
+	MockTrafficSimulator& trafficSimulator = runtime.GetTrafficSimulator();
+
+	std::mt19937 random(0x6b2d19);
+	FillCongestionMap(trafficSimulator.GetMockCongestionMap(), random);
+
+	for (uint32_t i = 0; i < options.transitSwitches; i++)
+	{
+		trafficSimulator.AddTransitSwitch();
+		trafficSimulator.SetTransitSwitchTraffic(i, kBusTravelType, kTransitSwitchCapacity, 0);
+	}
+
+	// Each simulated day reads every transit switch and the whole congestion map, so the
+	// running totals match the mock maps when the month is simulated.
+	Settings settings;
+	settings.transitSwitchesPerDay = options.transitSwitches;
+	settings.congestionTractsPerDay = UINT32_MAX;
+
+	TransitSwitchIndex index;
+	RidershipMeter meter;
+	CongestionMonitor monitor;
+
+	if (!index.Build(pCity)
+		|| !meter.Start(pCity, &index, settings)
+		|| !monitor.Start(pCity, &ordinance, settings, /*autoMode*/false)
+		|| !ordinance.PostCityInit(pCity))
+	{
+		std::fprintf(stderr, "PostCityInit failed.\n");
+		return 1;
+	}
+
+	ordinance.SetAvailable(true);
+	ordinance.SetTransitSwitchIndex(&index);
+	ordinance.UpdateCarCanReachDestination(/*calledFromPostCityInit*/true);
+	runtime.Tick();
+
+	const float fullCommercialDemand = GetFloatProperty(ordinance, kCommercialDemandEffect);
+	const float fullHealthBoost = GetFloatProperty(ordinance, kHealthQuotientBoostEffect);
+	cISCProperty* pCommercialDemand = ordinance.GetMiscProperties()->GetProperty(kCommercialDemandEffect);
+	const cIGZVariant* pCommercialDemandValue = pCommercialDemand->GetPropertyValue();
+
+	// The cost of a month without the scaled effects, which is subtracted from the enacted months.
+	MonthlyCost fixedCost{};
+
+	for (uint32_t i = 0; i < options.months; i++)
+	{
+		const MonthlyCost cost = SimulateMonth(runtime, ordinance);
+		fixedCost.microseconds += cost.microseconds;
+		fixedCost.allocations += cost.allocations;
+	}
+
+	ordinance.SetRidershipScaledEffects(&meter, &monitor);
+
+	// The baseline is the congestion of the last month before the car restriction.
+	SimulateMonth(runtime, ordinance);
+	const double baselineCongestion = GetAverage(trafficSimulator.GetMockCongestionMap()->GetValues());
+
+	ordinance.SetOn(true);
+	runtime.Tick();
+
+	MonthlyCost scaledCost{};
+	uint32_t mismatches = 0;
+
+	for (uint32_t month = 0; month < options.months; month++)
+	{
+		// The ridership and congestion relief grow for the first half of the run, and then stay level.
+		const double progress = std::min(static_cast<double>(month + 1) / (options.months / 2), 1.0);
+		const uint32_t arrived = static_cast<uint32_t>(progress * (kTransitSwitchCapacity / 2));
+
+		for (uint32_t i = 0; i < options.transitSwitches; i++)
+		{
+			trafficSimulator.SetTransitSwitchTraffic(i, kBusTravelType, kTransitSwitchCapacity, arrived);
+		}
+
+		for (uint8_t& value : trafficSimulator.GetMockCongestionMap()->GetValues())
+		{
+			value = static_cast<uint8_t>((value * 97) / 100);
+		}
+
+		const MonthlyCost cost = SimulateMonth(runtime, ordinance);
+		scaledCost.microseconds += cost.microseconds;
+		scaledCost.allocations += cost.allocations;
+
+		const float expected = GetExpectedStrength(
+			arrived,
+			baselineCongestion,
+			GetAverage(trafficSimulator.GetMockCongestionMap()->GetValues()));
+		const float commercialDemand = GetFloatProperty(ordinance, kCommercialDemandEffect);
+		const float healthBoost = GetFloatProperty(ordinance, kHealthQuotientBoostEffect);
+
+		if (std::fabs(ordinance.GetCurrentEffectStrength() - expected) > 1e-4f
+			|| std::fabs(commercialDemand - (1.0f + ((fullCommercialDemand - 1.0f) * expected))) > 1e-4f
+			|| std::fabs(healthBoost - (100.0f + ((fullHealthBoost - 100.0f) * expected))) > 1e-3f)
+		{
+			mismatches++;
+		}
+	}
+
+	const bool sameVariant = ordinance.GetMiscProperties()->GetProperty(kCommercialDemandEffect) == pCommercialDemand
+		&& pCommercialDemand->GetPropertyValue() == pCommercialDemandValue;
+
+	// Release the two GetProperty references.
+	pCommercialDemand->Release();
+	pCommercialDemand->Release();
+
+	std::printf(
+		"%u transit switches, %ux%u city, %u months, final strength %.3f (Commercial Demand %.4f)\n",
+		options.transitSwitches,
+		options.cityCellCount,
+		options.cityCellCount,
+		options.months,
+		ordinance.GetCurrentEffectStrength(),
+		GetFloatProperty(ordinance, kCommercialDemandEffect));
+	std::printf(
+		"month without scaled effects %.2f us, with scaled effects %.2f us, effect update %.2f us/month\n",
+		static_cast<double>(fixedCost.microseconds) / options.months,
+		static_cast<double>(scaledCost.microseconds) / options.months,
+		static_cast<double>(scaledCost.microseconds - fixedCost.microseconds) / options.months);
+	std::printf(
+		"allocations per month: without scaled effects %.2f, with scaled effects %.2f\n",
+		static_cast<double>(fixedCost.allocations) / options.months,
+		static_cast<double>(scaledCost.allocations) / options.months);
+
+	bool succeeded = true;
+
+	if (mismatches != 0)
+	{
+		std::fprintf(stderr, "%u months had effect values that do not match the ridership.\n", mismatches);
+		succeeded = false;
+	}
+
+	if (!sameVariant)
+	{
+		std::fprintf(stderr, "The effect property was replaced instead of updated in place.\n");
+		succeeded = false;
+	}
+
+	if (scaledCost.allocations > fixedCost.allocations)
+	{
+		std::fprintf(stderr, "The effect update allocated memory.\n");
+		succeeded = false;
+	}
+
+	ordinance.SetRidershipScaledEffects(nullptr, nullptr);
+	ordinance.PreCityShutdown(pCity);
+	monitor.Stop();
+	meter.Stop();
+	index.Clear();
+	runtime.UnloadCity();
+
+	return succeeded ? 0 : 1;
+}
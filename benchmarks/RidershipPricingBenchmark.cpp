@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Measures the query path of the ridership-based ordinance cost.
+//
+// The ridership meter reads a few transit switches per simulated day and the transit switch
+// index keeps the city-wide totals, so the budget query only multiplies the totals. The
+// benchmark compares that with reading every transit switch from the traffic simulator on
+// each query, and checks that the cost follows the traffic after a full sampling pass.
+
+#include "BenchmarkArguments.h"
+#include "MockRuntime.h"
+#include "ParknRideOrdinance.h"
+#include "RidershipMeter.h"
+#include "Settings.h"
+#include "Stopwatch.h"
+#include "TransitSwitchIndex.h"
+#include "cISC4Occupant.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+	constexpr uint32_t kTravelTypeCount = 9;
+	constexpr uint32_t kCostPerThousandTrips = 20;
+	constexpr float kTripScale = 2.5f;
+
+	struct BenchmarkOptions
+	{
+		uint32_t transitSwitches = 400;
+		uint32_t switchesPerDay = 32;
+		uint32_t days = 360;
+		uint32_t queryCost = 200;
+	};
+
+	void SetRandomTraffic(MockTrafficSimulator& trafficSimulator, std::mt19937& random)
+	{
+		std::uniform_int_distribution<uint32_t> arrivedValues(0, 400);
+
+		for (size_t i = 0; i < trafficSimulator.GetTransitSwitchCount(); i++)
+		{
+			for (uint32_t travelType = 0; travelType < kTravelTypeCount; travelType++)
+			{
+				trafficSimulator.SetTransitSwitchTraffic(i, travelType, 500, arrivedValues(random));
+			}
+		}
+	}
+
+	// Computes the cost the way a query would without the meter, by reading every transit switch.
+	int64_t CalculateCostFromTrafficSimulator(MockTrafficSimulator& trafficSimulator)
+	{
+		cISC4TrafficSimulator* pTrafficSimulator = &trafficSimulator;
+		uint64_t arrived = 0;
+
+		for (size_t i = 0; i < trafficSimulator.GetTransitSwitchCount(); i++)
+		{
+			cISCPropertyHolder* pPropertyHolder = trafficSimulator.GetTransitSwitchOccupant(i).AsPropertyHolder();
+
+			for (uint32_t travelType = 0; travelType < kTravelTypeCount; travelType++)
+			{
+				arrived += pTrafficSimulator->GetTrafficArrived(pPropertyHolder, travelType);
+			}
+		}
+
+		const double trips = static_cast<double>(arrived) * static_cast<double>(pTrafficSimulator->GetTripScale());
+
+		return -static_cast<int64_t>((trips / 1000.0) * kCostPerThousandTrips);
+	}
+
+	bool RunBenchmark(const BenchmarkOptions& options)
+	{
+		MockRuntimeOptions runtimeOptions;
+		runtimeOptions.messageCostNanoseconds = 0;
+		runtimeOptions.trafficSimulatorShutdownCostNanoseconds = 0;
+		runtimeOptions.trafficSimulatorInitCostNanoseconds = 0;
+		runtimeOptions.trafficSimulatorMessageCostNanoseconds = 0;
+
+		MockRuntime runtime(runtimeOptions);
+		cISC4City* pCity = runtime.LoadCity();
+		MockTrafficSimulator& trafficSimulator = runtime.GetTrafficSimulator();
+		std::mt19937 random(0x7a11c5);
+
+		trafficSimulator.SetMonthlyStatistics(kTripScale, 0.0f, 1.0f);
+
+		for (uint32_t i = 0; i < options.transitSwitches; i++)
+		{
+			trafficSimulator.AddTransitSwitch();
+		}
+
+		SetRandomTraffic(trafficSimulator, random);
+
+		Settings settings;
+		settings.transitSwitchesPerDay = options.switchesPerDay;
+
+		TransitSwitchIndex index;
+		RidershipMeter meter;
+		ParknRideOrdinance ordinance;
+
+		if (!index.Build(pCity) || !meter.Start(pCity, &index, settings) || !ordinance.PostCityInit(pCity))
+		{
+			std::fprintf(stderr, "The ridership meter could not be started.\n");
+			return false;
+		}
+
+		ordinance.SetRidershipPricing(&meter, kCostPerThousandTrips, 0);
+		ordinance.SetAvailable(true);
+
+		if (ordinance.GetCurrentMonthlyIncome() != CalculateCostFromTrafficSimulator(trafficSimulator))
+		{
+			std::fprintf(stderr, "The initial cost %lld differs from the traffic simulator cost %lld.\n",
+				static_cast<long long>(ordinance.GetCurrentMonthlyIncome()),
+				static_cast<long long>(CalculateCostFromTrafficSimulator(trafficSimulator)));
+			return false;
+		}
+
+		trafficSimulator.SetTransitSwitchQueryCost(options.queryCost);
+
+		Stopwatch samplingTime;
+		Stopwatch queryTime;
+		Stopwatch trafficSimulatorQueryTime;
+		const uint32_t daysPerPass = (options.transitSwitches + options.switchesPerDay - 1) / options.switchesPerDay;
+		int64_t trafficSimulatorCost = 0;
+
+		for (uint32_t day = 0; day < options.days; day++)
+		{
+			// The traffic changes at the start of every sampling pass, the cost must
+			// match it once the meter has read every switch again.
+			if (day % daysPerPass == 0)
+			{
+				SetRandomTraffic(trafficSimulator, random);
+			}
+
+			runtime.AdvanceSimDate(1);
+
+			samplingTime.Start();
+			runtime.Tick();
+			samplingTime.Stop();
+
+			// The first query on each date computes the cost, the later queries on the same date reuse it.
+			queryTime.Start();
+			const int64_t income = ordinance.GetCurrentMonthlyIncome();
+			queryTime.Stop();
+
+			trafficSimulatorQueryTime.Start();
+			trafficSimulatorCost = CalculateCostFromTrafficSimulator(trafficSimulator);
+			trafficSimulatorQueryTime.Stop();
+
+			if ((day + 1) % daysPerPass == 0 && income != trafficSimulatorCost)
+			{
+				std::fprintf(
+					stderr,
+					"Day %u: the cost after a full sampling pass is %lld, the traffic simulator cost is %lld.\n",
+					day,
+					static_cast<long long>(income),
+					static_cast<long long>(trafficSimulatorCost));
+				return false;
+			}
+		}
+
+		// The monthly cost limit caps the cost.
+		ordinance.SetRidershipPricing(&meter, kCostPerThousandTrips, 100);
+
+		if (ordinance.GetCurrentMonthlyIncome() != std::max<int64_t>(trafficSimulatorCost, -100))
+		{
+			std::fprintf(stderr, "The cost limit was not applied.\n");
+			return false;
+		}
+
+		const int64_t samplingMicroseconds = samplingTime.ElapsedMicroseconds();
+		const int64_t queryMicroseconds = queryTime.ElapsedMicroseconds();
+		const int64_t trafficSimulatorMicroseconds = trafficSimulatorQueryTime.ElapsedMicroseconds();
+
+		std::printf(
+			"%u transit switches, %u per day, %u days: %llu switch reads, sampling %.2f us/day\n",
+			options.transitSwitches,
+			options.switchesPerDay,
+			options.days,
+			static_cast<unsigned long long>(meter.GetSampledSwitchCount()),
+			static_cast<double>(samplingMicroseconds) / options.days);
+		std::printf(
+			"Cost query: meter %.3f us, reading every transit switch %.2f us (%.0fx faster)\n",
+			static_cast<double>(queryMicroseconds) / options.days,
+			static_cast<double>(trafficSimulatorMicroseconds) / options.days,
+			static_cast<double>(trafficSimulatorMicroseconds) / static_cast<double>(std::max<int64_t>(queryMicroseconds, 1)));
+
+		ordinance.PreCityShutdown(pCity);
+		meter.Stop();
+		index.Clear();
+		runtime.UnloadCity();
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--transit-switches", "n", "The transit switches in the city", options.transitSwitches);
+	arguments.AddValue("--switches-per-day", "n", "The transit switches that the meter reads per day", options.switchesPerDay);
+	arguments.AddValue("--days", "n", "The simulated days", options.days);
+	arguments.AddValue("--query-cost", "ns", "The cost of a traffic simulator transit switch query", options.queryCost);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	return RunBenchmark(options) ? 0 : 1;
+}
@@ -0,0 +1,264 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Runs the rush hour scheduler against the mock 24-hour clock and checks that the car
+// restriction follows the commuter windows without restarting or pausing the traffic
+// simulator, then reports the cost of each switch.
+//
+// A second run uses a switch budget below the tunables reload cost, which must make the
+// scheduler fall back to one restriction span per day.
+
+#include "BenchmarkArguments.h"
+#include "MockRuntime.h"
+#include "ParknRideOrdinance.h"
+#include "RushHourScheduler.h"
+#include "Settings.h"
+#include "TrafficTuningCoordinator.h"
+#include "cIGZVariant.h"
+#include "cISCProperty.h"
+#include "cISCPropertyHolder.h"
+#include "cRZBaseString.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t kParticipantID = 0x8b8d3b1a;
+	constexpr uint32_t kTravelTypeCanReachDestination = 0xA92356B5;
+	constexpr uint32_t kCarTravelTypeIndex = 1;
+
+	// 7-9,16-19
+	constexpr uint32_t kCommuterHourMask = (1u << 7) | (1u << 8) | (1u << 16) | (1u << 17) | (1u << 18);
+	// 7-19
+	constexpr uint32_t kDailySpanMask = ((1u << 19) - 1) & ~((1u << 7) - 1);
+
+	struct BenchmarkOptions
+	{
+		uint32_t days = 30;
+		int64_t reloadCostNanoseconds = 100000;
+		uint32_t budgetMicroseconds = 5000;
+	};
+
+	bool GetCarCanReachDestination(MockRuntime& runtime, bool& value)
+	{
+		cISCProperty* property = runtime.GetTrafficTuningExemplar()->GetProperty(kTravelTypeCanReachDestination);
+
+		if (property)
+		{
+			cIGZVariant* data = property->GetPropertyValue();
+
+			if (data && data->GetCount() > kCarTravelTypeIndex)
+			{
+				value = data->RefBool()[kCarTravelTypeIndex];
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	struct RunResult
+	{
+		bool succeeded;
+		bool dailyFallbackActive;
+		uint32_t switchCount;
+		uint32_t lastDaySwitchCount;
+		int64_t lastSwitchMicroseconds;
+		int64_t maxSwitchMicroseconds;
+		uint32_t restartCount;
+		uint32_t hiddenPauseCount;
+	};
+
+	// Steps the clock through every hour of the specified number of days and checks the
+	// tuning exemplar after each hour. The last day must follow the expected hour mask.
+	RunResult Run(const BenchmarkOptions& options, uint32_t budgetMicroseconds, uint32_t expectedLastDayMask)
+	{
+		RunResult result{};
+
+		MockRuntimeOptions runtimeOptions;
+		runtimeOptions.messageCostNanoseconds = 0;
+		runtimeOptions.trafficSimulatorMessageCostNanoseconds = options.reloadCostNanoseconds;
+
+		MockRuntime runtime(runtimeOptions);
+
+		TrafficTuningCoordinator coordinator;
+		coordinator.RegisterParticipant(kParticipantID, cRZBaseString("RushHourBenchmark"));
+
+		ParknRideOrdinance ordinance;
+		ordinance.SetTuningCoordinator(&coordinator, kParticipantID);
+		ordinance.SetImpactReportMonths(0);
+		ordinance.SetRushHourMode(true);
+
+		Settings settings;
+		settings.rushHourMask = kCommuterHourMask;
+		settings.rushHourSwitchBudgetMicroseconds = budgetMicroseconds;
+
+		cISC4City* pCity = runtime.LoadCity();
+		Mock24HourClock& clock = runtime.Get24HourClock();
+		clock.SetHour(0);
+
+		RushHourScheduler scheduler;
+
+		if (!ordinance.PostCityInit(pCity) || !scheduler.Start(pCity, &ordinance, settings))
+		{
+			std::fprintf(stderr, "Failed to initialize the city.\n");
+			return result;
+		}
+
+		ordinance.SetAvailable(true);
+		ordinance.UpdateCarCanReachDestination(/*calledFromPostCityInit*/true);
+		runtime.Tick();
+		ordinance.SetOn(true);
+		runtime.Tick();
+
+		const uint32_t initialRestarts = runtime.GetTrafficSimulatorRestartCount();
+		const uint32_t initialHiddenPauses = runtime.GetHiddenPauseCount();
+		result.succeeded = true;
+
+		for (uint32_t day = 0; day < options.days && result.succeeded; day++)
+		{
+			const uint32_t daySwitchStart = scheduler.GetSwitchCount();
+			const bool lastDay = day + 1 == options.days;
+
+			for (uint32_t hour = 0; hour < 24; hour++)
+			{
+				clock.SetHour(hour);
+				// A second tick in the same hour must not switch again.
+				runtime.Tick();
+				runtime.Tick();
+
+				const uint32_t hourMask = scheduler.GetActiveHourMask();
+				bool carCanReachDestination = false;
+
+				if (!GetCarCanReachDestination(runtime, carCanReachDestination)
+					|| carCanReachDestination == ((hourMask & (1u << hour)) != 0))
+				{
+					std::fprintf(stderr, "The car restriction does not match the schedule on day %u at %02u:00.\n", day, hour);
+					result.succeeded = false;
+					break;
+				}
+
+				if (lastDay && carCanReachDestination == ((expectedLastDayMask & (1u << hour)) != 0))
+				{
+					std::fprintf(stderr, "The last day does not follow the expected hours at %02u:00.\n", hour);
+					result.succeeded = false;
+					break;
+				}
+			}
+
+			result.lastDaySwitchCount = scheduler.GetSwitchCount() - daySwitchStart;
+		}
+
+		result.dailyFallbackActive = scheduler.IsDailyFallbackActive();
+		result.switchCount = scheduler.GetSwitchCount();
+		result.lastSwitchMicroseconds = scheduler.GetLastSwitchMicroseconds();
+		result.maxSwitchMicroseconds = scheduler.GetMaxSwitchMicroseconds();
+		result.restartCount = runtime.GetTrafficSimulatorRestartCount() - initialRestarts;
+		result.hiddenPauseCount = runtime.GetHiddenPauseCount() - initialHiddenPauses;
+
+		// The repealed ordinance must not send anything to the traffic simulator.
+		ordinance.SetOn(false);
+		runtime.Tick();
+
+		const uint32_t repealedSwitchStart = scheduler.GetSwitchCount();
+		const uint32_t repealedMessageStart = runtime.GetTrafficSimulatorMessageCount();
+
+		for (uint32_t hour = 0; hour < 24; hour++)
+		{
+			clock.SetHour(hour);
+			runtime.Tick();
+		}
+
+		if (scheduler.GetSwitchCount() != repealedSwitchStart
+			|| runtime.GetTrafficSimulatorMessageCount() != repealedMessageStart)
+		{
+			std::fprintf(stderr, "The traffic simulator was updated while the ordinance was repealed.\n");
+			result.succeeded = false;
+		}
+
+		scheduler.Stop();
+		ordinance.PreCityShutdown(pCity);
+		runtime.UnloadCity();
+
+		return result;
+	}
+
+	void PrintResult(const char* name, uint32_t budgetMicroseconds, const RunResult& result)
+	{
+		std::printf(
+			"%-9s budget %6u us: %u switches, %u on the last day, last %lld us, max %lld us,"
+			" daily fallback %s, restarts %u, hidden pauses %u\n",
+			name,
+			budgetMicroseconds,
+			result.switchCount,
+			result.lastDaySwitchCount,
+			static_cast<long long>(result.lastSwitchMicroseconds),
+			static_cast<long long>(result.maxSwitchMicroseconds),
+			result.dailyFallbackActive ? "yes" : "no",
+			result.restartCount,
+			result.hiddenPauseCount);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--days", "n", "The simulated days", options.days);
+	arguments.AddValue(
+		"--reload-cost",
+		"ns",
+		"The time that the traffic simulator takes to reload its tunables",
+		options.reloadCostNanoseconds,
+		0,
+		BenchmarkArguments::NoMaximum);
+	arguments.AddValue("--budget", "us", "The switch budget of the first run", options.budgetMicroseconds, 0);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	const RunResult inBudget = Run(options, options.budgetMicroseconds, kCommuterHourMask);
+	PrintResult("in budget", options.budgetMicroseconds, inBudget);
+
+	bool succeeded = inBudget.succeeded;
+
+	if (succeeded
+		&& (inBudget.dailyFallbackActive
+			|| inBudget.lastDaySwitchCount != 4
+			|| inBudget.restartCount != 0
+			|| inBudget.hiddenPauseCount != 0))
+	{
+		std::fprintf(stderr, "The rush hour switches did not stay within the budget, or restarted the traffic simulator.\n");
+		succeeded = false;
+	}
+
+	// Half of the reload cost, so every switch is over budget.
+	const uint32_t overBudgetMicroseconds = static_cast<uint32_t>(std::max<int64_t>(options.reloadCostNanoseconds / 2000, 0));
+	const RunResult overBudget = Run(options, overBudgetMicroseconds, kDailySpanMask);
+	PrintResult("over", overBudgetMicroseconds, overBudget);
+
+	if (succeeded
+		&& (!overBudget.succeeded
+			|| !overBudget.dailyFallbackActive
+			|| (options.days > 1 && overBudget.lastDaySwitchCount != 2)))
+	{
+		std::fprintf(stderr, "The scheduler did not fall back to one restriction span per day.\n");
+		succeeded = false;
+	}
+
+	return succeeded ? 0 : 1;
+}
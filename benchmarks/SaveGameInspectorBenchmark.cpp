@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Writes a folder of synthetic save games that contain the serialized ordinance state,
+// checks that the save game inspector decodes the state that OrdinanceBase::Write stored
+// and reports the cost of inspecting each save game.
+//
+// The program exits with a non-zero status if the state of a city is not found or
+// differs from the state that was written.
+
+#include "BenchmarkArguments.h"
+#include "DBPFFile.h"
+#include "MockRuntime.h"
+#include "MockSaveGame.h"
+#include "ParknRideOrdinance.h"
+#include "SaveGameInspector.h"
+#include "Stopwatch.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		uint32_t cities = 60;
+		uint32_t entries = 400;
+		uint32_t entrySize = 16384;
+	};
+
+	// The Commercial Demand Effect that the ordinance adds with a value of 1.05.
+	constexpr uint32_t kCommercialDemandEffect = 0x2a633000;
+
+	// The ordinance state is stored in one of the last entries, so most of the file is searched.
+	uint32_t GetOrdinanceEntryIndex(const BenchmarkOptions& options)
+	{
+		return options.entries - (options.entries / 10) - 1;
+	}
+
+	// Creates the entries of a city, a quarter of them are compressed. The ordinance state is
+	// stored near the end of a compressed entry after a false match of its version and class ID.
+	std::vector<MockSaveGame::Entry> CreateCityEntries(
+		const BenchmarkOptions& options,
+		std::mt19937& random,
+		const std::vector<uint8_t>& ordinanceState)
+	{
+		std::uniform_int_distribution<uint32_t> sizeDistribution(options.entrySize / 2, options.entrySize + options.entrySize / 2);
+		std::vector<MockSaveGame::Entry> entries;
+		entries.reserve(options.entries);
+
+		const uint32_t ordinanceEntry = GetOrdinanceEntryIndex(options);
+
+		for (uint32_t i = 0; i < options.entries; i++)
+		{
+			MockSaveGame::Entry entry{ DBPFFile::ResourceKey{ 0x2990c1e5 + (i % 7), 0x0e9a5a4c, i }, {}, (i % 4) == 0 };
+			entry.data = entry.compressed
+				? MockSaveGame::CreateRecordData(random, sizeDistribution(random))
+				: MockSaveGame::CreateRandomData(random, sizeDistribution(random));
+
+			if (i == ordinanceEntry)
+			{
+				entry.compressed = true;
+
+				std::vector<uint8_t> falseMatch(16, 0xff);
+				MockSaveGame::WriteUint32(falseMatch, 0, 1);
+				MockSaveGame::WriteUint32(falseMatch, 4, kParknRideOrdinanceCLSID);
+
+				entry.data.insert(entry.data.end(), falseMatch.begin(), falseMatch.end());
+				entry.data.insert(entry.data.end(), ordinanceState.begin(), ordinanceState.end());
+				entry.data.insert(entry.data.end(), 64, 0);
+			}
+
+			entries.push_back(std::move(entry));
+		}
+
+		return entries;
+	}
+
+	bool CheckState(
+		uint32_t city,
+		const SaveGameInspector::Result& result,
+		bool expectedOn,
+		uint32_t expectedCompressedEntries)
+	{
+		const OrdinanceStateReader::OrdinanceState& state = result.state;
+
+		if (!result.found || state.clsid != kParknRideOrdinanceCLSID || state.name.empty())
+		{
+			std::fprintf(stderr, "City %u: the ordinance state was not found.\n", city);
+			return false;
+		}
+
+		if (state.on != expectedOn || !state.available || !state.enabled || !state.initialized)
+		{
+			std::fprintf(
+				stderr,
+				"City %u: unexpected state on=%d, available=%d, enabled=%d, initialized=%d.\n",
+				city,
+				state.on,
+				state.available,
+				state.enabled,
+				state.initialized);
+			return false;
+		}
+
+		const auto effect = std::find_if(
+			state.effects.begin(),
+			state.effects.end(),
+			[](const OrdinanceStateReader::Effect& item) { return item.propertyID == kCommercialDemandEffect; });
+
+		if (effect == state.effects.end()
+			|| effect->type != cIGZVariant::Type::Float32
+			|| effect->values.size() != 1
+			|| effect->values[0] != static_cast<double>(1.05f))
+		{
+			std::fprintf(stderr, "City %u: the Commercial Demand Effect was not decoded.\n", city);
+			return false;
+		}
+
+		if (result.compressedEntriesSearched != expectedCompressedEntries || result.invalidEntries != 0)
+		{
+			std::fprintf(
+				stderr,
+				"City %u: %u compressed entries were searched, expected %u.\n",
+				city,
+				result.compressedEntriesSearched,
+				expectedCompressedEntries);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool RunBenchmark(const BenchmarkOptions& options, const std::filesystem::path& folder)
+	{
+		MockRuntime runtime(MockRuntimeOptions{});
+		cISC4City* pCity = runtime.LoadCity();
+
+		ParknRideOrdinance ordinance;
+		ordinance.SetEnabled(true);
+
+		if (!ordinance.PostCityInit(pCity))
+		{
+			std::fprintf(stderr, "PostCityInit failed.\n");
+			return false;
+		}
+
+		ordinance.SetAvailable(true);
+
+		std::vector<uint8_t> repealedState;
+		std::vector<uint8_t> enactedState;
+
+		const bool serialized = MockSaveGame::SerializeOrdinance(ordinance, repealedState);
+		ordinance.SetOn(true);
+
+		if (!serialized || !MockSaveGame::SerializeOrdinance(ordinance, enactedState))
+		{
+			std::fprintf(stderr, "The ordinance could not be serialized.\n");
+			return false;
+		}
+
+		std::mt19937 random(0x5a7e0451);
+		std::vector<std::filesystem::path> paths;
+		uint64_t totalBytes = 0;
+		std::vector<uint32_t> expectedCompressedEntries;
+
+		for (uint32_t city = 0; city < options.cities; city++)
+		{
+			const std::vector<MockSaveGame::Entry> entries = CreateCityEntries(
+				options,
+				random,
+				(city % 3) == 0 ? enactedState : repealedState);
+
+			// The search stops at the ordinance entry.
+			expectedCompressedEntries.push_back(static_cast<uint32_t>(std::count_if(
+				entries.begin(),
+				entries.begin() + GetOrdinanceEntryIndex(options) + 1,
+				[](const MockSaveGame::Entry& entry) { return entry.compressed; })));
+
+			const std::vector<uint8_t> file = MockSaveGame::BuildDBPF(entries);
+			char name[64]{};
+			std::snprintf(name, sizeof(name), "City - Synthetic %03u.sc4", city);
+
+			paths.push_back(folder / name);
+
+			if (!MockSaveGame::WriteFile(paths.back(), file))
+			{
+				std::fprintf(stderr, "Failed to write %s.\n", paths.back().string().c_str());
+				return false;
+			}
+
+			totalBytes += file.size();
+		}
+
+		Stopwatch inspectionTime;
+
+		for (uint32_t city = 0; city < options.cities; city++)
+		{
+			SaveGameInspector::Result result{};
+			DBPFFile file;
+
+			inspectionTime.Start();
+
+			const bool opened = file.Open(paths[city]);
+
+			if (opened)
+			{
+				SaveGameInspector::FindOrdinance(file, kParknRideOrdinanceCLSID, result);
+			}
+
+			inspectionTime.Stop();
+
+			if (!opened)
+			{
+				std::fprintf(stderr, "Failed to open %s.\n", paths[city].string().c_str());
+				return false;
+			}
+
+			if (!CheckState(city, result, (city % 3) == 0, expectedCompressedEntries[city]))
+			{
+				return false;
+			}
+		}
+
+		const double seconds = static_cast<double>(inspectionTime.ElapsedMicroseconds()) / 1000000.0;
+
+		std::printf(
+			"Inspected %u synthetic save games (%.1f MB, %u entries each).\n"
+			"Average per save game: %.1f us\n"
+			"Throughput: %.0f MB/s\n",
+			options.cities,
+			static_cast<double>(totalBytes) / (1024.0 * 1024.0),
+			options.entries,
+			static_cast<double>(inspectionTime.ElapsedMicroseconds()) / options.cities,
+			seconds > 0.0 ? (static_cast<double>(totalBytes) / (1024.0 * 1024.0)) / seconds : 0.0);
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--cities", "n", "The number of save games", options.cities);
+	arguments.AddValue("--entries", "n", "The number of entries in each save game, at least 20", options.entries, 20);
+	arguments.AddValue("--entry-size", "bytes", "The average entry size", options.entrySize);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	const std::filesystem::path folder = std::filesystem::temp_directory_path() / "SaveGameInspectorBenchmark";
+
+	std::error_code ec;
+	std::filesystem::remove_all(folder, ec);
+	std::filesystem::create_directories(folder, ec);
+
+	const bool succeeded = RunBenchmark(options, folder);
+
+	std::filesystem::remove_all(folder, ec);
+
+	return succeeded ? 0 : 1;
+}
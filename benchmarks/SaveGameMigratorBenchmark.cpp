@@ -0,0 +1,416 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+
+// Writes a region folder of synthetic save games that contain the ordinance state in an older
+// format, checks that a dry run does not change them and predicts the migration, migrates them
+// and verifies that every entry of the migrated save games has the expected data.
+//
+// Some of the save games also contain an outdated state in an unrelated entry, which models the
+// ordinance class ID matching other record data. The migrator must not change it.
+// Some of the save games have a large ordinance simulator entry and few other entries, appending
+// to them would leave too much unused space, so they are rewritten.
+//
+// The program exits with a non-zero status if a save game does not have the expected data.
+
+#include "BenchmarkArguments.h"
+#include "GZCLSIDDefs.h"
+#include "MockRuntime.h"
+#include "MockSaveGame.h"
+#include "OrdinanceStateReader.h"
+#include "ParknRideOrdinance.h"
+#include "SaveGameMigrator.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		uint32_t cities = 100;
+		uint32_t threads = 4;
+	};
+
+	constexpr uint32_t kOrdinanceSimulatorEntryType = static_cast<uint32_t>(GZCLSID::kcSC4OrdinanceSimulator);
+
+	struct ExpectedCity
+	{
+		std::filesystem::path path;
+		bool legacyFormat;
+		bool enacted;
+		// An outdated state is also written to an entry of another type.
+		bool unrelatedMatch;
+		// The uncompressed entries, with the ordinance state in the current format.
+		std::vector<MockSaveGame::Entry> entries;
+	};
+
+	// Converts a state in the current format to the version 2 property holder without curves,
+	// which the current plugin writes as version 1.
+	bool CreateLegacyState(const std::vector<uint8_t>& state, std::vector<uint8_t>& legacyState)
+	{
+		OrdinanceStateReader::OrdinanceState decoded;
+		size_t bytesRead = 0;
+
+		if (!OrdinanceStateReader::Read(state.data(), state.size(), decoded, bytesRead)
+			|| bytesRead != state.size()
+			|| decoded.propertyHolderVersion != 1)
+		{
+			return false;
+		}
+
+		const size_t propertyHolderOffset = 4 + 4 + 4 + decoded.name.size() + 4 + decoded.description.size() + 40 + 4 + 1;
+		// The curve count goes before the initialized, available, on and enabled flags.
+		const size_t curveCountOffset = state.size() - 4;
+		const uint32_t propertyHolderVersion = 2;
+		const uint8_t curveCount[4]{};
+
+		legacyState = state;
+		std::memcpy(legacyState.data() + propertyHolderOffset, &propertyHolderVersion, sizeof(propertyHolderVersion));
+		legacyState.insert(legacyState.begin() + curveCountOffset, std::begin(curveCount), std::end(curveCount));
+
+		return true;
+	}
+
+	uint64_t HashFile(const std::filesystem::path& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		const std::vector<uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+		// FNV-1a
+		uint64_t hash = 0xcbf29ce484222325;
+
+		for (uint8_t value : data)
+		{
+			hash = (hash ^ value) * 0x100000001b3;
+		}
+
+		return hash;
+	}
+
+	bool WriteRegion(
+		const BenchmarkOptions& options,
+		const std::filesystem::path& folder,
+		const std::vector<uint8_t> states[2],
+		std::vector<ExpectedCity>& expectedCities)
+	{
+		std::mt19937 random(0x5ca40049);
+		std::uniform_int_distribution<uint32_t> entryCountDistribution(10, 80);
+		std::uniform_int_distribution<uint32_t> entrySizeDistribution(1024, 16384);
+
+		for (uint32_t city = 0; city < options.cities; city++)
+		{
+			ExpectedCity expected
+			{
+				folder / ("City - Migration " + std::to_string(city) + ".sc4"),
+				(city % 3) != 0,
+				(city % 2) == 0,
+				(city % 5) == 0,
+				{},
+			};
+			const bool largeOrdinanceEntry = (city % 4) == 3;
+			const uint32_t entryCount = largeOrdinanceEntry ? 3 : entryCountDistribution(random);
+			std::vector<MockSaveGame::Entry> entries;
+
+			for (uint32_t i = 0; i < entryCount; i++)
+			{
+				const bool compressed = (i % 2) == 0;
+				const size_t size = entrySizeDistribution(random);
+
+				entries.push_back(MockSaveGame::Entry
+				{
+					DBPFFile::ResourceKey{ 0x2990c1e5 + (i % 7), 0x0e9a5a4c, i },
+					compressed ? MockSaveGame::CreateRecordData(random, size) : MockSaveGame::CreateRandomData(random, size),
+					compressed,
+				});
+			}
+
+			std::vector<uint8_t> legacyState;
+
+			if (!CreateLegacyState(states[expected.enacted ? 1 : 0], legacyState))
+			{
+				std::fprintf(stderr, "The legacy ordinance state could not be created.\n");
+				return false;
+			}
+
+			// Half of the cities store the ordinance in a compressed entry, it is followed by other data.
+			const std::vector<uint8_t>& currentState = states[expected.enacted ? 1 : 0];
+			const size_t ordinanceEntry = (city % 4) < 2 ? entryCount / 2 : (entryCount / 2) + 1;
+			const std::vector<uint8_t> trailer = MockSaveGame::CreateRecordData(random, largeOrdinanceEntry ? 65536 : 256);
+
+			entries[ordinanceEntry].key.type = kOrdinanceSimulatorEntryType;
+
+			if (expected.unrelatedMatch)
+			{
+				entries[0].data.insert(entries[0].data.end(), legacyState.begin(), legacyState.end());
+			}
+
+			expected.entries = entries;
+			expected.entries[ordinanceEntry].data.insert(expected.entries[ordinanceEntry].data.end(), currentState.begin(), currentState.end());
+			expected.entries[ordinanceEntry].data.insert(expected.entries[ordinanceEntry].data.end(), trailer.begin(), trailer.end());
+
+			const std::vector<uint8_t>& writtenState = expected.legacyFormat ? legacyState : currentState;
+			entries[ordinanceEntry].data.insert(entries[ordinanceEntry].data.end(), writtenState.begin(), writtenState.end());
+			entries[ordinanceEntry].data.insert(entries[ordinanceEntry].data.end(), trailer.begin(), trailer.end());
+
+			if (!MockSaveGame::WriteFile(expected.path, MockSaveGame::BuildDBPF(entries)))
+			{
+				std::fprintf(stderr, "Failed to write %s.\n", expected.path.string().c_str());
+				return false;
+			}
+
+			expectedCities.push_back(std::move(expected));
+		}
+
+		return true;
+	}
+
+	bool CheckCity(const ExpectedCity& expected, std::vector<uint8_t>& buffer)
+	{
+		DBPFFile file;
+
+		if (!file.Open(expected.path))
+		{
+			std::fprintf(stderr, "%s cannot be opened.\n", expected.path.string().c_str());
+			return false;
+		}
+
+		for (const MockSaveGame::Entry& expectedEntry : expected.entries)
+		{
+			DBPFFile::IndexEntry entry{};
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+
+			if (!file.FindEntry(expectedEntry.key, entry)
+				|| file.IsCompressed(entry) != expectedEntry.compressed
+				|| !file.ReadEntryData(entry, buffer, data, size)
+				|| size != expectedEntry.data.size()
+				|| std::memcmp(data, expectedEntry.data.data(), size) != 0)
+			{
+				std::fprintf(stderr, "Entry %u of %s does not have the expected data.\n", expectedEntry.key.instance, expected.path.string().c_str());
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool CheckResults(const std::vector<SaveGameMigrator::FileResult>& results)
+	{
+		for (const SaveGameMigrator::FileResult& result : results)
+		{
+			if (result.error)
+			{
+				std::fprintf(stderr, "%s: %s\n", result.path.string().c_str(), result.error);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void PrintSummary(const char* label, const SaveGameMigrator& migrator, const std::vector<SaveGameMigrator::FileResult>& results)
+	{
+		uint32_t inPlace = 0;
+		uint32_t rewritten = 0;
+		int64_t stateBytesSaved = 0;
+		int64_t fileBytesSaved = 0;
+
+		for (const SaveGameMigrator::FileResult& result : results)
+		{
+			inPlace += result.method == SaveGameMigrator::Method::InPlace ? 1 : 0;
+			rewritten += result.method == SaveGameMigrator::Method::Rewrite ? 1 : 0;
+			stateBytesSaved += result.stateBytesSaved;
+			fileBytesSaved += static_cast<int64_t>(result.originalFileSize) - static_cast<int64_t>(result.migratedFileSize);
+		}
+
+		std::printf(
+			"%-8s %5lld ms, %u updated in place, %u rewritten, %lld state bytes and %lld file bytes saved\n",
+			label,
+			static_cast<long long>(migrator.GetStatistics().elapsedMilliseconds),
+			inPlace,
+			rewritten,
+			static_cast<long long>(stateBytesSaved),
+			static_cast<long long>(fileBytesSaved));
+	}
+
+	bool RunBenchmark(const BenchmarkOptions& options, const std::filesystem::path& folder)
+	{
+		MockRuntime runtime(MockRuntimeOptions{});
+		cISC4City* pCity = runtime.LoadCity();
+
+		ParknRideOrdinance ordinance;
+		ordinance.SetEnabled(true);
+
+		if (!ordinance.PostCityInit(pCity))
+		{
+			std::fprintf(stderr, "PostCityInit failed.\n");
+			return false;
+		}
+
+		ordinance.SetAvailable(true);
+
+		std::vector<uint8_t> states[2];
+
+		const bool serialized = MockSaveGame::SerializeOrdinance(ordinance, states[0]);
+		ordinance.SetOn(true);
+
+		if (!serialized || !MockSaveGame::SerializeOrdinance(ordinance, states[1]))
+		{
+			std::fprintf(stderr, "The ordinance could not be serialized.\n");
+			return false;
+		}
+
+		std::vector<ExpectedCity> expectedCities;
+
+		if (!WriteRegion(options, folder, states, expectedCities))
+		{
+			return false;
+		}
+
+		std::vector<std::filesystem::path> paths;
+		std::vector<uint64_t> hashes;
+
+		for (const ExpectedCity& expected : expectedCities)
+		{
+			paths.push_back(expected.path);
+			hashes.push_back(HashFile(expected.path));
+		}
+
+		// The dry run must not change the files, and must predict the result of the migration.
+		SaveGameMigrator dryRun(options.threads, /*dryRun*/true);
+		std::vector<SaveGameMigrator::FileResult> dryRunResults;
+		dryRun.Migrate(paths, dryRunResults);
+
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			if (HashFile(paths[i]) != hashes[i])
+			{
+				std::fprintf(stderr, "The dry run changed %s.\n", paths[i].string().c_str());
+				return false;
+			}
+		}
+
+		SaveGameMigrator migrator(options.threads, /*dryRun*/false);
+		std::vector<SaveGameMigrator::FileResult> results;
+		migrator.Migrate(paths, results);
+
+		if (!CheckResults(dryRunResults) || !CheckResults(results))
+		{
+			return false;
+		}
+
+		uint32_t inPlace = 0;
+		uint32_t rewritten = 0;
+
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			const SaveGameMigrator::FileResult& result = results[i];
+			const bool legacyFormat = expectedCities[i].legacyFormat;
+
+			// The curve count is the only difference between the legacy and the current state.
+			if (result.states != 1
+				|| result.migratedStates != (legacyFormat ? 1u : 0u)
+				|| result.stateBytesSaved != (legacyFormat ? 4 : 0)
+				|| (result.method == SaveGameMigrator::Method::Unchanged) == legacyFormat
+				|| result.method != dryRunResults[i].method
+				|| result.migratedFileSize != dryRunResults[i].migratedFileSize
+				|| result.stateBytesSaved != dryRunResults[i].stateBytesSaved
+				|| std::filesystem::file_size(paths[i]) != result.migratedFileSize)
+			{
+				std::fprintf(stderr, "%s was not migrated as expected.\n", paths[i].string().c_str());
+				return false;
+			}
+
+			inPlace += result.method == SaveGameMigrator::Method::InPlace ? 1 : 0;
+			rewritten += result.method == SaveGameMigrator::Method::Rewrite ? 1 : 0;
+		}
+
+		if (options.cities >= 12 && (inPlace == 0 || rewritten == 0))
+		{
+			std::fprintf(stderr, "Expected both in place updates and rewrites, found %u and %u.\n", inPlace, rewritten);
+			return false;
+		}
+
+		std::vector<uint8_t> buffer;
+
+		for (const ExpectedCity& expected : expectedCities)
+		{
+			if (!CheckCity(expected, buffer))
+			{
+				return false;
+			}
+		}
+
+		std::error_code ec;
+
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(folder, ec))
+		{
+			if (entry.path().extension() != ".sc4")
+			{
+				std::fprintf(stderr, "The migration left %s behind.\n", entry.path().string().c_str());
+				return false;
+			}
+		}
+
+		// A second migration finds nothing to change.
+		SaveGameMigrator secondMigrator(options.threads, /*dryRun*/false);
+		std::vector<SaveGameMigrator::FileResult> secondResults;
+		secondMigrator.Migrate(paths, secondResults);
+
+		for (const SaveGameMigrator::FileResult& result : secondResults)
+		{
+			if (result.error || result.method != SaveGameMigrator::Method::Unchanged)
+			{
+				std::fprintf(stderr, "%s was changed by the second migration.\n", result.path.string().c_str());
+				return false;
+			}
+		}
+
+		std::printf("Migrated %zu synthetic save games with %u threads.\n", paths.size(), migrator.GetStatistics().threadCount);
+		PrintSummary("dry run", dryRun, dryRunResults);
+		PrintSummary("migrate", migrator, results);
+		PrintSummary("again", secondMigrator, secondResults);
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--cities", "n", "The number of save games", options.cities);
+	arguments.AddValue("--threads", "n", "The number of worker threads", options.threads);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	const std::filesystem::path folder = std::filesystem::temp_directory_path() / "SaveGameMigratorBenchmark";
+
+	std::error_code ec;
+	std::filesystem::remove_all(folder, ec);
+	std::filesystem::create_directories(folder, ec);
+
+	const bool succeeded = RunBenchmark(options, folder);
+
+	std::filesystem::remove_all(folder, ec);
+
+	return succeeded ? 0 : 1;
+}
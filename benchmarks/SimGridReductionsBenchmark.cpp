@@ -0,0 +1,270 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Verifies the SIMD grid reductions against the scalar reference kernels on
+// synthetic grids, and measures their throughput.
+//
+// The program exits with a non-zero status if any kernel result differs from
+// the scalar result.
+
+#include "BenchmarkArguments.h"
+#include "SimGridReductions.h"
+#include "Stopwatch.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace SimGridReductions;
+
+namespace
+{
+	enum class GridPattern
+	{
+		Random,
+		Constant,
+		Sparse,
+		Gradient,
+	};
+
+	const char* GetPatternName(GridPattern pattern)
+	{
+		switch (pattern)
+		{
+		case GridPattern::Constant:
+			return "constant";
+		case GridPattern::Sparse:
+			return "sparse";
+		case GridPattern::Gradient:
+			return "gradient";
+		case GridPattern::Random:
+		default:
+			return "random";
+		}
+	}
+
+	std::vector<uint8_t> CreateGrid(int32_t countX, int32_t countZ, GridPattern pattern, std::mt19937& random)
+	{
+		std::vector<uint8_t> grid(static_cast<size_t>(countX) * static_cast<size_t>(countZ));
+		std::uniform_int_distribution<int> values(0, 255);
+
+		for (int32_t z = 0; z < countZ; z++)
+		{
+			for (int32_t x = 0; x < countX; x++)
+			{
+				uint8_t value = 0;
+
+				switch (pattern)
+				{
+				case GridPattern::Random:
+					value = static_cast<uint8_t>(values(random));
+					break;
+				case GridPattern::Constant:
+					value = 255;
+					break;
+				case GridPattern::Sparse:
+					// Most of a city tile has no traffic.
+					value = (values(random) < 8) ? static_cast<uint8_t>(values(random)) : 0;
+					break;
+				case GridPattern::Gradient:
+					value = static_cast<uint8_t>((x + z) & 0xff);
+					break;
+				}
+
+				grid[(static_cast<size_t>(z) * countX) + x] = value;
+			}
+		}
+
+		return grid;
+	}
+
+	bool VerifyLevel(const SimGridView<uint8_t>& grid, SimdLevel level, const char* description)
+	{
+		bool result = true;
+
+		const uint64_t expectedSum = Sum(grid, SimdLevel::Scalar);
+		const MinMax expectedMinMax = GetMinMax(grid, SimdLevel::Scalar);
+		Histogram expectedHistogram;
+		BuildHistogram(grid, expectedHistogram, SimdLevel::Scalar);
+
+		const uint64_t sum = Sum(grid, level);
+
+		if (sum != expectedSum)
+		{
+			std::fprintf(stderr, "%s: %s Sum returned %llu, expected %llu.\n",
+				description, GetSimdLevelName(level),
+				static_cast<unsigned long long>(sum), static_cast<unsigned long long>(expectedSum));
+			result = false;
+		}
+
+		const MinMax minMax = GetMinMax(grid, level);
+
+		if (minMax.min != expectedMinMax.min || minMax.max != expectedMinMax.max)
+		{
+			std::fprintf(stderr, "%s: %s GetMinMax returned {%u, %u}, expected {%u, %u}.\n",
+				description, GetSimdLevelName(level),
+				minMax.min, minMax.max, expectedMinMax.min, expectedMinMax.max);
+			result = false;
+		}
+
+		for (const uint8_t threshold : { 0, 1, 2, 127, 128, 129, 254, 255 })
+		{
+			const size_t expectedCount = CountAtLeast(grid, threshold, SimdLevel::Scalar);
+			const size_t count = CountAtLeast(grid, threshold, level);
+
+			if (count != expectedCount)
+			{
+				std::fprintf(stderr, "%s: %s CountAtLeast(%u) returned %zu, expected %zu.\n",
+					description, GetSimdLevelName(level), threshold, count, expectedCount);
+				result = false;
+			}
+		}
+
+		Histogram histogram;
+		BuildHistogram(grid, histogram, level);
+
+		if (histogram != expectedHistogram)
+		{
+			std::fprintf(stderr, "%s: %s BuildHistogram differs from the scalar histogram.\n",
+				description, GetSimdLevelName(level));
+			result = false;
+		}
+
+		return result;
+	}
+
+	bool VerifyKernels(std::mt19937& random)
+	{
+		// The sizes cover empty grids, grids smaller than one vector, the vector remainder
+		// handling, and the tract grids of the game's city sizes.
+		static constexpr int32_t gridSizes[] = { 0, 1, 7, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 256, 257 };
+		static constexpr GridPattern patterns[] = { GridPattern::Random, GridPattern::Constant, GridPattern::Sparse, GridPattern::Gradient };
+
+		bool result = true;
+		const SimdLevel supportedLevel = GetSupportedSimdLevel();
+
+		for (const int32_t countX : gridSizes)
+		{
+			for (const int32_t countZ : { 1, 3, 64 })
+			{
+				for (const GridPattern pattern : patterns)
+				{
+					const std::vector<uint8_t> data = CreateGrid(countX, countZ, pattern, random);
+					const SimGridView<uint8_t> grid(data.data(), countX, countZ, 0);
+
+					char description[128]{};
+					std::snprintf(description, sizeof(description), "%dx%d %s grid", countX, countZ, GetPatternName(pattern));
+
+					for (uint32_t level = static_cast<uint32_t>(SimdLevel::SSE2); level <= static_cast<uint32_t>(supportedLevel); level++)
+					{
+						result &= VerifyLevel(grid, static_cast<SimdLevel>(level), description);
+					}
+
+					// Unaligned sub-ranges, as used by the incremental congestion sampling.
+					if (data.size() > 3)
+					{
+						const SimGridView<uint8_t> subRange(data.data() + 1, static_cast<int32_t>(data.size() - 3), 1, 0);
+
+						for (uint32_t level = static_cast<uint32_t>(SimdLevel::SSE2); level <= static_cast<uint32_t>(supportedLevel); level++)
+						{
+							result &= VerifyLevel(subRange, static_cast<SimdLevel>(level), description);
+						}
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+
+	template <typename Function>
+	double MeasureNanosecondsPerTract(const SimGridView<uint8_t>& grid, uint32_t iterations, Function&& function)
+	{
+		Stopwatch stopwatch;
+		stopwatch.Start();
+
+		for (uint32_t i = 0; i < iterations; i++)
+		{
+			function();
+		}
+
+		stopwatch.Stop();
+
+		return (static_cast<double>(stopwatch.ElapsedMicroseconds()) * 1000.0)
+			/ (static_cast<double>(iterations) * static_cast<double>(grid.Size()));
+	}
+
+	void RunBenchmark(std::mt19937& random, int32_t gridSize, uint32_t iterations)
+	{
+		const std::vector<uint8_t> data = CreateGrid(gridSize, gridSize, GridPattern::Random, random);
+		const SimGridView<uint8_t> grid(data.data(), gridSize, gridSize, 0);
+
+		std::printf("%dx%d grid, %u iterations, ns per tract:\n", gridSize, gridSize, iterations);
+
+		// The results are accumulated and printed, which prevents the compiler from removing the benchmark loops.
+		uint64_t sink = 0;
+
+		for (uint32_t level = 0; level <= static_cast<uint32_t>(GetSupportedSimdLevel()); level++)
+		{
+			const SimdLevel simdLevel = static_cast<SimdLevel>(level);
+			Histogram histogram;
+
+			const double sum = MeasureNanosecondsPerTract(grid, iterations, [&]() { sink += Sum(grid, simdLevel); });
+			const double minMax = MeasureNanosecondsPerTract(grid, iterations, [&]() { sink += GetMinMax(grid, simdLevel).max; });
+			const double count = MeasureNanosecondsPerTract(grid, iterations, [&]() { sink += CountAtLeast(grid, 128, simdLevel); });
+			const double histogramTime = MeasureNanosecondsPerTract(grid, iterations, [&]() { BuildHistogram(grid, histogram, simdLevel); sink += histogram[0]; });
+
+			std::printf(
+				"  %-6s sum=%.3f minmax=%.3f count=%.3f histogram=%.3f\n",
+				GetSimdLevelName(simdLevel),
+				sum,
+				minMax,
+				count,
+				histogramTime);
+		}
+
+		std::printf("  checksum=%llu\n", static_cast<unsigned long long>(sink));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool verifyOnly = false;
+
+	BenchmarkArguments arguments;
+	arguments.AddFlag("--verify-only", "Only check the kernels against the scalar reference", verifyOnly);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	std::mt19937 random(0x5eed);
+
+	std::printf("Supported SIMD level: %s\n", GetSimdLevelName(GetSupportedSimdLevel()));
+
+	if (!VerifyKernels(random))
+	{
+		return 1;
+	}
+
+	std::printf("All kernels match the scalar reference.\n");
+
+	if (!verifyOnly)
+	{
+		// The tract grids of a large city tile and of a grid with one tract per cell.
+		RunBenchmark(random, 128, 2000);
+		RunBenchmark(random, 1024, 50);
+	}
+
+	return 0;
+}
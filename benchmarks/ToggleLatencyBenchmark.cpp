@@ -0,0 +1,212 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Measures the latency of toggling the Park & Ride ordinance, from the SetOn call
+// until the traffic simulator has been restarted with the new tuning exemplar value.
+//
+// The game services are provided by the mock runtime, their costs can be adjusted
+// on the command line to model different machines and city sizes.
+
+#include "BenchmarkArguments.h"
+#include "BenchmarkStatistics.h"
+#include "MockRuntime.h"
+#include "ParknRideOrdinance.h"
+#include "Stopwatch.h"
+#include "TrafficTuningCoordinator.h"
+#include "cIGZVariant.h"
+#include "cISCProperty.h"
+#include "cISCPropertyHolder.h"
+#include "cRZBaseString.h"
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t kParticipantID = 0x8b8d3b1a;
+	constexpr uint32_t kTravelTypeCanReachDestination = 0xA92356B5;
+	constexpr uint32_t kCarTravelTypeIndex = 1;
+
+	struct BenchmarkOptions
+	{
+		uint32_t toggles = 1000;
+		uint32_t cities = 10;
+		MockRuntimeOptions runtime;
+	};
+
+	bool GetCarCanReachDestination(MockRuntime& runtime, bool& value)
+	{
+		cISCProperty* property = runtime.GetTrafficTuningExemplar()->GetProperty(kTravelTypeCanReachDestination);
+
+		if (property)
+		{
+			cIGZVariant* data = property->GetPropertyValue();
+
+			if (data && data->GetCount() > kCarTravelTypeIndex)
+			{
+				value = data->RefBool()[kCarTravelTypeIndex];
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void PrintLatencyReport(const char* label, std::vector<int64_t>& samples)
+	{
+		if (samples.empty())
+		{
+			return;
+		}
+
+		std::sort(samples.begin(), samples.end());
+
+		const double mean = static_cast<double>(std::accumulate(samples.begin(), samples.end(), int64_t(0)))
+			/ static_cast<double>(samples.size());
+
+		std::printf(
+			"%-16s n=%zu min=%lldus p50=%lldus p90=%lldus p99=%lldus max=%lldus mean=%.1fus\n",
+			label,
+			samples.size(),
+			static_cast<long long>(samples.front()),
+			static_cast<long long>(BenchmarkStatistics::GetPercentile(samples, 0.50)),
+			static_cast<long long>(BenchmarkStatistics::GetPercentile(samples, 0.90)),
+			static_cast<long long>(BenchmarkStatistics::GetPercentile(samples, 0.99)),
+			static_cast<long long>(samples.back()),
+			mean);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--toggles", "n", "The number of SetOn toggles per city", options.toggles);
+	arguments.AddValue("--cities", "n", "The number of city load/unload cycles", options.cities);
+	arguments.AddValue("--queue-depth", "n", "The messages queued by each hidden pause", options.runtime.messageQueueDepth, 0);
+	arguments.AddValue(
+		"--message-cost",
+		"ns",
+		"The cost of processing one queued message",
+		options.runtime.messageCostNanoseconds,
+		0,
+		BenchmarkArguments::NoMaximum);
+	arguments.AddValue(
+		"--shutdown-cost",
+		"ns",
+		"The traffic simulator Shutdown cost",
+		options.runtime.trafficSimulatorShutdownCostNanoseconds,
+		0,
+		BenchmarkArguments::NoMaximum);
+	arguments.AddValue(
+		"--init-cost",
+		"ns",
+		"The traffic simulator Init cost",
+		options.runtime.trafficSimulatorInitCostNanoseconds,
+		0,
+		BenchmarkArguments::NoMaximum);
+	arguments.AddValue(
+		"--reload-cost",
+		"ns",
+		"The traffic simulator DoMessage cost",
+		options.runtime.trafficSimulatorMessageCostNanoseconds,
+		0,
+		BenchmarkArguments::NoMaximum);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	MockRuntime runtime(options.runtime);
+
+	TrafficTuningCoordinator coordinator;
+	coordinator.RegisterParticipant(kParticipantID, cRZBaseString("ToggleLatencyBenchmark"));
+
+	ParknRideOrdinance ordinance;
+	ordinance.SetTuningCoordinator(&coordinator, kParticipantID);
+
+	std::vector<int64_t> toggleSamples;
+	std::vector<int64_t> cityLoadSamples;
+	toggleSamples.reserve(static_cast<size_t>(options.toggles) * options.cities);
+	cityLoadSamples.reserve(options.cities);
+
+	for (uint32_t cityIndex = 0; cityIndex < options.cities; cityIndex++)
+	{
+		cISC4City* pCity = runtime.LoadCity();
+
+		Stopwatch stopwatch;
+		stopwatch.Start();
+
+		if (!ordinance.PostCityInit(pCity))
+		{
+			std::fprintf(stderr, "PostCityInit failed for city %u.\n", cityIndex);
+			return 1;
+		}
+
+		// The game's ordinance simulator makes the ordinance available after the city loads.
+		ordinance.SetAvailable(true);
+		ordinance.UpdateCarCanReachDestination(/*calledFromPostCityInit*/true);
+		runtime.Tick();
+
+		stopwatch.Stop();
+		cityLoadSamples.push_back(stopwatch.ElapsedMicroseconds());
+
+		for (uint32_t toggle = 0; toggle < options.toggles; toggle++)
+		{
+			const bool on = !ordinance.IsOn();
+
+			stopwatch.Restart();
+
+			ordinance.SetOn(on);
+			// The coordinator applies the edit when the framework ticks at the start of the next frame.
+			runtime.Tick();
+
+			stopwatch.Stop();
+			toggleSamples.push_back(stopwatch.ElapsedMicroseconds());
+
+			bool carCanReachDestination = false;
+			if (!GetCarCanReachDestination(runtime, carCanReachDestination)
+				|| carCanReachDestination == on)
+			{
+				std::fprintf(stderr, "The tuning exemplar was not updated after toggle %u in city %u.\n", toggle, cityIndex);
+				return 1;
+			}
+		}
+
+		ordinance.PreCityShutdown(pCity);
+		runtime.UnloadCity();
+	}
+
+	std::printf(
+		"%u cities, %u toggles per city, queue depth %u, message cost %lldns\n",
+		options.cities,
+		options.toggles,
+		options.runtime.messageQueueDepth,
+		static_cast<long long>(options.runtime.messageCostNanoseconds));
+
+	PrintLatencyReport("city load", cityLoadSamples);
+	PrintLatencyReport("toggle", toggleSamples);
+
+	std::printf(
+		"traffic simulator restarts=%u messages=%u, hidden pauses=%u, exemplar lookups=%u, messages processed=%llu\n",
+		runtime.GetTrafficSimulatorRestartCount(),
+		runtime.GetTrafficSimulatorMessageCount(),
+		runtime.GetHiddenPauseCount(),
+		runtime.GetResourceLookupCount(),
+		static_cast<unsigned long long>(runtime.GetProcessedMessageCount()));
+
+	return 0;
+}
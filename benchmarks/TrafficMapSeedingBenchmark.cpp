@@ -0,0 +1,217 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Compares the congestion map after the ordinance restarts the traffic simulator, with
+// and without restoring the traffic maps.
+//
+// The mock traffic simulator clears its maps on Shutdown and then moves them towards
+// an equilibrium a fixed fraction per simulation day, which models the game rebuilding
+// its traffic data. Enacting the ordinance lowers that equilibrium, so the restored
+// maps are not the values that the simulator converges to.
+//
+// For each restart the benchmark reports the number of days the coordinator measured
+// until the congestion map converged, and the mean difference between the map and
+// the equilibrium over the measured period.
+
+#include "BenchmarkArguments.h"
+#include "MockRuntime.h"
+#include "ParknRideOrdinance.h"
+#include "Stopwatch.h"
+#include "TrafficTuningCoordinator.h"
+#include "cRZBaseString.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+	constexpr uint32_t kParticipantID = 0x8b8d3b1a;
+	constexpr int32_t kMaxDays = 365;
+
+	struct BenchmarkOptions
+	{
+		uint32_t cityCellCount = 256;
+		// The percentage of the tracts that have traffic.
+		uint32_t trafficCoverage = 30;
+		// The percentage of the difference from the previous traffic that the mock
+		// traffic simulator recovers each day.
+		uint32_t recoveryRate = 3;
+		// The equilibrium traffic after the ordinance is enacted, as a percentage
+		// of the traffic before.
+		uint32_t trafficAfterEnacting = 80;
+		uint32_t measuredDays = 60;
+	};
+
+	struct ScenarioResult
+	{
+		int32_t mapConvergenceDays = -1;
+		double meanDeviation = 0.0;
+	};
+
+	void FillTrafficMap(MockSimGrid<uint8_t>* map, uint32_t coverage, std::mt19937& random)
+	{
+		std::uniform_int_distribution<int> percentages(0, 99);
+		std::uniform_int_distribution<int> values(1, 255);
+
+		for (uint8_t& value : map->GetValues())
+		{
+			value = percentages(random) < static_cast<int>(coverage) ? static_cast<uint8_t>(values(random)) : 0;
+		}
+	}
+
+	double GetMeanDeviation(const MockTrafficSimulator& trafficSimulator)
+	{
+		const std::vector<uint8_t>& values = trafficSimulator.GetMockCongestionMap()->GetValues();
+		const std::vector<uint8_t>& equilibrium = trafficSimulator.GetCongestionEquilibrium();
+
+		double sum = 0.0;
+
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			sum += std::abs(static_cast<double>(values[i]) - static_cast<double>(equilibrium[i]));
+		}
+
+		return values.empty() ? 0.0 : sum / static_cast<double>(values.size());
+	}
+
+	bool RunScenario(const BenchmarkOptions& options, bool seedTrafficMaps, ScenarioResult& result)
+	{
+		MockRuntimeOptions runtimeOptions;
+		runtimeOptions.cityCellCount = options.cityCellCount;
+
+		MockRuntime runtime(runtimeOptions);
+
+		TrafficTuningCoordinator coordinator;
+		coordinator.RegisterParticipant(kParticipantID, cRZBaseString("TrafficMapSeedingBenchmark"));
+		coordinator.SetSeedTrafficMapsOnRestart(seedTrafficMaps);
+
+		ParknRideOrdinance ordinance;
+		ordinance.SetTuningCoordinator(&coordinator, kParticipantID);
+
+		cISC4City* pCity = runtime.LoadCity();
+
+		std::mt19937 random(0x7aff1c);
+		MockTrafficSimulator& trafficSimulator = runtime.GetTrafficSimulator();
+
+		FillTrafficMap(trafficSimulator.GetMockCongestionMap(), options.trafficCoverage, random);
+		FillTrafficMap(trafficSimulator.GetMockTripLengthMap(), options.trafficCoverage, random);
+		trafficSimulator.SetEquilibrium(static_cast<double>(options.recoveryRate) / 100.0);
+
+		if (!ordinance.PostCityInit(pCity))
+		{
+			std::fprintf(stderr, "PostCityInit failed.\n");
+			return false;
+		}
+
+		ordinance.SetAvailable(true);
+		ordinance.UpdateCarCanReachDestination(/*calledFromPostCityInit*/true);
+		runtime.Tick();
+
+		// The ordinance reduces the traffic that the simulator converges to.
+		trafficSimulator.ScaleEquilibrium(options.trafficAfterEnacting);
+
+		Stopwatch stopwatch;
+		stopwatch.Start();
+
+		// Enacting the ordinance restarts the traffic simulator.
+		ordinance.SetOn(true);
+		runtime.Tick();
+
+		stopwatch.Stop();
+
+		double deviationSum = 0.0;
+		int32_t days = 0;
+
+		while (days < static_cast<int32_t>(options.measuredDays)
+			|| (coordinator.GetLastMapConvergenceDays() < 0 && days < kMaxDays))
+		{
+			runtime.AdvanceSimDate(1);
+			runtime.Tick();
+			days++;
+
+			if (days <= static_cast<int32_t>(options.measuredDays))
+			{
+				deviationSum += GetMeanDeviation(trafficSimulator);
+			}
+		}
+
+		result.mapConvergenceDays = coordinator.GetLastMapConvergenceDays();
+		result.meanDeviation = deviationSum / static_cast<double>(options.measuredDays);
+
+		char convergenceText[64]{};
+
+		if (result.mapConvergenceDays >= 0)
+		{
+			std::snprintf(convergenceText, sizeof(convergenceText), "map converged after %d days", result.mapConvergenceDays);
+		}
+		else
+		{
+			std::snprintf(convergenceText, sizeof(convergenceText), "map did not converge within %d days", kMaxDays);
+		}
+
+		std::printf(
+			"%-11s restart %lld us, %s, mean deviation from the equilibrium %.2f\n",
+			seedTrafficMaps ? "seeded" : "not seeded",
+			static_cast<long long>(stopwatch.ElapsedMicroseconds()),
+			convergenceText,
+			result.meanDeviation);
+
+		ordinance.PreCityShutdown(pCity);
+		runtime.UnloadCity();
+
+		return result.mapConvergenceDays >= 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--city-size", "cells", "The city width in cells", options.cityCellCount);
+	arguments.AddValue("--coverage", "percent", "The percentage of tracts with traffic", options.trafficCoverage, 1, 100);
+	arguments.AddValue("--recovery-rate", "percent", "The traffic recovered per simulation day", options.recoveryRate, 1, 100);
+	arguments.AddValue("--traffic-after", "percent", "The traffic after enacting the ordinance", options.trafficAfterEnacting, 0, 200);
+	arguments.AddValue("--days", "count", "The simulation days the deviation is averaged over", options.measuredDays, 1, kMaxDays);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	std::printf(
+		"%ux%u city, %u%% traffic coverage, %u%% recovery per day, %u%% traffic after enacting\n",
+		options.cityCellCount,
+		options.cityCellCount,
+		options.trafficCoverage,
+		options.recoveryRate,
+		options.trafficAfterEnacting);
+
+	ScenarioResult unseeded;
+	ScenarioResult seeded;
+
+	if (!RunScenario(options, /*seedTrafficMaps*/false, unseeded)
+		|| !RunScenario(options, /*seedTrafficMaps*/true, seeded))
+	{
+		std::fprintf(stderr, "The congestion map did not converge.\n");
+		return 1;
+	}
+
+	std::printf(
+		"Seeding changed the convergence time by %+d days and the mean deviation by %+.2f over %u days.\n",
+		seeded.mapConvergenceDays - unseeded.mapConvergenceDays,
+		seeded.meanDeviation - unseeded.meanDeviation,
+		options.measuredDays);
+
+	return 0;
+}
@@ -0,0 +1,295 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Compares the transit switch index with reading the traffic simulator transit switch
+// list for every query, and checks that both return the same switches and utilization.
+//
+// The index is then updated from simulated occupant insert and remove notifications,
+// and must match the traffic simulator list after reading it only once.
+
+#include "BenchmarkArguments.h"
+#include "MockRuntime.h"
+#include "Stopwatch.h"
+#include "TransitSwitchIndex.h"
+#include "cISC4Occupant.h"
+#include "cISC4TrafficSimulator.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t kTravelTypeCount = 9;
+
+	struct BenchmarkOptions
+	{
+		uint32_t switches = 400;
+		uint32_t queries = 10000;
+		uint32_t radius = 32;
+		uint32_t cityCells = 1024;
+		uint32_t changes = 40;
+	};
+
+	size_t AddRandomTransitSwitch(MockTrafficSimulator& trafficSimulator, uint32_t cityCells, std::mt19937& random)
+	{
+		std::uniform_int_distribution<long> positions(0, static_cast<long>(cityCells) - 4);
+		std::uniform_int_distribution<long> sizes(0, 3);
+		std::uniform_int_distribution<uint32_t> capacities(0, 2000);
+
+		const size_t index = trafficSimulator.AddTransitSwitch();
+		const long x = positions(random);
+		const long z = positions(random);
+
+		trafficSimulator.GetTransitSwitchOccupant(index).SetBoundingCityCells(x, z, x + sizes(random), z + sizes(random));
+
+		for (uint32_t travelType = 0; travelType < kTravelTypeCount; travelType++)
+		{
+			const uint32_t capacity = capacities(random);
+			trafficSimulator.SetTransitSwitchTraffic(index, travelType, capacity, capacity / 2);
+		}
+
+		return index;
+	}
+
+	// The query that the ridership features would make without the index:
+	// read the list, then check the location and traffic of every switch.
+	TransitSwitchIndex::UtilizationTotals QueryWithoutIndex(cISC4TrafficSimulator* pTrafficSimulator, int32_t cellX, int32_t cellZ, uint32_t radius)
+	{
+		TransitSwitchIndex::UtilizationTotals totals{};
+		ilist<cISC4Occupant*> transitSwitches;
+
+		if (pTrafficSimulator->GetTransitSwitches(transitSwitches))
+		{
+			const int64_t radiusSquared = static_cast<int64_t>(radius) * radius;
+
+			for (cISC4Occupant* pOccupant : transitSwitches)
+			{
+				SC4Rect<long> cells{};
+
+				if (!pOccupant->GetBoundingCityCells(cells))
+				{
+					continue;
+				}
+
+				const int64_t dx = ((cells.topLeftX + cells.bottomRightX) / 2) - cellX;
+				const int64_t dz = ((cells.topLeftY + cells.bottomRightY) / 2) - cellZ;
+
+				if ((dx * dx) + (dz * dz) <= radiusSquared)
+				{
+					cISCPropertyHolder* pPropertyHolder = pOccupant->AsPropertyHolder();
+
+					totals.switchCount++;
+
+					for (uint32_t travelType = 0; travelType < kTravelTypeCount; travelType++)
+					{
+						totals.capacity += pTrafficSimulator->GetMaxTripCapacity(pPropertyHolder, travelType);
+						totals.arrived += pTrafficSimulator->GetTrafficArrived(pPropertyHolder, travelType);
+					}
+				}
+			}
+		}
+
+		return totals;
+	}
+
+	bool MatchesTrafficSimulator(const TransitSwitchIndex& index, MockTrafficSimulator& trafficSimulator)
+	{
+		if (index.GetCount() != trafficSimulator.GetTransitSwitchCount())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < trafficSimulator.GetTransitSwitchCount(); i++)
+		{
+			if (!index.Find(&trafficSimulator.GetTransitSwitchOccupant(i)))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--switches", "n", "The transit switches in the city", options.switches);
+	arguments.AddValue("--queries", "n", "The radius queries", options.queries);
+	arguments.AddValue("--radius", "cells", "The query radius in city cells", options.radius);
+	arguments.AddValue("--city-cells", "n", "The city width and height in cells, at least 16", options.cityCells, 16);
+	arguments.AddValue("--changes", "n", "The switches added and removed after the build", options.changes);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	MockRuntimeOptions runtimeOptions;
+	runtimeOptions.cityCellCount = options.cityCells;
+
+	MockRuntime runtime(runtimeOptions);
+	MockTrafficSimulator& trafficSimulator = runtime.GetTrafficSimulator();
+	cISC4City* pCity = runtime.LoadCity();
+
+	std::mt19937 random(0x7a3c91);
+
+	for (uint32_t i = 0; i < options.switches; i++)
+	{
+		AddRandomTransitSwitch(trafficSimulator, options.cityCells, random);
+	}
+
+	TransitSwitchIndex index;
+
+	Stopwatch buildTime;
+	buildTime.Start();
+
+	if (!index.Build(pCity) || !index.UpdateUtilization())
+	{
+		std::fprintf(stderr, "Failed to build the index.\n");
+		return 1;
+	}
+
+	buildTime.Stop();
+
+	std::uniform_int_distribution<int32_t> cells(0, static_cast<int32_t>(options.cityCells) - 1);
+	std::vector<int32_t> queryCells(static_cast<size_t>(options.queries) * 2);
+
+	for (int32_t& cell : queryCells)
+	{
+		cell = cells(random);
+	}
+
+	std::vector<TransitSwitchIndex::UtilizationTotals> expected(options.queries);
+
+	Stopwatch withoutIndexTime;
+	withoutIndexTime.Start();
+
+	for (uint32_t i = 0; i < options.queries; i++)
+	{
+		expected[i] = QueryWithoutIndex(&trafficSimulator, queryCells[i * 2], queryCells[(i * 2) + 1], options.radius);
+	}
+
+	withoutIndexTime.Stop();
+
+	uint32_t mismatches = 0;
+	uint64_t matchedSwitches = 0;
+
+	Stopwatch withIndexTime;
+	withIndexTime.Start();
+
+	for (uint32_t i = 0; i < options.queries; i++)
+	{
+		const TransitSwitchIndex::UtilizationTotals actual = index.GetUtilizationWithinTiles(queryCells[i * 2], queryCells[(i * 2) + 1], options.radius);
+
+		if (actual.switchCount != expected[i].switchCount
+			|| actual.capacity != expected[i].capacity
+			|| actual.arrived != expected[i].arrived)
+		{
+			mismatches++;
+		}
+
+		matchedSwitches += actual.switchCount;
+	}
+
+	withIndexTime.Stop();
+
+	std::printf(
+		"%u switches, %u queries of radius %u in a %ux%u city, %.2f switches per query\n",
+		options.switches,
+		options.queries,
+		options.radius,
+		options.cityCells,
+		options.cityCells,
+		static_cast<double>(matchedSwitches) / static_cast<double>(options.queries));
+	std::printf(
+		"build + utilization %lld us, without index %.3f us/query, with index %.3f us/query\n",
+		static_cast<long long>(buildTime.ElapsedMicroseconds()),
+		static_cast<double>(withoutIndexTime.ElapsedMicroseconds()) / options.queries,
+		static_cast<double>(withIndexTime.ElapsedMicroseconds()) / options.queries);
+
+	if (mismatches != 0)
+	{
+		std::fprintf(stderr, "%u queries returned different results.\n", mismatches);
+		return 1;
+	}
+
+	// Add and remove switches, with other occupants in between that the index must ignore.
+	std::vector<MockOccupant> otherOccupants;
+	otherOccupants.reserve(options.changes * 2);
+
+	for (uint32_t i = 0; i < options.changes; i++)
+	{
+		const size_t added = AddRandomTransitSwitch(trafficSimulator, options.cityCells, random);
+		index.OccupantInserted(&trafficSimulator.GetTransitSwitchOccupant(added));
+
+		// A prop, and a building that is not a transit switch.
+		index.OccupantInserted(&otherOccupants.emplace_back());
+		index.OccupantInserted(&otherOccupants.emplace_back(0x278128A0));
+
+		std::uniform_int_distribution<size_t> existing(0, trafficSimulator.GetTransitSwitchCount() - 1);
+		const size_t removed = existing(random);
+
+		index.OccupantRemoved(&trafficSimulator.GetTransitSwitchOccupant(removed));
+		trafficSimulator.RemoveTransitSwitch(removed);
+	}
+
+	const uint32_t listReadsBeforeUpdate = trafficSimulator.GetTransitSwitchListCount();
+
+	Stopwatch updateTime;
+	updateTime.Start();
+
+	const bool updated = index.Update() && index.UpdateUtilization();
+
+	updateTime.Stop();
+
+	// Nothing was inserted since the last update, so the list must not be read again.
+	index.Update();
+
+	const uint32_t listReads = trafficSimulator.GetTransitSwitchListCount() - listReadsBeforeUpdate;
+
+	std::printf(
+		"%u insertions and removals: update %lld us, %u list reads, %zu switches indexed\n",
+		options.changes,
+		static_cast<long long>(updateTime.ElapsedMicroseconds()),
+		listReads,
+		index.GetCount());
+
+	if (!updated || listReads != 1 || !MatchesTrafficSimulator(index, trafficSimulator))
+	{
+		std::fprintf(stderr, "The index does not match the traffic simulator after the incremental update.\n");
+		return 1;
+	}
+
+	for (uint32_t i = 0; i < std::min<uint32_t>(options.queries, 1000); i++)
+	{
+		const int32_t cellX = queryCells[i * 2];
+		const int32_t cellZ = queryCells[(i * 2) + 1];
+		const TransitSwitchIndex::UtilizationTotals actual = index.GetUtilizationWithinTiles(cellX, cellZ, options.radius);
+		const TransitSwitchIndex::UtilizationTotals reference = QueryWithoutIndex(&trafficSimulator, cellX, cellZ, options.radius);
+
+		if (actual.switchCount != reference.switchCount || actual.capacity != reference.capacity)
+		{
+			std::fprintf(stderr, "The radius queries do not match after the incremental update.\n");
+			return 1;
+		}
+	}
+
+	index.Clear();
+	runtime.UnloadCity();
+
+	return 0;
+}
@@ -0,0 +1,314 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Writes a synthetic game folder and a plugins folder with nested subfolders and tens of
+// thousands of index entries, where several plugins replace the traffic simulator tuning
+// exemplar. The validator is run with one worker thread and with several, and both runs
+// are checked against the expected load order and exemplar schema.
+//
+// The program exits with a non-zero status if a result differs from the expected state.
+
+#include "BenchmarkArguments.h"
+#include "DBPFExemplar.h"
+#include "MockSaveGame.h"
+#include "TrafficSimulatorTuning.h"
+#include "TrafficTuningOverride.h"
+#include "TuningExemplarValidator.h"
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		uint32_t files = 400;
+		uint32_t entries = 100;
+		uint32_t threads = 4;
+	};
+
+	struct ExpectedSource
+	{
+		std::filesystem::path path;
+		TuningExemplarValidator::Status status;
+		bool precompiledOverride;
+	};
+
+	constexpr DBPFFile::ResourceKey kTuningExemplarKey
+	{
+		TrafficSimulatorTuning::kType,
+		TrafficSimulatorTuning::kGroup,
+		TrafficSimulatorTuning::kInstance,
+	};
+
+	std::vector<uint8_t> CreateTravelTypeExemplar(uint32_t count)
+	{
+		const std::vector<bool> values(count, true);
+
+		return MockSaveGame::CreateBoolArrayExemplar(TrafficSimulatorTuning::kTravelTypeCanReachDestination, values);
+	}
+
+	std::vector<uint8_t> CreatePrecompiledOverride()
+	{
+		const std::vector<uint8_t> installed = CreateTravelTypeExemplar(TrafficSimulatorTuning::kTravelTypeCount);
+		DBPFExemplar exemplar;
+		std::vector<uint8_t> data;
+
+		if (exemplar.Parse(installed.data(), installed.size()) && TrafficTuningOverride::Apply(exemplar))
+		{
+			exemplar.Write(data);
+		}
+
+		return data;
+	}
+
+	// The filler entries of a plugin, every other entry is compressed so that the directory is read.
+	std::vector<MockSaveGame::Entry> CreatePluginEntries(std::mt19937& random, uint32_t file, uint32_t count)
+	{
+		std::uniform_int_distribution<uint32_t> sizeDistribution(16, 256);
+		std::vector<MockSaveGame::Entry> entries;
+		entries.reserve(count + 1);
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const bool compressed = (i % 2) == 0;
+
+			entries.push_back(MockSaveGame::Entry
+			{
+				DBPFFile::ResourceKey{ DBPFExemplar::ExemplarType, 0x1e9a5a00 + file, i },
+				MockSaveGame::CreateRecordData(random, sizeDistribution(random)),
+				compressed,
+			});
+		}
+
+		return entries;
+	}
+
+	bool WritePlugin(
+		const std::filesystem::path& path,
+		std::vector<MockSaveGame::Entry> entries,
+		const std::vector<uint8_t>& exemplar)
+	{
+		if (!exemplar.empty())
+		{
+			// The exemplar is placed in the middle of the index so it is not found by accident.
+			entries.insert(entries.begin() + (entries.size() / 2), MockSaveGame::Entry{ kTuningExemplarKey, exemplar, true });
+		}
+
+		if (!MockSaveGame::WriteFile(path, MockSaveGame::BuildDBPF(entries)))
+		{
+			std::fprintf(stderr, "Failed to write %s.\n", path.string().c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	// Writes the plugins so that the names only load in the expected order when the names
+	// are compared without regard to case and the subfolders load before the files of their folder.
+	bool WriteFolders(
+		const BenchmarkOptions& options,
+		const std::filesystem::path& gameFolder,
+		const std::filesystem::path& pluginsFolder,
+		std::vector<ExpectedSource>& expectedSources)
+	{
+		std::mt19937 random(0x5ca40050);
+		std::error_code ec;
+
+		const std::filesystem::path nestedFolder = pluginsFolder / "a-Network" / "Tuning";
+		const std::filesystem::path lateFolder = pluginsFolder / "Z-Last";
+		std::filesystem::create_directories(gameFolder, ec);
+		std::filesystem::create_directories(nestedFolder, ec);
+		std::filesystem::create_directories(lateFolder, ec);
+
+		const std::vector<uint8_t> installed = CreateTravelTypeExemplar(TrafficSimulatorTuning::kTravelTypeCount);
+		const std::vector<uint8_t> precompiled = CreatePrecompiledOverride();
+		const std::vector<uint8_t> shortArray = CreateTravelTypeExemplar(TrafficSimulatorTuning::kTravelTypeCount - 1);
+
+		if (precompiled.empty())
+		{
+			std::fprintf(stderr, "The precompiled override could not be created.\n");
+			return false;
+		}
+
+		const std::filesystem::path gameFile = gameFolder / "SimCity_1.dat";
+		const std::filesystem::path shortArrayFile = nestedFolder / "Broken Tuning.dat";
+		const std::filesystem::path upperCaseFile = pluginsFolder / "a-Network" / "B Tuning.dat";
+		const std::filesystem::path lateFile = lateFolder / "c tuning.SC4Desc";
+		const std::filesystem::path overrideFile = pluginsFolder / "zzz_ParknRideTuning.dat";
+
+		if (!WritePlugin(gameFile, CreatePluginEntries(random, 0, options.entries), installed)
+			|| !WritePlugin(shortArrayFile, CreatePluginEntries(random, 1, options.entries), shortArray)
+			|| !WritePlugin(upperCaseFile, CreatePluginEntries(random, 2, options.entries), installed)
+			|| !WritePlugin(lateFile, CreatePluginEntries(random, 3, options.entries), installed)
+			|| !WritePlugin(overrideFile, std::vector<MockSaveGame::Entry>(), precompiled))
+		{
+			return false;
+		}
+
+		expectedSources.push_back(ExpectedSource{ gameFile, TuningExemplarValidator::Status::Valid, false });
+		expectedSources.push_back(ExpectedSource{ shortArrayFile, TuningExemplarValidator::Status::WrongCount, false });
+		expectedSources.push_back(ExpectedSource{ upperCaseFile, TuningExemplarValidator::Status::Valid, false });
+		expectedSources.push_back(ExpectedSource{ lateFile, TuningExemplarValidator::Status::Valid, false });
+		expectedSources.push_back(ExpectedSource{ overrideFile, TuningExemplarValidator::Status::Valid, true });
+
+		const std::filesystem::path folders[] = { pluginsFolder, nestedFolder, lateFolder, pluginsFolder / "a-Network" };
+
+		for (uint32_t file = 5; file < options.files; file++)
+		{
+			char name[64]{};
+			std::snprintf(name, sizeof(name), "Synthetic Plugin %05u.dat", file);
+
+			if (!WritePlugin(folders[file % 4] / name, CreatePluginEntries(random, file, options.entries), std::vector<uint8_t>()))
+			{
+				return false;
+			}
+		}
+
+		// The game skips the files that are not DBPF files.
+		const std::vector<uint8_t> readme(64, 'x');
+		return MockSaveGame::WriteFile(pluginsFolder / "Readme.txt", readme);
+	}
+
+	bool CheckResult(
+		const TuningExemplarValidator::Result& result,
+		const BenchmarkOptions& options,
+		const std::vector<ExpectedSource>& expectedSources)
+	{
+		// Every file has a directory entry. The first four files with the exemplar also have the
+		// filler entries, and the precompiled override only has the exemplar.
+		const uint64_t fillerFiles = options.files - 5;
+		const uint64_t expectedEntries = (fillerFiles * (options.entries + 1)) + (4 * (options.entries + 2)) + 2;
+
+		if (result.dbpfFiles != options.files || result.skippedFiles != 1 || result.indexEntries != expectedEntries)
+		{
+			std::fprintf(
+				stderr,
+				"Indexed %u DBPF files with %llu entries and skipped %u files, expected %u files with %llu entries and 1 skipped file.\n",
+				result.dbpfFiles,
+				static_cast<unsigned long long>(result.indexEntries),
+				result.skippedFiles,
+				options.files,
+				static_cast<unsigned long long>(expectedEntries));
+			return false;
+		}
+
+		if (result.sources.size() != expectedSources.size())
+		{
+			std::fprintf(stderr, "Found the exemplar in %zu files, expected %zu.\n", result.sources.size(), expectedSources.size());
+			return false;
+		}
+
+		for (size_t i = 0; i < result.sources.size(); i++)
+		{
+			const TuningExemplarValidator::ExemplarSource& source = result.sources[i];
+			const ExpectedSource& expected = expectedSources[i];
+
+			if (source.path != expected.path
+				|| source.status != expected.status
+				|| source.precompiledOverride != expected.precompiledOverride)
+			{
+				std::fprintf(
+					stderr,
+					"Source %zu is %s (%s), expected %s (%s).\n",
+					i,
+					source.path.string().c_str(),
+					TuningExemplarValidator::GetStatusName(source.status),
+					expected.path.string().c_str(),
+					TuningExemplarValidator::GetStatusName(expected.status));
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool RunBenchmark(const BenchmarkOptions& options, const std::filesystem::path& folder)
+	{
+		const std::filesystem::path gameFolder = folder / "SimCity 4";
+		const std::filesystem::path pluginsFolder = folder / "Plugins";
+		std::vector<ExpectedSource> expectedSources;
+
+		if (!WriteFolders(options, gameFolder, pluginsFolder, expectedSources))
+		{
+			return false;
+		}
+
+		std::vector<std::filesystem::path> paths;
+
+		if (!TuningExemplarValidator::FindGameFiles(gameFolder, paths)
+			|| !TuningExemplarValidator::FindPluginFiles(pluginsFolder, paths))
+		{
+			std::fprintf(stderr, "Failed to list the files.\n");
+			return false;
+		}
+
+		TuningExemplarValidator singleThreadValidator(1);
+		TuningExemplarValidator parallelValidator(options.threads);
+		TuningExemplarValidator::Result singleThreadResult;
+		TuningExemplarValidator::Result parallelResult;
+
+		singleThreadValidator.Validate(paths, singleThreadResult);
+		parallelValidator.Validate(paths, parallelResult);
+
+		if (!CheckResult(singleThreadResult, options, expectedSources) || !CheckResult(parallelResult, options, expectedSources))
+		{
+			return false;
+		}
+
+		const TuningExemplarValidator::Statistics& single = singleThreadValidator.GetStatistics();
+		const TuningExemplarValidator::Statistics& parallel = parallelValidator.GetStatistics();
+
+		std::printf(
+			"Validated %u synthetic DBPF files with %llu index entries.\n"
+			"1 thread: %lld ms\n"
+			"%u threads: %lld ms, %llu files stolen, %u hardware threads\n",
+			parallelResult.dbpfFiles,
+			static_cast<unsigned long long>(parallelResult.indexEntries),
+			static_cast<long long>(single.elapsedMilliseconds),
+			parallel.threadCount,
+			static_cast<long long>(parallel.elapsedMilliseconds),
+			static_cast<unsigned long long>(parallel.stolenItems),
+			std::thread::hardware_concurrency());
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--files", "n", "The number of DBPF files, at least 5", options.files, 5);
+	arguments.AddValue("--entries", "n", "The number of filler entries in each file", options.entries);
+	arguments.AddValue("--threads", "n", "The number of threads of the parallel run", options.threads);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	const std::filesystem::path folder = std::filesystem::temp_directory_path() / "TuningExemplarValidatorBenchmark";
+
+	std::error_code ec;
+	std::filesystem::remove_all(folder, ec);
+	std::filesystem::create_directories(folder, ec);
+
+	const bool succeeded = RunBenchmark(options, folder);
+
+	std::filesystem::remove_all(folder, ec);
+
+	return succeeded ? 0 : 1;
+}
@@ -0,0 +1,361 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Builds a precompiled traffic tuning override from a synthetic game DAT and checks that it
+// reads back with the car restriction, then compares the city load cost of the runtime
+// exemplar edit with the cost when the override is installed.
+//
+// The program exits with a non-zero status if the override is not written or detected correctly.
+
+#include "BenchmarkArguments.h"
+#include "DBPFExemplar.h"
+#include "DBPFFile.h"
+#include "DBPFWriter.h"
+#include "MockRuntime.h"
+#include "MockSaveGame.h"
+#include "ParknRideOrdinance.h"
+#include "Stopwatch.h"
+#include "TrafficSimulatorTuning.h"
+#include "TrafficTuningCoordinator.h"
+#include "TrafficTuningOverride.h"
+#include "cRZBaseString.h"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t kParticipantID = 0x8b8d3b1a;
+
+	constexpr DBPFFile::ResourceKey kTuningExemplarKey
+	{
+		TrafficSimulatorTuning::kType,
+		TrafficSimulatorTuning::kGroup,
+		TrafficSimulatorTuning::kInstance,
+	};
+
+	struct CityLoadResult
+	{
+		int64_t totalMicroseconds;
+		uint32_t trafficSimulatorMessages;
+		uint32_t hiddenPauses;
+		bool carCanReachDestination;
+	};
+
+	DBPFExemplar::Property CreateProperty(uint32_t id, DBPFExemplar::ValueType type, bool isArray, const std::vector<uint8_t>& values)
+	{
+		return DBPFExemplar::Property
+		{
+			id,
+			type,
+			isArray,
+			static_cast<uint32_t>(values.size() / DBPFExemplar::GetValueSize(type)),
+			values,
+		};
+	}
+
+	// Creates a tuning exemplar with the travel type array between other properties, like the game's copy.
+	bool CreateInstalledExemplar(std::vector<uint8_t>& data)
+	{
+		std::vector<uint8_t> name{ 'T', 'r', 'a', 'f', 'f', 'i', 'c', ' ', 'S', 'i', 'm' };
+		std::vector<uint8_t> speeds(12 * sizeof(float));
+		const float speedValues[12] = { 1.0f, 4.5f, 6.0f, 8.0f, 2.5f, 3.0f, 9.0f, 1.2f, 0.5f, 7.5f, 4.0f, 2.0f };
+		std::memcpy(speeds.data(), speedValues, speeds.size());
+
+		const std::vector<uint8_t> travelTypes(TrafficSimulatorTuning::kTravelTypeCount, 1);
+
+		DBPFExemplar exemplar;
+
+		if (!exemplar.SetProperty(CreateProperty(0x00000020, DBPFExemplar::ValueType::String, true, name))
+			|| !exemplar.SetProperty(CreateProperty(0xa9235617, DBPFExemplar::ValueType::Float32, true, speeds))
+			|| !exemplar.SetProperty(CreateProperty(TrafficSimulatorTuning::kTravelTypeCanReachDestination, DBPFExemplar::ValueType::Bool, true, travelTypes))
+			|| !exemplar.SetProperty(CreateProperty(0x4a3b5c10, DBPFExemplar::ValueType::Uint8, false, { 3 })))
+		{
+			return false;
+		}
+
+		exemplar.Write(data);
+		return true;
+	}
+
+	bool CheckOverrideFile(const std::filesystem::path& folder)
+	{
+		std::vector<uint8_t> installedData;
+
+		if (!CreateInstalledExemplar(installedData))
+		{
+			std::fprintf(stderr, "The synthetic tuning exemplar could not be created.\n");
+			return false;
+		}
+
+		// The game DAT has the exemplar compressed among many other entries.
+		std::mt19937 random(0x5ca40048);
+		std::vector<MockSaveGame::Entry> entries;
+
+		for (uint32_t i = 0; i < 500; i++)
+		{
+			entries.push_back(MockSaveGame::Entry
+			{
+				DBPFFile::ResourceKey{ DBPFExemplar::ExemplarType, 0x1234abcd, i },
+				MockSaveGame::CreateRecordData(random, 2048),
+				true,
+			});
+		}
+
+		entries.push_back(MockSaveGame::Entry{ kTuningExemplarKey, installedData, true });
+
+		const std::filesystem::path gamePath = folder / "SimCity_1.dat";
+		const std::filesystem::path overridePath = folder / "zzz_ParknRideTuningOverride.dat";
+
+		DBPFFile gameFile;
+		DBPFFile::IndexEntry entry{};
+		std::vector<uint8_t> buffer;
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+		DBPFExemplar exemplar;
+
+		if (!MockSaveGame::WriteFile(gamePath, MockSaveGame::BuildDBPF(entries))
+			|| !gameFile.Open(gamePath)
+			|| !gameFile.FindEntry(kTuningExemplarKey, entry)
+			|| !gameFile.IsCompressed(entry)
+			|| !gameFile.ReadEntryData(entry, buffer, data, size)
+			|| !exemplar.Parse(data, size))
+		{
+			std::fprintf(stderr, "The synthetic game DAT could not be read.\n");
+			return false;
+		}
+
+		// A parsed exemplar must be written back unchanged.
+		std::vector<uint8_t> written;
+		exemplar.Write(written);
+
+		if (written != installedData)
+		{
+			std::fprintf(stderr, "The exemplar was not written back unchanged.\n");
+			return false;
+		}
+
+		if (TrafficTuningOverride::IsApplied(exemplar) || !TrafficTuningOverride::Apply(exemplar))
+		{
+			std::fprintf(stderr, "The override could not be applied.\n");
+			return false;
+		}
+
+		exemplar.Write(written);
+
+		DBPFWriter writer;
+
+		if (!writer.Open(overridePath)
+			|| !writer.AddEntry(kTuningExemplarKey, written.data(), written.size(), /*compress*/true)
+			|| !writer.Close())
+		{
+			std::fprintf(stderr, "The override DAT could not be written.\n");
+			return false;
+		}
+
+		DBPFFile overrideFile;
+		DBPFExemplar overrideExemplar;
+
+		if (!overrideFile.Open(overridePath)
+			|| overrideFile.GetIndexEntryCount() == 0
+			|| !overrideFile.FindEntry(kTuningExemplarKey, entry)
+			|| !overrideFile.ReadEntryData(entry, buffer, data, size)
+			|| !overrideExemplar.Parse(data, size)
+			|| !TrafficTuningOverride::IsApplied(overrideExemplar))
+		{
+			std::fprintf(stderr, "The override DAT does not have the car restriction.\n");
+			return false;
+		}
+
+		// Only the car item of the travel type array and the marker may differ from the installed exemplar.
+		DBPFExemplar installedExemplar;
+		installedExemplar.Parse(installedData.data(), installedData.size());
+
+		const std::vector<DBPFExemplar::Property>& installedProperties = installedExemplar.GetProperties();
+		const std::vector<DBPFExemplar::Property>& overrideProperties = overrideExemplar.GetProperties();
+
+		if (overrideProperties.size() != installedProperties.size() + 1)
+		{
+			std::fprintf(stderr, "The override DAT has %zu properties, expected %zu.\n", overrideProperties.size(), installedProperties.size() + 1);
+			return false;
+		}
+
+		for (size_t i = 0; i < installedProperties.size(); i++)
+		{
+			std::vector<uint8_t> expectedValues = installedProperties[i].values;
+
+			if (installedProperties[i].id == TrafficSimulatorTuning::kTravelTypeCanReachDestination)
+			{
+				expectedValues[TrafficSimulatorTuning::kCarTravelTypeIndex] = 0;
+			}
+
+			if (overrideProperties[i].id != installedProperties[i].id
+				|| overrideProperties[i].type != installedProperties[i].type
+				|| overrideProperties[i].values != expectedValues)
+			{
+				std::fprintf(stderr, "Property 0x%08x was changed by the override.\n", installedProperties[i].id);
+				return false;
+			}
+		}
+
+		std::printf(
+			"Wrote a %zu byte override exemplar from a %ju byte game DAT.\n",
+			written.size(),
+			static_cast<uintmax_t>(std::filesystem::file_size(gamePath)));
+
+		return true;
+	}
+
+	bool GetCarCanReachDestination(MockRuntime& runtime, bool& value)
+	{
+		cISCProperty* property = runtime.GetTrafficTuningExemplar()->GetProperty(TrafficSimulatorTuning::kTravelTypeCanReachDestination);
+
+		if (property)
+		{
+			cIGZVariant* data = property->GetPropertyValue();
+
+			if (data && data->GetCount() > TrafficSimulatorTuning::kCarTravelTypeIndex)
+			{
+				value = data->RefBool()[TrafficSimulatorTuning::kCarTravelTypeIndex];
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Loads a city the same way as the DLL director's PostCityInit handler, with the ordinance enacted.
+	// Each city is loaded in a new game session, the cached tuning exemplar starts as the game's copy.
+	bool MeasureCityLoads(bool precompiledTuningOverride, uint32_t cities, CityLoadResult& result)
+	{
+		MockRuntimeOptions runtimeOptions;
+		runtimeOptions.precompiledTuningOverride = precompiledTuningOverride;
+
+		result = CityLoadResult{};
+
+		for (uint32_t cityIndex = 0; cityIndex < cities; cityIndex++)
+		{
+			MockRuntime runtime(runtimeOptions);
+
+			TrafficTuningCoordinator coordinator;
+			coordinator.RegisterParticipant(kParticipantID, cRZBaseString("TuningOverrideBenchmark"));
+
+			ParknRideOrdinance ordinance;
+			ordinance.SetTuningCoordinator(&coordinator, kParticipantID);
+			// The ordinance is enacted in the save game, before PostCityInit the state change is not applied.
+			ordinance.SetOn(true);
+
+			cISC4City* pCity = runtime.LoadCity();
+
+			Stopwatch stopwatch;
+			stopwatch.Start();
+
+			if (!ordinance.PostCityInit(pCity))
+			{
+				std::fprintf(stderr, "PostCityInit failed for city %u.\n", cityIndex);
+				return false;
+			}
+
+			ordinance.SetAvailable(true);
+
+			const bool installed = TrafficTuningCoordinator::IsPrecompiledOverrideInstalled();
+
+			if (installed != precompiledTuningOverride)
+			{
+				std::fprintf(stderr, "The precompiled override was %sdetected.\n", installed ? "" : "not ");
+				return false;
+			}
+
+			ordinance.SetPrecompiledTuningOverride(installed);
+			ordinance.UpdateCarCanReachDestination(/*calledFromPostCityInit*/true);
+			runtime.Tick();
+
+			stopwatch.Stop();
+			result.totalMicroseconds += stopwatch.ElapsedMicroseconds();
+
+			if (!GetCarCanReachDestination(runtime, result.carCanReachDestination) || result.carCanReachDestination)
+			{
+				std::fprintf(stderr, "Cars are not restricted after loading city %u.\n", cityIndex);
+				return false;
+			}
+
+			ordinance.PreCityShutdown(pCity);
+			runtime.UnloadCity();
+
+			result.trafficSimulatorMessages += runtime.GetTrafficSimulatorMessageCount() + runtime.GetTrafficSimulatorRestartCount();
+			result.hiddenPauses += runtime.GetHiddenPauseCount();
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t cities = 20;
+
+	BenchmarkArguments arguments;
+	arguments.AddValue("--cities", "n", "The number of city loads that are measured", cities);
+
+	if (!arguments.Parse(argc, argv))
+	{
+		arguments.PrintUsage(argv[0]);
+		return 2;
+	}
+
+	const std::filesystem::path folder = std::filesystem::temp_directory_path() / "TuningOverrideBenchmark";
+
+	std::error_code ec;
+	std::filesystem::remove_all(folder, ec);
+	std::filesystem::create_directories(folder, ec);
+
+	const bool fileChecked = CheckOverrideFile(folder);
+
+	std::filesystem::remove_all(folder, ec);
+
+	if (!fileChecked)
+	{
+		return 1;
+	}
+
+	CityLoadResult runtimeEdit{};
+	CityLoadResult precompiled{};
+
+	if (!MeasureCityLoads(false, cities, runtimeEdit) || !MeasureCityLoads(true, cities, precompiled))
+	{
+		return 1;
+	}
+
+	// The override must remove every traffic simulator notification from the city load.
+	if (precompiled.trafficSimulatorMessages != 0 || precompiled.hiddenPauses != 0)
+	{
+		std::fprintf(
+			stderr,
+			"The city load with the precompiled override sent %u traffic simulator messages and %u pauses.\n",
+			precompiled.trafficSimulatorMessages,
+			precompiled.hiddenPauses);
+		return 1;
+	}
+
+	std::printf(
+		"%u city loads\n"
+		"runtime edit: %.1fus per city, %u traffic simulator messages\n"
+		"precompiled override: %.1fus per city, %u traffic simulator messages\n",
+		cities,
+		static_cast<double>(runtimeEdit.totalMicroseconds) / cities,
+		runtimeEdit.trafficSimulatorMessages,
+		static_cast<double>(precompiled.totalMicroseconds) / cities,
+		precompiled.trafficSimulatorMessages);
+
+	return 0;
+}
@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "CongestionMonitor.h"
+#include "ParknRideOrdinance.h"
+#include "Settings.h"
+#include "cISC4City.h"
+#include "cISC4SimGrid.h"
+#include "cISC4Simulator.h"
+#include "cISC4TrafficSimulator.h"
+
+namespace
+{
+	constexpr uint32_t kCongestionMonitorServiceID = 0x3c1f7e92;
+
+	// The sampling is cheap, so it runs with the default priority.
+	constexpr int32_t kCongestionMonitorServicePriority = 0;
+}
+
+CongestionMonitor::CongestionMonitor()
+	: TickServiceBase(kCongestionMonitorServiceID, kCongestionMonitorServicePriority),
+	  logger(Logger::GetInstance()),
+	  pCity(nullptr),
+	  pOrdinance(nullptr),
+	  autoMode(false),
+	  enableThreshold(0),
+	  disableThreshold(0),
+	  tractsPerDay(0),
+	  lastSimDate(0),
+	  sampler(),
+	  samplingTime(),
+	  samplingSteps(0)
+{
+}
+
+bool CongestionMonitor::Start(cISC4City* pCity, ParknRideOrdinance* pOrdinance, const Settings& settings, bool autoMode)
+{
+	Stop();
+
+	if (!pCity || !pOrdinance)
+	{
+		return false;
+	}
+
+	cISC4Simulator* pSimulator = pCity->GetSimulator();
+
+	if (!pSimulator)
+	{
+		logger.WriteLine(LogOptions::Errors, "The cISC4Simulator pointer was null.");
+		return false;
+	}
+
+	this->pCity = pCity;
+	this->pOrdinance = pOrdinance;
+	this->autoMode = autoMode;
+	enableThreshold = settings.congestionEnableThreshold;
+	disableThreshold = settings.congestionDisableThreshold;
+	tractsPerDay = settings.congestionTractsPerDay;
+	lastSimDate = pSimulator->GetSimDateNumber();
+	sampler.Reset(GetCongestionMap(), tractsPerDay);
+	samplingTime.Reset();
+	samplingSteps = 0;
+
+	if (!RegisterTick())
+	{
+		logger.WriteLine(LogOptions::Errors, "Failed to register the congestion monitor tick service.");
+		Stop();
+		return false;
+	}
+
+	if (autoMode)
+	{
+		logger.WriteLineFormatted(
+			LogOptions::Info,
+			"Park & Ride auto mode: enable at %u, disable at %u, sampling %u tracts per day.",
+			enableThreshold,
+			disableThreshold,
+			tractsPerDay);
+	}
+	else
+	{
+		logger.WriteLineFormatted(
+			LogOptions::Info,
+			"Park & Ride congestion monitor: sampling %u tracts per day.",
+			tractsPerDay);
+	}
+
+	return true;
+}
+
+void CongestionMonitor::Stop()
+{
+	UnregisterTick();
+
+	pCity = nullptr;
+	pOrdinance = nullptr;
+	autoMode = false;
+	sampler.Clear();
+}
+
+bool CongestionMonitor::GetMapAverageCongestion(double& value) const
+{
+	if (!sampler.HasCompletePass())
+	{
+		return false;
+	}
+
+	value = sampler.GetMapAverageCongestion();
+	return true;
+}
+
+bool CongestionMonitor::Shutdown()
+{
+	Stop();
+	return true;
+}
+
+bool CongestionMonitor::OnTick()
+{
+	if (!pCity)
+	{
+		return true;
+	}
+
+	cISC4Simulator* pSimulator = pCity->GetSimulator();
+
+	if (!pSimulator)
+	{
+		return true;
+	}
+
+	// The sampling is driven by the simulation date, so nothing is sampled while the game is paused.
+	const int32_t simDate = pSimulator->GetSimDateNumber();
+
+	if (simDate == lastSimDate)
+	{
+		return true;
+	}
+
+	lastSimDate = simDate;
+
+	samplingTime.Start();
+
+	// The traffic simulator recreates its maps when it is restarted, so the map is
+	// checked on every step. The sampling starts over if the buffer changed.
+	const SimGridView<uint8_t> congestionMap = GetCongestionMap();
+
+	if (congestionMap != sampler.GetGrid())
+	{
+		sampler.Reset(congestionMap, tractsPerDay);
+	}
+
+	const bool completedPass = sampler.Step();
+
+	samplingTime.Stop();
+	samplingSteps++;
+
+	if (completedPass)
+	{
+		if (autoMode)
+		{
+			UpdateRestriction();
+		}
+
+		WriteProfilingReport();
+	}
+
+	return true;
+}
+
+SimGridView<uint8_t> CongestionMonitor::GetCongestionMap() const
+{
+	cISC4TrafficSimulator* pTrafficSimulator = pCity ? pCity->GetTrafficSimulator() : nullptr;
+
+	if (!pTrafficSimulator)
+	{
+		return SimGridView<uint8_t>();
+	}
+
+	return SimGridView<uint8_t>::FromGrid(reinterpret_cast<cISC4SimGrid<uint8_t>*>(pTrafficSimulator->GetCongestionMap()));
+}
+
+void CongestionMonitor::UpdateRestriction()
+{
+	const double averageCongestion = sampler.GetAverageCongestion();
+	const bool restrictionActive = pOrdinance->IsCongestionRestrictionActive();
+
+	if (!restrictionActive && averageCongestion >= static_cast<double>(enableThreshold))
+	{
+		logger.WriteLineFormatted(
+			LogOptions::Info,
+			"Park & Ride auto mode: restricting cars, average congestion %.1f >= %u.",
+			averageCongestion,
+			enableThreshold);
+
+		pOrdinance->SetCongestionRestrictionActive(true);
+	}
+	else if (restrictionActive && averageCongestion < static_cast<double>(disableThreshold))
+	{
+		logger.WriteLineFormatted(
+			LogOptions::Info,
+			"Park & Ride auto mode: lifting the car restriction, average congestion %.1f < %u.",
+			averageCongestion,
+			disableThreshold);
+
+		pOrdinance->SetCongestionRestrictionActive(false);
+	}
+}
+
+void CongestionMonitor::WriteProfilingReport()
+{
+	if (logger.IsEnabled(LogOptions::Profiling))
+	{
+		const SimGridView<uint8_t>& grid = sampler.GetGrid();
+		const int64_t elapsedMicroseconds = samplingTime.ElapsedMicroseconds();
+
+		logger.WriteLineFormatted(
+			LogOptions::Profiling,
+			"Congestion sampling: %dx%d tracts in %u steps, %lld us total, %.2f us/step,"
+			" average congestion %.1f, traffic coverage %.1f%%.",
+			grid.CountX(),
+			grid.CountZ(),
+			samplingSteps,
+			elapsedMicroseconds,
+			samplingSteps > 0 ? static_cast<double>(elapsedMicroseconds) / static_cast<double>(samplingSteps) : 0.0,
+			sampler.GetAverageCongestion(),
+			sampler.GetTrafficCoverage());
+	}
+
+	samplingTime.Reset();
+	samplingSteps = 0;
+}
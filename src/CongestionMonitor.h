@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "CongestionSampler.h"
+#include "Logger.h"
+#include "Stopwatch.h"
+#include "TickServiceBase.h"
+
+class cISC4City;
+class ParknRideOrdinance;
+class Settings;
+
+// Drives the ordinance's auto mode from the traffic simulator congestion map.
+//
+// The monitor is a framework tick service that samples one chunk of the congestion
+// map each time the simulation date advances, so the cost per game day is bounded
+// by the CongestionTractsPerDay setting regardless of the city size.
+// After every complete pass over the map the average congestion is compared against
+// the enable and disable thresholds, the gap between them provides the hysteresis.
+// Without auto mode the monitor only keeps the average for the ridership scaled effects.
+class CongestionMonitor final : public TickServiceBase
+{
+public:
+
+	CongestionMonitor();
+
+	/**
+	 * @brief Starts monitoring the congestion in the specified city.
+	 * @param pCity The city.
+	 * @param pOrdinance The ordinance that the monitor controls.
+	 * @param settings The auto mode settings.
+	 * @param autoMode True if the monitor sets the ordinance's congestion restriction; otherwise, false.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Start(cISC4City* pCity, ParknRideOrdinance* pOrdinance, const Settings& settings, bool autoMode);
+
+	/**
+	 * @brief Stops monitoring the city, this must be called before the city is destroyed.
+	 */
+	void Stop();
+
+	/**
+	 * @brief Gets the average congestion of every congestion map tract from the sampled totals.
+	 * @param value Receives the average congestion.
+	 * @return True if the whole map has been sampled since the traffic simulator created it; otherwise, false.
+	 */
+	bool GetMapAverageCongestion(double& value) const;
+
+	bool Shutdown() override;
+	bool OnTick() override;
+
+private:
+
+	SimGridView<uint8_t> GetCongestionMap() const;
+	void UpdateRestriction();
+	void WriteProfilingReport();
+
+	Logger& logger;
+	cISC4City* pCity;
+	ParknRideOrdinance* pOrdinance;
+	bool autoMode;
+	uint32_t enableThreshold;
+	uint32_t disableThreshold;
+	uint32_t tractsPerDay;
+	int32_t lastSimDate;
+	CongestionSampler sampler;
+	// The time spent sampling since the last profiling report.
+	Stopwatch samplingTime;
+	uint32_t samplingSteps;
+};
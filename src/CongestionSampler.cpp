@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "CongestionSampler.h"
+#include "SimGridReductions.h"
+#include <algorithm>
+
+namespace
+{
+	// Limits the chunk size so that the per-chunk sum of 8-bit values fits in 32 bits.
+	constexpr size_t MaxTractsPerChunk = 1 << 24;
+}
+
+CongestionSampler::CongestionSampler()
+	: grid(),
+	  tractsPerChunk(1),
+	  nextChunk(0),
+	  completePass(false),
+	  congestionSum(0),
+	  trafficTracts(0),
+	  chunks()
+{
+}
+
+void CongestionSampler::Reset(const SimGridView<uint8_t>& grid, uint32_t tractsPerStep)
+{
+	this->grid = grid;
+	tractsPerChunk = std::clamp<size_t>(tractsPerStep, 1, MaxTractsPerChunk);
+	nextChunk = 0;
+	completePass = false;
+	congestionSum = 0;
+	trafficTracts = 0;
+
+	const size_t chunkCount = (grid.Size() + tractsPerChunk - 1) / tractsPerChunk;
+
+	chunks.assign(chunkCount, ChunkTotals{});
+}
+
+void CongestionSampler::Clear()
+{
+	Reset(SimGridView<uint8_t>(), 1);
+}
+
+const SimGridView<uint8_t>& CongestionSampler::GetGrid() const
+{
+	return grid;
+}
+
+bool CongestionSampler::Step()
+{
+	if (chunks.empty())
+	{
+		return false;
+	}
+
+	const size_t start = nextChunk * tractsPerChunk;
+	const size_t end = std::min(start + tractsPerChunk, grid.Size());
+
+	const uint8_t* const data = grid.Data() + start;
+	const size_t count = end - start;
+
+	const uint32_t chunkCongestionSum = static_cast<uint32_t>(SimGridReductions::Sum(data, count));
+	const uint32_t chunkTrafficTracts = static_cast<uint32_t>(SimGridReductions::CountAtLeast(data, count, 1));
+
+	ChunkTotals& totals = chunks[nextChunk];
+
+	congestionSum = congestionSum - totals.congestionSum + chunkCongestionSum;
+	trafficTracts = trafficTracts - totals.trafficTracts + chunkTrafficTracts;
+	totals.congestionSum = chunkCongestionSum;
+	totals.trafficTracts = chunkTrafficTracts;
+
+	nextChunk++;
+
+	if (nextChunk == chunks.size())
+	{
+		nextChunk = 0;
+		completePass = true;
+		return true;
+	}
+
+	return false;
+}
+
+bool CongestionSampler::HasCompletePass() const
+{
+	return completePass;
+}
+
+double CongestionSampler::GetAverageCongestion() const
+{
+	if (trafficTracts == 0)
+	{
+		return 0.0;
+	}
+
+	return static_cast<double>(congestionSum) / static_cast<double>(trafficTracts);
+}
+
+double CongestionSampler::GetMapAverageCongestion() const
+{
+	const size_t tractCount = grid.Size();
+
+	if (tractCount == 0)
+	{
+		return 0.0;
+	}
+
+	return static_cast<double>(congestionSum) / static_cast<double>(tractCount);
+}
+
+double CongestionSampler::GetTrafficCoverage() const
+{
+	const size_t tractCount = grid.Size();
+
+	if (tractCount == 0)
+	{
+		return 0.0;
+	}
+
+	return (static_cast<double>(trafficTracts) * 100.0) / static_cast<double>(tractCount);
+}
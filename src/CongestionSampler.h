@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "SimGridView.h"
+#include <vector>
+
+// Incrementally samples a congestion map to maintain the city-wide average congestion.
+//
+// The grid is split into fixed-size chunks of consecutive tracts, and each Step call
+// rescans one chunk. The totals for every chunk are kept, so the average always covers
+// the whole grid and is at most one full pass old, while the cost of a step is bounded
+// by the chunk size instead of the map size.
+class CongestionSampler
+{
+public:
+
+	CongestionSampler();
+
+	/**
+	 * @brief Starts sampling a new grid, discarding the existing totals.
+	 * @param grid The congestion map view.
+	 * @param tractsPerStep The number of tracts that each step samples.
+	 */
+	void Reset(const SimGridView<uint8_t>& grid, uint32_t tractsPerStep);
+
+	/**
+	 * @brief Removes the grid, this must be called before the grid is destroyed.
+	 */
+	void Clear();
+
+	const SimGridView<uint8_t>& GetGrid() const;
+
+	/**
+	 * @brief Samples the next chunk of the grid.
+	 * @return True if the step completed a pass over the grid; otherwise, false.
+	 */
+	bool Step();
+
+	/**
+	 * @brief Gets a value indicating whether every chunk has been sampled at least once.
+	 */
+	bool HasCompletePass() const;
+
+	/**
+	 * @brief Gets the average congestion of the tracts that have traffic.
+	 * @return The average congestion, or zero if none of the tracts have traffic.
+	 */
+	double GetAverageCongestion() const;
+
+	/**
+	 * @brief Gets the average congestion of all of the grid's tracts, including the tracts without traffic.
+	 */
+	double GetMapAverageCongestion() const;
+
+	/**
+	 * @brief Gets the percentage of the grid's tracts that have traffic.
+	 */
+	double GetTrafficCoverage() const;
+
+private:
+
+	struct ChunkTotals
+	{
+		uint32_t congestionSum;
+		uint32_t trafficTracts;
+	};
+
+	SimGridView<uint8_t> grid;
+	size_t tractsPerChunk;
+	size_t nextChunk;
+	bool completePass;
+	uint64_t congestionSum;
+	uint64_t trafficTracts;
+	std::vector<ChunkTotals> chunks;
+};
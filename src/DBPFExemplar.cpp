@@ -0,0 +1,292 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "DBPFExemplar.h"
+#include <cstring>
+
+namespace
+{
+	constexpr size_t kSignatureLength = 8;
+	constexpr uint16_t kKeyTypeSingle = 0x0000;
+	constexpr uint16_t kKeyTypeArray = 0x0080;
+	// The exemplars with the most properties have a few hundred of them.
+	constexpr uint32_t kMaxPropertyCount = 65536;
+
+	const char* GetSignature(bool cohort)
+	{
+		return cohort ? "CQZB1###" : "EQZB1###";
+	}
+
+	template<typename T> void Append(std::vector<uint8_t>& data, T value)
+	{
+		const size_t offset = data.size();
+
+		data.resize(offset + sizeof(T));
+		std::memcpy(data.data() + offset, &value, sizeof(T));
+	}
+
+	class EntryReader
+	{
+	public:
+
+		EntryReader(const uint8_t* data, size_t size) : data(data), size(size), position(0)
+		{
+		}
+
+		template<typename T> bool Read(T& value)
+		{
+			if (size - position < sizeof(T))
+			{
+				return false;
+			}
+
+			std::memcpy(&value, data + position, sizeof(T));
+			position += sizeof(T);
+			return true;
+		}
+
+		bool ReadBytes(std::vector<uint8_t>& bytes, size_t count)
+		{
+			if (size - position < count)
+			{
+				return false;
+			}
+
+			bytes.assign(data + position, data + position + count);
+			position += count;
+			return true;
+		}
+
+	private:
+
+		const uint8_t* data;
+		size_t size;
+		size_t position;
+	};
+}
+
+DBPFExemplar::DBPFExemplar()
+	: cohort(false),
+	  parentCohort(),
+	  properties()
+{
+}
+
+bool DBPFExemplar::Parse(const uint8_t* data, size_t size)
+{
+	cohort = false;
+	parentCohort = DBPFFile::ResourceKey{};
+	properties.clear();
+
+	if (size < kSignatureLength)
+	{
+		return false;
+	}
+
+	if (std::memcmp(data, GetSignature(false), kSignatureLength) == 0)
+	{
+		cohort = false;
+	}
+	else if (std::memcmp(data, GetSignature(true), kSignatureLength) == 0)
+	{
+		cohort = true;
+	}
+	else
+	{
+		return false;
+	}
+
+	EntryReader reader(data + kSignatureLength, size - kSignatureLength);
+	uint32_t propertyCount = 0;
+
+	if (!reader.Read(parentCohort.type)
+		|| !reader.Read(parentCohort.group)
+		|| !reader.Read(parentCohort.instance)
+		|| !reader.Read(propertyCount)
+		|| propertyCount > kMaxPropertyCount)
+	{
+		return false;
+	}
+
+	properties.resize(propertyCount);
+
+	for (Property& property : properties)
+	{
+		uint16_t type = 0;
+		uint16_t keyType = 0;
+		uint8_t unused = 0;
+
+		if (!reader.Read(property.id) || !reader.Read(type) || !reader.Read(keyType) || !reader.Read(unused))
+		{
+			return false;
+		}
+
+		property.type = static_cast<ValueType>(type);
+
+		const uint32_t valueSize = GetValueSize(property.type);
+
+		if (valueSize == 0)
+		{
+			return false;
+		}
+
+		if (keyType == kKeyTypeArray)
+		{
+			property.isArray = true;
+
+			if (!reader.Read(property.count))
+			{
+				return false;
+			}
+		}
+		else if (keyType == kKeyTypeSingle)
+		{
+			property.isArray = false;
+			property.count = 1;
+		}
+		else
+		{
+			return false;
+		}
+
+		if (!reader.ReadBytes(property.values, static_cast<size_t>(property.count) * valueSize))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool DBPFExemplar::IsCohort() const
+{
+	return cohort;
+}
+
+const DBPFFile::ResourceKey& DBPFExemplar::GetParentCohort() const
+{
+	return parentCohort;
+}
+
+const std::vector<DBPFExemplar::Property>& DBPFExemplar::GetProperties() const
+{
+	return properties;
+}
+
+const DBPFExemplar::Property* DBPFExemplar::FindProperty(uint32_t id) const
+{
+	for (const Property& property : properties)
+	{
+		if (property.id == id)
+		{
+			return &property;
+		}
+	}
+
+	return nullptr;
+}
+
+bool DBPFExemplar::SetProperty(const Property& property)
+{
+	const uint32_t valueSize = GetValueSize(property.type);
+
+	if (valueSize == 0
+		|| (!property.isArray && property.count != 1)
+		|| property.values.size() != static_cast<size_t>(property.count) * valueSize)
+	{
+		return false;
+	}
+
+	for (Property& existing : properties)
+	{
+		if (existing.id == property.id)
+		{
+			existing = property;
+			return true;
+		}
+	}
+
+	properties.push_back(property);
+	return true;
+}
+
+void DBPFExemplar::Write(std::vector<uint8_t>& data) const
+{
+	data.clear();
+	data.insert(data.end(), GetSignature(cohort), GetSignature(cohort) + kSignatureLength);
+
+	Append(data, parentCohort.type);
+	Append(data, parentCohort.group);
+	Append(data, parentCohort.instance);
+	Append(data, static_cast<uint32_t>(properties.size()));
+
+	for (const Property& property : properties)
+	{
+		Append(data, property.id);
+		Append(data, static_cast<uint16_t>(property.type));
+		Append(data, property.isArray ? kKeyTypeArray : kKeyTypeSingle);
+		Append(data, uint8_t(0));
+
+		if (property.isArray)
+		{
+			Append(data, property.count);
+		}
+
+		data.insert(data.end(), property.values.begin(), property.values.end());
+	}
+}
+
+uint32_t DBPFExemplar::GetValueSize(ValueType type)
+{
+	switch (type)
+	{
+	case ValueType::Uint8:
+	case ValueType::Bool:
+	case ValueType::String:
+		return 1;
+	case ValueType::Uint16:
+		return 2;
+	case ValueType::Uint32:
+	case ValueType::Sint32:
+	case ValueType::Float32:
+		return 4;
+	case ValueType::Sint64:
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+const char* DBPFExemplar::GetValueTypeName(ValueType type)
+{
+	switch (type)
+	{
+	case ValueType::Uint8:
+		return "Uint8";
+	case ValueType::Uint16:
+		return "Uint16";
+	case ValueType::Uint32:
+		return "Uint32";
+	case ValueType::Sint32:
+		return "Sint32";
+	case ValueType::Sint64:
+		return "Sint64";
+	case ValueType::Float32:
+		return "Float32";
+	case ValueType::Bool:
+		return "Bool";
+	case ValueType::String:
+		return "String";
+	default:
+		return "Unknown";
+	}
+}
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "DBPFFile.h"
+#include <vector>
+
+// Reads and writes the binary exemplar and cohort entries of a DBPF file.
+//
+// The properties are kept as their exemplar value type and raw little-endian values.
+// Text exemplars are not supported.
+class DBPFExemplar
+{
+public:
+
+	enum class ValueType : uint16_t
+	{
+		Uint8 = 0x0100,
+		Uint16 = 0x0200,
+		Uint32 = 0x0300,
+		Sint32 = 0x0700,
+		Sint64 = 0x0800,
+		Float32 = 0x0900,
+		Bool = 0x0b00,
+		String = 0x0c00,
+	};
+
+	struct Property
+	{
+		uint32_t id;
+		ValueType type;
+		bool isArray;
+		uint32_t count;
+		std::vector<uint8_t> values;
+	};
+
+	// The type of the exemplar entries.
+	static constexpr uint32_t ExemplarType = 0x6534284a;
+	static constexpr uint32_t CohortType = 0x05342861;
+
+	DBPFExemplar();
+
+	/**
+	 * @brief Reads a binary exemplar or cohort.
+	 * @param data The entry data, it must be uncompressed.
+	 * @param size The size of the data.
+	 * @return True on success; otherwise, false if the data is not a binary exemplar.
+	 */
+	bool Parse(const uint8_t* data, size_t size);
+
+	bool IsCohort() const;
+
+	const DBPFFile::ResourceKey& GetParentCohort() const;
+
+	const std::vector<Property>& GetProperties() const;
+
+	/**
+	 * @brief Finds a property by its ID.
+	 * @return The property, or null if the exemplar does not have it.
+	 */
+	const Property* FindProperty(uint32_t id) const;
+
+	/**
+	 * @brief Replaces the property with the same ID, or adds it after the existing properties.
+	 * @param property The property, its values must hold count items of its type.
+	 * @return True on success; otherwise, false if the property values have the wrong size.
+	 */
+	bool SetProperty(const Property& property);
+
+	/**
+	 * @brief Writes the exemplar in the binary format that Parse reads.
+	 * @param data Receives the entry data.
+	 */
+	void Write(std::vector<uint8_t>& data) const;
+
+	/**
+	 * @brief Gets the size of each value of the specified type.
+	 * @return The value size in bytes, or 0 if the type is unknown.
+	 */
+	static uint32_t GetValueSize(ValueType type);
+
+	static const char* GetValueTypeName(ValueType type);
+
+private:
+
+	bool cohort;
+	DBPFFile::ResourceKey parentCohort;
+	std::vector<Property> properties;
+};
@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "DBPFFile.h"
+#include "QFSCompression.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	constexpr size_t HeaderSize = 96;
+	constexpr size_t IndexEntrySize = 20;
+	constexpr size_t DirectoryEntrySize = 16;
+
+	constexpr uint32_t MajorVersionOffset = 4;
+	constexpr uint32_t MinorVersionOffset = 8;
+	constexpr uint32_t IndexMajorVersionOffset = 32;
+	constexpr uint32_t IndexEntryCountOffset = 36;
+	constexpr uint32_t IndexOffsetOffset = 40;
+	constexpr uint32_t IndexSizeOffset = 44;
+
+	// The DBPF fields are little-endian and not aligned.
+	uint32_t ReadUint32(const uint8_t* data)
+	{
+		uint32_t value = 0;
+		std::memcpy(&value, data, sizeof(value));
+
+		return value;
+	}
+
+	bool IsRangeInFile(size_t fileSize, uint64_t offset, uint64_t size)
+	{
+		return offset <= fileSize && size <= fileSize - offset;
+	}
+}
+
+DBPFFile::DBPFFile()
+	: file(),
+	  indexTable(nullptr),
+	  indexEntryCount(0),
+	  compressedEntries()
+{
+}
+
+DBPFFile::~DBPFFile()
+{
+	Close();
+}
+
+bool DBPFFile::Open(const std::filesystem::path& path)
+{
+	Close();
+
+	if (!Platform::MapFile(path, file))
+	{
+		return false;
+	}
+
+	const uint8_t* header = file.data;
+
+	if (file.size < HeaderSize
+		|| std::memcmp(header, "DBPF", 4) != 0
+		|| ReadUint32(header + MajorVersionOffset) != 1
+		|| ReadUint32(header + MinorVersionOffset) != 0
+		|| ReadUint32(header + IndexMajorVersionOffset) != 7)
+	{
+		Close();
+		return false;
+	}
+
+	const uint32_t entryCount = ReadUint32(header + IndexEntryCountOffset);
+	const uint32_t indexOffset = ReadUint32(header + IndexOffsetOffset);
+	const uint32_t indexSize = ReadUint32(header + IndexSizeOffset);
+
+	if (static_cast<uint64_t>(entryCount) * IndexEntrySize > indexSize
+		|| !IsRangeInFile(file.size, indexOffset, indexSize))
+	{
+		Close();
+		return false;
+	}
+
+	indexTable = file.data + indexOffset;
+	indexEntryCount = entryCount;
+
+	if (!ReadDirectory())
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void DBPFFile::Close()
+{
+	Platform::UnmapFile(file);
+	indexTable = nullptr;
+	indexEntryCount = 0;
+	compressedEntries.clear();
+}
+
+bool DBPFFile::IsOpen() const
+{
+	return file.data != nullptr;
+}
+
+uint32_t DBPFFile::GetIndexEntryCount() const
+{
+	return indexEntryCount;
+}
+
+DBPFFile::IndexEntry DBPFFile::GetIndexEntry(uint32_t index) const
+{
+	const uint8_t* entry = indexTable + (static_cast<size_t>(index) * IndexEntrySize);
+
+	return IndexEntry
+	{
+		ResourceKey
+		{
+			ReadUint32(entry),
+			ReadUint32(entry + 4),
+			ReadUint32(entry + 8),
+		},
+		ReadUint32(entry + 12),
+		ReadUint32(entry + 16),
+	};
+}
+
+uint64_t DBPFFile::GetFileSize() const
+{
+	return file.size;
+}
+
+bool DBPFFile::FindEntry(const ResourceKey& key, IndexEntry& entry) const
+{
+	for (uint32_t i = 0; i < indexEntryCount; i++)
+	{
+		const IndexEntry current = GetIndexEntry(i);
+
+		if (current.key == key)
+		{
+			entry = current;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool DBPFFile::IsCompressed(const IndexEntry& entry) const
+{
+	return std::binary_search(compressedEntries.begin(), compressedEntries.end(), entry.key);
+}
+
+bool DBPFFile::GetEntryData(const IndexEntry& entry, const uint8_t*& data) const
+{
+	if (!IsRangeInFile(file.size, entry.offset, entry.size))
+	{
+		return false;
+	}
+
+	data = file.data + entry.offset;
+	return true;
+}
+
+bool DBPFFile::ReadEntryData(
+	const IndexEntry& entry,
+	std::vector<uint8_t>& buffer,
+	const uint8_t*& data,
+	size_t& size) const
+{
+	const uint8_t* storedData = nullptr;
+
+	if (!GetEntryData(entry, storedData))
+	{
+		return false;
+	}
+
+	if (!IsCompressed(entry))
+	{
+		data = storedData;
+		size = entry.size;
+		return true;
+	}
+
+	if (!QFSCompression::Decompress(storedData, entry.size, buffer))
+	{
+		return false;
+	}
+
+	data = buffer.data();
+	size = buffer.size();
+	return true;
+}
+
+bool DBPFFile::ReadDirectory()
+{
+	IndexEntry directory{};
+
+	// A file without a directory entry has no compressed entries.
+	if (!FindEntry(DirectoryKey, directory))
+	{
+		return true;
+	}
+
+	const uint8_t* data = nullptr;
+
+	if (!GetEntryData(directory, data) || (directory.size % DirectoryEntrySize) != 0)
+	{
+		return false;
+	}
+
+	const size_t count = directory.size / DirectoryEntrySize;
+	compressedEntries.reserve(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const uint8_t* item = data + (i * DirectoryEntrySize);
+
+		compressedEntries.push_back(ResourceKey
+		{
+			ReadUint32(item),
+			ReadUint32(item + 4),
+			ReadUint32(item + 8),
+		});
+	}
+
+	std::sort(compressedEntries.begin(), compressedEntries.end());
+	return true;
+}
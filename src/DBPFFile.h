@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Platform.h"
+#include <filesystem>
+#include <vector>
+
+// Reads the index of a DBPF file, the container format of the SimCity 4 saves and plugins.
+//
+// The file is memory-mapped, the index entries and the entry data are read directly from
+// the mapping instead of being copied. Only the DBPF 1.0 files with a 7.0 index that
+// SimCity 4 uses are supported.
+class DBPFFile
+{
+public:
+
+	struct ResourceKey
+	{
+		uint32_t type;
+		uint32_t group;
+		uint32_t instance;
+
+		auto operator<=>(const ResourceKey&) const = default;
+	};
+
+	struct IndexEntry
+	{
+		ResourceKey key;
+		uint32_t offset;
+		uint32_t size;
+	};
+
+	// The key of the directory entry, which lists the compressed entries in the file.
+	static constexpr ResourceKey DirectoryKey{ 0xe86b1eef, 0xe86b1eef, 0x286b1f03 };
+
+	DBPFFile();
+	~DBPFFile();
+
+	DBPFFile(const DBPFFile&) = delete;
+	DBPFFile& operator=(const DBPFFile&) = delete;
+
+	/**
+	 * @brief Maps the file into memory and validates its header and index.
+	 * @param path The file path.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Open(const std::filesystem::path& path);
+
+	void Close();
+
+	bool IsOpen() const;
+
+	uint32_t GetIndexEntryCount() const;
+
+	/**
+	 * @brief Reads an index entry from the mapped index table.
+	 * @param index The index of the entry, it must be less than GetIndexEntryCount.
+	 */
+	IndexEntry GetIndexEntry(uint32_t index) const;
+
+	uint64_t GetFileSize() const;
+
+	/**
+	 * @brief Finds the first entry with the specified key.
+	 * @param key The entry key.
+	 * @param entry Receives the index entry.
+	 * @return True if the file contains the entry; otherwise, false.
+	 */
+	bool FindEntry(const ResourceKey& key, IndexEntry& entry) const;
+
+	/**
+	 * @brief Determines whether the entry data is compressed, based on the directory entry.
+	 */
+	bool IsCompressed(const IndexEntry& entry) const;
+
+	/**
+	 * @brief Gets the data of an entry as it is stored in the file.
+	 * @param entry The index entry.
+	 * @param data Receives a pointer into the mapped file, it is valid until the file is closed.
+	 * @return True on success; otherwise, false if the entry is outside of the file.
+	 */
+	bool GetEntryData(const IndexEntry& entry, const uint8_t*& data) const;
+
+	/**
+	 * @brief Gets the uncompressed data of an entry.
+	 * @param entry The index entry.
+	 * @param buffer The buffer that a compressed entry is decompressed into, it can be reused for several entries.
+	 * @param data Receives a pointer to the data in the mapped file, or in the buffer if the entry is compressed.
+	 * @param size Receives the size of the uncompressed data.
+	 * @return True on success; otherwise, false if the entry is outside of the file or cannot be decompressed.
+	 */
+	bool ReadEntryData(
+		const IndexEntry& entry,
+		std::vector<uint8_t>& buffer,
+		const uint8_t*& data,
+		size_t& size) const;
+
+private:
+
+	bool ReadDirectory();
+
+	Platform::MappedFile file;
+	const uint8_t* indexTable;
+	uint32_t indexEntryCount;
+	// The keys of the compressed entries, sorted for binary searches.
+	std::vector<ResourceKey> compressedEntries;
+};
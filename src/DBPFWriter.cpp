@@ -0,0 +1,272 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "DBPFWriter.h"
+#include "Platform.h"
+#include "QFSCompression.h"
+#include <cstring>
+
+namespace
+{
+	constexpr size_t HeaderSize = 96;
+	constexpr size_t IndexEntrySize = 20;
+
+	constexpr uint32_t MajorVersionOffset = 4;
+	constexpr uint32_t IndexMajorVersionOffset = 32;
+	constexpr uint32_t IndexEntryCountOffset = 36;
+	constexpr uint32_t IndexOffsetOffset = 40;
+	constexpr uint32_t IndexSizeOffset = 44;
+
+	void WriteUint32(uint8_t* data, uint32_t value)
+	{
+		std::memcpy(data, &value, sizeof(value));
+	}
+
+	void AppendUint32(std::vector<uint8_t>& buffer, uint32_t value)
+	{
+		const size_t offset = buffer.size();
+
+		buffer.resize(offset + sizeof(value));
+		WriteUint32(buffer.data() + offset, value);
+	}
+
+	void AppendKey(std::vector<uint8_t>& buffer, const DBPFFile::ResourceKey& key)
+	{
+		AppendUint32(buffer, key.type);
+		AppendUint32(buffer, key.group);
+		AppendUint32(buffer, key.instance);
+	}
+}
+
+DBPFWriter::DBPFWriter()
+	: path(),
+	  stream(),
+	  appending(false),
+	  position(0),
+	  index(),
+	  directory(),
+	  compressionBuffer(),
+	  failed(false)
+{
+}
+
+bool DBPFWriter::Open(const std::filesystem::path& path)
+{
+	stream.close();
+	stream.clear();
+	this->path = path;
+	appending = false;
+	position = 0;
+	index.clear();
+	directory.clear();
+	failed = false;
+
+	stream.open(path, std::ios::binary | std::ios::trunc);
+
+	if (!stream)
+	{
+		failed = true;
+		return false;
+	}
+
+	// The header is written again with the index location when the file is closed.
+	const uint8_t header[HeaderSize]{};
+
+	return WriteBytes(header, sizeof(header));
+}
+
+bool DBPFWriter::OpenForAppend(const std::filesystem::path& path)
+{
+	stream.close();
+	stream.clear();
+	this->path = path;
+	appending = true;
+	position = 0;
+	index.clear();
+	directory.clear();
+	failed = false;
+
+	// The input mode opens the file without truncating it.
+	stream.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::ate);
+
+	if (!stream)
+	{
+		failed = true;
+		return false;
+	}
+
+	const std::streamoff end = stream.tellp();
+
+	// The DBPF offsets are 32-bit.
+	if (end < static_cast<std::streamoff>(HeaderSize) || static_cast<uint64_t>(end) > UINT32_MAX)
+	{
+		failed = true;
+		return false;
+	}
+
+	position = static_cast<uint64_t>(end);
+	return true;
+}
+
+bool DBPFWriter::AddEntry(const DBPFFile::ResourceKey& key, const uint8_t* data, size_t size, bool compress)
+{
+	if (failed || !stream.is_open() || size > UINT32_MAX)
+	{
+		failed = true;
+		return false;
+	}
+
+	if (compress
+		&& QFSCompression::Compress(data, size, compressionBuffer)
+		&& compressionBuffer.size() < size)
+	{
+		return AddCompressedEntry(key, compressionBuffer.data(), compressionBuffer.size(), static_cast<uint32_t>(size));
+	}
+
+	index.push_back(DBPFFile::IndexEntry{ key, static_cast<uint32_t>(position), static_cast<uint32_t>(size) });
+	return WriteBytes(data, size);
+}
+
+bool DBPFWriter::AddCompressedEntry(const DBPFFile::ResourceKey& key, const uint8_t* data, size_t size, uint32_t uncompressedSize)
+{
+	if (failed || !stream.is_open() || size > UINT32_MAX)
+	{
+		failed = true;
+		return false;
+	}
+
+	AppendKey(directory, key);
+	AppendUint32(directory, uncompressedSize);
+
+	index.push_back(DBPFFile::IndexEntry{ key, static_cast<uint32_t>(position), static_cast<uint32_t>(size) });
+	return WriteBytes(data, size);
+}
+
+bool DBPFWriter::AddExistingEntry(const DBPFFile::IndexEntry& entry, bool compressed, uint32_t uncompressedSize)
+{
+	if (failed || !stream.is_open() || !appending)
+	{
+		failed = true;
+		return false;
+	}
+
+	if (compressed)
+	{
+		AppendKey(directory, entry.key);
+		AppendUint32(directory, uncompressedSize);
+	}
+
+	index.push_back(entry);
+	return true;
+}
+
+bool DBPFWriter::Close()
+{
+	if (!stream.is_open())
+	{
+		return false;
+	}
+
+	if (!failed && !directory.empty())
+	{
+		index.push_back(DBPFFile::IndexEntry{ DBPFFile::DirectoryKey, static_cast<uint32_t>(position), static_cast<uint32_t>(directory.size()) });
+		WriteBytes(directory.data(), directory.size());
+	}
+
+	const uint64_t indexOffset = position;
+	std::vector<uint8_t> indexTable;
+	indexTable.reserve(index.size() * IndexEntrySize);
+
+	for (const DBPFFile::IndexEntry& entry : index)
+	{
+		AppendKey(indexTable, entry.key);
+		AppendUint32(indexTable, entry.offset);
+		AppendUint32(indexTable, entry.size);
+	}
+
+	if (!failed && WriteBytes(indexTable.data(), indexTable.size()))
+	{
+		if (!(appending ? WriteAppendedHeader(indexTable, indexOffset) : WriteHeader(indexTable, indexOffset)))
+		{
+			failed = true;
+		}
+	}
+
+	stream.close();
+
+	bool result = !failed && !stream.fail();
+
+	if (result && appending)
+	{
+		result = Platform::FlushFile(path);
+	}
+
+	index.clear();
+	directory.clear();
+
+	return result;
+}
+
+bool DBPFWriter::WriteHeader(const std::vector<uint8_t>& indexTable, uint64_t indexOffset)
+{
+	uint8_t header[HeaderSize]{};
+	std::memcpy(header, "DBPF", 4);
+	WriteUint32(header + MajorVersionOffset, 1);
+	WriteUint32(header + IndexMajorVersionOffset, 7);
+	WriteUint32(header + IndexEntryCountOffset, static_cast<uint32_t>(index.size()));
+	WriteUint32(header + IndexOffsetOffset, static_cast<uint32_t>(indexOffset));
+	WriteUint32(header + IndexSizeOffset, static_cast<uint32_t>(indexTable.size()));
+
+	stream.seekp(0);
+
+	return static_cast<bool>(stream.write(reinterpret_cast<const char*>(header), sizeof(header)));
+}
+
+bool DBPFWriter::WriteAppendedHeader(const std::vector<uint8_t>& indexTable, uint64_t indexOffset)
+{
+	// The new entries and index must be on the disk before the header refers to them,
+	// otherwise an interrupted write could leave the header pointing at missing data.
+	if (!stream.flush() || !Platform::FlushFile(path))
+	{
+		return false;
+	}
+
+	// The rest of the existing header is kept. The index count, offset and size are
+	// adjacent, they are updated with a single write to the first sector of the file.
+	uint8_t indexLocation[3 * sizeof(uint32_t)]{};
+	WriteUint32(indexLocation, static_cast<uint32_t>(index.size()));
+	WriteUint32(indexLocation + (IndexOffsetOffset - IndexEntryCountOffset), static_cast<uint32_t>(indexOffset));
+	WriteUint32(indexLocation + (IndexSizeOffset - IndexEntryCountOffset), static_cast<uint32_t>(indexTable.size()));
+
+	stream.seekp(IndexEntryCountOffset);
+
+	return static_cast<bool>(stream.write(reinterpret_cast<const char*>(indexLocation), sizeof(indexLocation)));
+}
+
+bool DBPFWriter::WriteBytes(const uint8_t* data, size_t size)
+{
+	// The DBPF offsets are 32-bit.
+	if (failed || size > UINT32_MAX - position)
+	{
+		failed = true;
+		return false;
+	}
+
+	if (size > 0 && !stream.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size)))
+	{
+		failed = true;
+		return false;
+	}
+
+	position += size;
+	return true;
+}
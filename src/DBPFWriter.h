@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "DBPFFile.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+// Writes a DBPF 1.0 file with a 7.0 index, the format that SimCity 4 loads its plugins from.
+//
+// The entry data is written to the file as each entry is added, only the index is kept
+// in memory. The index, the directory of the compressed entries and the header are
+// written when the file is closed.
+//
+// An existing file can also be opened for appending, the new entries, directory and index
+// are written after its end and the header is only switched to the new index once they
+// have been flushed to the disk. An interrupted append leaves the file with its old index.
+class DBPFWriter
+{
+public:
+
+	DBPFWriter();
+
+	DBPFWriter(const DBPFWriter&) = delete;
+	DBPFWriter& operator=(const DBPFWriter&) = delete;
+
+	/**
+	 * @brief Creates the file, an existing file is replaced.
+	 * @param path The file path.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Open(const std::filesystem::path& path);
+
+	/**
+	 * @brief Opens an existing DBPF file for appending.
+	 * The entries that are kept must be added again with AddExistingEntry, the old index,
+	 * directory and replaced entries become unused space in the file.
+	 * @param path The file path.
+	 * @return True on success; otherwise, false.
+	 */
+	bool OpenForAppend(const std::filesystem::path& path);
+
+	/**
+	 * @brief Appends an entry to the file.
+	 * @param key The entry key.
+	 * @param data The uncompressed entry data.
+	 * @param size The size of the data.
+	 * @param compress True to QFS compress the entry, it is stored uncompressed if it does not get smaller.
+	 * @return True on success; otherwise, false.
+	 */
+	bool AddEntry(const DBPFFile::ResourceKey& key, const uint8_t* data, size_t size, bool compress);
+
+	/**
+	 * @brief Appends an entry that is already QFS compressed, e.g. when copying it from another file.
+	 * @param key The entry key.
+	 * @param data The compressed entry data, including the QFS header.
+	 * @param size The size of the compressed data.
+	 * @param uncompressedSize The uncompressed size that is listed in the directory entry.
+	 * @return True on success; otherwise, false.
+	 */
+	bool AddCompressedEntry(const DBPFFile::ResourceKey& key, const uint8_t* data, size_t size, uint32_t uncompressedSize);
+
+	/**
+	 * @brief Adds an entry whose data is already in a file that was opened with OpenForAppend.
+	 * @param entry The index entry of the existing data.
+	 * @param compressed True if the data is QFS compressed; otherwise, false.
+	 * @param uncompressedSize The uncompressed size that is listed in the directory entry of a compressed entry.
+	 * @return True on success; otherwise, false.
+	 */
+	bool AddExistingEntry(const DBPFFile::IndexEntry& entry, bool compressed, uint32_t uncompressedSize);
+
+	/**
+	 * @brief Writes the index and the header, and closes the file.
+	 * An appended file is flushed to the disk before and after its header is updated.
+	 * @return True if every entry was written; otherwise, false.
+	 */
+	bool Close();
+
+private:
+
+	bool WriteBytes(const uint8_t* data, size_t size);
+	bool WriteHeader(const std::vector<uint8_t>& indexTable, uint64_t indexOffset);
+	bool WriteAppendedHeader(const std::vector<uint8_t>& indexTable, uint64_t indexOffset);
+
+	std::filesystem::path path;
+	std::ofstream stream;
+	bool appending;
+	uint64_t position;
+	std::vector<DBPFFile::IndexEntry> index;
+	// The directory records of the compressed entries: the key and the uncompressed size.
+	std::vector<uint8_t> directory;
+	std::vector<uint8_t> compressionBuffer;
+	bool failed;
+};
@@ -0,0 +1,375 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "ExperimentScheduler.h"
+#include "TrafficSummary.h"
+#include "cISC4City.h"
+#include "cISC4Demand.h"
+#include "cISC4DemandSimulator.h"
+#include "cISC4Simulator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	constexpr int64_t kNoMonth = INT64_MIN;
+
+	// The first congestion bucket that is counted as congested, this is a value of 128.
+	constexpr uint32_t kCongestedBucket = 8;
+
+	struct MetricInfo
+	{
+		const char* name;
+		// The demand simulator type, or zero for the traffic metrics.
+		uint32_t demandType;
+	};
+
+	constexpr std::array<MetricInfo, ExperimentScheduler::MetricCount> Metrics =
+	{{
+		{ "average congestion", 0 },
+		{ "congested tracts %", 0 },
+		{ "average trip length", 0 },
+		{ "transit switch usage %", 0 },
+		{ "R$ demand", 0x1010 },
+		{ "R$$ demand", 0x1020 },
+		{ "R$$$ demand", 0x1030 },
+		{ "CS$ demand", 0x3110 },
+		{ "CS$$ demand", 0x3120 },
+		{ "CS$$$ demand", 0x3130 },
+		{ "CO$$ demand", 0x3320 },
+		{ "CO$$$ demand", 0x3330 },
+		{ "IR demand", 0x4100 },
+		{ "ID demand", 0x4200 },
+		{ "IM demand", 0x4300 },
+		{ "IHT demand", 0x4400 },
+	}};
+
+	// The two-sided 95% critical values of Student's t distribution for 1 to 30 degrees of freedom.
+	constexpr std::array<double, 30> kStudentT95 =
+	{
+		12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+	};
+
+	double GetStudentT95(uint32_t degreesOfFreedom)
+	{
+		if (degreesOfFreedom == 0)
+		{
+			return 0.0;
+		}
+
+		return degreesOfFreedom <= kStudentT95.size() ? kStudentT95[degreesOfFreedom - 1] : 1.960;
+	}
+
+	size_t GetArmIndex(bool ordinanceOn)
+	{
+		return ordinanceOn ? 1 : 0;
+	}
+}
+
+void ExperimentScheduler::RunningStatistics::Add(double value)
+{
+	count++;
+
+	const double delta = value - mean;
+	mean += delta / static_cast<double>(count);
+	sumOfSquares += delta * (value - mean);
+}
+
+double ExperimentScheduler::RunningStatistics::GetVariance() const
+{
+	return count > 1 ? sumOfSquares / static_cast<double>(count - 1) : 0.0;
+}
+
+ExperimentScheduler::ExperimentScheduler()
+	: logger(Logger::GetInstance()),
+	  pTransitSwitchIndex(nullptr),
+	  periodMonths(0),
+	  washoutMonths(0),
+	  periodActive(false),
+	  periodOrdinanceOn(false),
+	  period(0),
+	  lastMonth(kNoMonth),
+	  periodSums(),
+	  periodSampleCounts(),
+	  arms(),
+	  discardedPeriods(0),
+	  toggleCount(0),
+	  totalToggleMicroseconds(0),
+	  maxToggleMicroseconds(0)
+{
+}
+
+void ExperimentScheduler::Configure(uint32_t periodMonths, uint32_t washoutMonths)
+{
+	this->periodMonths = periodMonths;
+	// At least one month of each period must be measured.
+	this->washoutMonths = periodMonths > 0 ? std::min(washoutMonths, periodMonths - 1) : 0;
+}
+
+bool ExperimentScheduler::IsEnabled() const
+{
+	return periodMonths > 0;
+}
+
+void ExperimentScheduler::SetTransitSwitchIndex(const TransitSwitchIndex* pIndex)
+{
+	pTransitSwitchIndex = pIndex;
+}
+
+bool ExperimentScheduler::Simulate(cISC4City* pCity, bool ordinanceOn)
+{
+	cISC4Simulator* pSimulator = pCity ? pCity->GetSimulator() : nullptr;
+
+	if (!IsEnabled() || !pSimulator)
+	{
+		return false;
+	}
+
+	long year = 0;
+	long month = 0;
+	long day = 0;
+	long dayOfYear = 0;
+	long weekDay = 0;
+
+	pSimulator->GetSimDate(year, month, day, dayOfYear, weekDay);
+
+	// The month is zero-based, this aligns 12 month periods with the calendar years.
+	const int64_t currentMonth = (static_cast<int64_t>(year) * 12) + (month - 1);
+
+	if (currentMonth == lastMonth)
+	{
+		return false;
+	}
+
+	lastMonth = currentMonth;
+
+	const int64_t currentPeriod = currentMonth / periodMonths;
+	const int64_t monthInPeriod = currentMonth % periodMonths;
+	const bool periodArmOn = (currentPeriod % 2) != 0;
+	const bool lastMonthInPeriod = monthInPeriod == (periodMonths - 1);
+
+	if (periodActive && currentPeriod != period)
+	{
+		// A month was skipped, the period is incomplete.
+		periodActive = false;
+	}
+
+	if (periodActive && ordinanceOn != periodOrdinanceOn)
+	{
+		discardedPeriods++;
+
+		logger.WriteLine(
+			LogOptions::Info,
+			"Park & Ride experiment: the ordinance was toggled outside of the schedule, the period was discarded.");
+
+		periodActive = false;
+	}
+
+	if (!periodActive && monthInPeriod == 0 && ordinanceOn == periodArmOn)
+	{
+		StartPeriod(currentPeriod, ordinanceOn);
+	}
+
+	if (periodActive)
+	{
+		if (monthInPeriod >= washoutMonths)
+		{
+			MeasureMonth(pCity);
+		}
+
+		if (lastMonthInPeriod)
+		{
+			FinishPeriod();
+			WriteReport();
+		}
+	}
+
+	// When the ordinance does not match the arm of the current period, e.g. after the player
+	// toggled it, it is left alone until the next period has the same arm as its state.
+	return lastMonthInPeriod && ordinanceOn == periodArmOn;
+}
+
+void ExperimentScheduler::RecordToggle(int64_t elapsedMicroseconds)
+{
+	toggleCount++;
+	totalToggleMicroseconds += elapsedMicroseconds;
+	maxToggleMicroseconds = std::max(maxToggleMicroseconds, elapsedMicroseconds);
+
+	logger.WriteLineFormatted(
+		LogOptions::Profiling,
+		"Park & Ride experiment: toggled the ordinance in %lld us.",
+		static_cast<long long>(elapsedMicroseconds));
+}
+
+void ExperimentScheduler::Reset()
+{
+	periodActive = false;
+	period = 0;
+	lastMonth = kNoMonth;
+	arms = {};
+	discardedPeriods = 0;
+	toggleCount = 0;
+	totalToggleMicroseconds = 0;
+	maxToggleMicroseconds = 0;
+}
+
+uint32_t ExperimentScheduler::GetCompletedPeriods(bool ordinanceOn) const
+{
+	return arms[GetArmIndex(ordinanceOn)].periods;
+}
+
+uint32_t ExperimentScheduler::GetDiscardedPeriods() const
+{
+	return discardedPeriods;
+}
+
+uint32_t ExperimentScheduler::GetToggleCount() const
+{
+	return toggleCount;
+}
+
+double ExperimentScheduler::GetMean(Metric metric, bool ordinanceOn) const
+{
+	return arms[GetArmIndex(ordinanceOn)].metrics[metric].mean;
+}
+
+double ExperimentScheduler::GetConfidenceInterval(Metric metric, bool ordinanceOn) const
+{
+	const RunningStatistics& statistics = arms[GetArmIndex(ordinanceOn)].metrics[metric];
+
+	if (statistics.count < 2)
+	{
+		return 0.0;
+	}
+
+	return GetStudentT95(statistics.count - 1) * std::sqrt(statistics.GetVariance() / static_cast<double>(statistics.count));
+}
+
+const char* ExperimentScheduler::GetMetricName(Metric metric)
+{
+	return metric < MetricCount ? Metrics[metric].name : "";
+}
+
+void ExperimentScheduler::WriteReport() const
+{
+	if (!logger.IsEnabled(LogOptions::Info))
+	{
+		return;
+	}
+
+	const Arm& off = arms[GetArmIndex(false)];
+	const Arm& on = arms[GetArmIndex(true)];
+
+	logger.WriteLineFormatted(
+		LogOptions::Info,
+		"Park & Ride experiment: %u periods with the ordinance enacted, %u repealed, %u discarded, mean +/- 95%% CI:",
+		on.periods,
+		off.periods,
+		discardedPeriods);
+
+	for (uint32_t i = 0; i < MetricCount; i++)
+	{
+		const Metric metric = static_cast<Metric>(i);
+
+		if (on.metrics[i].count == 0 && off.metrics[i].count == 0)
+		{
+			continue;
+		}
+
+		logger.WriteLineFormatted(
+			LogOptions::Info,
+			"  %-24s enacted %10.3f +/- %-8.3f repealed %10.3f +/- %.3f",
+			Metrics[i].name,
+			GetMean(metric, true),
+			GetConfidenceInterval(metric, true),
+			GetMean(metric, false),
+			GetConfidenceInterval(metric, false));
+	}
+
+	if (toggleCount > 0)
+	{
+		logger.WriteLineFormatted(
+			LogOptions::Info,
+			"  %u scheduled toggles, mean %lld us, max %lld us",
+			toggleCount,
+			static_cast<long long>(totalToggleMicroseconds / toggleCount),
+			static_cast<long long>(maxToggleMicroseconds));
+	}
+}
+
+void ExperimentScheduler::StartPeriod(int64_t period, bool ordinanceOn)
+{
+	this->period = period;
+	periodActive = true;
+	periodOrdinanceOn = ordinanceOn;
+	periodSums.fill(0.0);
+	periodSampleCounts.fill(0);
+}
+
+void ExperimentScheduler::MeasureMonth(cISC4City* pCity)
+{
+	TrafficSummary traffic;
+
+	if (traffic.Capture(pCity, pTransitSwitchIndex))
+	{
+		periodSums[AverageCongestion] += traffic.GetAverageCongestion();
+		periodSums[CongestedTracts] += traffic.GetCongestionShareAtLeast(kCongestedBucket) * 100.0;
+		periodSums[AverageTripLength] += traffic.GetAverageTripLength();
+		periodSampleCounts[AverageCongestion]++;
+		periodSampleCounts[CongestedTracts]++;
+		periodSampleCounts[AverageTripLength]++;
+
+		if (traffic.HasTransitSwitches())
+		{
+			periodSums[TransitSwitchUsage] += traffic.GetTransitSwitchUsage() * 100.0;
+			periodSampleCounts[TransitSwitchUsage]++;
+		}
+	}
+
+	cISC4DemandSimulator* pDemandSimulator = pCity->GetDemandSimulator();
+
+	if (pDemandSimulator)
+	{
+		for (uint32_t i = 0; i < MetricCount; i++)
+		{
+			if (Metrics[i].demandType != 0)
+			{
+				cISC4Demand* pDemand = pDemandSimulator->GetDemand(Metrics[i].demandType);
+
+				if (pDemand)
+				{
+					periodSums[i] += pDemand->QueryDemandValue();
+					periodSampleCounts[i]++;
+				}
+			}
+		}
+	}
+}
+
+void ExperimentScheduler::FinishPeriod()
+{
+	Arm& arm = arms[GetArmIndex(periodOrdinanceOn)];
+
+	arm.periods++;
+
+	for (uint32_t i = 0; i < MetricCount; i++)
+	{
+		if (periodSampleCounts[i] > 0)
+		{
+			arm.metrics[i].Add(periodSums[i] / static_cast<double>(periodSampleCounts[i]));
+		}
+	}
+
+	periodActive = false;
+}
@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Logger.h"
+#include <array>
+#include <stdint.h>
+
+class cISC4City;
+class TransitSwitchIndex;
+
+// Runs an A/B experiment that alternates the ordinance state on a fixed simulation calendar.
+//
+// Each period keeps the ordinance in one state (the arm) for a fixed number of months.
+// The periods and their arms are derived from the simulation date, the ordinance is repealed
+// in the even periods and enacted in the odd ones, so the schedule continues when the city
+// is saved and loaded again without storing any state in the save game.
+// The traffic and demand metrics of every month after the washout months are averaged,
+// and the period average is added to the statistics of its arm. The ordinance is toggled
+// from its monthly Simulate call when a period ends, and the report with the mean and the
+// 95% confidence interval of each arm is written to the log.
+// Only the periods that are observed from their first month in the state of their arm are
+// measured, a period is discarded if the ordinance is toggled by the player before it ends.
+class ExperimentScheduler
+{
+public:
+
+	enum Metric : uint32_t
+	{
+		AverageCongestion = 0,
+		CongestedTracts,
+		AverageTripLength,
+		TransitSwitchUsage,
+		ResidentialLowWealthDemand,
+		ResidentialMediumWealthDemand,
+		ResidentialHighWealthDemand,
+		CommercialServiceLowWealthDemand,
+		CommercialServiceMediumWealthDemand,
+		CommercialServiceHighWealthDemand,
+		CommercialOfficeMediumWealthDemand,
+		CommercialOfficeHighWealthDemand,
+		IndustrialResourceDemand,
+		IndustrialDirtyDemand,
+		IndustrialManufacturingDemand,
+		IndustrialHighTechDemand,
+		MetricCount
+	};
+
+	ExperimentScheduler();
+
+	/**
+	 * @brief Sets the experiment schedule.
+	 * @param periodMonths The number of months in each period, zero disables the experiment.
+	 * @param washoutMonths The number of months at the start of a period that are not measured.
+	 */
+	void Configure(uint32_t periodMonths, uint32_t washoutMonths);
+
+	bool IsEnabled() const;
+
+	/**
+	 * @brief Sets the index that provides the transit switch totals.
+	 * @param pIndex The index, or null to leave out the transit switch usage.
+	 */
+	void SetTransitSwitchIndex(const TransitSwitchIndex* pIndex);
+
+	/**
+	 * @brief Measures the current month, this is called once per simulation month.
+	 * @param pCity The city.
+	 * @param ordinanceOn True if the ordinance is enacted.
+	 * @return True if the period ended and the ordinance should be toggled; otherwise, false.
+	 */
+	bool Simulate(cISC4City* pCity, bool ordinanceOn);
+
+	/**
+	 * @brief Records the time that the scheduled toggle took.
+	 * @param elapsedMicroseconds The time that the tuning coordinator took to apply the batch
+	 * with the toggle, in microseconds.
+	 */
+	void RecordToggle(int64_t elapsedMicroseconds);
+
+	/**
+	 * @brief Discards the experiment results, this must be called when the city is shut down.
+	 */
+	void Reset();
+
+	uint32_t GetCompletedPeriods(bool ordinanceOn) const;
+	uint32_t GetDiscardedPeriods() const;
+	uint32_t GetToggleCount() const;
+
+	double GetMean(Metric metric, bool ordinanceOn) const;
+
+	/**
+	 * @brief Gets the half-width of the 95% confidence interval of the arm mean.
+	 * @return The half-width, or zero if the arm has less than two periods.
+	 */
+	double GetConfidenceInterval(Metric metric, bool ordinanceOn) const;
+
+	static const char* GetMetricName(Metric metric);
+
+	void WriteReport() const;
+
+private:
+
+	// Welford's online mean and variance.
+	struct RunningStatistics
+	{
+		uint32_t count;
+		double mean;
+		double sumOfSquares;
+
+		void Add(double value);
+		double GetVariance() const;
+	};
+
+	struct Arm
+	{
+		uint32_t periods;
+		std::array<RunningStatistics, MetricCount> metrics;
+	};
+
+	void StartPeriod(int64_t period, bool ordinanceOn);
+	void MeasureMonth(cISC4City* pCity);
+	void FinishPeriod();
+
+	Logger& logger;
+	const TransitSwitchIndex* pTransitSwitchIndex;
+	uint32_t periodMonths;
+	uint32_t washoutMonths;
+	bool periodActive;
+	bool periodOrdinanceOn;
+	// The index of the measured period, counted in periods since the start of the calendar.
+	int64_t period;
+	// The year and month of the last Simulate call.
+	int64_t lastMonth;
+	std::array<double, MetricCount> periodSums;
+	std::array<uint32_t, MetricCount> periodSampleCounts;
+	// The statistics of the ordinance off and on arms, in that order.
+	std::array<Arm, 2> arms;
+	uint32_t discardedPeriods;
+	uint32_t toggleCount;
+	int64_t totalToggleMicroseconds;
+	int64_t maxToggleMicroseconds;
+};
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "ImpactReporter.h"
+#include "cISC4City.h"
+#include "cISC4Simulator.h"
+
+namespace
+{
+	// The first congestion bucket that the summary reports as congested, this is a value of 128.
+	constexpr uint32_t kCongestedBucket = 8;
+
+	bool GetSimMonth(cISC4City* pCity, long& year, long& month)
+	{
+		cISC4Simulator* pSimulator = pCity ? pCity->GetSimulator() : nullptr;
+
+		if (!pSimulator)
+		{
+			return false;
+		}
+
+		long day = 0;
+		long dayOfYear = 0;
+		long weekDay = 0;
+
+		pSimulator->GetSimDate(year, month, day, dayOfYear, weekDay);
+		return true;
+	}
+}
+
+ImpactReporter::ImpactReporter()
+	: logger(Logger::GetInstance()),
+	  pTransitSwitchIndex(nullptr),
+	  reportMonths(0),
+	  reportPending(false),
+	  lastMonth(0),
+	  pendingReport(),
+	  accumulator(),
+	  reports()
+{
+}
+
+void ImpactReporter::SetReportMonths(uint32_t months)
+{
+	reportMonths = months;
+}
+
+void ImpactReporter::SetTransitSwitchIndex(const TransitSwitchIndex* pIndex)
+{
+	pTransitSwitchIndex = pIndex;
+}
+
+void ImpactReporter::Start(cISC4City* pCity, bool enacted)
+{
+	if (reportPending)
+	{
+		Finish();
+	}
+
+	long year = 0;
+	long month = 0;
+
+	if (reportMonths == 0 || !GetSimMonth(pCity, year, month))
+	{
+		return;
+	}
+
+	pendingReport = ImpactReport();
+	pendingReport.year = static_cast<int32_t>(year);
+	pendingReport.month = static_cast<int32_t>(month);
+	pendingReport.enacted = enacted;
+
+	if (!pendingReport.before.Capture(pCity, pTransitSwitchIndex))
+	{
+		logger.WriteLine(LogOptions::Errors, "Failed to read the traffic maps for the impact report.");
+		return;
+	}
+
+	// The month of the toggle is part of the baseline.
+	lastMonth = (static_cast<int64_t>(year) * 12) + month;
+	accumulator.Clear();
+	reportPending = true;
+}
+
+void ImpactReporter::Update(cISC4City* pCity)
+{
+	long year = 0;
+	long month = 0;
+
+	if (!reportPending || !GetSimMonth(pCity, year, month))
+	{
+		return;
+	}
+
+	const int64_t currentMonth = (static_cast<int64_t>(year) * 12) + month;
+
+	if (currentMonth <= lastMonth)
+	{
+		return;
+	}
+
+	TrafficSummary summary;
+
+	if (summary.Capture(pCity, pTransitSwitchIndex))
+	{
+		accumulator.Add(summary);
+		lastMonth = currentMonth;
+
+		if (accumulator.GetCount() >= reportMonths)
+		{
+			Finish();
+		}
+	}
+}
+
+void ImpactReporter::Clear()
+{
+	reportPending = false;
+	accumulator.Clear();
+	reports.clear();
+}
+
+bool ImpactReporter::IsReportPending() const
+{
+	return reportPending;
+}
+
+const std::vector<ImpactReport>& ImpactReporter::GetReports() const
+{
+	return reports;
+}
+
+void ImpactReporter::Finish()
+{
+	reportPending = false;
+
+	if (accumulator.GetCount() == 0)
+	{
+		return;
+	}
+
+	pendingReport.monthCount = static_cast<uint16_t>(accumulator.GetCount());
+	pendingReport.complete = accumulator.GetCount() >= reportMonths;
+	pendingReport.after = accumulator.GetAverage();
+
+	reports.push_back(pendingReport);
+	WriteSummary(pendingReport);
+}
+
+void ImpactReporter::WriteSummary(const ImpactReport& report) const
+{
+	const TrafficSummary& before = report.before;
+	const TrafficSummary& after = report.after;
+
+	logger.WriteLineFormatted(
+		LogOptions::Info,
+		"Park & Ride impact report: the ordinance was %s in month %d of year %d, average of the next %u months%s:",
+		report.enacted ? "enacted" : "repealed",
+		report.month,
+		report.year,
+		report.monthCount,
+		report.complete ? "" : " (interrupted by another toggle)");
+
+	const double congestedBefore = before.GetCongestionShareAtLeast(kCongestedBucket) * 100.0;
+	const double congestedAfter = after.GetCongestionShareAtLeast(kCongestedBucket) * 100.0;
+
+	logger.WriteLineFormatted(
+		LogOptions::Info,
+		"  congestion %.1f -> %.1f (%+.1f), congested tracts %.1f%% -> %.1f%% (%+.1f), trip length %.1f -> %.1f (%+.1f)",
+		before.GetAverageCongestion(),
+		after.GetAverageCongestion(),
+		after.GetAverageCongestion() - before.GetAverageCongestion(),
+		congestedBefore,
+		congestedAfter,
+		congestedAfter - congestedBefore,
+		before.GetAverageTripLength(),
+		after.GetAverageTripLength(),
+		after.GetAverageTripLength() - before.GetAverageTripLength());
+
+	if (before.HasTransitSwitches() && after.HasTransitSwitches())
+	{
+		const double usageBefore = before.GetTransitSwitchUsage() * 100.0;
+		const double usageAfter = after.GetTransitSwitchUsage() * 100.0;
+
+		logger.WriteLineFormatted(
+			LogOptions::Info,
+			"  transit switch usage %.1f%% -> %.1f%% (%+.1f), arrivals %u -> %u",
+			usageBefore,
+			usageAfter,
+			usageAfter - usageBefore,
+			before.GetTransitSwitchTrafficArrived(),
+			after.GetTransitSwitchTrafficArrived());
+	}
+}
@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Logger.h"
+#include "TrafficSummary.h"
+#include <vector>
+
+class cISC4City;
+class TransitSwitchIndex;
+
+// The traffic before an ordinance toggle and the average traffic in the following months.
+struct ImpactReport
+{
+	int32_t year;
+	int32_t month;
+	// True if the ordinance was enacted; otherwise, it was repealed.
+	bool enacted;
+	// False if the ordinance was toggled again before the report had all of its months.
+	bool complete;
+	uint16_t monthCount;
+	TrafficSummary before;
+	TrafficSummary after;
+};
+
+// Compares the city traffic before and after the ordinance is toggled.
+//
+// When the ordinance state changes the current traffic is kept as the baseline, and the
+// traffic in each of the following months is added to a running average. After the
+// configured number of months the report is completed and a summary is written to the log.
+// Only the fixed-size summaries are stored, so the reports for every toggle can be kept.
+class ImpactReporter
+{
+public:
+
+	ImpactReporter();
+
+	/**
+	 * @brief Sets the number of months that each report covers.
+	 * @param months The number of months, zero disables the reports.
+	 */
+	void SetReportMonths(uint32_t months);
+
+	/**
+	 * @brief Sets the index that provides the transit switch totals.
+	 * @param pIndex The index, or null to leave the transit switches out of the reports.
+	 */
+	void SetTransitSwitchIndex(const TransitSwitchIndex* pIndex);
+
+	/**
+	 * @brief Starts a new report, the pending report is completed with the months it has.
+	 * @param pCity The city.
+	 * @param enacted True if the ordinance was enacted; otherwise, false.
+	 */
+	void Start(cISC4City* pCity, bool enacted);
+
+	/**
+	 * @brief Adds the current traffic to the pending report, this is called once per simulation month.
+	 * @param pCity The city.
+	 */
+	void Update(cISC4City* pCity);
+
+	/**
+	 * @brief Removes the reports, this must be called when the city is shut down.
+	 */
+	void Clear();
+
+	bool IsReportPending() const;
+
+	const std::vector<ImpactReport>& GetReports() const;
+
+private:
+
+	void Finish();
+	void WriteSummary(const ImpactReport& report) const;
+
+	Logger& logger;
+	const TransitSwitchIndex* pTransitSwitchIndex;
+	uint32_t reportMonths;
+	bool reportPending;
+	// The year and month of the last month that was added, or the month of the toggle.
+	int64_t lastMonth;
+	ImpactReport pendingReport;
+	TrafficSummaryAccumulator accumulator;
+	std::vector<ImpactReport> reports;
+};
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "InternedStringTable.h"
+
+namespace
+{
+	std::string_view ToStringView(const cIGZString& value)
+	{
+		return std::string_view(value.Data(), value.Strlen());
+	}
+}
+
+InternedStringTable& InternedStringTable::GetInstance()
+{
+	static InternedStringTable instance;
+
+	return instance;
+}
+
+InternedStringTable::InternedStringTable()
+	: strings(), ids()
+{
+	Intern(std::string_view(""));
+}
+
+uint32_t InternedStringTable::Intern(std::string_view value)
+{
+	const auto it = ids.find(value);
+
+	if (it != ids.end())
+	{
+		return it->second;
+	}
+
+	const uint32_t id = static_cast<uint32_t>(strings.size());
+
+	const cRZBaseString& stored = strings.emplace_back(value.data(), value.size());
+	ids.emplace(ToStringView(stored), id);
+
+	return id;
+}
+
+uint32_t InternedStringTable::Intern(const cIGZString& value)
+{
+	return Intern(ToStringView(value));
+}
+
+cIGZString* InternedStringTable::Get(uint32_t id)
+{
+	if (id >= strings.size())
+	{
+		id = EmptyStringID;
+	}
+
+	return &strings[id];
+}
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cRZBaseString.h"
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
+// A process-wide table of the ordinance name and description strings.
+//
+// Each distinct string is stored once and identified by a 32-bit ID, so the ordinances
+// can be created, copied and relocalized without allocating. The stored strings are
+// never modified or removed, which keeps the cIGZString pointers and IDs stable for
+// the lifetime of the process. Two strings are equal if and only if their IDs are equal.
+class InternedStringTable
+{
+public:
+
+	// The ID of the empty string.
+	static constexpr uint32_t EmptyStringID = 0;
+
+	static InternedStringTable& GetInstance();
+
+	/**
+	 * @brief Adds a string to the table, if it is not already present.
+	 * @param value The string to add.
+	 * @return The ID of the string.
+	 */
+	uint32_t Intern(std::string_view value);
+
+	/**
+	 * @brief Adds a string to the table, if it is not already present.
+	 * @param value The string to add.
+	 * @return The ID of the string.
+	 */
+	uint32_t Intern(const cIGZString& value);
+
+	/**
+	 * @brief Gets the string that has the specified ID.
+	 * @param id The string ID.
+	 * @return The string. The callers must treat it as read-only, the value
+	 * is shared by every object that interned it.
+	 */
+	cIGZString* Get(uint32_t id);
+
+private:
+
+	InternedStringTable();
+
+	InternedStringTable(const InternedStringTable&) = delete;
+	InternedStringTable& operator=(const InternedStringTable&) = delete;
+
+	// A deque never moves its existing items when growing, the map keys point into the stored strings.
+	std::deque<cRZBaseString> strings;
+	std::unordered_map<std::string_view, uint32_t> ids;
+};
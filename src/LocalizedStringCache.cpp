@@ -0,0 +1,110 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "LocalizedStringCache.h"
+#include "Logger.h"
+#include "StringResourceManager.h"
+#include "cIGZLanguageManager.h"
+#include "GZServPtrs.h"
+
+namespace
+{
+	uint64_t MakeCacheKey(uint32_t groupID, uint32_t instanceID)
+	{
+		return (static_cast<uint64_t>(groupID) << 32) | static_cast<uint64_t>(instanceID);
+	}
+
+	bool TryGetString(uint32_t groupID, uint32_t instanceID, cRZBaseString& value)
+	{
+		bool result = false;
+		cIGZString* resource = nullptr;
+
+		if (StringResourceManager::GetString(StringResourceKey(groupID, instanceID), &resource))
+		{
+			value.Copy(*resource);
+			resource->Release();
+			result = true;
+		}
+
+		return result;
+	}
+}
+
+LocalizedStringCache& LocalizedStringCache::GetInstance()
+{
+	static LocalizedStringCache instance;
+
+	return instance;
+}
+
+LocalizedStringCache::LocalizedStringCache()
+	: entries(), lookupCount(0)
+{
+}
+
+const cIGZString* LocalizedStringCache::GetLocalizedString(const StringResourceKey& key)
+{
+	if (key.groupID == 0 || key.instanceID == 0)
+	{
+		return nullptr;
+	}
+
+	uint32_t currentLanguage = 0;
+
+	cIGZLanguageManagerPtr languageManager;
+	if (languageManager)
+	{
+		currentLanguage = languageManager->GetCurrentLanguage();
+	}
+
+	// The localized resources use a group ID that is offset from the default language
+	// group ID, see StringResourceManager::GetLocalizedString.
+	const uint32_t localizedGroupID = key.groupID + currentLanguage;
+
+	const auto it = entries.find(MakeCacheKey(localizedGroupID, key.instanceID));
+	const Entry& entry = it != entries.end() ? it->second : LoadEntry(localizedGroupID, key);
+
+	return entry.found ? &entry.value : nullptr;
+}
+
+void LocalizedStringCache::Clear()
+{
+	entries.clear();
+}
+
+const LocalizedStringCache::Entry& LocalizedStringCache::LoadEntry(uint32_t localizedGroupID, const StringResourceKey& key)
+{
+	Entry entry{ false, cRZBaseString() };
+
+	// We search the loaded string resources for a matching value in the game's
+	// currently configured language. If one is not found we use the default string resource.
+	// Failed lookups are also cached, so a missing resource is only searched for once.
+
+	entry.found = TryGetString(localizedGroupID, key.instanceID, entry.value);
+	lookupCount++;
+
+	if (!entry.found && localizedGroupID != key.groupID)
+	{
+		entry.found = TryGetString(key.groupID, key.instanceID, entry.value);
+		lookupCount++;
+	}
+
+	Logger::GetInstance().WriteLineFormatted(
+		LogOptions::Info,
+		"Cached LTEXT resource 0x%08x, 0x%08x: %s, total resource lookups=%u.",
+		localizedGroupID,
+		key.instanceID,
+		entry.found ? "found" : "not found",
+		lookupCount);
+
+	return entries.emplace(MakeCacheKey(localizedGroupID, key.instanceID), std::move(entry)).first->second;
+}
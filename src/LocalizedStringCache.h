@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cRZBaseString.h"
+#include "StringResourceKey.h"
+#include <unordered_map>
+
+// A process-wide cache of the LTEXT resources that are loaded by the ordinances.
+//
+// The StringResourceManager lookups bypass the game's resource cache, so without
+// this class every city load would repeat the same resource manager queries.
+// The entries are keyed by the language-specific group ID and the instance ID, and
+// are filled the first time a string is requested, which is the first city load.
+class LocalizedStringCache
+{
+public:
+
+	static LocalizedStringCache& GetInstance();
+
+	/**
+	 * @brief Gets a string in the game's current language.
+	 * @param key The key of the default language LTEXT resource.
+	 * @return The localized string, or nullptr if the resource does not exist.
+	 * The pointer remains valid until Clear is called.
+	 */
+	const cIGZString* GetLocalizedString(const StringResourceKey& key);
+
+	/**
+	 * @brief Removes all of the cached strings.
+	 */
+	void Clear();
+
+private:
+
+	struct Entry
+	{
+		bool found;
+		cRZBaseString value;
+	};
+
+	LocalizedStringCache();
+
+	LocalizedStringCache(const LocalizedStringCache&) = delete;
+	LocalizedStringCache& operator=(const LocalizedStringCache&) = delete;
+
+	const Entry& LoadEntry(uint32_t localizedGroupID, const StringResourceKey& key);
+
+	// The map nodes are never moved, which keeps the returned string pointers stable.
+	std::unordered_map<uint64_t, Entry> entries;
+	uint32_t lookupCount;
+};
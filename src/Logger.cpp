@@ -11,7 +11,10 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "Logger.h"
-#include <Windows.h>
+#include "Platform.h"
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
 
 namespace
 {
@@ -19,18 +22,16 @@ namespace
 	{
 		char buffer[1024]{};
 
-		SYSTEMTIME time;
-
-		GetLocalTime(&time);
+		const Platform::LocalTime time = Platform::GetLocalTime();
 
 		std::snprintf(
 			buffer,
 			sizeof(buffer),
 			"[%hu:%hu:%hu.%hu] ",
-			time.wHour,
-			time.wMinute,
-			time.wSecond,
-			time.wMilliseconds);
+			time.hour,
+			time.minute,
+			time.second,
+			time.milliseconds);
 
 		return std::string(buffer);
 	}
@@ -38,8 +39,7 @@ namespace
 #ifdef _DEBUG
 	void PrintLineToDebugOutput(const char* line)
 	{
-		OutputDebugStringA(line);
-		OutputDebugStringA("\n");
+		Platform::WriteDebugOutputLine(line);
 	}
 #endif // _DEBUG
 }
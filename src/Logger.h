@@ -22,8 +22,9 @@ enum class LogOptions : int32_t
 	OrdinanceAPI = 1 << 2,
 	OrdinancePropertyAPI = 1 << 3,
 	DumpRegisteredOrdinances = 1 << 4,
+	Profiling = 1 << 5,
 	InfoAndErrors = Info | Errors,
-	All = Info | Errors | OrdinanceAPI | OrdinancePropertyAPI | DumpRegisteredOrdinances
+	All = Info | Errors | OrdinanceAPI | OrdinancePropertyAPI | DumpRegisteredOrdinances | Profiling
 };
 
 inline LogOptions operator|(LogOptions lhs, LogOptions rhs)
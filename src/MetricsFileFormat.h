@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <array>
+#include <stdint.h>
+
+// The layout of the monthly metrics files that MetricsRecorder writes and MetricsFileReader reads.
+//
+// The file starts with a FileHeader and one ColumnDescriptor per column, followed by
+// fixed-size blocks. Each block has a BlockHeader and then RowsPerBlock values for
+// every column, stored column by column. All values are 4 bytes and little-endian.
+//
+// A new block is written as zeros when the previous block is full, appending a row
+// only overwrites existing bytes and then increments the block row count. A row that
+// was interrupted before the row count was written is ignored by the reader.
+namespace MetricsFileFormat
+{
+	constexpr std::array<char, 8> Signature = { 'P', 'N', 'R', 'M', 'E', 'T', 'R', 'C' };
+	constexpr uint32_t Version = 1;
+	constexpr uint32_t RowsPerBlock = 64;
+	constexpr uint32_t ColumnNameLength = 24;
+
+	enum class ColumnType : uint32_t
+	{
+		Int32 = 0,
+		UInt32 = 1,
+		Float32 = 2,
+	};
+
+	struct FileHeader
+	{
+		char signature[8];
+		uint32_t version;
+		uint32_t columnCount;
+		uint32_t rowsPerBlock;
+		uint32_t reserved;
+	};
+
+	struct ColumnDescriptor
+	{
+		// The column name, padded with zeros.
+		char name[ColumnNameLength];
+		ColumnType type;
+		uint32_t reserved;
+	};
+
+	struct BlockHeader
+	{
+		uint32_t rowCount;
+		uint32_t reserved;
+	};
+
+	static_assert(sizeof(FileHeader) == 24);
+	static_assert(sizeof(ColumnDescriptor) == 32);
+	static_assert(sizeof(BlockHeader) == 8);
+
+	// The columns that the current version writes.
+	enum Column : uint32_t
+	{
+		Year = 0,
+		Month,
+		OrdinanceOn,
+		CarRestrictionActive,
+		TripScale,
+		LastMonthlyIncome,
+		FreightScalingFactor,
+		// The number of congestion map tracts without traffic.
+		CongestionZero,
+		// The number of congestion map tracts in each 32 value range, the first
+		// bucket excludes the tracts without traffic.
+		CongestionBucket0,
+		CongestionBucket1,
+		CongestionBucket2,
+		CongestionBucket3,
+		CongestionBucket4,
+		CongestionBucket5,
+		CongestionBucket6,
+		CongestionBucket7,
+		ColumnCount
+	};
+
+	constexpr uint32_t CongestionBucketCount = 8;
+	constexpr uint32_t CongestionBucketShift = 5;
+
+	struct ColumnInfo
+	{
+		const char* name;
+		ColumnType type;
+	};
+
+	constexpr std::array<ColumnInfo, ColumnCount> Columns =
+	{{
+		{ "Year", ColumnType::Int32 },
+		{ "Month", ColumnType::Int32 },
+		{ "OrdinanceOn", ColumnType::UInt32 },
+		{ "CarRestrictionActive", ColumnType::UInt32 },
+		{ "TripScale", ColumnType::Float32 },
+		{ "LastMonthlyIncome", ColumnType::Float32 },
+		{ "FreightScalingFactor", ColumnType::Float32 },
+		{ "Congestion0", ColumnType::UInt32 },
+		{ "Congestion1To31", ColumnType::UInt32 },
+		{ "Congestion32To63", ColumnType::UInt32 },
+		{ "Congestion64To95", ColumnType::UInt32 },
+		{ "Congestion96To127", ColumnType::UInt32 },
+		{ "Congestion128To159", ColumnType::UInt32 },
+		{ "Congestion160To191", ColumnType::UInt32 },
+		{ "Congestion192To223", ColumnType::UInt32 },
+		{ "Congestion224To255", ColumnType::UInt32 },
+	}};
+
+	constexpr uint64_t GetBlockSize(uint32_t columnCount, uint32_t rowsPerBlock)
+	{
+		return sizeof(BlockHeader) + (static_cast<uint64_t>(columnCount) * rowsPerBlock * sizeof(uint32_t));
+	}
+
+	constexpr uint64_t GetHeaderSize(uint32_t columnCount)
+	{
+		return sizeof(FileHeader) + (static_cast<uint64_t>(columnCount) * sizeof(ColumnDescriptor));
+	}
+}
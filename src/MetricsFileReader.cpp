@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "MetricsFileReader.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+using namespace MetricsFileFormat;
+
+MetricsFileReader::MetricsFileReader()
+	: columns(),
+	  rowCount(0)
+{
+}
+
+bool MetricsFileReader::Open(const std::filesystem::path& path)
+{
+	columns.clear();
+	rowCount = 0;
+
+	std::ifstream stream(path, std::ios::binary);
+
+	FileHeader header{};
+
+	if (!stream
+		|| !stream.read(reinterpret_cast<char*>(&header), sizeof(header))
+		|| std::memcmp(header.signature, Signature.data(), Signature.size()) != 0
+		|| header.version != Version
+		|| header.columnCount == 0
+		|| header.rowsPerBlock == 0)
+	{
+		return false;
+	}
+
+	columns.resize(header.columnCount);
+
+	for (Column& column : columns)
+	{
+		ColumnDescriptor descriptor{};
+
+		if (!stream.read(reinterpret_cast<char*>(&descriptor), sizeof(descriptor)))
+		{
+			columns.clear();
+			return false;
+		}
+
+		column.name.assign(descriptor.name, std::find(descriptor.name, descriptor.name + ColumnNameLength, '\0'));
+		column.type = descriptor.type;
+	}
+
+	std::vector<uint32_t> blockValues(static_cast<size_t>(header.columnCount) * header.rowsPerBlock);
+
+	while (true)
+	{
+		BlockHeader blockHeader{};
+
+		// A block that was not completely written is ignored.
+		if (!stream.read(reinterpret_cast<char*>(&blockHeader), sizeof(blockHeader))
+			|| !stream.read(reinterpret_cast<char*>(blockValues.data()), blockValues.size() * sizeof(uint32_t)))
+		{
+			break;
+		}
+
+		const uint32_t blockRowCount = std::min(blockHeader.rowCount, header.rowsPerBlock);
+
+		for (size_t i = 0; i < columns.size(); i++)
+		{
+			const uint32_t* columnValues = blockValues.data() + (i * header.rowsPerBlock);
+
+			columns[i].values.insert(columns[i].values.end(), columnValues, columnValues + blockRowCount);
+		}
+
+		rowCount += blockRowCount;
+	}
+
+	return true;
+}
+
+size_t MetricsFileReader::GetColumnCount() const
+{
+	return columns.size();
+}
+
+size_t MetricsFileReader::GetRowCount() const
+{
+	return rowCount;
+}
+
+const std::string& MetricsFileReader::GetColumnName(size_t column) const
+{
+	return columns[column].name;
+}
+
+ColumnType MetricsFileReader::GetColumnType(size_t column) const
+{
+	return columns[column].type;
+}
+
+bool MetricsFileReader::FindColumn(std::string_view name, size_t& column) const
+{
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		if (columns[i].name == name)
+		{
+			column = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int32_t MetricsFileReader::GetInt32(size_t column, size_t row) const
+{
+	return std::bit_cast<int32_t>(columns[column].values[row]);
+}
+
+uint32_t MetricsFileReader::GetUInt32(size_t column, size_t row) const
+{
+	return columns[column].values[row];
+}
+
+float MetricsFileReader::GetFloat(size_t column, size_t row) const
+{
+	return std::bit_cast<float>(columns[column].values[row]);
+}
+
+bool MetricsFileReader::WriteCsv(std::ostream& stream) const
+{
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		if (i > 0)
+		{
+			stream << ',';
+		}
+
+		stream << columns[i].name;
+	}
+
+	stream << '\n';
+
+	const std::streamsize oldPrecision = stream.precision(9);
+
+	for (size_t row = 0; row < rowCount; row++)
+	{
+		for (size_t i = 0; i < columns.size(); i++)
+		{
+			if (i > 0)
+			{
+				stream << ',';
+			}
+
+			switch (columns[i].type)
+			{
+			case ColumnType::Int32:
+				stream << GetInt32(i, row);
+				break;
+			case ColumnType::Float32:
+				stream << GetFloat(i, row);
+				break;
+			case ColumnType::UInt32:
+			default:
+				stream << GetUInt32(i, row);
+				break;
+			}
+		}
+
+		stream << '\n';
+	}
+
+	stream.precision(oldPrecision);
+
+	return static_cast<bool>(stream);
+}
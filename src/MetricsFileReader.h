@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "MetricsFileFormat.h"
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Reads the metrics files that MetricsRecorder writes.
+//
+// The reader uses the column descriptors stored in the file, so it can read
+// files that have columns the current plugin version does not write.
+class MetricsFileReader
+{
+public:
+
+	MetricsFileReader();
+
+	/**
+	 * @brief Reads all of the rows in the specified file.
+	 * @param path The file path.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Open(const std::filesystem::path& path);
+
+	size_t GetColumnCount() const;
+	size_t GetRowCount() const;
+
+	const std::string& GetColumnName(size_t column) const;
+	MetricsFileFormat::ColumnType GetColumnType(size_t column) const;
+
+	/**
+	 * @brief Finds the column with the specified name.
+	 * @param name The column name.
+	 * @param column Receives the column index.
+	 * @return True if the column was found; otherwise, false.
+	 */
+	bool FindColumn(std::string_view name, size_t& column) const;
+
+	int32_t GetInt32(size_t column, size_t row) const;
+	uint32_t GetUInt32(size_t column, size_t row) const;
+	float GetFloat(size_t column, size_t row) const;
+
+	/**
+	 * @brief Writes the rows as comma-separated values, the first line contains the column names.
+	 * @param stream The output stream.
+	 * @return True on success; otherwise, false.
+	 */
+	bool WriteCsv(std::ostream& stream) const;
+
+private:
+
+	struct Column
+	{
+		std::string name;
+		MetricsFileFormat::ColumnType type;
+		std::vector<uint32_t> values;
+	};
+
+	std::vector<Column> columns;
+	size_t rowCount;
+};
@@ -0,0 +1,401 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "MetricsRecorder.h"
+#include "cISC4City.h"
+#include "cISC4SimGrid.h"
+#include "cISC4Simulator.h"
+#include "cISC4TrafficSimulator.h"
+#include "cRZBaseString.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <string>
+
+using namespace MetricsFileFormat;
+
+namespace
+{
+	constexpr int64_t kNotRecorded = -1;
+	constexpr std::string_view MetricsFileExtension = ".pnrmetrics";
+
+	constexpr uint64_t kHeaderSize = GetHeaderSize(ColumnCount);
+	constexpr uint64_t kBlockSize = GetBlockSize(ColumnCount, RowsPerBlock);
+
+	constexpr std::array<uint32_t, RowsPerBlock> kEmptyColumn{};
+
+	uint64_t GetBlockOffset(uint64_t blockIndex)
+	{
+		return kHeaderSize + (blockIndex * kBlockSize);
+	}
+
+	uint64_t GetValueOffset(uint64_t blockIndex, uint32_t column, uint32_t rowIndex)
+	{
+		return GetBlockOffset(blockIndex)
+			+ sizeof(BlockHeader)
+			+ ((static_cast<uint64_t>(column) * RowsPerBlock) + rowIndex) * sizeof(uint32_t);
+	}
+
+	bool IsInvalidFileNameChar(char c)
+	{
+		return static_cast<unsigned char>(c) < 0x20 || std::strchr("<>:\"/\\|?*", c) != nullptr;
+	}
+}
+
+MetricsRecorder::MetricsRecorder()
+	: logger(Logger::GetInstance()),
+	  file(),
+	  blockCount(0),
+	  lastBlockRowCount(0),
+	  recordedMonth(kNotRecorded),
+	  row(),
+	  congestionHistogram()
+{
+}
+
+std::filesystem::path MetricsRecorder::GetCityFilePath(const std::filesystem::path& folderPath, cISC4City* pCity)
+{
+	std::string fileName;
+
+	cRZBaseString cityName;
+
+	if (pCity && pCity->GetCityName(cityName) && cityName.Strlen() > 0)
+	{
+		fileName.assign(cityName.ToChar(), cityName.Strlen());
+
+		for (char& c : fileName)
+		{
+			if (IsInvalidFileNameChar(c))
+			{
+				c = '_';
+			}
+		}
+	}
+	else
+	{
+		fileName = "Unnamed City";
+	}
+
+	fileName.append(MetricsFileExtension);
+
+	std::filesystem::path path = folderPath;
+	path /= fileName;
+
+	return path;
+}
+
+bool MetricsRecorder::Open(const std::filesystem::path& path)
+{
+	Close();
+
+	std::error_code ec;
+	const bool exists = std::filesystem::exists(path, ec);
+
+	const bool result = exists ? ValidateExistingFile(path) : CreateNewFile(path);
+
+	if (result)
+	{
+		file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+
+		if (!file)
+		{
+			logger.WriteLine(LogOptions::Errors, "Failed to open the metrics file.");
+			return false;
+		}
+	}
+
+	return result;
+}
+
+void MetricsRecorder::Close()
+{
+	if (file.is_open())
+	{
+		file.close();
+	}
+
+	file.clear();
+	blockCount = 0;
+	lastBlockRowCount = 0;
+	recordedMonth = kNotRecorded;
+}
+
+bool MetricsRecorder::IsOpen() const
+{
+	return file.is_open();
+}
+
+bool MetricsRecorder::Record(cISC4City* pCity, bool ordinanceOn, bool carRestrictionActive)
+{
+	cISC4Simulator* pSimulator = pCity ? pCity->GetSimulator() : nullptr;
+
+	if (!file.is_open() || !pSimulator)
+	{
+		return false;
+	}
+
+	long year = 0;
+	long month = 0;
+	long day = 0;
+	long dayOfYear = 0;
+	long weekDay = 0;
+
+	pSimulator->GetSimDate(year, month, day, dayOfYear, weekDay);
+
+	const int64_t currentMonth = (static_cast<int64_t>(year) * 12) + month;
+
+	if (currentMonth == recordedMonth)
+	{
+		return false;
+	}
+
+	row[Year] = std::bit_cast<uint32_t>(static_cast<int32_t>(year));
+	row[Month] = std::bit_cast<uint32_t>(static_cast<int32_t>(month));
+	FillRow(pCity, ordinanceOn, carRestrictionActive);
+
+	if (!AppendRow())
+	{
+		logger.WriteLine(LogOptions::Errors, "Failed to write to the metrics file, recording is stopped.");
+		Close();
+		return false;
+	}
+
+	recordedMonth = currentMonth;
+	return true;
+}
+
+uint64_t MetricsRecorder::GetRowCount() const
+{
+	return blockCount > 0 ? ((blockCount - 1) * RowsPerBlock) + lastBlockRowCount : 0;
+}
+
+bool MetricsRecorder::CreateNewFile(const std::filesystem::path& path)
+{
+	std::error_code ec;
+	std::filesystem::create_directories(path.parent_path(), ec);
+
+	std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+
+	if (!stream)
+	{
+		logger.WriteLine(LogOptions::Errors, "Failed to create the metrics file.");
+		return false;
+	}
+
+	FileHeader header{};
+	std::memcpy(header.signature, Signature.data(), Signature.size());
+	header.version = Version;
+	header.columnCount = ColumnCount;
+	header.rowsPerBlock = RowsPerBlock;
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	for (const ColumnInfo& column : Columns)
+	{
+		ColumnDescriptor descriptor{};
+		std::strncpy(descriptor.name, column.name, ColumnNameLength - 1);
+		descriptor.type = column.type;
+
+		stream.write(reinterpret_cast<const char*>(&descriptor), sizeof(descriptor));
+	}
+
+	blockCount = 0;
+	lastBlockRowCount = 0;
+
+	return static_cast<bool>(stream.flush());
+}
+
+bool MetricsRecorder::ValidateExistingFile(const std::filesystem::path& path)
+{
+	std::ifstream stream(path, std::ios::binary);
+
+	FileHeader header{};
+
+	if (!stream || !stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+	{
+		logger.WriteLine(LogOptions::Errors, "Failed to read the metrics file header.");
+		return false;
+	}
+
+	bool columnsMatch = std::memcmp(header.signature, Signature.data(), Signature.size()) == 0
+		&& header.version == Version
+		&& header.columnCount == ColumnCount
+		&& header.rowsPerBlock == RowsPerBlock;
+
+	for (uint32_t i = 0; columnsMatch && i < ColumnCount; i++)
+	{
+		ColumnDescriptor descriptor{};
+
+		columnsMatch = stream.read(reinterpret_cast<char*>(&descriptor), sizeof(descriptor))
+			&& std::strncmp(descriptor.name, Columns[i].name, ColumnNameLength) == 0
+			&& descriptor.type == Columns[i].type;
+	}
+
+	if (!columnsMatch)
+	{
+		logger.WriteLine(
+			LogOptions::Errors,
+			"The existing metrics file uses a different format, rename or delete it to record new metrics.");
+		return false;
+	}
+
+	std::error_code ec;
+	const uint64_t fileSize = std::filesystem::file_size(path, ec);
+
+	if (ec)
+	{
+		logger.WriteLine(LogOptions::Errors, "Failed to get the metrics file size.");
+		return false;
+	}
+
+	blockCount = (fileSize - kHeaderSize) / kBlockSize;
+	lastBlockRowCount = 0;
+
+	if (blockCount > 0)
+	{
+		BlockHeader blockHeader{};
+
+		if (!stream.seekg(static_cast<std::streamoff>(GetBlockOffset(blockCount - 1)))
+			|| !stream.read(reinterpret_cast<char*>(&blockHeader), sizeof(blockHeader)))
+		{
+			logger.WriteLine(LogOptions::Errors, "Failed to read the last metrics file block.");
+			return false;
+		}
+
+		lastBlockRowCount = std::min(blockHeader.rowCount, RowsPerBlock);
+	}
+
+	stream.close();
+
+	// Remove a block that was only partially written, the next row starts a new one.
+	if (fileSize != GetBlockOffset(blockCount))
+	{
+		std::filesystem::resize_file(path, GetBlockOffset(blockCount), ec);
+
+		if (ec)
+		{
+			logger.WriteLine(LogOptions::Errors, "Failed to remove the incomplete metrics file block.");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void MetricsRecorder::FillRow(cISC4City* pCity, bool ordinanceOn, bool carRestrictionActive)
+{
+	row[OrdinanceOn] = ordinanceOn ? 1 : 0;
+	row[CarRestrictionActive] = carRestrictionActive ? 1 : 0;
+
+	cISC4TrafficSimulator* pTrafficSimulator = pCity->GetTrafficSimulator();
+
+	float tripScale = 0.0f;
+	float lastMonthlyIncome = 0.0f;
+	float freightScalingFactor = 0.0f;
+	SimGridView<uint8_t> congestion;
+
+	if (pTrafficSimulator)
+	{
+		tripScale = pTrafficSimulator->GetTripScale();
+		lastMonthlyIncome = pTrafficSimulator->GetLastMonthlyIncome();
+		freightScalingFactor = pTrafficSimulator->GetFreightScalingFactor();
+		congestion = SimGridView<uint8_t>::FromGrid(
+			reinterpret_cast<cISC4SimGrid<uint8_t>*>(pTrafficSimulator->GetCongestionMap()));
+	}
+
+	row[TripScale] = std::bit_cast<uint32_t>(tripScale);
+	row[LastMonthlyIncome] = std::bit_cast<uint32_t>(lastMonthlyIncome);
+	row[FreightScalingFactor] = std::bit_cast<uint32_t>(freightScalingFactor);
+
+	for (uint32_t i = CongestionZero; i < ColumnCount; i++)
+	{
+		row[i] = 0;
+	}
+
+	if (congestion.IsValid())
+	{
+		SimGridReductions::BuildHistogram(congestion, congestionHistogram);
+
+		row[CongestionZero] = congestionHistogram[0];
+
+		for (size_t value = 1; value < congestionHistogram.size(); value++)
+		{
+			row[CongestionBucket0 + (value >> CongestionBucketShift)] += congestionHistogram[value];
+		}
+	}
+}
+
+bool MetricsRecorder::AppendBlock()
+{
+	const BlockHeader blockHeader{};
+
+	if (!WriteAt(GetBlockOffset(blockCount), &blockHeader, sizeof(blockHeader)))
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < ColumnCount; i++)
+	{
+		if (!file.write(reinterpret_cast<const char*>(kEmptyColumn.data()), sizeof(kEmptyColumn)))
+		{
+			return false;
+		}
+	}
+
+	blockCount++;
+	lastBlockRowCount = 0;
+
+	return true;
+}
+
+bool MetricsRecorder::AppendRow()
+{
+	if (blockCount == 0 || lastBlockRowCount == RowsPerBlock)
+	{
+		if (!AppendBlock())
+		{
+			return false;
+		}
+	}
+
+	const uint64_t blockIndex = blockCount - 1;
+
+	for (uint32_t i = 0; i < ColumnCount; i++)
+	{
+		if (!WriteAt(GetValueOffset(blockIndex, i, lastBlockRowCount), &row[i], sizeof(uint32_t)))
+		{
+			return false;
+		}
+	}
+
+	// The row count is written last, the reader ignores a row that is not counted.
+	if (!file.flush())
+	{
+		return false;
+	}
+
+	const uint32_t rowCount = lastBlockRowCount + 1;
+
+	if (!WriteAt(GetBlockOffset(blockIndex), &rowCount, sizeof(rowCount)) || !file.flush())
+	{
+		return false;
+	}
+
+	lastBlockRowCount = rowCount;
+	return true;
+}
+
+bool MetricsRecorder::WriteAt(uint64_t offset, const void* data, size_t size)
+{
+	return file.seekp(static_cast<std::streamoff>(offset))
+		&& file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Logger.h"
+#include "MetricsFileFormat.h"
+#include "SimGridReductions.h"
+#include <filesystem>
+#include <fstream>
+
+class cISC4City;
+
+// Appends the monthly traffic statistics of a city to a metrics file, see MetricsFileFormat.h.
+//
+// Every row has the same columns, and the values are written into a preallocated
+// block in the file so recording a month does not allocate any memory.
+class MetricsRecorder
+{
+public:
+
+	MetricsRecorder();
+
+	/**
+	 * @brief Gets the metrics file path for the specified city.
+	 * @param folderPath The folder that contains the metrics files.
+	 * @param pCity The city.
+	 * @return The file path, the file name is based on the city name.
+	 */
+	static std::filesystem::path GetCityFilePath(const std::filesystem::path& folderPath, cISC4City* pCity);
+
+	/**
+	 * @brief Opens the metrics file, the file is created if it does not exist.
+	 *
+	 * An existing file must use the current columns, it is never overwritten.
+	 * @param path The file path.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Open(const std::filesystem::path& path);
+
+	void Close();
+
+	bool IsOpen() const;
+
+	/**
+	 * @brief Appends the statistics for the current simulation month.
+	 *
+	 * Only the first call in a simulation month writes a row.
+	 * @param pCity The city.
+	 * @param ordinanceOn True if the ordinance is enacted.
+	 * @param carRestrictionActive True if the ordinance is currently restricting cars.
+	 * @return True if a row was written; otherwise, false.
+	 */
+	bool Record(cISC4City* pCity, bool ordinanceOn, bool carRestrictionActive);
+
+	/**
+	 * @brief Gets the number of rows in the file, including the rows from earlier sessions.
+	 */
+	uint64_t GetRowCount() const;
+
+private:
+
+	bool CreateNewFile(const std::filesystem::path& path);
+	bool ValidateExistingFile(const std::filesystem::path& path);
+	void FillRow(cISC4City* pCity, bool ordinanceOn, bool carRestrictionActive);
+	bool AppendBlock();
+	bool AppendRow();
+	bool WriteAt(uint64_t offset, const void* data, size_t size);
+
+	Logger& logger;
+	std::fstream file;
+	uint64_t blockCount;
+	// The number of rows in the last block.
+	uint32_t lastBlockRowCount;
+	// The year and month of the last row, or -1 if no row was written in this session.
+	int64_t recordedMonth;
+	std::array<uint32_t, MetricsFileFormat::ColumnCount> row;
+	SimGridReductions::Histogram congestionHistogram;
+};
@@ -11,8 +11,9 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "OrdinanceBase.h"
+#include "InternedStringTable.h"
+#include "LocalizedStringCache.h"
 #include "StringResourceKey.h"
-#include "StringResourceManager.h"
 #include "cIGZDate.h"
 #include "cIGZIStream.h"
 #include "cIGZOStream.h"
@@ -20,10 +21,14 @@
 #include "cISC4Simulator.h"
 #include "SC4Percentage.h"
 #include <algorithm>
+#include <limits>
 #include <stdlib.h>
 
 static const uint32_t GZIID_OrdinanceBase = 0x3cb94c9e;
 
+// The query cache date of a value that has not been computed.
+static constexpr int32_t kNoQueryCacheDate = std::numeric_limits<int32_t>::min();
+
 OrdinanceBase::OrdinanceBase(
 	uint32_t clsid,
 	const char* name,
@@ -33,26 +38,30 @@ OrdinanceBase::OrdinanceBase(
 	int64_t monthlyConstantIncome,
 	float monthlyIncomeFactor,
 	bool isIncomeOrdinance)
-	: clsid(clsid),
-	  refCount(0),
-	  name(name),
-	  nameKey(),
-	  description(description),
-	  descriptionKey(),
+	: logger(Logger::GetInstance()),
+	  clsid(clsid),
+	  nameID(InternedStringTable::GetInstance().Intern(name)),
+	  descriptionID(InternedStringTable::GetInstance().Intern(description)),
 	  enactmentIncome(enactmentIncome),
 	  retracmentIncome(retracmentIncome),
 	  monthlyConstantIncome(monthlyConstantIncome),
+	  monthlyAdjustedIncome(0),
 	  monthlyIncomeFactor(monthlyIncomeFactor),
 	  isIncomeOrdinance(isIncomeOrdinance),
-	  monthlyAdjustedIncome(0),
+	  miscProperties(),
 	  initialized(false),
 	  available(false),
 	  on(false),
 	  enabled(false),
+	  refCount(0),
 	  pResidentialSimulator(nullptr),
 	  pSimulator(nullptr),
-	  miscProperties(),
-	  logger(Logger::GetInstance())
+	  nameKey(),
+	  descriptionKey(),
+	  scaledEffects(),
+	  effectStrength(1.0f),
+	  queryCache{ kNoQueryCacheDate, 0, kNoQueryCacheDate, false },
+	  queryCacheStatistics{}
 {
 }
 
@@ -66,26 +75,30 @@ OrdinanceBase::OrdinanceBase(
 	float monthlyIncomeFactor,
 	bool isIncomeOrdinance,
 	const OrdinancePropertyHolder& properties)
-	: clsid(clsid),
-	  refCount(0),
-	  name(name),
-	  nameKey(),
-	  description(description),
-	  descriptionKey(),
+	: logger(Logger::GetInstance()),
+	  clsid(clsid),
+	  nameID(InternedStringTable::GetInstance().Intern(name)),
+	  descriptionID(InternedStringTable::GetInstance().Intern(description)),
 	  enactmentIncome(enactmentIncome),
 	  retracmentIncome(retracmentIncome),
 	  monthlyConstantIncome(monthlyConstantIncome),
+	  monthlyAdjustedIncome(0),
 	  monthlyIncomeFactor(monthlyIncomeFactor),
 	  isIncomeOrdinance(isIncomeOrdinance),
-	  monthlyAdjustedIncome(0),
+	  miscProperties(properties),
 	  initialized(false),
 	  available(false),
 	  on(false),
 	  enabled(false),
+	  refCount(0),
 	  pResidentialSimulator(nullptr),
 	  pSimulator(nullptr),
-	  miscProperties(properties),
-	  logger(Logger::GetInstance())
+	  nameKey(),
+	  descriptionKey(),
+	  scaledEffects(),
+	  effectStrength(1.0f),
+	  queryCache{ kNoQueryCacheDate, 0, kNoQueryCacheDate, false },
+	  queryCacheStatistics{}
 {
 }
 
@@ -100,26 +113,30 @@ OrdinanceBase::OrdinanceBase(
 	int64_t monthlyConstantIncome,
 	float monthlyIncomeFactor,
 	bool isIncomeOrdinance)
-	: clsid(clsid),
-	  refCount(0),
-	  name(name),
-	  nameKey(nameKey),
-	  description(description),
-	  descriptionKey(descriptionKey),
+	: logger(Logger::GetInstance()),
+	  clsid(clsid),
+	  nameID(InternedStringTable::GetInstance().Intern(name)),
+	  descriptionID(InternedStringTable::GetInstance().Intern(description)),
 	  enactmentIncome(enactmentIncome),
 	  retracmentIncome(retracmentIncome),
 	  monthlyConstantIncome(monthlyConstantIncome),
+	  monthlyAdjustedIncome(0),
 	  monthlyIncomeFactor(monthlyIncomeFactor),
 	  isIncomeOrdinance(isIncomeOrdinance),
-	  monthlyAdjustedIncome(0),
+	  miscProperties(),
 	  initialized(false),
 	  available(false),
 	  on(false),
 	  enabled(false),
+	  refCount(0),
 	  pResidentialSimulator(nullptr),
 	  pSimulator(nullptr),
-	  miscProperties(),
-	  logger(Logger::GetInstance())
+	  nameKey(nameKey),
+	  descriptionKey(descriptionKey),
+	  scaledEffects(),
+	  effectStrength(1.0f),
+	  queryCache{ kNoQueryCacheDate, 0, kNoQueryCacheDate, false },
+	  queryCacheStatistics{}
 {
 }
 
@@ -135,74 +152,86 @@ OrdinanceBase::OrdinanceBase(
 	float monthlyIncomeFactor,
 	bool isIncomeOrdinance,
 	const OrdinancePropertyHolder& properties)
-	: clsid(clsid),
-	  refCount(0),
-	  name(name),
-	  nameKey(nameKey),
-	  description(description),
-	  descriptionKey(descriptionKey),
+	: logger(Logger::GetInstance()),
+	  clsid(clsid),
+	  nameID(InternedStringTable::GetInstance().Intern(name)),
+	  descriptionID(InternedStringTable::GetInstance().Intern(description)),
 	  enactmentIncome(enactmentIncome),
 	  retracmentIncome(retracmentIncome),
 	  monthlyConstantIncome(monthlyConstantIncome),
+	  monthlyAdjustedIncome(0),
 	  monthlyIncomeFactor(monthlyIncomeFactor),
 	  isIncomeOrdinance(isIncomeOrdinance),
-	  monthlyAdjustedIncome(0),
+	  miscProperties(properties),
 	  initialized(false),
 	  available(false),
 	  on(false),
 	  enabled(false),
+	  refCount(0),
 	  pResidentialSimulator(nullptr),
 	  pSimulator(nullptr),
-	  miscProperties(properties),
-	  logger(Logger::GetInstance())
+	  nameKey(nameKey),
+	  descriptionKey(descriptionKey),
+	  scaledEffects(),
+	  effectStrength(1.0f),
+	  queryCache{ kNoQueryCacheDate, 0, kNoQueryCacheDate, false },
+	  queryCacheStatistics{}
 {
 }
 
 OrdinanceBase::OrdinanceBase(const OrdinanceBase& other)
-	: clsid(other.clsid),
-	  refCount(0),
-	  name(other.name),
-	  nameKey(other.nameKey),
-	  description(other.description),
-	  descriptionKey(other.descriptionKey),
+	: logger(Logger::GetInstance()),
+	  clsid(other.clsid),
+	  nameID(other.nameID),
+	  descriptionID(other.descriptionID),
 	  enactmentIncome(other.enactmentIncome),
 	  retracmentIncome(other.retracmentIncome),
 	  monthlyConstantIncome(other.monthlyConstantIncome),
+	  monthlyAdjustedIncome(other.monthlyAdjustedIncome),
 	  monthlyIncomeFactor(other.monthlyIncomeFactor),
 	  isIncomeOrdinance(other.isIncomeOrdinance),
-	  monthlyAdjustedIncome(other.monthlyAdjustedIncome),
+	  miscProperties(other.miscProperties),
 	  initialized(other.initialized),
 	  available(other.available),
 	  on(other.on),
 	  enabled(other.enabled),
+	  refCount(0),
 	  pResidentialSimulator(other.pResidentialSimulator),
 	  pSimulator(other.pSimulator),
-	  miscProperties(other.miscProperties),
-	  logger(Logger::GetInstance())
+	  nameKey(other.nameKey),
+	  descriptionKey(other.descriptionKey),
+	  scaledEffects(other.scaledEffects),
+	  effectStrength(other.effectStrength),
+	  queryCache(other.queryCache),
+	  queryCacheStatistics(other.queryCacheStatistics)
 {
 }
 
 OrdinanceBase::OrdinanceBase(OrdinanceBase&& other) noexcept
-	: clsid(other.clsid),
-	  refCount(0),
-	  name(std::move(name)),
-	  nameKey(other.nameKey),
-	  description(std::move(other.description)),
-	  descriptionKey(other.descriptionKey),
+	: logger(Logger::GetInstance()),
+	  clsid(other.clsid),
+	  nameID(other.nameID),
+	  descriptionID(other.descriptionID),
 	  enactmentIncome(other.enactmentIncome),
 	  retracmentIncome(other.retracmentIncome),
 	  monthlyConstantIncome(other.monthlyConstantIncome),
+	  monthlyAdjustedIncome(other.monthlyAdjustedIncome),
 	  monthlyIncomeFactor(other.monthlyIncomeFactor),
 	  isIncomeOrdinance(other.isIncomeOrdinance),
-	  monthlyAdjustedIncome(other.monthlyAdjustedIncome),
+	  miscProperties(std::move(other.miscProperties)),
 	  initialized(other.initialized),
 	  available(other.available),
 	  on(other.on),
 	  enabled(other.enabled),
+	  refCount(0),
 	  pResidentialSimulator(other.pResidentialSimulator),
 	  pSimulator(other.pSimulator),
-	  miscProperties(std::move(other.miscProperties)),
-	  logger(Logger::GetInstance())
+	  nameKey(other.nameKey),
+	  descriptionKey(other.descriptionKey),
+	  scaledEffects(std::move(other.scaledEffects)),
+	  effectStrength(other.effectStrength),
+	  queryCache(other.queryCache),
+	  queryCacheStatistics(other.queryCacheStatistics)
 {
 	other.pResidentialSimulator = nullptr;
 	other.pSimulator = nullptr;
@@ -217,9 +246,9 @@ OrdinanceBase& OrdinanceBase::operator=(const OrdinanceBase& other)
 
 	clsid = other.clsid;
 	refCount = 0;
-	name = name;
+	nameID = other.nameID;
 	nameKey = other.nameKey;
-	description = other.description;
+	descriptionID = other.descriptionID;
 	descriptionKey = other.descriptionKey;
 	enactmentIncome = other.enactmentIncome;
 	retracmentIncome = other.retracmentIncome;
@@ -234,6 +263,10 @@ OrdinanceBase& OrdinanceBase::operator=(const OrdinanceBase& other)
 	pResidentialSimulator = other.pResidentialSimulator;
 	pSimulator = other.pSimulator;
 	miscProperties = other.miscProperties;
+	scaledEffects = other.scaledEffects;
+	effectStrength = other.effectStrength;
+	queryCache = other.queryCache;
+	queryCacheStatistics = other.queryCacheStatistics;
 
 	return *this;
 }
@@ -247,9 +280,9 @@ OrdinanceBase& OrdinanceBase::operator=(OrdinanceBase&& other) noexcept
 
 	clsid = other.clsid;
 	refCount = 0;
-	name = std::move(name);
+	nameID = other.nameID;
 	nameKey = other.nameKey;
-	description = std::move(other.description);
+	descriptionID = other.descriptionID;
 	descriptionKey = other.descriptionKey;
 	enactmentIncome = other.enactmentIncome;
 	retracmentIncome = other.retracmentIncome;
@@ -264,6 +297,10 @@ OrdinanceBase& OrdinanceBase::operator=(OrdinanceBase&& other) noexcept
 	pResidentialSimulator = other.pResidentialSimulator;
 	pSimulator = other.pSimulator;
 	miscProperties = std::move(other.miscProperties);
+	scaledEffects = std::move(other.scaledEffects);
+	effectStrength = other.effectStrength;
+	queryCache = other.queryCache;
+	queryCacheStatistics = other.queryCacheStatistics;
 
 	other.pResidentialSimulator = nullptr;
 	other.pSimulator = nullptr;
@@ -342,6 +379,29 @@ bool OrdinanceBase::Shutdown(void)
 }
 
 int64_t OrdinanceBase::GetCurrentMonthlyIncome(void)
+{
+	int32_t dateNumber = 0;
+
+	if (!TryGetSimDateNumber(dateNumber))
+	{
+		queryCacheStatistics.incomeMisses++;
+		return CalculateMonthlyIncome();
+	}
+
+	if (queryCache.incomeDate == dateNumber)
+	{
+		queryCacheStatistics.incomeHits++;
+		return queryCache.income;
+	}
+
+	queryCacheStatistics.incomeMisses++;
+	queryCache.income = CalculateMonthlyIncome();
+	queryCache.incomeDate = dateNumber;
+
+	return queryCache.income;
+}
+
+int64_t OrdinanceBase::CalculateMonthlyIncome()
 {
 	const int64_t monthlyConstantIncome = GetMonthlyConstantIncome();
 	const double monthlyIncomeFactor = GetMonthlyIncomeFactor();
@@ -391,12 +451,12 @@ uint32_t OrdinanceBase::GetID(void) const
 
 cIGZString* OrdinanceBase::GetName(void)
 {
-	return &name;
+	return InternedStringTable::GetInstance().Get(nameID);
 }
 
 cIGZString* OrdinanceBase::GetDescription(void)
 {
-	return &description;
+	return InternedStringTable::GetInstance().Get(descriptionID);
 }
 
 uint32_t OrdinanceBase::GetYearFirstAvailable(void)
@@ -496,6 +556,29 @@ int64_t OrdinanceBase::GetMonthlyAdjustedIncome(void)
 }
 
 bool OrdinanceBase::CheckConditions(void)
+{
+	int32_t dateNumber = 0;
+
+	if (!TryGetSimDateNumber(dateNumber))
+	{
+		queryCacheStatistics.conditionMisses++;
+		return EvaluateConditions();
+	}
+
+	if (queryCache.conditionsDate == dateNumber)
+	{
+		queryCacheStatistics.conditionHits++;
+		return queryCache.conditions;
+	}
+
+	queryCacheStatistics.conditionMisses++;
+	queryCache.conditions = EvaluateConditions();
+	queryCache.conditionsDate = dateNumber;
+
+	return queryCache.conditions;
+}
+
+bool OrdinanceBase::EvaluateConditions()
 {
 	bool result = false;
 
@@ -530,13 +613,22 @@ bool OrdinanceBase::IsIncomeOrdinance(void)
 
 bool OrdinanceBase::Simulate(void)
 {
+	// The monthly simulation may change the values that the income and conditions depend on.
+	InvalidateQueryCache();
+
 	monthlyAdjustedIncome = GetCurrentMonthlyIncome();
 
 	logger.WriteLineFormatted(
 		LogOptions::OrdinanceAPI,
-		"%s: monthlyAdjustedIncome=%lld",
+		"%s: monthlyAdjustedIncome=%lld, query cache: income hits=%llu, misses=%llu, conditions hits=%llu, misses=%llu",
 		__FUNCTION__,
-		monthlyAdjustedIncome);
+		monthlyAdjustedIncome,
+		queryCacheStatistics.incomeHits,
+		queryCacheStatistics.incomeMisses,
+		queryCacheStatistics.conditionHits,
+		queryCacheStatistics.conditionMisses);
+
+	UpdateScaledEffects();
 
 	return true;
 }
@@ -551,6 +643,7 @@ bool OrdinanceBase::SetAvailable(bool isAvailable)
 
 	available = isAvailable;
 	monthlyAdjustedIncome = 0;
+	InvalidateQueryCache();
 	return true;
 }
 
@@ -563,6 +656,7 @@ bool OrdinanceBase::SetOn(bool isOn)
 		isOn);
 
 	on = isOn;
+	InvalidateQueryCache();
 
 	if (isOn)
 	{
@@ -585,6 +679,7 @@ bool OrdinanceBase::SetEnabled(bool isEnabled)
 		isEnabled);
 
 	enabled = isEnabled;
+	InvalidateQueryCache();
 	return true;
 }
 
@@ -619,6 +714,8 @@ bool OrdinanceBase::PostCityInit(cISC4City* pCity)
 {
 	bool result = false;
 
+	InvalidateQueryCache();
+
 	if (pCity)
 	{
 		pResidentialSimulator = pCity->GetResidentialSimulator();
@@ -644,6 +741,7 @@ bool OrdinanceBase::PreCityShutdown(cISC4City* pCity)
 
 	pResidentialSimulator = nullptr;
 	pSimulator = nullptr;
+	InvalidateQueryCache();
 
 	return result;
 }
@@ -688,12 +786,14 @@ bool OrdinanceBase::Write(cIGZOStream& stream)
 		return false;
 	}
 
-	if (!stream.SetGZStr(name))
+	InternedStringTable& stringTable = InternedStringTable::GetInstance();
+
+	if (!stream.SetGZStr(*stringTable.Get(nameID)))
 	{
 		return false;
 	}
 
-	if (!stream.SetGZStr(description))
+	if (!stream.SetGZStr(*stringTable.Get(descriptionID)))
 	{
 		return false;
 	}
@@ -781,16 +881,23 @@ bool OrdinanceBase::Read(cIGZIStream& stream)
 		return false;
 	}
 
-	if (!stream.GetGZStr(name))
+	InternedStringTable& stringTable = InternedStringTable::GetInstance();
+	cRZBaseString temp;
+
+	if (!stream.GetGZStr(temp))
 	{
 		return false;
 	}
 
-	if (!stream.GetGZStr(description))
+	nameID = stringTable.Intern(temp);
+
+	if (!stream.GetGZStr(temp))
 	{
 		return false;
 	}
 
+	descriptionID = stringTable.Intern(temp);
+
 	if (!stream.GetSint64(enactmentIncome))
 	{
 		return false;
@@ -831,6 +938,10 @@ bool OrdinanceBase::Read(cIGZIStream& stream)
 		return false;
 	}
 
+	// The saved effect values were computed from the traffic at the time the city was saved,
+	// the next simulation month replaces them with the current strength.
+	effectStrength = -1.0f;
+
 	if (!ReadBool(stream, initialized))
 	{
 		return false;
@@ -851,9 +962,89 @@ bool OrdinanceBase::Read(cIGZIStream& stream)
 		return false;
 	}
 
+	InvalidateQueryCache();
+
+	return true;
+}
+
+float OrdinanceBase::GetCurrentEffectStrength() const
+{
+	return effectStrength;
+}
+
+const OrdinanceBase::QueryCacheStatistics& OrdinanceBase::GetQueryCacheStatistics() const
+{
+	return queryCacheStatistics;
+}
+
+void OrdinanceBase::InvalidateQueryCache()
+{
+	queryCache.incomeDate = kNoQueryCacheDate;
+	queryCache.conditionsDate = kNoQueryCacheDate;
+}
+
+bool OrdinanceBase::TryGetSimDateNumber(int32_t& dateNumber) const
+{
+	// The values are only reused while a city is loaded.
+	if (!pSimulator)
+	{
+		return false;
+	}
+
+	dateNumber = pSimulator->GetSimDateNumber();
+	return true;
+}
+
+bool OrdinanceBase::AddScaledEffect(uint32_t propertyID, float neutralValue)
+{
+	float fullValue = 0.0f;
+
+	if (!miscProperties.GetFloatValue(propertyID, fullValue))
+	{
+		return false;
+	}
+
+	scaledEffects.push_back(ScaledEffect{ propertyID, neutralValue, fullValue, 0 });
 	return true;
 }
 
+float OrdinanceBase::GetEffectStrength()
+{
+	return 1.0f;
+}
+
+void OrdinanceBase::UpdateScaledEffects()
+{
+	if (scaledEffects.empty())
+	{
+		return;
+	}
+
+	const float strength = std::clamp(GetEffectStrength(), 0.0f, 1.0f);
+
+	if (strength == effectStrength)
+	{
+		return;
+	}
+
+	// The values are written into the existing property variants, the game reads
+	// them from the property holder when it applies the ordinance effects.
+	for (ScaledEffect& effect : scaledEffects)
+	{
+		const float value = effect.neutralValue + ((effect.fullValue - effect.neutralValue) * strength);
+
+		miscProperties.SetFloatValue(effect.propertyID, value, effect.propertyIndex);
+	}
+
+	effectStrength = strength;
+
+	logger.WriteLineFormatted(
+		LogOptions::OrdinanceAPI,
+		"%s: effectStrength=%f",
+		__FUNCTION__,
+		strength);
+}
+
 uint32_t OrdinanceBase::GetGZCLSID()
 {
 	logger.WriteLine(LogOptions::OrdinanceAPI, __FUNCTION__);
@@ -863,26 +1054,31 @@ uint32_t OrdinanceBase::GetGZCLSID()
 
 void OrdinanceBase::LoadLocalizedStringResources()
 {
-	cIGZString* localizedName = nullptr;
-	cIGZString* localizedDescription = nullptr;
+	// The strings are shared by every ordinance and only loaded from the resource
+	// manager on the first city load, switching cities reuses the cached values.
+	LocalizedStringCache& cache = LocalizedStringCache::GetInstance();
+
+	const cIGZString* localizedName = cache.GetLocalizedString(nameKey);
 
-	if (StringResourceManager::GetLocalizedString(nameKey, &localizedName))
+	if (localizedName)
 	{
-		if (StringResourceManager::GetLocalizedString(descriptionKey, &localizedDescription))
+		const cIGZString* localizedDescription = cache.GetLocalizedString(descriptionKey);
+
+		if (localizedDescription)
 		{
-			if (localizedName->Strlen() > 0 && !localizedName->IsEqual(this->name, false))
+			// Interning an existing string is a hash table lookup, relocalizing the
+			// ordinance does not allocate after the first city load.
+			InternedStringTable& stringTable = InternedStringTable::GetInstance();
+
+			if (localizedName->Strlen() > 0)
 			{
-				this->name.Copy(*localizedName);
+				nameID = stringTable.Intern(*localizedName);
 			}
 
-			if (localizedDescription->Strlen() > 0 && !localizedDescription->IsEqual(this->description, false))
+			if (localizedDescription->Strlen() > 0)
 			{
-				this->description.Copy(*localizedDescription);
+				descriptionID = stringTable.Intern(*localizedDescription);
 			}
-
-			localizedDescription->Release();
 		}
-
-		localizedName->Release();
 	}
 }
@@ -18,6 +18,7 @@
 #include "OrdinancePropertyHolder.h"
 #include "Logger.h"
 #include "StringResourceKey.h"
+#include <vector>
 
 // The base class for a custom ordinance.
 class OrdinanceBase : public cISC4Ordinance, protected cIGZSerializable
@@ -139,11 +140,10 @@ public:
 	/**
 	 * @brief Gets the monthly income/expense for this ordinance.
 	 * @return The monthly income/expense for this ordinance.
-	 * @remarks This method uses a default algorithm of
-	 * <monthly constent income> + (<city population> x <monthly income factor>).
-	 * This method can be overridden to use a custom algorithm.
+	 * @remarks The game calls this method many times per month, the value from
+	 * CalculateMonthlyIncome is reused until the simulation date changes.
 	*/
-	virtual int64_t GetCurrentMonthlyIncome(void);
+	int64_t GetCurrentMonthlyIncome(void) final;
 
 	/**
 	 * @brief Gets the unique ordinance ID.
@@ -231,12 +231,12 @@ public:
 	virtual int64_t GetMonthlyAdjustedIncome(void);
 
 	/**
-	 * @brief Defines the conditions that are required for the ordinance to become available.
+	 * @brief Determines whether the conditions that are required for the ordinance to become available are met.
 	 * @return True if the ordinance should become available in the menu; otherwise, false.
-	 * @remarks By default the only required condition is the starting year @see GetYearFirstAvailable.
-	 * This method can be overridden to provide custom conditions for the ordinance availability.
+	 * @remarks The game calls this method many times per month, the value from
+	 * EvaluateConditions is reused until the simulation date changes.
 	*/
-	virtual bool CheckConditions(void);
+	bool CheckConditions(void) final;
 
 	/**
 	 * @brief Gets a value indicating whether this ordinance generates income.
@@ -280,8 +280,67 @@ public:
 	*/
 	virtual bool PreCityShutdown(cISC4City* pCity);
 
+	/**
+	 * @brief Gets the strength that was last applied to the scaled effects.
+	 * @return A value between 0.0 (no effect) and 1.0 (the full effect values).
+	*/
+	float GetCurrentEffectStrength() const;
+
+	// The number of GetCurrentMonthlyIncome and CheckConditions calls that reused
+	// the value computed earlier on the same simulation date, and that computed it.
+	struct QueryCacheStatistics
+	{
+		uint64_t incomeHits;
+		uint64_t incomeMisses;
+		uint64_t conditionHits;
+		uint64_t conditionMisses;
+	};
+
+	const QueryCacheStatistics& GetQueryCacheStatistics() const;
+
 protected:
 
+	/**
+	 * @brief Calculates the monthly income/expense for this ordinance.
+	 * @return The monthly income/expense for this ordinance.
+	 * @remarks This method uses a default algorithm of
+	 * <monthly constent income> + (<city population> x <monthly income factor>).
+	 * This method can be overridden to use a custom algorithm.
+	*/
+	virtual int64_t CalculateMonthlyIncome();
+
+	/**
+	 * @brief Defines the conditions that are required for the ordinance to become available.
+	 * @return True if the ordinance should become available in the menu; otherwise, false.
+	 * @remarks By default the only required condition is the starting year @see GetYearFirstAvailable.
+	 * This method can be overridden to provide custom conditions for the ordinance availability.
+	*/
+	virtual bool EvaluateConditions();
+
+	/**
+	 * @brief Discards the values that GetCurrentMonthlyIncome and CheckConditions reuse.
+	 * @remarks Derived classes must call this method when a value that their
+	 * CalculateMonthlyIncome or EvaluateConditions implementation uses changes
+	 * during a simulation day.
+	*/
+	void InvalidateQueryCache();
+
+	/**
+	 * @brief Allows the strength of a Float32 effect to change during the game.
+	 * @param propertyID The ID of the effect property, its current value is the full-strength value.
+	 * @param neutralValue The value that has no effect, e.g. 1.0 for a demand multiplier.
+	 * @return True if the ordinance has the effect; otherwise, false.
+	*/
+	bool AddScaledEffect(uint32_t propertyID, float neutralValue);
+
+	/**
+	 * @brief Gets the strength of the scaled effects, this is called once per simulation month.
+	 * @return A value between 0.0 (no effect) and 1.0 (the full effect values).
+	 * @remarks The default implementation returns 1.0.
+	 * This method can be overridden to make the effects depend on the city.
+	*/
+	virtual float GetEffectStrength();
+
 	static bool ReadBool(cIGZIStream& stream, bool& value);
 	static bool WriteBool(cIGZOStream& stream, bool value);
 
@@ -292,8 +351,9 @@ protected:
 	Logger& logger;
 
 	uint32_t clsid;
-	cRZBaseString name;
-	cRZBaseString description;
+	// The name and description are stored in the InternedStringTable.
+	uint32_t nameID;
+	uint32_t descriptionID;
 	int64_t enactmentIncome;
 	int64_t retracmentIncome;
 	int64_t monthlyConstantIncome;
@@ -308,12 +368,39 @@ protected:
 
 private:
 
+	struct ScaledEffect
+	{
+		uint32_t propertyID;
+		float neutralValue;
+		float fullValue;
+		// The position of the property in miscProperties, which avoids a search on every update.
+		size_t propertyIndex;
+	};
+
+	// The GetCurrentMonthlyIncome and CheckConditions values, keyed by the simulation date
+	// that they were computed on.
+	struct QueryCache
+	{
+		int32_t incomeDate;
+		int64_t income;
+		int32_t conditionsDate;
+		bool conditions;
+	};
+
+	bool TryGetSimDateNumber(int32_t& dateNumber) const;
 	void LoadLocalizedStringResources();
+	void UpdateScaledEffects();
 
 	uint32_t refCount;
 	cISC4ResidentialSimulator* pResidentialSimulator;
 	cISC4Simulator* pSimulator;
 	StringResourceKey nameKey;
 	StringResourceKey descriptionKey;
+	std::vector<ScaledEffect> scaledEffects;
+	// The strength that the effect values in miscProperties were computed with, or a
+	// negative value if they must be written again.
+	float effectStrength;
+	QueryCache queryCache;
+	QueryCacheStatistics queryCacheStatistics;
 };
 
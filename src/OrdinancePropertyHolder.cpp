@@ -13,7 +13,10 @@
 #include "OrdinancePropertyHolder.h"
 #include "cIGZIStream.h"
 #include "cIGZOStream.h"
+#include "cRZBaseVariant.h"
 #include "Logger.h"
+#include "Platform.h"
+#include <algorithm>
 
 static constexpr uint32_t GZCLSID_OrdinancePropertyHolder = 0xd0f95c79;
 static constexpr uint32_t GZIID_OrdinancePropertyHolder = 0x84672560;
@@ -171,18 +174,18 @@ OrdinancePropertyHolder::OrdinancePropertyHolder()
 }
 
 OrdinancePropertyHolder::OrdinancePropertyHolder(const std::vector<cSCBaseProperty>& properties)
-	: refCount(0), properties(properties)
+	: refCount(0), properties(properties), curves()
 {
 }
 
 OrdinancePropertyHolder::OrdinancePropertyHolder(const OrdinancePropertyHolder& other)
-	: refCount(0), properties(other.properties)
+	: refCount(0), properties(other.properties), curves(other.curves)
 {
 
 }
 
 OrdinancePropertyHolder::OrdinancePropertyHolder(OrdinancePropertyHolder&& other) noexcept
-	: refCount(0), properties(std::move(other.properties))
+	: refCount(0), properties(std::move(other.properties)), curves(std::move(other.curves))
 {
 }
 
@@ -198,6 +201,7 @@ OrdinancePropertyHolder& OrdinancePropertyHolder::operator=(const OrdinancePrope
 	}
 
 	properties = other.properties;
+	curves = other.curves;
 
 	return *this;
 }
@@ -210,6 +214,7 @@ OrdinancePropertyHolder& OrdinancePropertyHolder::operator=(OrdinancePropertyHol
 	}
 
 	properties = std::move(other.properties);
+	curves = std::move(other.curves);
 
 	return *this;
 }
@@ -285,7 +290,7 @@ bool OrdinancePropertyHolder::GetPropertyList(cIGZUnknownList** ppList)
 
 cISCProperty* OrdinancePropertyHolder::GetProperty(uint32_t dwProperty)
 {
-	LogPropertyId(__FUNCSIG__, dwProperty);
+	LogPropertyId(PLATFORM_FUNCSIG, dwProperty);
 
 	for (auto& property : properties)
 	{
@@ -303,7 +308,7 @@ cISCProperty* OrdinancePropertyHolder::GetProperty(uint32_t dwProperty)
 
 bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, uint32_t& dwValueOut)
 {
-	LogPropertyId(__FUNCSIG__, dwProperty);
+	LogPropertyId(PLATFORM_FUNCSIG, dwProperty);
 
 	bool result = false;
 
@@ -323,21 +328,21 @@ bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, uint32_t& dwValue
 
 bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, cIGZString& szValueOut)
 {
-	LogPropertyId(__FUNCSIG__, dwProperty);
+	LogPropertyId(PLATFORM_FUNCSIG, dwProperty);
 
 	return false;
 }
 
 bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, uint32_t riid, void** ppvObj)
 {
-	LogPropertyId(__FUNCSIG__, dwProperty);
+	LogPropertyId(PLATFORM_FUNCSIG, dwProperty);
 
 	return false;
 }
 
 bool OrdinancePropertyHolder::GetProperty(uint32_t dwProperty, void* pUnknown, uint32_t& dwUnknownOut)
 {
-	LogPropertyId(__FUNCSIG__, dwProperty);
+	LogPropertyId(PLATFORM_FUNCSIG, dwProperty);
 
 	return false;
 }
@@ -387,6 +392,120 @@ bool OrdinancePropertyHolder::AddProperty(uint32_t dwProperty, float value)
 	return true;
 }
 
+bool OrdinancePropertyHolder::GetFloatValue(uint32_t dwProperty, float& value) const
+{
+	for (const auto& property : properties)
+	{
+		if (property.GetPropertyID() == dwProperty)
+		{
+			return property.GetPropertyValue()->GetValFloat32(value);
+		}
+	}
+
+	return false;
+}
+
+bool OrdinancePropertyHolder::SetFloatValue(uint32_t dwProperty, float value, size_t& indexHint)
+{
+	if (indexHint >= properties.size() || properties[indexHint].GetPropertyID() != dwProperty)
+	{
+		indexHint = properties.size();
+
+		for (size_t i = 0; i < properties.size(); i++)
+		{
+			if (properties[i].GetPropertyID() == dwProperty)
+			{
+				indexHint = i;
+				break;
+			}
+		}
+
+		if (indexHint == properties.size())
+		{
+			return false;
+		}
+	}
+
+	cIGZVariant* pVariant = properties[indexHint].GetPropertyValue();
+
+	if (pVariant->GetType() != cIGZVariant::Type::Float32)
+	{
+		return false;
+	}
+
+	pVariant->SetValFloat32(value);
+	return true;
+}
+
+bool OrdinancePropertyHolder::AddCurveProperty(uint32_t dwProperty, const float* controlPoints, uint32_t pointCount)
+{
+	ResponseCurve curve;
+
+	if (!curve.SetControlPoints(controlPoints, pointCount))
+	{
+		return false;
+	}
+
+	cRZBaseVariant variant;
+	variant.RefFloat32(const_cast<float*>(controlPoints), pointCount * 2);
+
+	properties.push_back(cSCBaseProperty(dwProperty, variant));
+	curves.push_back(CurveProperty{ dwProperty, std::move(curve) });
+
+	return true;
+}
+
+const ResponseCurve* OrdinancePropertyHolder::GetCurve(uint32_t dwProperty) const
+{
+	for (const CurveProperty& item : curves)
+	{
+		if (item.propertyID == dwProperty)
+		{
+			return &item.curve;
+		}
+	}
+
+	return nullptr;
+}
+
+bool OrdinancePropertyHolder::RebuildCurve(uint32_t dwProperty)
+{
+	for (const auto& property : properties)
+	{
+		if (property.GetPropertyID() == dwProperty)
+		{
+			const cIGZVariant* pVariant = property.GetPropertyValue();
+
+			if (pVariant->GetType() != cIGZVariant::Type::Float32Array || (pVariant->GetCount() % 2) != 0)
+			{
+				return false;
+			}
+
+			ResponseCurve curve;
+
+			if (!curve.SetControlPoints(pVariant->RefFloat32(), pVariant->GetCount() / 2))
+			{
+				return false;
+			}
+
+			curves.push_back(CurveProperty{ dwProperty, std::move(curve) });
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void OrdinancePropertyHolder::RemoveCurve(uint32_t dwProperty)
+{
+	curves.erase(
+		std::remove_if(
+			curves.begin(),
+			curves.end(),
+			[dwProperty](const CurveProperty& item) { return item.propertyID == dwProperty; }),
+		curves.end());
+}
+
 bool OrdinancePropertyHolder::CopyAddProperty(cISCProperty* pProperty, bool bUnknown)
 {
 	return false;
@@ -394,11 +513,12 @@ bool OrdinancePropertyHolder::CopyAddProperty(cISCProperty* pProperty, bool bUnk
 
 bool OrdinancePropertyHolder::RemoveProperty(uint32_t dwProperty)
 {
-	for (std::vector<cSCBaseProperty>::iterator it = properties.begin(); it != properties.end();)
+	for (std::vector<cSCBaseProperty>::iterator it = properties.begin(); it != properties.end(); ++it)
 	{
 		if (it->GetPropertyID() == dwProperty)
 		{
 			properties.erase(it);
+			RemoveCurve(dwProperty);
 			return true;
 		}
 	}
@@ -409,6 +529,7 @@ bool OrdinancePropertyHolder::RemoveProperty(uint32_t dwProperty)
 bool OrdinancePropertyHolder::RemoveAllProperties(void)
 {
 	properties.clear();
+	curves.clear();
 	return true;
 }
 
@@ -443,7 +564,9 @@ bool OrdinancePropertyHolder::Write(cIGZOStream& stream)
 		return false;
 	}
 
-	const uint32_t version = 1;
+	// Version 2 adds the list of curve properties, a holder without curves is written
+	// as version 1 so that older plugin versions can still read it.
+	const uint32_t version = curves.empty() ? 1 : 2;
 	const uint32_t propertyCount = static_cast<uint32_t>(properties.size());
 
 	if (!stream.SetUint32(version) || !stream.SetUint32(propertyCount))
@@ -459,6 +582,24 @@ bool OrdinancePropertyHolder::Write(cIGZOStream& stream)
 		}
 	}
 
+	if (version >= 2)
+	{
+		// Only the IDs are written, the control points are stored in the properties
+		// and the lookup tables are rebuilt when the holder is read.
+		if (!stream.SetUint32(static_cast<uint32_t>(curves.size())))
+		{
+			return false;
+		}
+
+		for (const CurveProperty& item : curves)
+		{
+			if (!stream.SetUint32(item.propertyID))
+			{
+				return false;
+			}
+		}
+	}
+
 	return true;
 }
 
@@ -470,7 +611,7 @@ bool OrdinancePropertyHolder::Read(cIGZIStream& stream)
 	}
 
 	uint32_t version = 0;
-	if (!stream.GetUint32(version) || version != 1)
+	if (!stream.GetUint32(version) || version < 1 || version > 2)
 	{
 		return false;
 	}
@@ -482,6 +623,7 @@ bool OrdinancePropertyHolder::Read(cIGZIStream& stream)
 	}
 
 	properties.clear();
+	curves.clear();
 
 	for (uint32_t i = 0; i < propertyCount; i++)
 	{
@@ -495,6 +637,25 @@ bool OrdinancePropertyHolder::Read(cIGZIStream& stream)
 		properties.push_back(prop);
 	}
 
+	if (version >= 2)
+	{
+		uint32_t curveCount = 0;
+		if (!stream.GetUint32(curveCount) || curveCount > propertyCount)
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < curveCount; i++)
+		{
+			uint32_t propertyID = 0;
+
+			if (!stream.GetUint32(propertyID) || !RebuildCurve(propertyID))
+			{
+				return false;
+			}
+		}
+	}
+
 	return true;
 }
 
@@ -14,6 +14,8 @@
 #include "cISCPropertyHolder.h"
 #include "cIGZSerializable.h"
 #include "cSCBaseProperty.h"
+#include "ResponseCurve.h"
+#include <stddef.h>
 #include <vector>
 
 class OrdinancePropertyHolder : public cISCPropertyHolder, cIGZSerializable
@@ -53,6 +55,33 @@ public:
 	virtual bool AddProperty(uint32_t dwProperty, void* pUnknown, uint32_t dwUnknown, bool bUnknown);
 	virtual bool AddProperty(uint32_t dwProperty, float value); // Not part of the SC4 API, but a convenience method.
 
+	// Not part of the SC4 API: gets the value of a Float32 property without logging the call.
+	bool GetFloatValue(uint32_t dwProperty, float& value) const;
+
+	/**
+	 * @brief Not part of the SC4 API: changes the value of an existing Float32 property in place.
+	 * The property variant is reused, so the call does not allocate.
+	 * @param dwProperty The property ID.
+	 * @param value The new value.
+	 * @param indexHint The index of the property from the previous call, it is updated if the property moved.
+	 * @return True if the property was found; otherwise, false.
+	 */
+	bool SetFloatValue(uint32_t dwProperty, float value, size_t& indexHint);
+
+	/**
+	 * @brief Not part of the SC4 API: adds a general response curve effect.
+	 * The property is a Float32 array of the control points, the holder also keeps a
+	 * lookup table of the curve that is returned by GetCurve.
+	 * @param dwProperty The property ID.
+	 * @param controlPoints The x and y value of each control point, the x values must be in ascending order.
+	 * @param pointCount The number of control points.
+	 * @return True on success; otherwise, false.
+	 */
+	bool AddCurveProperty(uint32_t dwProperty, const float* controlPoints, uint32_t pointCount);
+
+	// Not part of the SC4 API: gets the lookup table of a curve property, or null if the holder does not contain the curve.
+	const ResponseCurve* GetCurve(uint32_t dwProperty) const;
+
 	virtual bool CopyAddProperty(cISCProperty* pProperty, bool bUnknown);
 
 	virtual bool RemoveProperty(uint32_t dwProperty);
@@ -68,8 +97,19 @@ public:
 	uint32_t GetGZCLSID();
 
 private:
-	
+
+	struct CurveProperty
+	{
+		uint32_t propertyID;
+		ResponseCurve curve;
+	};
+
+	bool RebuildCurve(uint32_t dwProperty);
+	void RemoveCurve(uint32_t dwProperty);
+
 	uint32_t refCount;
 	std::vector<cSCBaseProperty> properties;
+	// The lookup tables of the curve properties, they are rebuilt from the control points after a Read.
+	std::vector<CurveProperty> curves;
 };
 
@@ -0,0 +1,256 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "OrdinanceStateReader.h"
+#include "cIGZVariant.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+
+namespace
+{
+	// The version that OrdinanceBase::Write uses.
+	constexpr uint32_t OrdinanceVersion = 1;
+	// Ordinance names and descriptions are short, longer strings indicate that
+	// the candidate is not an ordinance state.
+	constexpr uint32_t MaxStringLength = 4096;
+	constexpr uint32_t MaxPropertyCount = 1024;
+	constexpr uint32_t MaxValueCount = 65536;
+
+	class ByteReader
+	{
+	public:
+
+		ByteReader(const uint8_t* data, size_t size) : data(data), size(size), position(0)
+		{
+		}
+
+		size_t GetPosition() const
+		{
+			return position;
+		}
+
+		template<typename T> bool Read(T& value)
+		{
+			if (size - position < sizeof(T))
+			{
+				return false;
+			}
+
+			std::memcpy(&value, data + position, sizeof(T));
+			position += sizeof(T);
+			return true;
+		}
+
+		bool ReadBool(bool& value)
+		{
+			uint8_t temp = 0;
+
+			if (!Read(temp))
+			{
+				return false;
+			}
+
+			value = temp != 0;
+			return true;
+		}
+
+		bool ReadString(std::string& value)
+		{
+			uint32_t length = 0;
+
+			if (!Read(length) || length > MaxStringLength || size - position < length)
+			{
+				return false;
+			}
+
+			value.assign(reinterpret_cast<const char*>(data + position), length);
+			position += length;
+			return true;
+		}
+
+	private:
+
+		const uint8_t* data;
+		size_t size;
+		size_t position;
+	};
+
+	template<typename T> bool ReadValues(ByteReader& reader, uint32_t count, std::vector<double>& values)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			T value{};
+
+			if (!reader.Read(value))
+			{
+				return false;
+			}
+
+			values.push_back(static_cast<double>(value));
+		}
+
+		return true;
+	}
+
+	bool ReadVariant(ByteReader& reader, uint16_t& type, std::vector<double>& values)
+	{
+		uint32_t count = 0;
+
+		if (!reader.Read(type) || !reader.Read(count) || count > MaxValueCount)
+		{
+			return false;
+		}
+
+		if ((type & cIGZVariant::TypeArray) == 0)
+		{
+			// The count of a scalar value is ignored.
+			count = 1;
+		}
+
+		values.clear();
+		values.reserve(count);
+
+		switch (type & ~cIGZVariant::TypeArray)
+		{
+		case cIGZVariant::Type::Bool:
+		case cIGZVariant::Type::Uint8:
+		case cIGZVariant::Type::Char:
+		case cIGZVariant::Type::RZChar:
+			return ReadValues<uint8_t>(reader, count, values);
+		case cIGZVariant::Type::Sint8:
+			return ReadValues<int8_t>(reader, count, values);
+		case cIGZVariant::Type::Uint16:
+		case cIGZVariant::Type::RZUnicodeChar:
+			return ReadValues<uint16_t>(reader, count, values);
+		case cIGZVariant::Type::Sint16:
+			return ReadValues<int16_t>(reader, count, values);
+		case cIGZVariant::Type::Uint32:
+			return ReadValues<uint32_t>(reader, count, values);
+		case cIGZVariant::Type::Sint32:
+			return ReadValues<int32_t>(reader, count, values);
+		case cIGZVariant::Type::Uint64:
+			return ReadValues<uint64_t>(reader, count, values);
+		case cIGZVariant::Type::Sint64:
+			return ReadValues<int64_t>(reader, count, values);
+		case cIGZVariant::Type::Float32:
+			return ReadValues<float>(reader, count, values);
+		case cIGZVariant::Type::Float64:
+			return ReadValues<double>(reader, count, values);
+		default:
+			return false;
+		}
+	}
+
+	bool ReadPropertyHolder(ByteReader& reader, OrdinanceStateReader::OrdinanceState& state)
+	{
+		uint32_t propertyCount = 0;
+
+		if (!reader.Read(state.propertyHolderVersion)
+			|| state.propertyHolderVersion < 1
+			|| state.propertyHolderVersion > 2
+			|| !reader.Read(propertyCount)
+			|| propertyCount > MaxPropertyCount)
+		{
+			return false;
+		}
+
+		state.effects.resize(propertyCount);
+
+		for (OrdinanceStateReader::Effect& effect : state.effects)
+		{
+			if (!reader.Read(effect.propertyID) || !ReadVariant(reader, effect.type, effect.values))
+			{
+				return false;
+			}
+		}
+
+		state.curvePropertyIDs.clear();
+
+		if (state.propertyHolderVersion >= 2)
+		{
+			uint32_t curveCount = 0;
+
+			if (!reader.Read(curveCount) || curveCount > propertyCount)
+			{
+				return false;
+			}
+
+			state.curvePropertyIDs.resize(curveCount);
+
+			for (uint32_t& propertyID : state.curvePropertyIDs)
+			{
+				if (!reader.Read(propertyID))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+}
+
+bool OrdinanceStateReader::Find(const uint8_t* data, size_t size, uint32_t clsid, size_t& offset)
+{
+	if (offset >= size)
+	{
+		return false;
+	}
+
+	std::array<uint8_t, 8> pattern{};
+	std::memcpy(pattern.data(), &OrdinanceVersion, sizeof(OrdinanceVersion));
+	std::memcpy(pattern.data() + 4, &clsid, sizeof(clsid));
+
+	const std::boyer_moore_horspool_searcher searcher(pattern.begin(), pattern.end());
+	const uint8_t* const end = data + size;
+	const uint8_t* match = std::search(data + offset, end, searcher);
+
+	if (match == end)
+	{
+		return false;
+	}
+
+	offset = static_cast<size_t>(match - data);
+	return true;
+}
+
+bool OrdinanceStateReader::Read(const uint8_t* data, size_t size, OrdinanceState& state, size_t& bytesRead)
+{
+	ByteReader reader(data, size);
+
+	// OrdinanceBase::Write stores the retracment income twice.
+	if (!reader.Read(state.version)
+		|| state.version != OrdinanceVersion
+		|| !reader.Read(state.clsid)
+		|| !reader.ReadString(state.name)
+		|| !reader.ReadString(state.description)
+		|| !reader.Read(state.enactmentIncome)
+		|| !reader.Read(state.retracmentIncome)
+		|| !reader.Read(state.retracmentIncome)
+		|| !reader.Read(state.monthlyConstantIncome)
+		|| !reader.Read(state.monthlyAdjustedIncome)
+		|| !reader.Read(state.monthlyIncomeFactor)
+		|| !reader.ReadBool(state.isIncomeOrdinance)
+		|| !ReadPropertyHolder(reader, state)
+		|| !reader.ReadBool(state.initialized)
+		|| !reader.ReadBool(state.available)
+		|| !reader.ReadBool(state.on)
+		|| !reader.ReadBool(state.enabled))
+	{
+		return false;
+	}
+
+	bytesRead = reader.GetPosition();
+	return true;
+}
@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Decodes the state that OrdinanceBase::Write stores in a save game, without the game.
+//
+// The reader works on a byte range, e.g. an entry of a memory-mapped save file, and follows
+// the layout of OrdinanceBase::Write and OrdinancePropertyHolder::Write. The property values
+// are read using the variant layout of the DB segment streams: the type as a uint16, the element
+// count as a uint32 and the little-endian values.
+namespace OrdinanceStateReader
+{
+	struct Effect
+	{
+		uint32_t propertyID;
+		// The cIGZVariant type of the property value.
+		uint16_t type;
+		std::vector<double> values;
+	};
+
+	struct OrdinanceState
+	{
+		uint32_t version;
+		uint32_t clsid;
+		std::string name;
+		std::string description;
+		int64_t enactmentIncome;
+		int64_t retracmentIncome;
+		int64_t monthlyConstantIncome;
+		int64_t monthlyAdjustedIncome;
+		float monthlyIncomeFactor;
+		bool isIncomeOrdinance;
+		uint32_t propertyHolderVersion;
+		std::vector<Effect> effects;
+		// The effects that use a response curve, the control points are stored in the effect values.
+		std::vector<uint32_t> curvePropertyIDs;
+		bool initialized;
+		bool available;
+		bool on;
+		bool enabled;
+	};
+
+	/**
+	 * @brief Finds the start of the serialized state of an ordinance class.
+	 * @param data The data to search.
+	 * @param size The size of the data.
+	 * @param clsid The class ID of the ordinance.
+	 * @param offset The offset to start searching at, receives the offset of the state.
+	 * @return True if a candidate was found; otherwise, false.
+	 * Candidates are only matched on the version and class ID, use Read to validate them.
+	 */
+	bool Find(const uint8_t* data, size_t size, uint32_t clsid, size_t& offset);
+
+	/**
+	 * @brief Decodes the serialized ordinance state.
+	 * @param data The start of the serialized state.
+	 * @param size The number of bytes that are available.
+	 * @param state Receives the decoded state.
+	 * @param bytesRead Receives the size of the serialized state.
+	 * @return True on success; otherwise, false if the data is not a supported ordinance state.
+	 */
+	bool Read(const uint8_t* data, size_t size, OrdinanceState& state, size_t& bytesRead);
+}
@@ -11,23 +11,39 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "ParknRideOrdinance.h"
-#include "Stopwatch.h"
+#include "CongestionMonitor.h"
+#include "MetricsRecorder.h"
+#include "RidershipMeter.h"
+#include "TrafficSimulatorTuning.h"
 #include "cISC4City.h"
-#include "cISC4Simulator.h"
-#include "cISC4TrafficSimulator.h"
-#include "cGZPersistResourceKey.h"
-#include "cIGZMessageServer.h"
-#include "cIGZMessageServer2.h"
-#include "cIGZPersistResourceManager.h"
-#include "GZServPtrs.h"
-#include "cRZMessage2Standard.h"
-
-// The unique ID that identifies this ordinance.
-// The value must never be reused, when creating a new ordinance generate a random 32-bit integer and use that.
-static constexpr uint32_t kParknRideOrdinanceCLSID = 0x479bf2c7;
+#include <algorithm>
 
 namespace
 {
+	// The share of the transit switch capacity that must be used for the full ridership effect.
+	constexpr double kFullStrengthTransitUtilization = 0.5;
+	// The congestion reduction, relative to the last month without the car restriction,
+	// that gives the full congestion relief effect.
+	constexpr double kFullStrengthCongestionRelief = 0.25;
+
+	// The demand and air effects that are multipliers, their neutral value is 1.0.
+	constexpr uint32_t kScaledMultiplierEffects[] =
+	{
+		0x2a633000,
+		0x2a653110,
+		0x2a653120,
+		0x2a653130,
+		0x2a653320,
+		0x2a653330,
+		0x08f79b8e,
+		0x2a654100,
+		0x2a654200,
+		0x2a654300,
+	};
+
+	// Health Quotient Boost Effect, a percentage with a neutral value of 100.
+	constexpr uint32_t kHealthQuotientBoostEffect = 0xe91b3aee;
+
 	OrdinancePropertyHolder CreateOrdinanceEffects()
 	{
 		OrdinancePropertyHolder properties;
@@ -62,66 +78,6 @@ namespace
 
 		return properties;
 	}
-
-	void RunMessageServerPump(int maxIterations, int maxTimeInMilliseconds)
-	{
-		cIGZMessageServerPtr pMsgServ;
-
-		if (pMsgServ)
-		{
-			Stopwatch timer;
-			timer.Start();
-
-			for (int i = 0; i < maxIterations; i++)
-			{
-				int queueSize = pMsgServ->GetMessageQueueSize();
-
-				if (queueSize == 0)
-				{
-					break;
-				}
-
-				pMsgServ->OnTick(0);
-
-				int64_t elapsedMilliseconds = timer.ElapsedMilliseconds();
-
-				if (elapsedMilliseconds > maxTimeInMilliseconds)
-				{
-					break;
-				}
-			}
-		}
-	}
-
-	void RunMessageServer2Pump(int maxIterations, int maxTimeInMilliseconds)
-	{
-		cIGZMessageServer2Ptr pMsgServ;
-
-		if (pMsgServ)
-		{
-			Stopwatch timer;
-			timer.Start();
-
-			for (int i = 0; i < maxIterations; i++)
-			{
-				int queueSize = pMsgServ->GetMessageQueueSize();
-
-				if (queueSize == 0)
-				{
-					break;
-				}
-
-				pMsgServ->OnTick(0);
-
-				int64_t elapsedMilliseconds = timer.ElapsedMilliseconds();
-
-				if (elapsedMilliseconds > maxTimeInMilliseconds)
-				{
-					break;
-				}
-			}
-		}
-	}
 }
 
 ParknRideOrdinance::ParknRideOrdinance()
@@ -137,8 +93,33 @@ ParknRideOrdinance::ParknRideOrdinance()
 		/* monthly income factor */   0.0f,
 		/* income ordinance */		  false,
 	    CreateOrdinanceEffects()),
-	  pCity(nullptr)
+	  pCity(nullptr),
+	  pTuningCoordinator(nullptr),
+	  participantID(0),
+	  pMetricsRecorder(nullptr),
+	  impactReporter(),
+	  experimentScheduler(),
+	  experimentToggleTimed(false),
+	  autoMode(false),
+	  congestionRestrictionActive(false),
+	  rushHourMode(false),
+	  rushHourRestrictionActive(false),
+	  pEffectsRidershipMeter(nullptr),
+	  pEffectsCongestionMonitor(nullptr),
+	  transitUtilization(0.0),
+	  averageCongestion(0.0),
+	  baselineCongestion(-1.0),
+	  pRidershipMeter(nullptr),
+	  ridershipCostPerThousandTrips(0),
+	  ridershipMaxMonthlyCost(0),
+	  precompiledTuningOverride(false)
 {
+	for (uint32_t propertyID : kScaledMultiplierEffects)
+	{
+		AddScaledEffect(propertyID, 1.0f);
+	}
+
+	AddScaledEffect(kHealthQuotientBoostEffect, 100.0f);
 }
 
 void ParknRideOrdinance::UpdateCarCanReachDestination(bool calledFromPostCityInit) const
@@ -151,259 +132,295 @@ void ParknRideOrdinance::UpdateCarCanReachDestination(bool calledFromPostCityIni
 		return;
 	}
 
-	cISC4SimulatorPtr pSimulator;
+	// Restarting the traffic simulator in PostCityInit crashes the game, so we make
+	// it reload its tunable values instead.
+	QueueCarCanReachDestination(calledFromPostCityInit
+		? TrafficSimulatorUpdateMode::ReloadTunables
+		: TrafficSimulatorUpdateMode::Restart);
+}
+
+void ParknRideOrdinance::SetTuningCoordinator(cITrafficTuningCoordinator* pCoordinator, uint32_t participantID)
+{
+	pTuningCoordinator = pCoordinator;
+	this->participantID = participantID;
+}
+
+void ParknRideOrdinance::SetMetricsRecorder(MetricsRecorder* pRecorder)
+{
+	pMetricsRecorder = pRecorder;
+}
+
+void ParknRideOrdinance::SetImpactReportMonths(uint32_t months)
+{
+	impactReporter.SetReportMonths(months);
+}
+
+const ImpactReporter& ParknRideOrdinance::GetImpactReporter() const
+{
+	return impactReporter;
+}
 
-	if (!pSimulator)
+void ParknRideOrdinance::SetExperimentSchedule(uint32_t periodMonths, uint32_t washoutMonths)
+{
+	experimentScheduler.Configure(periodMonths, washoutMonths);
+}
+
+const ExperimentScheduler& ParknRideOrdinance::GetExperimentScheduler() const
+{
+	return experimentScheduler;
+}
+
+void ParknRideOrdinance::SetAutoMode(bool enabled)
+{
+	autoMode = enabled;
+}
+
+bool ParknRideOrdinance::IsCongestionRestrictionActive() const
+{
+	return congestionRestrictionActive;
+}
+
+void ParknRideOrdinance::SetCongestionRestrictionActive(bool active)
+{
+	const bool oldRestrictionActive = IsCarRestrictionActive();
+
+	congestionRestrictionActive = active;
+
+	if (oldRestrictionActive != IsCarRestrictionActive())
+	{
+		UpdateCarCanReachDestination(/*calledFromPostCityInit*/false);
+	}
+}
+
+void ParknRideOrdinance::SetRushHourMode(bool enabled)
+{
+	rushHourMode = enabled;
+}
+
+bool ParknRideOrdinance::IsRushHourRestrictionActive() const
+{
+	return rushHourRestrictionActive;
+}
+
+bool ParknRideOrdinance::SetRushHourRestrictionActive(bool active)
+{
+	const bool oldRestrictionActive = IsCarRestrictionActive();
+
+	rushHourRestrictionActive = active;
+
+	if (!initialized || !pTuningCoordinator || oldRestrictionActive == IsCarRestrictionActive())
+	{
+		return false;
+	}
+
+	// The ordinance switches several times per in-game day, so only the tunable values are
+	// reloaded and the game is not paused. The edit is applied immediately, which allows the
+	// scheduler to measure its cost.
+	QueueCarCanReachDestination(TrafficSimulatorUpdateMode::ReloadTunables);
+
+	return pTuningCoordinator->Flush(/*pauseGame*/false);
+}
+
+bool ParknRideOrdinance::IsCarRestrictionActive() const
+{
+	if (precompiledTuningOverride)
+	{
+		return true;
+	}
+
+	return on
+		&& (!autoMode || congestionRestrictionActive)
+		&& (!rushHourMode || rushHourRestrictionActive);
+}
+
+void ParknRideOrdinance::QueueCarCanReachDestination(TrafficSimulatorUpdateMode updateMode) const
+{
+	if (precompiledTuningOverride)
 	{
-		logger.WriteLine(LogOptions::Errors, "The cISC4Simulator pointer was null.");
 		return;
 	}
 
-	// Pause the game before making any changes to the traffic simulator tuning exemplar.
-	// This should prevent the issues caused by having the traffic simulator reload its
-	// tuning exemplar while the simulation is running.
-	if (!pSimulator->HiddenPause())
+	if (!pTuningCoordinator)
 	{
-		logger.WriteLine(LogOptions::Errors, "Failed to pause the game.");
+		logger.WriteLine(LogOptions::Errors, "The traffic tuning coordinator pointer was null.");
 		return;
 	}
 
-	constexpr int maxIterations = 500;
-	constexpr int maxTimeInMilliseconds = 5000;
+	const bool carCanReachDestination = !IsCarRestrictionActive();
 
-	// Process messages for a few seconds, this allows the pause
-	// message subscribers time to process to the message.
-	RunMessageServerPump(maxIterations, maxTimeInMilliseconds);
-	RunMessageServer2Pump(maxIterations, maxTimeInMilliseconds);
+	// The coordinator applies the edits from all of the participating plugins
+	// at the end of the frame, and restarts or reloads the traffic simulator once.
+	pTuningCoordinator->QueueBoolArrayEdit(
+		participantID,
+		TrafficSimulatorTuning::kTravelTypeCanReachDestination,
+		TrafficSimulatorTuning::kCarTravelTypeIndex,
+		carCanReachDestination,
+		updateMode);
+}
 
-	const bool carCanReachDestination = !on;
+bool ParknRideOrdinance::RequestExperimentToggleTime()
+{
+	bool result = false;
 
-	cIGZPersistResourceManagerPtr pResourceManager;
-	if (pResourceManager)
+	// The coordinator from an older version of another plugin may not report the batch times,
+	// the toggle is not timed in that case.
+	cITrafficTuningCoordinatorTiming* pTiming = nullptr;
+
+	if (pTuningCoordinator && pTuningCoordinator->QueryInterface(
+		GZIID_cITrafficTuningCoordinatorTiming,
+		reinterpret_cast<void**>(&pTiming)))
 	{
-		constexpr uint32_t kTravelTypeCanReachDestination = 0xA92356B5;
+		result = pTiming->RequestBatchTime(participantID);
+		pTiming->Release();
+	}
 
-		// The resource key is set to the TGI of the traffic simulator tuning exemplar.
-		cGZPersistResourceKey key(0x6534284a, 0xe7e2c2db, 0xc9133286);
-		cISCPropertyHolder* propertyHolder = nullptr;
-		bool valueChanged = false;
+	return result;
+}
 
-		// Load the traffic simulator tuning exemplar.
-		// The game will temporarily cache the loaded exemplar, which allows us
-		// to modify the in-memory copy.
+void ParknRideOrdinance::RecordExperimentToggleTime()
+{
+	cITrafficTuningCoordinatorTiming* pTiming = nullptr;
 
-		bool result = pResourceManager->GetResource(
-			key,
-			GZIID_cISCPropertyHolder,
-			reinterpret_cast<void**>(&propertyHolder),
-			0,
-			nullptr);
+	if (pTuningCoordinator && pTuningCoordinator->QueryInterface(
+		GZIID_cITrafficTuningCoordinatorTiming,
+		reinterpret_cast<void**>(&pTiming)))
+	{
+		int64_t elapsedMicroseconds = 0;
 
-		if (result)
-		{
-			cISCProperty* property = propertyHolder->GetProperty(kTravelTypeCanReachDestination);
-
-			if (property)
-			{
-				cIGZVariant* data = property->GetPropertyValue();
-
-				if (data)
-				{
-					uint16_t type = data->GetType();
-					uint32_t count = data->GetCount();
-
-					if (type == cIGZVariant::Type::BoolArray && count == 9)
-					{
-						bool* values = data->RefBool();
-
-						// Update the "Travel type can reach destination" value for cars.
-						// The property order is walk, car, bus...
-						if (values[1] != carCanReachDestination)
-						{
-							logger.WriteLineFormatted(
-								LogOptions::Info,
-								"Setting 'Travel type can reach destination' value for cars to %s.",
-								carCanReachDestination ? "true" : "false");
-
-							values[1] = carCanReachDestination;
-							valueChanged = true;
-						}
-					}
-					else
-					{
-						logger.WriteLineFormatted(
-							LogOptions::Errors,
-							"The 'Travel type can reach destination' property data has an unexpected type and/or count"
-							", type=0x04x, count=%u. Expected type=0x8001 and count=9.",
-							type,
-							count);
-					}
-				}
-				else
-				{
-					logger.WriteLine(LogOptions::Errors, "The 'Travel type can reach destination' property data was null.");
-				}
-			}
-			else
-			{
-				logger.WriteLine(LogOptions::Errors, "The 'Travel type can reach destination' property does not exist.");
-			}
-
-			propertyHolder->Release();
-			propertyHolder = nullptr;
-		}
-		else
+		if (pTiming->GetBatchTime(participantID, elapsedMicroseconds))
 		{
-			logger.WriteLine(LogOptions::Errors, "Failed to load the traffic simulator tuning exemplar.");
+			experimentScheduler.RecordToggle(elapsedMicroseconds);
+			experimentToggleTimed = false;
 		}
 
-		if (valueChanged)
-		{
-			// If we modified the in-memory copy of the traffic simulator tuning exemplar
-			// we first shutdown and restart the traffic simulator.
-			// After that message is sent we verify that the in-memory modifications are
-			// still present.
-
-			if (pCity)
-			{
-				cISC4TrafficSimulator* pTrafficSim = pCity->GetTrafficSimulator();
-
-				if (pTrafficSim)
-				{
-					// We bypass the game's messaging system and dispatch our messages directly to the
-					// target method in the traffic simulator.
-					// This is required to restart the traffic simulator in-game because it needs to receive
-					// a PostCityInit message after being restarted, and broadcasting that message to the
-					// other game systems would probably cause more issues.
-					cIGZMessageTarget2* target = static_cast<cIGZMessageTarget2*>(pTrafficSim);
-					cRZMessage2Standard message;
-
-					if (calledFromPostCityInit)
-					{
-						// If we are being called from the DLL's PostCityInit message we send a message
-						// to the traffic simulator that makes it reload its tunable values.
-						// Restarting the traffic simulator in PostCityInit crashes the game.
-						//
-						// A number of the games's simulators support a message that forces
-						// them to reload their tunable values.
-						// The message takes 2 integer parameters that identify the intended
-						// target. These values appear to be the group and instance IDs of
-						// the simulator's tuning exemplar.
-						//
-						// This feature was likely used during SC4's development to allow
-						// the tuning values to be applied after they were modified in the
-						// in-game editor.
-
-						constexpr uint32_t kSC4MessageReloadTunableValues = 0xC53D10AA;
-						constexpr uint32_t trafficSimData1 = 0xE7E2C2DB;
-						constexpr uint32_t trafficSimData2 = 0xC9133286;
-
-						logger.WriteLine(
-							LogOptions::Info,
-							"Sending the updated 'Travel type can reach destination' value to the traffic simulator.");
-
-						message.SetType(kSC4MessageReloadTunableValues);
-						message.SetData1(trafficSimData1);
-						message.SetData2(trafficSimData2);
-					}
-					else
-					{
-						// If the user changed the ordinance state in-game we shutdown and restart the traffic simulator.
-						// We send it a PostCityInit message to make it compete the setup it performs when loading a city.
-
-						logger.WriteLine(
-							LogOptions::Info,
-							"Restarting the traffic simulator for the 'Travel type can reach destination' value change.");
-
-						pTrafficSim->Shutdown();
-						pTrafficSim->Init();
-
-						// Dispatch a PostCityInit message directly to the traffic simulator.
-						// This is required for it to reinitialize its data after we restarted it.
-						constexpr uint32_t kSC4MessagePostCityInit = 0x26D31EC1;
-
-						message.SetType(kSC4MessagePostCityInit);
-						message.SetVoid1(pCity); // The first parameter is always a pointer to the city.
-						message.SetIGZUnknown(pCity);
-						message.SetData2(1); // This parameter is always 1 for a city that has been loaded.
-						message.SetData3(0); // This parameter is always 0.
-					}
-
-					target->DoMessage(static_cast<cIGZMessage2*>(static_cast<cIGZMessage2Standard*>(&message)));
-				}
-				else
-				{
-					logger.WriteLine(
-						LogOptions::Errors,
-						"The traffic simulator pointer was null.");
-				}
-			}
-			else
-			{
-				logger.WriteLine(
-					LogOptions::Errors,
-					"The city pointer was null.");
-			}
-
-			// Verify that are in-memory modifications to the exemplar are sill present.
-
-			result = pResourceManager->GetResource(
-				key,
-				GZIID_cISCPropertyHolder,
-				reinterpret_cast<void**>(&propertyHolder),
-				0,
-				nullptr);
-
-			if (result)
-			{
-				cISCProperty* property = propertyHolder->GetProperty(kTravelTypeCanReachDestination);
-
-				if (property)
-				{
-					cIGZVariant* data = property->GetPropertyValue();
-
-					if (data)
-					{
-						uint16_t type = data->GetType();
-						uint32_t count = data->GetCount();
-
-						if (type == cIGZVariant::Type::BoolArray && count == 9)
-						{
-							bool* values = data->RefBool();
-
-							if (values[1] != carCanReachDestination)
-							{
-								logger.WriteLine(
-									LogOptions::Errors,
-									"Someone else changed the 'Travel type can reach destination' value, cache refresh?.");
-							}
-						}
-					}
-				}
-
-				propertyHolder->Release();
-				propertyHolder = nullptr;
-			}
-		}
+		pTiming->Release();
+	}
+	else
+	{
+		experimentToggleTimed = false;
+	}
+}
+
+void ParknRideOrdinance::SetTransitSwitchIndex(TransitSwitchIndex* pIndex)
+{
+	impactReporter.SetTransitSwitchIndex(pIndex);
+	experimentScheduler.SetTransitSwitchIndex(pIndex);
+}
+
+void ParknRideOrdinance::SetRidershipScaledEffects(const RidershipMeter* pMeter, const CongestionMonitor* pMonitor)
+{
+	const bool enabled = pMeter && pMonitor;
+
+	pEffectsRidershipMeter = enabled ? pMeter : nullptr;
+	pEffectsCongestionMonitor = enabled ? pMonitor : nullptr;
+}
+
+void ParknRideOrdinance::SetRidershipPricing(RidershipMeter* pMeter, uint32_t costPerThousandTrips, uint32_t maxMonthlyCost)
+{
+	pRidershipMeter = pMeter;
+	ridershipCostPerThousandTrips = costPerThousandTrips;
+	ridershipMaxMonthlyCost = maxMonthlyCost;
+	InvalidateQueryCache();
+}
+
+void ParknRideOrdinance::SetPrecompiledTuningOverride(bool installed)
+{
+	precompiledTuningOverride = installed;
+}
+
+float ParknRideOrdinance::GetEffectStrength()
+{
+	if (!pEffectsRidershipMeter)
+	{
+		return 1.0f;
+	}
+
+	const double ridership = std::min(transitUtilization / kFullStrengthTransitUtilization, 1.0);
+
+	if (baselineCongestion <= 0.0)
+	{
+		return static_cast<float>(ridership);
+	}
+
+	const double relief = (baselineCongestion - averageCongestion) / baselineCongestion;
+	const double congestionRelief = std::clamp(relief / kFullStrengthCongestionRelief, 0.0, 1.0);
+
+	return static_cast<float>((ridership + congestionRelief) * 0.5);
+}
+
+void ParknRideOrdinance::UpdateRidershipAggregates()
+{
+	if (!pEffectsRidershipMeter)
+	{
+		return;
 	}
 
-	if (!pSimulator->HiddenResume())
+	// The meter and the monitor keep running totals as they sample the city each day,
+	// so the monthly update does not read the transit switches or the congestion map.
+	transitUtilization = pEffectsRidershipMeter->GetTransitUtilization();
+
+	double congestion = 0.0;
+
+	// The average is skipped until the monitor has sampled the whole map, e.g. after the
+	// traffic simulator was restarted.
+	if (pEffectsCongestionMonitor->GetMapAverageCongestion(congestion))
 	{
-		logger.WriteLine(LogOptions::Errors, "Failed to resume the game.");
+		averageCongestion = congestion;
+
+		if (!IsCarRestrictionActive())
+		{
+			baselineCongestion = averageCongestion;
+		}
 	}
 }
 
-int64_t ParknRideOrdinance::GetCurrentMonthlyIncome()
+int64_t ParknRideOrdinance::CalculateMonthlyIncome()
 {
-	return 0;
+	// Without the ridership pricing the ordinance has no monthly cost.
+	if (!pRidershipMeter || !pRidershipMeter->IsStarted())
+	{
+		return 0;
+	}
+
+	// The meter keeps the usage totals as it samples the transit switches, so this
+	// does not query the traffic simulator.
+	const double transitTrips = pRidershipMeter->GetTransitTrips();
+	double monthlyCost = (transitTrips / 1000.0) * static_cast<double>(ridershipCostPerThousandTrips);
+
+	if (ridershipMaxMonthlyCost > 0)
+	{
+		monthlyCost = std::min(monthlyCost, static_cast<double>(ridershipMaxMonthlyCost));
+	}
+
+	// Costs are reported as negative income, the clamp keeps the conversion in range.
+	const int64_t monthlyIncome = -static_cast<int64_t>(std::clamp(monthlyCost, 0.0, static_cast<double>(UINT32_MAX)));
+
+	logger.WriteLineFormatted(
+		LogOptions::OrdinanceAPI,
+		"%s: transit trips=%.0f, current=%lld",
+		__FUNCTION__,
+		transitTrips,
+		monthlyIncome);
+
+	return monthlyIncome;
 }
 
 bool ParknRideOrdinance::SetOn(bool isOn)
 {
-	bool oldOn = on;
+	const bool oldRestrictionActive = IsCarRestrictionActive();
+	const bool stateChanged = on != isOn;
 
 	OrdinanceBase::SetOn(isOn);
-	if (oldOn != isOn)
+
+	// The baseline is captured before the traffic simulator is restarted with the new setting.
+	// With the precompiled override the traffic does not depend on the ordinance state, so
+	// there is no impact to report.
+	if (stateChanged && initialized && pCity && !precompiledTuningOverride)
+	{
+		impactReporter.Start(pCity, isOn);
+	}
+
+	if (oldRestrictionActive != IsCarRestrictionActive())
 	{
 		UpdateCarCanReachDestination(/*calledFromPostCityInit*/false);
 	}
@@ -411,6 +428,38 @@ bool ParknRideOrdinance::SetOn(bool isOn)
 	return true;
 }
 
+bool ParknRideOrdinance::Simulate()
+{
+	// The base class applies the effect strength that is computed from these values.
+	UpdateRidershipAggregates();
+
+	if (experimentToggleTimed)
+	{
+		RecordExperimentToggleTime();
+	}
+
+	bool result = OrdinanceBase::Simulate();
+
+	impactReporter.Update(pCity);
+
+	if (pMetricsRecorder)
+	{
+		pMetricsRecorder->Record(pCity, IsOn(), IsCarRestrictionActive());
+	}
+
+	// The experiment only toggles the ordinance at the end of a simulation month.
+	// Both arms would be the same with the precompiled override, so it is not run.
+	// The coordinator applies the toggle in its batch at the start of the next frame, the time
+	// that batch took is recorded once it has been applied.
+	if (available && !precompiledTuningOverride && experimentScheduler.Simulate(pCity, on))
+	{
+		SetOn(!on);
+		experimentToggleTimed = RequestExperimentToggleTime();
+	}
+
+	return result;
+}
+
 bool ParknRideOrdinance::PostCityInit(cISC4City* pCity)
 {
 	bool result = OrdinanceBase::PostCityInit(pCity);
@@ -434,7 +483,18 @@ bool ParknRideOrdinance::PostCityInit(cISC4City* pCity)
 bool ParknRideOrdinance::PreCityShutdown(cISC4City* pCity)
 {
 	bool result = OrdinanceBase::PreCityShutdown(pCity);
-	pCity = nullptr;
+	this->pCity = nullptr;
+
+	impactReporter.Clear();
+	experimentScheduler.Reset();
+	experimentToggleTimed = false;
+	// The ordinance is kept when the next city loads, the congestion monitor decides
+	// again for that city once it has sampled the whole map.
+	congestionRestrictionActive = false;
+	rushHourRestrictionActive = false;
+	transitUtilization = 0.0;
+	averageCongestion = 0.0;
+	baselineCongestion = -1.0;
 
 	return result;
 }
@@ -12,6 +12,18 @@
 
 #pragma once
 #include "OrdinanceBase.h"
+#include "ExperimentScheduler.h"
+#include "ImpactReporter.h"
+#include "cITrafficTuningCoordinator.h"
+
+class CongestionMonitor;
+class MetricsRecorder;
+class RidershipMeter;
+class TransitSwitchIndex;
+
+// The unique ID that identifies this ordinance, it is also stored in the save games.
+// The value must never be reused, when creating a new ordinance generate a random 32-bit integer and use that.
+static constexpr uint32_t kParknRideOrdinanceCLSID = 0x479bf2c7;
 
 class ParknRideOrdinance final : public OrdinanceBase
 {
@@ -21,19 +33,122 @@ public:
 
 	void UpdateCarCanReachDestination(bool calledFromPostCityInit) const;
 
-	// Gets the monthly income or expense when the ordinance is enabled.
-	int64_t GetCurrentMonthlyIncome() override;
+	// Sets the coordinator that applies the traffic simulator tuning exemplar edits.
+	void SetTuningCoordinator(cITrafficTuningCoordinator* pCoordinator, uint32_t participantID);
+
+	// Sets the recorder that the monthly traffic statistics are written to, or null to stop recording.
+	void SetMetricsRecorder(MetricsRecorder* pRecorder);
+
+	// Sets the number of months that the impact report of each toggle covers, zero disables the reports.
+	void SetImpactReportMonths(uint32_t months);
+
+	const ImpactReporter& GetImpactReporter() const;
+
+	// Sets the A/B experiment schedule, a period length of zero disables the experiment.
+	void SetExperimentSchedule(uint32_t periodMonths, uint32_t washoutMonths);
+
+	const ExperimentScheduler& GetExperimentScheduler() const;
+
+	// In auto mode the enacted ordinance only restricts cars while the congestion restriction is active.
+	void SetAutoMode(bool enabled);
+
+	bool IsCongestionRestrictionActive() const;
+
+	// Called by the congestion monitor when the city-wide congestion crosses a threshold.
+	void SetCongestionRestrictionActive(bool active);
+
+	// In rush hour mode the enacted ordinance only restricts cars while the rush hour restriction is active.
+	void SetRushHourMode(bool enabled);
+
+	bool IsRushHourRestrictionActive() const;
+
+	/**
+	 * @brief Called by the rush hour scheduler when a commuter window starts or ends.
+	 * The traffic simulator is made to reload its tunable values, it is not paused or restarted.
+	 * @param active True if the rush hour restriction is active; otherwise, false.
+	 * @return True if the traffic simulator was updated; otherwise, false.
+	 */
+	bool SetRushHourRestrictionActive(bool active);
+
+	// Sets the transit switches that the traffic reports are measured from.
+	void SetTransitSwitchIndex(TransitSwitchIndex* pIndex);
+
+	/**
+	 * @brief Makes the strength of the ordinance effects follow the transit ridership and the congestion relief.
+	 * The values are read from the running totals of the meter and the monitor once per month.
+	 * @param pMeter The meter that measures the transit switch usage.
+	 * @param pMonitor The monitor that samples the congestion map.
+	 * If either is null the ordinance always has its full effects.
+	 */
+	void SetRidershipScaledEffects(const RidershipMeter* pMeter, const CongestionMonitor* pMonitor);
+
+	/**
+	 * @brief Sets the ridership-based monthly cost.
+	 * @param pMeter The meter that measures the transit switch usage, or null to disable the monthly cost.
+	 * @param costPerThousandTrips The monthly cost of every 1000 trips that arrive at the transit switches.
+	 * @param maxMonthlyCost The largest monthly cost, zero removes the limit.
+	 */
+	void SetRidershipPricing(RidershipMeter* pMeter, uint32_t costPerThousandTrips, uint32_t maxMonthlyCost);
+
+	// When the precompiled tuning override is installed cars are always restricted by the
+	// game's exemplar, so the ordinance does not edit the cached tuning exemplar. The
+	// experiment schedule and the impact reports are disabled because the ordinance
+	// state has no effect on the traffic.
+	void SetPrecompiledTuningOverride(bool installed);
 
 	bool SetOn(bool isOn) override;
 
+	// Called by the game once per simulation month.
+	bool Simulate() override;
+
 	// Initializes the ordinance when entering a city.
 	bool PostCityInit(cISC4City* pCity) override;
 
 	// Shuts down the ordinance when exiting a city.
 	bool PreCityShutdown(cISC4City* pCity) override;
 
+protected:
+
+	// Calculates the monthly income or expense when the ordinance is enabled.
+	int64_t CalculateMonthlyIncome() override;
+
+	float GetEffectStrength() override;
+
 private:
 
+	bool IsCarRestrictionActive() const;
+	void UpdateRidershipAggregates();
+	void QueueCarCanReachDestination(TrafficSimulatorUpdateMode updateMode) const;
+	bool RequestExperimentToggleTime();
+	void RecordExperimentToggleTime();
+
 	cISC4City* pCity;
+	cITrafficTuningCoordinator* pTuningCoordinator;
+	uint32_t participantID;
+	MetricsRecorder* pMetricsRecorder;
+	ImpactReporter impactReporter;
+	ExperimentScheduler experimentScheduler;
+	// True while the coordinator has not reported the time it took to apply the experiment toggle.
+	bool experimentToggleTimed;
+	bool autoMode;
+	// The congestion restriction is not saved with the city, the congestion
+	// monitor sets it again after its first pass over the congestion map.
+	bool congestionRestrictionActive;
+	bool rushHourMode;
+	// The rush hour restriction is set from the 24-hour clock by the rush hour scheduler.
+	bool rushHourRestrictionActive;
+	// The sources of the ridership scaled effects, both are null when the effects are not scaled.
+	const RidershipMeter* pEffectsRidershipMeter;
+	const CongestionMonitor* pEffectsCongestionMonitor;
+	// The monthly aggregates that the effect strength is computed from.
+	double transitUtilization;
+	double averageCongestion;
+	// The average congestion in the last month without the car restriction,
+	// or a negative value if it has not been measured since the city was loaded.
+	double baselineCongestion;
+	RidershipMeter* pRidershipMeter;
+	uint32_t ridershipCostPerThousandTrips;
+	uint32_t ridershipMaxMonthlyCost;
+	bool precompiledTuningOverride;
 };
 
@@ -11,12 +11,22 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "version.h"
+#include "CongestionMonitor.h"
+#include "LocalizedStringCache.h"
 #include "Logger.h"
+#include "MetricsRecorder.h"
 #include "ParknRideOrdinance.h"
+#include "RidershipMeter.h"
+#include "RushHourScheduler.h"
+#include "Settings.h"
+#include "TrafficTuningCoordinator.h"
+#include "TransitSwitchIndex.h"
 #include "cIGZFrameWork.h"
+#include "cIGZCOM.h"
 #include "cIGZApp.h"
 #include "cISC4App.h"
 #include "cISC4City.h"
+#include "cISC4Occupant.h"
 #include "cISCProperty.h"
 #include "cISCPropertyHolder.h"
 #include "cISC4Ordinance.h"
@@ -43,11 +53,14 @@
 
 static constexpr uint32_t kSC4MessagePostCityInit = 0x26D31EC1;
 static constexpr uint32_t kSC4MessagePreCityShutdown = 0x26D31EC2;
+static constexpr uint32_t kSC4MessageInsertOccupant = 0x99EF1142;
+static constexpr uint32_t kSC4MessageRemoveOccupant = 0x99EF1143;
 
 static constexpr uint32_t kParknRideOrdinancePluginDirectorID = 0x198d91a2;
 
 static constexpr std::string_view PluginConfigFileName = "SC4ParknRideOrdinance.ini";
 static constexpr std::string_view PluginLogFileName = "SC4ParknRideOrdinance.log";
+static constexpr std::string_view PluginMetricsFolderName = "SC4ParknRideOrdinance Metrics";
 
 class ParknRideOrdinanceDllDirector : public cRZMessage2COMDirector
 {
@@ -55,7 +68,16 @@ public:
 
 	ParknRideOrdinanceDllDirector()
 		: parkAndRideOrdinance(),
+		  trafficTuningCoordinator(),
+		  congestionMonitor(),
+		  rushHourScheduler(),
+		  metricsRecorder(),
+		  transitSwitchIndex(),
+		  ridershipMeter(),
+		  settings(),
+		  pActiveTuningCoordinator(nullptr),
 		  configFilePath(),
+		  metricsFolderPath(),
 		  localizedName(),
 		  localizedDescription()
 	{
@@ -64,6 +86,9 @@ public:
 		configFilePath = dllFolderPath;
 		configFilePath /= PluginConfigFileName;
 
+		metricsFolderPath = dllFolderPath;
+		metricsFolderPath /= PluginMetricsFolderName;
+
 		std::filesystem::path logFilePath = dllFolderPath;
 		logFilePath /= PluginLogFileName;
 
@@ -76,6 +101,9 @@ public:
 
 
 		logger.WriteLogFileHeader("SC4ParknRideOrdinance v" PLUGIN_VERSION_STR);
+
+		settings.Load(configFilePath);
+		trafficTuningCoordinator.SetSeedTrafficMapsOnRestart(settings.seedTrafficMapsOnRestart);
 	}
 
 	uint32_t GetDirectorID() const
@@ -90,6 +118,9 @@ public:
 		// This method is called once when initializing a director, the list of class IDs
 		// it returns is cached by the framework.
 		pCallback(parkAndRideOrdinance.GetID(), 0, pContext);
+		// Every plugin that edits the traffic simulator tuning exemplar registers this class ID,
+		// the framework only uses the class object from the first DLL that registered it.
+		pCallback(GZCLSID_cTrafficTuningCoordinator, 0, pContext);
 	}
 
 	bool GetClassObject(uint32_t rclsid, uint32_t riid, void** ppvObj)
@@ -103,6 +134,10 @@ public:
 		{
 			result = parkAndRideOrdinance.QueryInterface(riid, ppvObj);
 		}
+		else if (rclsid == GZCLSID_cTrafficTuningCoordinator)
+		{
+			result = trafficTuningCoordinator.QueryInterface(riid, ppvObj);
+		}
 
 		return result;
 	}
@@ -113,6 +148,9 @@ public:
 
 		if (pCity)
 		{
+			// The index is kept current from the occupant notifications after this point.
+			transitSwitchIndex.Build(pCity);
+
 			cISC4OrdinanceSimulator* pOrdinanceSimulator = pCity->GetOrdinanceSimulator();
 
 			if (pOrdinanceSimulator)
@@ -140,7 +178,55 @@ public:
 						pParkAndRideOrdinance->PostCityInit(pCity);
 					}
 
+					// With the precompiled override the game loads a tuning exemplar that always restricts
+					// cars, the cached copy is not edited and the traffic simulator is not reloaded.
+					const bool tuningOverrideInstalled = TrafficTuningCoordinator::IsPrecompiledOverrideInstalled();
+
+					if (tuningOverrideInstalled)
+					{
+						Logger::GetInstance().WriteLine(
+							LogOptions::Info,
+							"The precompiled traffic tuning override is installed, cars are always restricted."
+							" The auto mode, rush hour, experiment and impact report settings are ignored.");
+					}
+
+					pParkAndRideOrdinance->SetPrecompiledTuningOverride(tuningOverrideInstalled);
+					pParkAndRideOrdinance->SetAutoMode(settings.autoMode && !tuningOverrideInstalled);
+					pParkAndRideOrdinance->SetImpactReportMonths(settings.impactReportMonths);
+					pParkAndRideOrdinance->SetExperimentSchedule(settings.experimentPeriodMonths, settings.experimentWashoutMonths);
+					pParkAndRideOrdinance->SetTransitSwitchIndex(&transitSwitchIndex);
+
+					// The meter keeps the transit switch totals of the index current for the ordinance
+					// cost and effects and the traffic reports, so they never read every switch.
+					const bool ridershipMeterStarted = (settings.ridershipPricing
+						|| settings.ridershipScaledEffects
+						|| (!tuningOverrideInstalled && (settings.impactReportMonths > 0 || settings.experimentPeriodMonths > 0)))
+						&& ridershipMeter.Start(pCity, &transitSwitchIndex, settings);
+
+					pParkAndRideOrdinance->SetRidershipPricing(
+						settings.ridershipPricing && ridershipMeterStarted ? &ridershipMeter : nullptr,
+						settings.ridershipCostPerThousandTrips,
+						settings.ridershipMaxMonthlyCost);
+					// The scheduler sets the rush hour restriction from the 24-hour clock on its first tick.
+					pParkAndRideOrdinance->SetRushHourMode(
+						settings.rushHourMask != 0
+						&& !tuningOverrideInstalled
+						&& rushHourScheduler.Start(pCity, pParkAndRideOrdinance, settings));
 					pParkAndRideOrdinance->UpdateCarCanReachDestination(/*calledFromPostCityInit*/true);
+
+					const bool autoMode = settings.autoMode && !tuningOverrideInstalled;
+					const bool congestionMonitorStarted = (autoMode || settings.ridershipScaledEffects)
+						&& congestionMonitor.Start(pCity, pParkAndRideOrdinance, settings, autoMode);
+
+					pParkAndRideOrdinance->SetRidershipScaledEffects(
+						settings.ridershipScaledEffects && ridershipMeterStarted ? &ridershipMeter : nullptr,
+						settings.ridershipScaledEffects && congestionMonitorStarted ? &congestionMonitor : nullptr);
+
+					if (settings.recordMetrics
+						&& metricsRecorder.Open(MetricsRecorder::GetCityFilePath(metricsFolderPath, pCity)))
+					{
+						pParkAndRideOrdinance->SetMetricsRecorder(&metricsRecorder);
+					}
 				}
 				else
 				{
@@ -154,6 +240,10 @@ public:
 
 	void PreCityShutdown(cIGZMessage2Standard* pStandardMsg)
 	{
+		congestionMonitor.Stop();
+		rushHourScheduler.Stop();
+		ridershipMeter.Stop();
+
 		cISC4City* pCity = reinterpret_cast<cISC4City*>(pStandardMsg->GetIGZUnknown());
 
 		if (pCity)
@@ -167,11 +257,16 @@ public:
 				if (pOrdinance)
 				{
 					ParknRideOrdinance* pParkAndRideOrdinance = reinterpret_cast<ParknRideOrdinance*>(pOrdinance);
+					pParkAndRideOrdinance->SetMetricsRecorder(nullptr);
+					pParkAndRideOrdinance->SetRidershipScaledEffects(nullptr, nullptr);
 					pParkAndRideOrdinance->PreCityShutdown(pCity);
 					pOrdinanceSimulator->RemoveOrdinance(*pOrdinance);
 				}
 			}
 		}
+
+		metricsRecorder.Close();
+		transitSwitchIndex.Clear();
 	}
 
 	bool DoMessage(cIGZMessage2* pMessage)
@@ -187,6 +282,12 @@ public:
 		case kSC4MessagePreCityShutdown:
 			PreCityShutdown(pStandardMsg);
 			break;
+		case kSC4MessageInsertOccupant:
+			transitSwitchIndex.OccupantInserted(reinterpret_cast<cISC4Occupant*>(pStandardMsg->GetIGZUnknown()));
+			break;
+		case kSC4MessageRemoveOccupant:
+			transitSwitchIndex.OccupantRemoved(reinterpret_cast<cISC4Occupant*>(pStandardMsg->GetIGZUnknown()));
+			break;
 		}
 
 		return true;
@@ -202,6 +303,8 @@ public:
 			std::vector<uint32_t> requiredNotifications;
 			requiredNotifications.push_back(kSC4MessagePostCityInit);
 			requiredNotifications.push_back(kSC4MessagePreCityShutdown);
+			requiredNotifications.push_back(kSC4MessageInsertOccupant);
+			requiredNotifications.push_back(kSC4MessageRemoveOccupant);
 
 			for (uint32_t messageID : requiredNotifications)
 			{
@@ -217,6 +320,28 @@ public:
 			logger.WriteLine(LogOptions::Errors, "Failed to subscribe to the required notifications.");
 			return true;
 		}
+
+		InitTuningCoordinator();
+
+		return true;
+	}
+
+	bool PreAppShutdown()
+	{
+		congestionMonitor.Stop();
+		rushHourScheduler.Stop();
+		ridershipMeter.Stop();
+
+		if (pActiveTuningCoordinator)
+		{
+			parkAndRideOrdinance.SetTuningCoordinator(nullptr, 0);
+			pActiveTuningCoordinator->Release();
+			pActiveTuningCoordinator = nullptr;
+		}
+
+		trafficTuningCoordinator.Shutdown();
+		LocalizedStringCache::GetInstance().Clear();
+
 		return true;
 	}
 
@@ -237,6 +362,36 @@ public:
 
 private:
 
+	void InitTuningCoordinator()
+	{
+		Logger& logger = Logger::GetInstance();
+
+		// The framework returns the coordinator from the first plugin that registered the class ID,
+		// this may be our own instance or one that belongs to another DLL.
+		cIGZCOM* const pCOM = GZCOM();
+
+		if (pCOM && pCOM->GetClassObject(
+			GZCLSID_cTrafficTuningCoordinator,
+			GZIID_cITrafficTuningCoordinator,
+			reinterpret_cast<void**>(&pActiveTuningCoordinator)))
+		{
+			const bool isCoordinator = pActiveTuningCoordinator == static_cast<cITrafficTuningCoordinator*>(&trafficTuningCoordinator);
+
+			logger.WriteLineFormatted(
+				LogOptions::Info,
+				"Using the traffic tuning coordinator from %s.",
+				isCoordinator ? "this plugin" : "another plugin");
+
+			pActiveTuningCoordinator->RegisterParticipant(kParknRideOrdinancePluginDirectorID, cRZBaseString("SC4ParknRideOrdinance"));
+			parkAndRideOrdinance.SetTuningCoordinator(pActiveTuningCoordinator, kParknRideOrdinancePluginDirectorID);
+		}
+		else
+		{
+			pActiveTuningCoordinator = nullptr;
+			logger.WriteLine(LogOptions::Errors, "Failed to get the traffic tuning coordinator.");
+		}
+	}
+
 	std::filesystem::path GetDllFolderPath()
 	{
 		wil::unique_cotaskmem_string modulePath = wil::GetModuleFileNameW(wil::GetModuleInstanceHandle());
@@ -327,7 +482,16 @@ private:
 	}
 
 	ParknRideOrdinance parkAndRideOrdinance;
+	TrafficTuningCoordinator trafficTuningCoordinator;
+	CongestionMonitor congestionMonitor;
+	RushHourScheduler rushHourScheduler;
+	MetricsRecorder metricsRecorder;
+	TransitSwitchIndex transitSwitchIndex;
+	RidershipMeter ridershipMeter;
+	Settings settings;
+	cITrafficTuningCoordinator* pActiveTuningCoordinator;
 	std::filesystem::path configFilePath;
+	std::filesystem::path metricsFolderPath;
 	cRZBaseString localizedName;
 	cRZBaseString localizedDescription;
 };
@@ -0,0 +1,279 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "Platform.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+
+Platform::LocalTime Platform::GetLocalTime()
+{
+	SYSTEMTIME time;
+
+	::GetLocalTime(&time);
+
+	return LocalTime{ time.wHour, time.wMinute, time.wSecond, time.wMilliseconds };
+}
+
+int64_t Platform::GetTimestamp()
+{
+	LARGE_INTEGER li{};
+
+	QueryPerformanceCounter(&li);
+
+	return li.QuadPart;
+}
+
+int64_t Platform::GetTimestampFrequency()
+{
+	LARGE_INTEGER li{};
+
+	QueryPerformanceFrequency(&li);
+
+	return li.QuadPart;
+}
+
+void Platform::WriteDebugOutputLine(const char* message)
+{
+	OutputDebugStringA(message);
+	OutputDebugStringA("\n");
+}
+
+bool Platform::MapFile(const std::filesystem::path& path, MappedFile& file)
+{
+	file = MappedFile{};
+
+	HANDLE hFile = CreateFileW(
+		path.c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+	HANDLE hMapping = nullptr;
+
+	if (GetFileSizeEx(hFile, &fileSize)
+		&& fileSize.QuadPart > 0
+		&& static_cast<uint64_t>(fileSize.QuadPart) <= SIZE_MAX)
+	{
+		hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+
+	// The mapping keeps the file open.
+	CloseHandle(hFile);
+
+	if (!hMapping)
+	{
+		return false;
+	}
+
+	const void* view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (!view)
+	{
+		CloseHandle(hMapping);
+		return false;
+	}
+
+	file.data = static_cast<const uint8_t*>(view);
+	file.size = static_cast<size_t>(fileSize.QuadPart);
+	file.handle = hMapping;
+	return true;
+}
+
+void Platform::UnmapFile(MappedFile& file)
+{
+	if (file.data)
+	{
+		UnmapViewOfFile(file.data);
+	}
+
+	if (file.handle)
+	{
+		CloseHandle(file.handle);
+	}
+
+	file = MappedFile{};
+}
+
+bool Platform::FlushFile(const std::filesystem::path& path)
+{
+	HANDLE hFile = CreateFileW(
+		path.c_str(),
+		GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_WRITE,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		nullptr);
+
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	const bool result = FlushFileBuffers(hFile) != FALSE;
+
+	CloseHandle(hFile);
+
+	return result;
+}
+
+bool Platform::ReplaceExistingFile(const std::filesystem::path& source, const std::filesystem::path& target)
+{
+	// MOVEFILE_WRITE_THROUGH does not return until the file has been moved on the disk.
+	return MoveFileExW(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+}
+
+#else
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+Platform::LocalTime Platform::GetLocalTime()
+{
+	timeval now{};
+	gettimeofday(&now, nullptr);
+
+	tm local{};
+	localtime_r(&now.tv_sec, &local);
+
+	return LocalTime
+	{
+		static_cast<uint16_t>(local.tm_hour),
+		static_cast<uint16_t>(local.tm_min),
+		static_cast<uint16_t>(local.tm_sec),
+		static_cast<uint16_t>(now.tv_usec / 1000)
+	};
+}
+
+int64_t Platform::GetTimestamp()
+{
+	timespec ts{};
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (static_cast<int64_t>(ts.tv_sec) * 1000000000) + ts.tv_nsec;
+}
+
+int64_t Platform::GetTimestampFrequency()
+{
+	return 1000000000;
+}
+
+void Platform::WriteDebugOutputLine(const char* message)
+{
+	fputs(message, stderr);
+	fputc('\n', stderr);
+}
+
+bool Platform::MapFile(const std::filesystem::path& path, MappedFile& file)
+{
+	file = MappedFile{};
+
+	const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	struct stat fileInfo{};
+	void* view = MAP_FAILED;
+
+	if (fstat(fd, &fileInfo) == 0 && fileInfo.st_size > 0)
+	{
+		view = mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+
+	// The mapping keeps the file open.
+	close(fd);
+
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	file.data = static_cast<const uint8_t*>(view);
+	file.size = static_cast<size_t>(fileInfo.st_size);
+	return true;
+}
+
+void Platform::UnmapFile(MappedFile& file)
+{
+	if (file.data)
+	{
+		munmap(const_cast<uint8_t*>(file.data), file.size);
+	}
+
+	file = MappedFile{};
+}
+
+bool Platform::FlushFile(const std::filesystem::path& path)
+{
+	const int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	// fsync writes the data of the file, not only the data that was written through this descriptor.
+	const bool result = fsync(fd) == 0;
+
+	close(fd);
+
+	return result;
+}
+
+bool Platform::ReplaceExistingFile(const std::filesystem::path& source, const std::filesystem::path& target)
+{
+	if (rename(source.c_str(), target.c_str()) != 0)
+	{
+		return false;
+	}
+
+	// The rename is only durable once the directory that contains the file has been written.
+	std::filesystem::path folder = target.parent_path();
+
+	if (folder.empty())
+	{
+		folder = ".";
+	}
+
+	const int fd = open(folder.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+	if (fd == -1)
+	{
+		return false;
+	}
+
+	const bool result = fsync(fd) == 0;
+
+	close(fd);
+
+	return result;
+}
+
+#endif // _WIN32
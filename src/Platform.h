@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <filesystem>
+#include <stdint.h>
+
+// The operating system functions that are used by the platform-neutral plugin code.
+// The Win32 implementation is used by the plugin DLL, the POSIX implementation allows
+// the core library to be built on Linux for testing and benchmarking.
+
+// The signature of the enclosing function, for the log messages.
+#ifdef _MSC_VER
+#define PLATFORM_FUNCSIG __FUNCSIG__
+#else
+#define PLATFORM_FUNCSIG __PRETTY_FUNCTION__
+#endif // _MSC_VER
+
+namespace Platform
+{
+	struct LocalTime
+	{
+		uint16_t hour;
+		uint16_t minute;
+		uint16_t second;
+		uint16_t milliseconds;
+	};
+
+	// A read-only view of a file that is mapped into the process address space.
+	struct MappedFile
+	{
+		const uint8_t* data;
+		size_t size;
+		// The platform-specific mapping handle.
+		void* handle;
+	};
+
+	/**
+	 * @brief Gets the current local time.
+	 * @return The current local time.
+	 */
+	LocalTime GetLocalTime();
+
+	/**
+	 * @brief Gets the current value of the high-resolution performance counter.
+	 * @return The current value of the high-resolution performance counter.
+	 */
+	int64_t GetTimestamp();
+
+	/**
+	 * @brief Gets the number of high-resolution performance counter ticks per second.
+	 * @return The number of high-resolution performance counter ticks per second.
+	 */
+	int64_t GetTimestampFrequency();
+
+	/**
+	 * @brief Writes a line to the debugger output.
+	 * @param message The message to write.
+	 */
+	void WriteDebugOutputLine(const char* message);
+
+	/**
+	 * @brief Maps a file into memory for reading.
+	 * @param path The file path.
+	 * @param file Receives the mapped view, it must be released with UnmapFile.
+	 * @return True on success; otherwise, false. Empty files cannot be mapped.
+	 */
+	bool MapFile(const std::filesystem::path& path, MappedFile& file);
+
+	/**
+	 * @brief Releases a view that was created by MapFile.
+	 * @param file The mapped view, it is reset to an empty view.
+	 */
+	void UnmapFile(MappedFile& file);
+
+	/**
+	 * @brief Writes the cached data of a file to the disk.
+	 * @param path The file path, the file may be open in another stream.
+	 * @return True on success; otherwise, false.
+	 */
+	bool FlushFile(const std::filesystem::path& path);
+
+	/**
+	 * @brief Replaces a file with another file and writes the directory change to the disk.
+	 * @param source The path of the file that replaces the target, its data must already be flushed.
+	 * @param target The path of the file that is replaced.
+	 * @return True on success; otherwise, false.
+	 */
+	bool ReplaceExistingFile(const std::filesystem::path& source, const std::filesystem::path& target);
+}
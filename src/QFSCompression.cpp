@@ -0,0 +1,514 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "QFSCompression.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	// The DBPF entries store the compressed size before the QFS signature.
+	constexpr size_t kCompressedSizePrefix = 4;
+	constexpr uint8_t kSignature = 0xfb;
+	constexpr uint8_t kFlagLargeSizes = 0x80;
+	constexpr uint8_t kFlagCompressedSize = 0x01;
+	constexpr uint32_t kMaxUncompressedSize = 0xffffff;
+
+	// The longest match and the furthest offset of each command size.
+	constexpr uint32_t kMaxShortMatchLength = 10;
+	constexpr uint32_t kMaxShortMatchOffset = 1024;
+	constexpr uint32_t kMaxMediumMatchLength = 67;
+	constexpr uint32_t kMaxMediumMatchOffset = 16384;
+	constexpr uint32_t kMaxLongMatchLength = 1028;
+	constexpr uint32_t kMaxLongMatchOffset = 131072;
+	constexpr uint32_t kMaxLiteralRun = 112;
+
+	struct Command
+	{
+		uint32_t literalCount;
+		uint32_t matchLength;
+		uint32_t matchOffset;
+		bool end;
+	};
+
+	bool ParseHeader(const uint8_t* data, size_t size, uint32_t& uncompressedSize, size_t& headerSize)
+	{
+		if (size < kCompressedSizePrefix + 2)
+		{
+			return false;
+		}
+
+		const uint8_t flags = data[kCompressedSizePrefix];
+
+		if ((flags & 0x7e) != 0x10 || data[kCompressedSizePrefix + 1] != kSignature)
+		{
+			return false;
+		}
+
+		const size_t sizeFieldLength = (flags & kFlagLargeSizes) ? 4 : 3;
+		size_t position = kCompressedSizePrefix + 2;
+
+		if (flags & kFlagCompressedSize)
+		{
+			position += sizeFieldLength;
+		}
+
+		if (size < position + sizeFieldLength)
+		{
+			return false;
+		}
+
+		// The sizes in the QFS header are big-endian.
+		uint32_t value = 0;
+
+		for (size_t i = 0; i < sizeFieldLength; i++)
+		{
+			value = (value << 8) | data[position + i];
+		}
+
+		uncompressedSize = value;
+		headerSize = position + sizeFieldLength;
+		return true;
+	}
+
+	// Reads the next command and the number of literal bytes that follow it.
+	// The input must not be empty, false is returned if the command is truncated.
+	bool ReadCommand(const uint8_t*& input, const uint8_t* inputEnd, Command& command)
+	{
+		const size_t remaining = static_cast<size_t>(inputEnd - input);
+		const uint32_t b0 = input[0];
+
+		command.matchLength = 0;
+		command.matchOffset = 0;
+		command.end = false;
+
+		if (b0 < 0x80)
+		{
+			if (remaining < 2)
+			{
+				return false;
+			}
+
+			const uint32_t b1 = input[1];
+
+			command.literalCount = b0 & 0x03;
+			command.matchLength = ((b0 & 0x1c) >> 2) + 3;
+			command.matchOffset = ((b0 & 0x60) << 3) + b1 + 1;
+			input += 2;
+		}
+		else if (b0 < 0xc0)
+		{
+			if (remaining < 3)
+			{
+				return false;
+			}
+
+			const uint32_t b1 = input[1];
+			const uint32_t b2 = input[2];
+
+			command.literalCount = (b1 >> 6) & 0x03;
+			command.matchLength = (b0 & 0x3f) + 4;
+			command.matchOffset = ((b1 & 0x3f) << 8) + b2 + 1;
+			input += 3;
+		}
+		else if (b0 < 0xe0)
+		{
+			if (remaining < 4)
+			{
+				return false;
+			}
+
+			const uint32_t b1 = input[1];
+			const uint32_t b2 = input[2];
+			const uint32_t b3 = input[3];
+
+			command.literalCount = b0 & 0x03;
+			command.matchLength = ((b0 & 0x0c) << 6) + b3 + 5;
+			command.matchOffset = ((b0 & 0x10) << 12) + (b1 << 8) + b2 + 1;
+			input += 4;
+		}
+		else if (b0 < 0xfc)
+		{
+			command.literalCount = ((b0 & 0x1f) << 2) + 4;
+			input += 1;
+		}
+		else
+		{
+			command.literalCount = b0 & 0x03;
+			command.end = true;
+			input += 1;
+		}
+
+		return true;
+	}
+
+	void CopyLiterals(uint8_t* output, const uint8_t* outputEnd, const uint8_t* input, const uint8_t* inputEnd, uint32_t count)
+	{
+		// Most literal runs are short, a fixed 16 byte move is cheaper than a variable length copy.
+		if (count <= 16 && (outputEnd - output) >= 16 && (inputEnd - input) >= 16)
+		{
+			std::memcpy(output, input, 16);
+		}
+		else
+		{
+			std::memcpy(output, input, count);
+		}
+	}
+
+	void CopyMatch(uint8_t* output, const uint8_t* outputEnd, uint32_t offset, uint32_t length)
+	{
+		const uint8_t* source = output - offset;
+
+		const size_t available = static_cast<size_t>(outputEnd - output);
+
+		if (offset >= 16 && available >= static_cast<size_t>(length) + 16)
+		{
+			// Most matches are short, with the source at least 16 bytes behind they take
+			// one or two 16 byte moves.
+			uint8_t* const end = output + length;
+
+			do
+			{
+				std::memcpy(output, source, 16);
+				output += 16;
+				source += 16;
+			} while (output < end);
+		}
+		else if (offset >= 8 && available >= static_cast<size_t>(length) + 8)
+		{
+			// The source is at least 8 bytes behind, so each 8 byte move only reads bytes that
+			// were already written. The last move can write up to 7 bytes past the match, they
+			// are overwritten by the following commands.
+			uint8_t* const end = output + length;
+
+			do
+			{
+				std::memcpy(output, source, 8);
+				output += 8;
+				source += 8;
+			} while (output < end);
+		}
+		else if (offset == 1)
+		{
+			std::memset(output, output[-1], length);
+		}
+		else if (available >= static_cast<size_t>(length) + 8)
+		{
+			// The match repeats the last 2 to 7 bytes. After the first 8 bytes are copied one
+			// at a time, the pattern repeats at a multiple of the offset that is at least 8
+			// bytes behind, so the rest of the match can use 8 byte moves.
+			for (uint32_t i = 0; i < 8; i++)
+			{
+				output[i] = source[i];
+			}
+
+			const uint32_t distance = offset * ((8 + offset - 1) / offset);
+
+			for (uint32_t position = 8; position < length; position += 8)
+			{
+				std::memcpy(output + position, output + position - distance, 8);
+			}
+		}
+		else
+		{
+			for (uint32_t i = 0; i < length; i++)
+			{
+				output[i] = source[i];
+			}
+		}
+	}
+
+	void AppendMatchCommand(std::vector<uint8_t>& output, uint32_t literalCount, uint32_t length, uint32_t offset)
+	{
+		const uint32_t encodedOffset = offset - 1;
+
+		if (length <= kMaxShortMatchLength && offset <= kMaxShortMatchOffset)
+		{
+			output.push_back(static_cast<uint8_t>(((encodedOffset >> 3) & 0x60) | ((length - 3) << 2) | literalCount));
+			output.push_back(static_cast<uint8_t>(encodedOffset));
+		}
+		else if (length <= kMaxMediumMatchLength && offset <= kMaxMediumMatchOffset)
+		{
+			output.push_back(static_cast<uint8_t>(0x80 | (length - 4)));
+			output.push_back(static_cast<uint8_t>((literalCount << 6) | (encodedOffset >> 8)));
+			output.push_back(static_cast<uint8_t>(encodedOffset));
+		}
+		else
+		{
+			const uint32_t encodedLength = length - 5;
+
+			output.push_back(static_cast<uint8_t>(0xc0 | ((encodedOffset >> 12) & 0x10) | ((encodedLength >> 6) & 0x0c) | literalCount));
+			output.push_back(static_cast<uint8_t>(encodedOffset >> 8));
+			output.push_back(static_cast<uint8_t>(encodedOffset));
+			output.push_back(static_cast<uint8_t>(encodedLength));
+		}
+	}
+
+	// Writes the literal runs of 4 to 112 bytes, the remaining 0 to 3 bytes are
+	// written by the next match or end command.
+	const uint8_t* AppendLiteralRuns(std::vector<uint8_t>& output, const uint8_t* literals, const uint8_t* end)
+	{
+		while (end - literals >= 4)
+		{
+			const uint32_t count = std::min(static_cast<uint32_t>(end - literals) & ~3u, kMaxLiteralRun);
+
+			output.push_back(static_cast<uint8_t>(0xe0 | ((count - 4) >> 2)));
+			output.insert(output.end(), literals, literals + count);
+			literals += count;
+		}
+
+		return literals;
+	}
+
+	bool IsEncodableMatch(uint32_t length, uint32_t offset)
+	{
+		if (offset <= kMaxShortMatchOffset)
+		{
+			return length >= 3;
+		}
+		else if (offset <= kMaxMediumMatchOffset)
+		{
+			return length >= 4;
+		}
+
+		return length >= 5 && offset <= kMaxLongMatchOffset;
+	}
+
+	uint32_t HashBytes(const uint8_t* data)
+	{
+		const uint32_t value = data[0] | (data[1] << 8) | (data[2] << 16);
+
+		return (value * 2654435761u) >> 16;
+	}
+}
+
+bool QFSCompression::IsCompressed(const uint8_t* data, size_t size)
+{
+	uint32_t uncompressedSize = 0;
+	size_t headerSize = 0;
+
+	return ParseHeader(data, size, uncompressedSize, headerSize);
+}
+
+bool QFSCompression::GetUncompressedSize(const uint8_t* data, size_t size, uint32_t& uncompressedSize)
+{
+	size_t headerSize = 0;
+
+	return ParseHeader(data, size, uncompressedSize, headerSize);
+}
+
+bool QFSCompression::Decompress(const uint8_t* data, size_t size, uint8_t* output, size_t outputSize)
+{
+	uint32_t uncompressedSize = 0;
+	size_t headerSize = 0;
+
+	if (!ParseHeader(data, size, uncompressedSize, headerSize) || uncompressedSize != outputSize)
+	{
+		return false;
+	}
+
+	const uint8_t* input = data + headerSize;
+	const uint8_t* const inputEnd = data + size;
+	uint8_t* const outputBegin = output;
+	const uint8_t* const outputEnd = output + outputSize;
+
+	while (input < inputEnd)
+	{
+		Command command{};
+
+		if (!ReadCommand(input, inputEnd, command))
+		{
+			return false;
+		}
+
+		if (command.literalCount > static_cast<size_t>(inputEnd - input)
+			|| command.literalCount > static_cast<size_t>(outputEnd - output))
+		{
+			return false;
+		}
+
+		CopyLiterals(output, outputEnd, input, inputEnd, command.literalCount);
+		input += command.literalCount;
+		output += command.literalCount;
+
+		if (command.end)
+		{
+			break;
+		}
+
+		if (command.matchLength > 0)
+		{
+			if (command.matchOffset > static_cast<size_t>(output - outputBegin)
+				|| command.matchLength > static_cast<size_t>(outputEnd - output))
+			{
+				return false;
+			}
+
+			CopyMatch(output, outputEnd, command.matchOffset, command.matchLength);
+			output += command.matchLength;
+		}
+	}
+
+	return output == outputEnd;
+}
+
+bool QFSCompression::Decompress(const uint8_t* data, size_t size, std::vector<uint8_t>& output)
+{
+	uint32_t uncompressedSize = 0;
+
+	if (!GetUncompressedSize(data, size, uncompressedSize))
+	{
+		return false;
+	}
+
+	output.resize(uncompressedSize);
+
+	return Decompress(data, size, output.data(), output.size());
+}
+
+bool QFSCompression::DecompressReference(const uint8_t* data, size_t size, uint8_t* output, size_t outputSize)
+{
+	uint32_t uncompressedSize = 0;
+	size_t headerSize = 0;
+
+	if (!ParseHeader(data, size, uncompressedSize, headerSize) || uncompressedSize != outputSize)
+	{
+		return false;
+	}
+
+	size_t inputPosition = headerSize;
+	size_t outputPosition = 0;
+
+	while (inputPosition < size)
+	{
+		const uint8_t* input = data + inputPosition;
+		Command command{};
+
+		if (!ReadCommand(input, data + size, command))
+		{
+			return false;
+		}
+
+		inputPosition = static_cast<size_t>(input - data);
+
+		for (uint32_t i = 0; i < command.literalCount; i++)
+		{
+			if (inputPosition >= size || outputPosition >= outputSize)
+			{
+				return false;
+			}
+
+			output[outputPosition++] = data[inputPosition++];
+		}
+
+		if (command.end)
+		{
+			break;
+		}
+
+		if (command.matchOffset > outputPosition)
+		{
+			return false;
+		}
+
+		for (uint32_t i = 0; i < command.matchLength; i++)
+		{
+			if (outputPosition >= outputSize)
+			{
+				return false;
+			}
+
+			output[outputPosition] = output[outputPosition - command.matchOffset];
+			outputPosition++;
+		}
+	}
+
+	return outputPosition == outputSize;
+}
+
+bool QFSCompression::Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& output)
+{
+	if (size > kMaxUncompressedSize)
+	{
+		return false;
+	}
+
+	output.clear();
+	output.reserve(size + (size / 100) + 16);
+
+	// The compressed size is written after the data is compressed.
+	output.resize(kCompressedSizePrefix);
+	output.push_back(0x10);
+	output.push_back(kSignature);
+	output.push_back(static_cast<uint8_t>(size >> 16));
+	output.push_back(static_cast<uint8_t>(size >> 8));
+	output.push_back(static_cast<uint8_t>(size));
+
+	// The most recent position of each 3 byte sequence.
+	std::vector<uint32_t> lastPositions(65536, UINT32_MAX);
+
+	const uint8_t* const end = data + size;
+	const uint8_t* literals = data;
+	const uint8_t* current = data;
+
+	while (end - current >= 3)
+	{
+		const uint32_t position = static_cast<uint32_t>(current - data);
+		const uint32_t hash = HashBytes(current);
+		const uint32_t candidate = lastPositions[hash];
+		lastPositions[hash] = position;
+
+		uint32_t length = 0;
+		const uint32_t offset = position - candidate;
+
+		if (candidate != UINT32_MAX && offset <= kMaxLongMatchOffset)
+		{
+			const uint32_t maxLength = std::min(static_cast<uint32_t>(end - current), kMaxLongMatchLength);
+			const uint8_t* match = data + candidate;
+
+			while (length < maxLength && match[length] == current[length])
+			{
+				length++;
+			}
+		}
+
+		if (!IsEncodableMatch(length, offset))
+		{
+			current++;
+			continue;
+		}
+
+		literals = AppendLiteralRuns(output, literals, current);
+		AppendMatchCommand(output, static_cast<uint32_t>(current - literals), length, offset);
+		output.insert(output.end(), literals, current);
+
+		// Index the positions inside the match so that later data can refer to them.
+		const uint8_t* const matchEnd = current + length;
+
+		for (current++; current < matchEnd && end - current >= 3; current++)
+		{
+			lastPositions[HashBytes(current)] = static_cast<uint32_t>(current - data);
+		}
+
+		current = matchEnd;
+		literals = current;
+	}
+
+	literals = AppendLiteralRuns(output, literals, end);
+	output.push_back(static_cast<uint8_t>(0xfc | (end - literals)));
+	output.insert(output.end(), literals, end);
+
+	const uint32_t compressedSize = static_cast<uint32_t>(output.size());
+	std::memcpy(output.data(), &compressedSize, sizeof(compressedSize));
+
+	return true;
+}
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// The QFS (RefPack) compression that is used for the DBPF entries of the SimCity 4
+// save games and plugins.
+//
+// A compressed entry starts with its compressed size as a little-endian uint32, followed by
+// the 0x10FB signature, the big-endian uncompressed size and the RefPack command stream.
+namespace QFSCompression
+{
+	/**
+	 * @brief Determines whether the data starts with a QFS header.
+	 */
+	bool IsCompressed(const uint8_t* data, size_t size);
+
+	/**
+	 * @brief Reads the uncompressed size from the QFS header.
+	 * @return True on success; otherwise, false if the data does not start with a QFS header.
+	 */
+	bool GetUncompressedSize(const uint8_t* data, size_t size, uint32_t& uncompressedSize);
+
+	/**
+	 * @brief Decompresses QFS data.
+	 * @param data The compressed data, including the QFS header.
+	 * @param size The size of the compressed data.
+	 * @param output The output buffer.
+	 * @param outputSize The size of the output buffer, it must be the uncompressed size in the header.
+	 * @return True on success; otherwise, false if the data is not valid.
+	 * The literal and match copies use 8 and 16 byte moves when the remaining output allows it,
+	 * every command is checked against the input and output bounds before it is copied.
+	 */
+	bool Decompress(const uint8_t* data, size_t size, uint8_t* output, size_t outputSize);
+
+	/**
+	 * @brief Decompresses QFS data into a buffer that is resized to the uncompressed size.
+	 * The buffer keeps its capacity, reusing it for several entries avoids reallocating.
+	 * @return True on success; otherwise, false if the data is not valid.
+	 */
+	bool Decompress(const uint8_t* data, size_t size, std::vector<uint8_t>& output);
+
+	/**
+	 * @brief Decompresses QFS data one byte at a time, the reference for Decompress.
+	 * @return True on success; otherwise, false if the data is not valid.
+	 */
+	bool DecompressReference(const uint8_t* data, size_t size, uint8_t* output, size_t outputSize);
+
+	/**
+	 * @brief Compresses data with a greedy match search.
+	 * @param data The uncompressed data, at most 16 MB.
+	 * @param size The size of the uncompressed data.
+	 * @param output Receives the compressed data, including the QFS header.
+	 * @return True on success; otherwise, false if the data is too large.
+	 */
+	bool Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& output);
+}
@@ -0,0 +1,410 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "RegionScanner.h"
+#include "DBPFExemplar.h"
+#include "ParknRideOrdinance.h"
+#include "Stopwatch.h"
+#include "TrafficSimulatorTuning.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <numeric>
+#include <string>
+#include <system_error>
+
+namespace
+{
+	bool IsSaveGame(const std::filesystem::path& path)
+	{
+		std::string extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+
+		return extension == ".sc4";
+	}
+
+	void WriteJsonString(std::ostream& stream, const std::string& value)
+	{
+		stream << '"';
+
+		for (const char c : value)
+		{
+			switch (c)
+			{
+			case '"':
+				stream << "\\\"";
+				break;
+			case '\\':
+				stream << "\\\\";
+				break;
+			case '\n':
+				stream << "\\n";
+				break;
+			case '\r':
+				stream << "\\r";
+				break;
+			case '\t':
+				stream << "\\t";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					char escaped[8]{};
+					std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+					stream << escaped;
+				}
+				else
+				{
+					stream << c;
+				}
+				break;
+			}
+		}
+
+		stream << '"';
+	}
+
+	void WriteCsvString(std::ostream& stream, const std::string& value)
+	{
+		stream << '"';
+
+		for (const char c : value)
+		{
+			if (c == '"')
+			{
+				stream << '"';
+			}
+
+			stream << c;
+		}
+
+		stream << '"';
+	}
+
+	const char* FormatBool(bool value)
+	{
+		return value ? "true" : "false";
+	}
+
+	std::string FormatDouble(double value)
+	{
+		char buffer[32]{};
+		std::snprintf(buffer, sizeof(buffer), "%.7g", value);
+
+		return buffer;
+	}
+
+	std::string FormatHex(uint32_t value)
+	{
+		char buffer[16]{};
+		std::snprintf(buffer, sizeof(buffer), "0x%08x", value);
+
+		return buffer;
+	}
+
+	void WriteBoolArray(std::ostream& stream, const std::vector<bool>& values, char separator)
+	{
+		for (size_t i = 0; i < values.size(); i++)
+		{
+			if (i > 0)
+			{
+				stream << separator;
+			}
+
+			stream << FormatBool(values[i]);
+		}
+	}
+
+	void WriteJsonOrdinance(std::ostream& stream, const SaveGameInspector::Result& ordinance)
+	{
+		stream << "\"ordinance\": {\"found\": " << FormatBool(ordinance.found);
+
+		if (ordinance.found)
+		{
+			const OrdinanceStateReader::OrdinanceState& state = ordinance.state;
+
+			stream << ", \"name\": ";
+			WriteJsonString(stream, state.name);
+			stream
+				<< ", \"version\": " << state.version
+				<< ", \"propertyHolderVersion\": " << state.propertyHolderVersion
+				<< ", \"enacted\": " << FormatBool(state.on)
+				<< ", \"available\": " << FormatBool(state.available)
+				<< ", \"enabled\": " << FormatBool(state.enabled)
+				<< ", \"monthlyConstantIncome\": " << state.monthlyConstantIncome
+				<< ", \"effects\": [";
+
+			for (size_t i = 0; i < state.effects.size(); i++)
+			{
+				const OrdinanceStateReader::Effect& effect = state.effects[i];
+
+				stream << (i > 0 ? ", " : "") << "{\"id\": \"" << FormatHex(effect.propertyID) << "\", \"values\": [";
+
+				for (size_t j = 0; j < effect.values.size(); j++)
+				{
+					stream << (j > 0 ? ", " : "") << FormatDouble(effect.values[j]);
+				}
+
+				stream << "]}";
+			}
+
+			stream << ']';
+		}
+
+		stream << '}';
+	}
+}
+
+RegionScanner::RegionScanner(uint32_t threadCount)
+	: pool(threadCount),
+	  statistics()
+{
+}
+
+bool RegionScanner::FindSaveGames(const std::filesystem::path& folder, std::vector<std::filesystem::path>& paths)
+{
+	paths.clear();
+
+	std::error_code ec;
+	std::filesystem::recursive_directory_iterator iterator(folder, ec);
+
+	if (ec)
+	{
+		return false;
+	}
+
+	for (const std::filesystem::directory_entry& item : iterator)
+	{
+		if (item.is_regular_file(ec) && IsSaveGame(item.path()))
+		{
+			paths.push_back(item.path());
+		}
+	}
+
+	std::sort(paths.begin(), paths.end());
+	return true;
+}
+
+void RegionScanner::Scan(const std::vector<std::filesystem::path>& paths, std::vector<CityResult>& results)
+{
+	Stopwatch stopwatch;
+	stopwatch.Start();
+
+	results.clear();
+	results.resize(paths.size());
+
+	std::error_code ec;
+
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		results[i].path = paths[i];
+		results[i].fileSize = std::filesystem::file_size(paths[i], ec);
+
+		if (ec)
+		{
+			results[i].fileSize = 0;
+		}
+	}
+
+	// The largest save games are dealt out first, so that each worker starts with a
+	// similar amount of work and the small ones fill the gaps at the end.
+	std::vector<size_t> order(paths.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return results[a].fileSize > results[b].fileSize; });
+
+	std::vector<std::vector<uint8_t>> buffers(pool.GetThreadCount());
+
+	pool.ParallelFor(order.size(), [&](size_t index, uint32_t worker)
+	{
+		ScanSaveGame(results[order[index]], buffers[worker]);
+	});
+
+	stopwatch.Stop();
+
+	statistics.threadCount = pool.GetThreadCount();
+	statistics.totalBytes = std::accumulate(
+		results.begin(),
+		results.end(),
+		uint64_t(0),
+		[](uint64_t total, const CityResult& result) { return total + result.fileSize; });
+	statistics.elapsedMilliseconds = stopwatch.ElapsedMilliseconds();
+	statistics.stolenItems = pool.GetStolenItemCount();
+}
+
+const RegionScanner::Statistics& RegionScanner::GetStatistics() const
+{
+	return statistics;
+}
+
+bool RegionScanner::WriteJson(std::ostream& stream, const std::vector<CityResult>& results)
+{
+	uint32_t enacted = 0;
+	uint32_t notFound = 0;
+	uint32_t unreadable = 0;
+	uint32_t trafficTuningOverrides = 0;
+
+	stream << "{\n  \"cities\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const CityResult& result = results[i];
+
+		stream << "    {\"path\": ";
+		WriteJsonString(stream, result.path.generic_string());
+		stream << ", \"fileSize\": " << result.fileSize << ", \"readable\": " << FormatBool(result.readable);
+
+		if (result.readable)
+		{
+			stream << ", ";
+			WriteJsonOrdinance(stream, result.ordinance);
+
+			stream << ", \"trafficTuningOverride\": {\"present\": " << FormatBool(result.trafficTuning.present);
+
+			if (result.trafficTuning.present)
+			{
+				stream << ", \"valid\": " << FormatBool(result.trafficTuning.valid) << ", \"travelTypeCanReachDestination\": [";
+				WriteBoolArray(stream, result.trafficTuning.travelTypeCanReachDestination, ',');
+				stream << ']';
+			}
+
+			stream << '}';
+
+			if (!result.ordinance.found)
+			{
+				notFound++;
+			}
+			else if (result.ordinance.state.on)
+			{
+				enacted++;
+			}
+
+			if (result.trafficTuning.present)
+			{
+				trafficTuningOverrides++;
+			}
+		}
+		else
+		{
+			unreadable++;
+		}
+
+		stream << '}' << (i + 1 < results.size() ? "," : "") << '\n';
+	}
+
+	stream
+		<< "  ],\n  \"summary\": {\"cities\": " << results.size()
+		<< ", \"enacted\": " << enacted
+		<< ", \"notFound\": " << notFound
+		<< ", \"unreadable\": " << unreadable
+		<< ", \"trafficTuningOverrides\": " << trafficTuningOverrides
+		<< "}\n}\n";
+
+	return static_cast<bool>(stream);
+}
+
+bool RegionScanner::WriteCsv(std::ostream& stream, const std::vector<CityResult>& results)
+{
+	stream << "Path,File Size,Readable,Ordinance Found,Enacted,Available,Enabled,State Version,"
+		"Property Holder Version,Effects,Monthly Constant Income,Traffic Tuning Override,Travel Type Can Reach Destination\n";
+
+	for (const CityResult& result : results)
+	{
+		const SaveGameInspector::Result& ordinance = result.ordinance;
+		const OrdinanceStateReader::OrdinanceState& state = ordinance.state;
+		const bool found = result.readable && ordinance.found;
+
+		WriteCsvString(stream, result.path.generic_string());
+		stream
+			<< ',' << result.fileSize
+			<< ',' << FormatBool(result.readable)
+			<< ',' << FormatBool(found);
+
+		if (found)
+		{
+			stream
+				<< ',' << FormatBool(state.on)
+				<< ',' << FormatBool(state.available)
+				<< ',' << FormatBool(state.enabled)
+				<< ',' << state.version
+				<< ',' << state.propertyHolderVersion
+				<< ',' << state.effects.size()
+				<< ',' << state.monthlyConstantIncome;
+		}
+		else
+		{
+			stream << ",,,,,,,";
+		}
+
+		const bool overridePresent = result.readable && result.trafficTuning.present;
+
+		stream << ',' << FormatBool(overridePresent) << ",\"";
+
+		if (overridePresent)
+		{
+			WriteBoolArray(stream, result.trafficTuning.travelTypeCanReachDestination, ' ');
+		}
+
+		stream << "\"\n";
+	}
+
+	return static_cast<bool>(stream);
+}
+
+void RegionScanner::ScanSaveGame(CityResult& result, std::vector<uint8_t>& buffer)
+{
+	result.readable = false;
+	result.ordinance = SaveGameInspector::Result{};
+	result.trafficTuning = TrafficTuningOverride{};
+
+	DBPFFile file;
+
+	if (!file.Open(result.path))
+	{
+		return;
+	}
+
+	result.readable = true;
+	SaveGameInspector::FindOrdinance(file, kParknRideOrdinanceCLSID, buffer, result.ordinance);
+
+	const DBPFFile::ResourceKey tuningKey
+	{
+		TrafficSimulatorTuning::kType,
+		TrafficSimulatorTuning::kGroup,
+		TrafficSimulatorTuning::kInstance,
+	};
+
+	DBPFFile::IndexEntry entry{};
+
+	if (file.FindEntry(tuningKey, entry))
+	{
+		result.trafficTuning.present = true;
+
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+		DBPFExemplar exemplar;
+
+		if (file.ReadEntryData(entry, buffer, data, size) && exemplar.Parse(data, size))
+		{
+			const DBPFExemplar::Property* property = exemplar.FindProperty(TrafficSimulatorTuning::kTravelTypeCanReachDestination);
+
+			if (property && property->type == DBPFExemplar::ValueType::Bool && property->isArray)
+			{
+				result.trafficTuning.valid = true;
+
+				for (uint8_t value : property->values)
+				{
+					result.trafficTuning.travelTypeCanReachDestination.push_back(value != 0);
+				}
+			}
+		}
+	}
+}
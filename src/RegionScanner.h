@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "SaveGameInspector.h"
+#include "WorkStealingPool.h"
+#include <filesystem>
+#include <ostream>
+#include <vector>
+
+// Inspects every save game in a region folder on several threads.
+//
+// Each save game is memory-mapped and each worker reuses one buffer for the compressed
+// entries, so the memory use does not depend on the number of save games.
+class RegionScanner
+{
+public:
+
+	// A copy of the traffic simulator tuning exemplar that is stored in a save game.
+	struct TrafficTuningOverride
+	{
+		bool present;
+		// The entry is a binary exemplar with a Travel type can reach destination Boolean array.
+		bool valid;
+		std::vector<bool> travelTypeCanReachDestination;
+	};
+
+	struct CityResult
+	{
+		std::filesystem::path path;
+		uint64_t fileSize;
+		bool readable;
+		SaveGameInspector::Result ordinance;
+		TrafficTuningOverride trafficTuning;
+	};
+
+	struct Statistics
+	{
+		uint32_t threadCount;
+		uint64_t totalBytes;
+		int64_t elapsedMilliseconds;
+		uint64_t stolenItems;
+	};
+
+	/**
+	 * @brief Initializes the scanner.
+	 * @param threadCount The number of worker threads, 0 uses the number of hardware threads.
+	 */
+	explicit RegionScanner(uint32_t threadCount);
+
+	/**
+	 * @brief Finds the save games in a folder and its subfolders.
+	 * @param folder The region folder.
+	 * @param paths Receives the save game paths, sorted by name.
+	 * @return True on success; otherwise, false if the folder could not be read.
+	 */
+	static bool FindSaveGames(const std::filesystem::path& folder, std::vector<std::filesystem::path>& paths);
+
+	/**
+	 * @brief Inspects the save games.
+	 * @param paths The save game paths.
+	 * @param results Receives one result per save game, in the same order as the paths.
+	 */
+	void Scan(const std::vector<std::filesystem::path>& paths, std::vector<CityResult>& results);
+
+	const Statistics& GetStatistics() const;
+
+	static bool WriteJson(std::ostream& stream, const std::vector<CityResult>& results);
+
+	static bool WriteCsv(std::ostream& stream, const std::vector<CityResult>& results);
+
+private:
+
+	static void ScanSaveGame(CityResult& result, std::vector<uint8_t>& buffer);
+
+	WorkStealingPool pool;
+	Statistics statistics;
+};
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "ResponseCurve.h"
+#include <algorithm>
+
+ResponseCurve::ResponseCurve()
+	: controlPoints(),
+	  minX(0.0f),
+	  scale(0.0f),
+	  table()
+{
+}
+
+bool ResponseCurve::SetControlPoints(const float* controlPoints, uint32_t pointCount)
+{
+	Clear();
+
+	if (!controlPoints || pointCount == 0)
+	{
+		return false;
+	}
+
+	for (uint32_t i = 1; i < pointCount; i++)
+	{
+		// The negated comparison also rejects NaN.
+		if (!(controlPoints[(i - 1) * 2] <= controlPoints[i * 2]))
+		{
+			return false;
+		}
+	}
+
+	this->controlPoints.assign(controlPoints, controlPoints + (static_cast<size_t>(pointCount) * 2));
+
+	minX = controlPoints[0];
+	const float maxX = controlPoints[(pointCount - 1) * 2];
+	const float range = maxX - minX;
+
+	scale = range > 0.0f ? static_cast<float>(kTableIntervals) / range : 0.0f;
+
+	for (uint32_t i = 0; i <= kTableIntervals; i++)
+	{
+		const float x = range > 0.0f ? minX + ((range * static_cast<float>(i)) / static_cast<float>(kTableIntervals)) : minX;
+
+		table[i] = EvaluateControlPoints(x);
+	}
+
+	table[kTableIntervals + 1] = table[kTableIntervals];
+
+	return true;
+}
+
+void ResponseCurve::Clear()
+{
+	controlPoints.clear();
+	minX = 0.0f;
+	scale = 0.0f;
+	table.fill(0.0f);
+}
+
+bool ResponseCurve::IsEmpty() const
+{
+	return controlPoints.empty();
+}
+
+float ResponseCurve::Evaluate(float x) const
+{
+	// The operand order of the clamp maps NaN to the start of the table, both
+	// calls compile to a single min or max instruction.
+	const float position = std::min(static_cast<float>(kTableIntervals), std::max(0.0f, (x - minX) * scale));
+	const uint32_t index = static_cast<uint32_t>(position);
+	const float fraction = position - static_cast<float>(index);
+
+	return table[index] + ((table[index + 1] - table[index]) * fraction);
+}
+
+float ResponseCurve::EvaluateControlPoints(float x) const
+{
+	const size_t pointCount = controlPoints.size() / 2;
+
+	if (pointCount == 0)
+	{
+		return 0.0f;
+	}
+
+	if (!(x > controlPoints[0]))
+	{
+		return controlPoints[1];
+	}
+
+	for (size_t i = 1; i < pointCount; i++)
+	{
+		const float x1 = controlPoints[i * 2];
+
+		if (x <= x1)
+		{
+			const float x0 = controlPoints[(i - 1) * 2];
+			const float y0 = controlPoints[((i - 1) * 2) + 1];
+			const float y1 = controlPoints[(i * 2) + 1];
+
+			return x1 > x0 ? y0 + ((y1 - y0) * ((x - x0) / (x1 - x0))) : y1;
+		}
+	}
+
+	return controlPoints[((pointCount - 1) * 2) + 1];
+}
+
+const std::vector<float>& ResponseCurve::GetControlPoints() const
+{
+	return controlPoints;
+}
@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <array>
+#include <stdint.h>
+#include <vector>
+
+// A general response curve, e.g. the Health Effectiveness vs. Distance Effect.
+//
+// The game stores a curve as a Float32 array of x and y pairs, and interpolates linearly
+// between the control points. The curve is sampled into a fixed-resolution table when the
+// control points are set, so evaluating it is a clamp and one interpolation between two
+// table entries instead of a search for the control point interval.
+class ResponseCurve
+{
+public:
+
+	// The number of intervals in the lookup table.
+	static constexpr uint32_t kTableIntervals = 1024;
+
+	ResponseCurve();
+
+	/**
+	 * @brief Sets the control points and builds the lookup table.
+	 * @param controlPoints The x and y value of each point, the x values must be in ascending order.
+	 * @param pointCount The number of points.
+	 * @return True on success; otherwise, false if there are no points or the x values are not ascending.
+	 */
+	bool SetControlPoints(const float* controlPoints, uint32_t pointCount);
+
+	void Clear();
+
+	bool IsEmpty() const;
+
+	/**
+	 * @brief Evaluates the curve from the lookup table.
+	 * @param x The input value, values outside of the control points use the first or last point.
+	 * @return The interpolated value.
+	 */
+	float Evaluate(float x) const;
+
+	/**
+	 * @brief Evaluates the curve by interpolating between the control points.
+	 * This is the reference that the lookup table is measured against.
+	 * @param x The input value, values outside of the control points use the first or last point.
+	 * @return The interpolated value.
+	 */
+	float EvaluateControlPoints(float x) const;
+
+	// Gets the x and y value of each control point.
+	const std::vector<float>& GetControlPoints() const;
+
+private:
+
+	std::vector<float> controlPoints;
+	float minX;
+	// Converts an x value to a table position.
+	float scale;
+	// The last entry repeats the end of the curve, so the interpolation never needs a bounds check.
+	std::array<float, kTableIntervals + 2> table;
+};
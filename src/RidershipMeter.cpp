@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "RidershipMeter.h"
+#include "Settings.h"
+#include "TransitSwitchIndex.h"
+#include "cISC4City.h"
+#include "cISC4Simulator.h"
+#include "cISC4TrafficSimulator.h"
+
+namespace
+{
+	constexpr uint32_t kRidershipMeterServiceID = 0x5e0a9c47;
+
+	// The sampling is cheap, so it runs with the default priority.
+	constexpr int32_t kRidershipMeterServicePriority = 0;
+}
+
+RidershipMeter::RidershipMeter()
+	: TickServiceBase(kRidershipMeterServiceID, kRidershipMeterServicePriority),
+	  logger(Logger::GetInstance()),
+	  pCity(nullptr),
+	  pTransitSwitchIndex(nullptr),
+	  switchesPerDay(0),
+	  lastSimDate(0),
+	  tripScale(1.0f),
+	  sampledSwitchCount(0)
+{
+}
+
+bool RidershipMeter::Start(cISC4City* pCity, TransitSwitchIndex* pTransitSwitchIndex, const Settings& settings)
+{
+	Stop();
+
+	if (!pCity || !pTransitSwitchIndex)
+	{
+		return false;
+	}
+
+	cISC4Simulator* pSimulator = pCity->GetSimulator();
+
+	if (!pSimulator)
+	{
+		logger.WriteLine(LogOptions::Errors, "The cISC4Simulator pointer was null.");
+		return false;
+	}
+
+	this->pCity = pCity;
+	this->pTransitSwitchIndex = pTransitSwitchIndex;
+	switchesPerDay = settings.transitSwitchesPerDay;
+	lastSimDate = pSimulator->GetSimDateNumber();
+	sampledSwitchCount = 0;
+
+	// The first pass reads every switch, so the usage is known before the first budget query.
+	if (pTransitSwitchIndex->UpdateUtilization())
+	{
+		sampledSwitchCount += pTransitSwitchIndex->GetCount();
+	}
+
+	cISC4TrafficSimulator* pTrafficSimulator = pCity->GetTrafficSimulator();
+	tripScale = pTrafficSimulator ? pTrafficSimulator->GetTripScale() : 1.0f;
+
+	if (!RegisterTick())
+	{
+		logger.WriteLine(LogOptions::Errors, "Failed to register the ridership meter tick service.");
+		Stop();
+		return false;
+	}
+
+	logger.WriteLineFormatted(
+		LogOptions::Info,
+		"Park & Ride ridership meter: sampling %u transit switches per day.",
+		switchesPerDay);
+
+	return true;
+}
+
+void RidershipMeter::Stop()
+{
+	UnregisterTick();
+
+	pCity = nullptr;
+	pTransitSwitchIndex = nullptr;
+	tripScale = 1.0f;
+}
+
+bool RidershipMeter::IsStarted() const
+{
+	return pCity != nullptr;
+}
+
+double RidershipMeter::GetTransitTrips() const
+{
+	if (!pTransitSwitchIndex)
+	{
+		return 0.0;
+	}
+
+	return static_cast<double>(pTransitSwitchIndex->GetTotalUtilization().arrived) * static_cast<double>(tripScale);
+}
+
+double RidershipMeter::GetTransitUtilization() const
+{
+	if (!pTransitSwitchIndex)
+	{
+		return 0.0;
+	}
+
+	return pTransitSwitchIndex->GetTotalUtilization().GetUtilization();
+}
+
+uint64_t RidershipMeter::GetSampledSwitchCount() const
+{
+	return sampledSwitchCount;
+}
+
+bool RidershipMeter::Shutdown()
+{
+	Stop();
+	return true;
+}
+
+bool RidershipMeter::OnTick()
+{
+	if (!pCity)
+	{
+		return true;
+	}
+
+	cISC4Simulator* pSimulator = pCity->GetSimulator();
+
+	if (!pSimulator)
+	{
+		return true;
+	}
+
+	// The sampling is driven by the simulation date, so nothing is sampled while the game is paused.
+	const int32_t simDate = pSimulator->GetSimDateNumber();
+
+	if (simDate != lastSimDate)
+	{
+		lastSimDate = simDate;
+		Sample();
+	}
+
+	return true;
+}
+
+void RidershipMeter::Sample()
+{
+	// Adds the transit switches that were built since the last sample.
+	pTransitSwitchIndex->Update();
+
+	sampledSwitchCount += pTransitSwitchIndex->SampleUtilization(switchesPerDay);
+
+	cISC4TrafficSimulator* pTrafficSimulator = pCity->GetTrafficSimulator();
+
+	if (pTrafficSimulator)
+	{
+		tripScale = pTrafficSimulator->GetTripScale();
+	}
+}
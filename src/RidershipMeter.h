@@ -0,0 +1,79 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Logger.h"
+#include "TickServiceBase.h"
+
+class cISC4City;
+class Settings;
+class TransitSwitchIndex;
+
+// Measures the park and ride usage for the ridership-based ordinance cost and effects, and the traffic reports.
+//
+// The meter is a framework tick service that reads the arrived traffic of a few transit
+// switches each time the simulation date advances, the transit switch index adjusts its
+// city-wide totals as each switch is read. Getting the usage is a multiplication of the
+// totals by the trip scale, so the budget queries never visit the transit switches.
+class RidershipMeter final : public TickServiceBase
+{
+public:
+
+	RidershipMeter();
+
+	/**
+	 * @brief Starts measuring the transit switch usage in the specified city.
+	 * @param pCity The city.
+	 * @param pTransitSwitchIndex The transit switches of the city.
+	 * @param settings The transit switch sampling settings.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Start(cISC4City* pCity, TransitSwitchIndex* pTransitSwitchIndex, const Settings& settings);
+
+	/**
+	 * @brief Stops measuring, this must be called before the city is destroyed.
+	 */
+	void Stop();
+
+	bool IsStarted() const;
+
+	/**
+	 * @brief Gets the number of trips that arrived at the transit switches.
+	 * @return The arrived traffic of the transit switches multiplied by the traffic simulator trip scale.
+	 */
+	double GetTransitTrips() const;
+
+	/**
+	 * @brief Gets the share of the transit switch trip capacity that is used.
+	 * @return The arrived traffic of the transit switches divided by their trip capacity.
+	 */
+	double GetTransitUtilization() const;
+
+	// The number of transit switch reads since the meter was started.
+	uint64_t GetSampledSwitchCount() const;
+
+	bool Shutdown() override;
+	bool OnTick() override;
+
+private:
+
+	void Sample();
+
+	Logger& logger;
+	cISC4City* pCity;
+	TransitSwitchIndex* pTransitSwitchIndex;
+	uint32_t switchesPerDay;
+	int32_t lastSimDate;
+	// The trip scale is read with each sample, the traffic simulator changes it as the city grows.
+	float tripScale;
+	uint64_t sampledSwitchCount;
+};
@@ -0,0 +1,281 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "RushHourScheduler.h"
+#include "ParknRideOrdinance.h"
+#include "Settings.h"
+#include "Stopwatch.h"
+#include "cISC424HourClock.h"
+#include "cISC4City.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr uint32_t kRushHourSchedulerServiceID = 0x6d2a84e1;
+
+	// Reading the clock is cheap, so the scheduler runs with the default priority.
+	constexpr int32_t kRushHourSchedulerServicePriority = 0;
+
+	constexpr uint32_t kHoursPerDay = 24;
+	constexpr uint32_t kAllHoursMask = (1u << kHoursPerDay) - 1;
+
+	// Forces the first tick to evaluate the current hour.
+	constexpr uint32_t kInvalidHour = UINT32_MAX;
+
+	// A single slow switch can be caused by something else running in the same frame,
+	// the scheduler only falls back after this many over-budget switches in a row.
+	constexpr uint32_t kOverBudgetSwitchLimit = 3;
+}
+
+RushHourScheduler::RushHourScheduler()
+	: TickServiceBase(kRushHourSchedulerServiceID, kRushHourSchedulerServicePriority),
+	  logger(Logger::GetInstance()),
+	  pCity(nullptr),
+	  pOrdinance(nullptr),
+	  activeHourMask(0),
+	  dailySpanMask(0),
+	  lastHour(kInvalidHour),
+	  switchBudgetMicroseconds(0),
+	  switchCount(0),
+	  overBudgetSwitches(0),
+	  lastSwitchMicroseconds(0),
+	  maxSwitchMicroseconds(0),
+	  dailyFallbackActive(false)
+{
+}
+
+bool RushHourScheduler::Start(cISC4City* pCity, ParknRideOrdinance* pOrdinance, const Settings& settings)
+{
+	Stop();
+
+	if (!pCity || !pOrdinance)
+	{
+		return false;
+	}
+
+	if (!pCity->Get24HourClock())
+	{
+		logger.WriteLine(LogOptions::Errors, "The cISC424HourClock pointer was null.");
+		return false;
+	}
+
+	this->pCity = pCity;
+	this->pOrdinance = pOrdinance;
+	activeHourMask = settings.rushHourMask & kAllHoursMask;
+	dailySpanMask = GetDailySpan(activeHourMask);
+	lastHour = kInvalidHour;
+	switchBudgetMicroseconds = static_cast<int64_t>(settings.rushHourSwitchBudgetMicroseconds);
+	switchCount = 0;
+	overBudgetSwitches = 0;
+	lastSwitchMicroseconds = 0;
+	maxSwitchMicroseconds = 0;
+	dailyFallbackActive = false;
+
+	if (!RegisterTick())
+	{
+		logger.WriteLine(LogOptions::Errors, "Failed to register the rush hour scheduler tick service.");
+		Stop();
+		return false;
+	}
+
+	logger.WriteLineFormatted(
+		LogOptions::Info,
+		"Park & Ride rush hours: hour mask 0x%06x, switch budget %lld us.",
+		activeHourMask,
+		switchBudgetMicroseconds);
+
+	return true;
+}
+
+void RushHourScheduler::Stop()
+{
+	UnregisterTick();
+
+	pCity = nullptr;
+	pOrdinance = nullptr;
+}
+
+uint32_t RushHourScheduler::GetActiveHourMask() const
+{
+	return activeHourMask;
+}
+
+bool RushHourScheduler::IsDailyFallbackActive() const
+{
+	return dailyFallbackActive;
+}
+
+uint32_t RushHourScheduler::GetSwitchCount() const
+{
+	return switchCount;
+}
+
+int64_t RushHourScheduler::GetLastSwitchMicroseconds() const
+{
+	return lastSwitchMicroseconds;
+}
+
+int64_t RushHourScheduler::GetMaxSwitchMicroseconds() const
+{
+	return maxSwitchMicroseconds;
+}
+
+uint32_t RushHourScheduler::GetDailySpan(uint32_t hourMask)
+{
+	hourMask &= kAllHoursMask;
+
+	if (hourMask == 0 || hourMask == kAllHoursMask)
+	{
+		return hourMask;
+	}
+
+	// Find the longest run of unset hours, starting the scan after a set hour
+	// allows a run that wraps around midnight to be measured in one piece.
+	uint32_t firstSetHour = 0;
+
+	while ((hourMask & (1u << firstSetHour)) == 0)
+	{
+		firstSetHour++;
+	}
+
+	uint32_t longestGapStart = 0;
+	uint32_t longestGapLength = 0;
+	uint32_t gapStart = 0;
+	uint32_t gapLength = 0;
+
+	for (uint32_t i = 1; i <= kHoursPerDay; i++)
+	{
+		const uint32_t hour = (firstSetHour + i) % kHoursPerDay;
+
+		if ((hourMask & (1u << hour)) == 0)
+		{
+			if (gapLength == 0)
+			{
+				gapStart = hour;
+			}
+
+			gapLength++;
+
+			if (gapLength > longestGapLength)
+			{
+				longestGapStart = gapStart;
+				longestGapLength = gapLength;
+			}
+		}
+		else
+		{
+			gapLength = 0;
+		}
+	}
+
+	uint32_t spanMask = kAllHoursMask;
+
+	for (uint32_t i = 0; i < longestGapLength; i++)
+	{
+		spanMask &= ~(1u << ((longestGapStart + i) % kHoursPerDay));
+	}
+
+	return spanMask;
+}
+
+bool RushHourScheduler::Shutdown()
+{
+	Stop();
+	return true;
+}
+
+bool RushHourScheduler::OnTick()
+{
+	if (!pCity)
+	{
+		return true;
+	}
+
+	cISC424HourClock* pClock = pCity->Get24HourClock();
+
+	if (!pClock)
+	{
+		return true;
+	}
+
+	// The restriction can only change at the start of an hour.
+	const uint32_t hour = pClock->GetHour();
+
+	if (hour == lastHour || hour >= kHoursPerDay)
+	{
+		return true;
+	}
+
+	lastHour = hour;
+
+	const bool restrictionActive = (activeHourMask & (1u << hour)) != 0;
+
+	if (restrictionActive == pOrdinance->IsRushHourRestrictionActive())
+	{
+		return true;
+	}
+
+	Stopwatch stopwatch;
+	stopwatch.Start();
+
+	const bool switched = pOrdinance->SetRushHourRestrictionActive(restrictionActive);
+
+	stopwatch.Stop();
+
+	// Nothing is sent to the traffic simulator while the ordinance is repealed.
+	if (switched)
+	{
+		RecordSwitchCost(hour, restrictionActive, stopwatch.ElapsedMicroseconds());
+	}
+
+	return true;
+}
+
+void RushHourScheduler::RecordSwitchCost(uint32_t hour, bool restrictionActive, int64_t elapsedMicroseconds)
+{
+	switchCount++;
+	lastSwitchMicroseconds = elapsedMicroseconds;
+	maxSwitchMicroseconds = std::max(maxSwitchMicroseconds, elapsedMicroseconds);
+
+	logger.WriteLineFormatted(
+		LogOptions::Profiling,
+		"Rush hour switch at %02u:00: %s cars in %lld us (budget %lld us).",
+		hour,
+		restrictionActive ? "restricted" : "allowed",
+		elapsedMicroseconds,
+		switchBudgetMicroseconds);
+
+	if (elapsedMicroseconds <= switchBudgetMicroseconds)
+	{
+		overBudgetSwitches = 0;
+		return;
+	}
+
+	overBudgetSwitches++;
+
+	if (overBudgetSwitches >= kOverBudgetSwitchLimit
+		&& !dailyFallbackActive
+		&& dailySpanMask != activeHourMask)
+	{
+		logger.WriteLineFormatted(
+			LogOptions::Info,
+			"Park & Ride rush hours: %u switches in a row took longer than %lld us (last %lld us),"
+			" restricting cars once per day with hour mask 0x%06x.",
+			overBudgetSwitches,
+			switchBudgetMicroseconds,
+			elapsedMicroseconds,
+			dailySpanMask);
+
+		activeHourMask = dailySpanMask;
+		dailyFallbackActive = true;
+	}
+}
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Logger.h"
+#include "TickServiceBase.h"
+
+class cISC4City;
+class ParknRideOrdinance;
+class Settings;
+
+// Restricts cars only during the commuter windows of the in-game day.
+//
+// The scheduler is a framework tick service that reads the hour from the city's 24-hour
+// clock, the ordinance stays enacted for the whole day and its car restriction follows the
+// configured hours. Each switch makes the traffic simulator reload its tunable values, the
+// cost of every switch is measured and compared against the budget. When several switches in
+// a row exceed the budget the windows are merged into a single span, so the restriction only
+// changes once in each direction per day.
+class RushHourScheduler final : public TickServiceBase
+{
+public:
+
+	RushHourScheduler();
+
+	/**
+	 * @brief Starts following the 24-hour clock of the specified city.
+	 * @param pCity The city.
+	 * @param pOrdinance The ordinance that the scheduler controls.
+	 * @param settings The rush hour settings.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Start(cISC4City* pCity, ParknRideOrdinance* pOrdinance, const Settings& settings);
+
+	/**
+	 * @brief Stops following the city, this must be called before the city is destroyed.
+	 */
+	void Stop();
+
+	// Gets the hours in which cars are restricted, bit N is set for the hour starting at N:00.
+	uint32_t GetActiveHourMask() const;
+
+	bool IsDailyFallbackActive() const;
+
+	uint32_t GetSwitchCount() const;
+
+	int64_t GetLastSwitchMicroseconds() const;
+
+	int64_t GetMaxSwitchMicroseconds() const;
+
+	/**
+	 * @brief Gets the single span of hours that covers all of the specified hours.
+	 * The span excludes the longest run of unset hours, which may wrap around midnight.
+	 * @param hourMask The hours, bit N is set for the hour starting at N:00.
+	 * @return The hour mask of the span.
+	 */
+	static uint32_t GetDailySpan(uint32_t hourMask);
+
+	bool Shutdown() override;
+	bool OnTick() override;
+
+private:
+
+	void RecordSwitchCost(uint32_t hour, bool restrictionActive, int64_t elapsedMicroseconds);
+
+	Logger& logger;
+	cISC4City* pCity;
+	ParknRideOrdinance* pOrdinance;
+	uint32_t activeHourMask;
+	uint32_t dailySpanMask;
+	uint32_t lastHour;
+	int64_t switchBudgetMicroseconds;
+	uint32_t switchCount;
+	uint32_t overBudgetSwitches;
+	int64_t lastSwitchMicroseconds;
+	int64_t maxSwitchMicroseconds;
+	bool dailyFallbackActive;
+};
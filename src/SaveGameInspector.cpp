@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "SaveGameInspector.h"
+
+namespace
+{
+	bool FindOrdinanceInEntry(
+		const uint8_t* data,
+		size_t size,
+		uint32_t clsid,
+		OrdinanceStateReader::OrdinanceState& state)
+	{
+		size_t offset = 0;
+
+		while (OrdinanceStateReader::Find(data, size, clsid, offset))
+		{
+			size_t bytesRead = 0;
+
+			if (OrdinanceStateReader::Read(data + offset, size - offset, state, bytesRead))
+			{
+				return true;
+			}
+
+			// The class ID also matched other data, continue after it.
+			offset++;
+		}
+
+		return false;
+	}
+}
+
+bool SaveGameInspector::FindOrdinance(const DBPFFile& file, uint32_t clsid, Result& result)
+{
+	// The compressed entries are decompressed into the same buffer, the save games have
+	// thousands of entries and most of them are small.
+	std::vector<uint8_t> buffer;
+
+	return FindOrdinance(file, clsid, buffer, result);
+}
+
+bool SaveGameInspector::FindOrdinance(const DBPFFile& file, uint32_t clsid, std::vector<uint8_t>& buffer, Result& result)
+{
+	result.found = false;
+	result.entryKey = DBPFFile::ResourceKey{};
+	result.entriesSearched = 0;
+	result.compressedEntriesSearched = 0;
+	result.invalidEntries = 0;
+
+	const uint32_t entryCount = file.GetIndexEntryCount();
+
+	for (uint32_t i = 0; i < entryCount; i++)
+	{
+		const DBPFFile::IndexEntry entry = file.GetIndexEntry(i);
+
+		if (entry.key == DBPFFile::DirectoryKey)
+		{
+			continue;
+		}
+
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+
+		if (!file.ReadEntryData(entry, buffer, data, size))
+		{
+			result.invalidEntries++;
+			continue;
+		}
+
+		result.entriesSearched++;
+
+		if (file.IsCompressed(entry))
+		{
+			result.compressedEntriesSearched++;
+		}
+
+		if (FindOrdinanceInEntry(data, size, clsid, result.state))
+		{
+			result.found = true;
+			result.entryKey = entry.key;
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "DBPFFile.h"
+#include "OrdinanceStateReader.h"
+
+// Finds the state of an ordinance in a SimCity 4 save game.
+//
+// The layout of the ordinance simulator entry is not documented, so every entry is searched
+// for the start of an OrdinanceBase state with the ordinance class ID.
+namespace SaveGameInspector
+{
+	struct Result
+	{
+		bool found;
+		OrdinanceStateReader::OrdinanceState state;
+		// The entry that contains the ordinance state.
+		DBPFFile::ResourceKey entryKey;
+		uint32_t entriesSearched;
+		// The entries that were decompressed before they were searched.
+		uint32_t compressedEntriesSearched;
+		// The entries that are outside of the file or could not be decompressed.
+		uint32_t invalidEntries;
+	};
+
+	/**
+	 * @brief Searches the save game for the state of an ordinance.
+	 * @param file The open save game.
+	 * @param clsid The class ID of the ordinance.
+	 * @param result Receives the ordinance state and the search statistics.
+	 * @return True if the ordinance state was found; otherwise, false.
+	 */
+	bool FindOrdinance(const DBPFFile& file, uint32_t clsid, Result& result);
+
+	/**
+	 * @brief Searches the save game for the state of an ordinance.
+	 * @param file The open save game.
+	 * @param clsid The class ID of the ordinance.
+	 * @param buffer The buffer that the compressed entries are decompressed into.
+	 * @param result Receives the ordinance state and the search statistics.
+	 * @return True if the ordinance state was found; otherwise, false.
+	 */
+	bool FindOrdinance(const DBPFFile& file, uint32_t clsid, std::vector<uint8_t>& buffer, Result& result);
+}
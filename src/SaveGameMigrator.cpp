@@ -0,0 +1,452 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+
+#include "SaveGameMigrator.h"
+#include "DBPFWriter.h"
+#include "GZCLSIDDefs.h"
+#include "OrdinanceStateReader.h"
+#include "ParknRideOrdinance.h"
+#include "Platform.h"
+#include "QFSCompression.h"
+#include "Stopwatch.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <system_error>
+
+namespace
+{
+	constexpr uint64_t HeaderSize = 96;
+	constexpr uint64_t IndexEntrySize = 20;
+	constexpr uint64_t DirectoryEntrySize = 16;
+
+	// The game uses the class ID of a serialized simulator as the type of its save game entry.
+	// The ordinance states are only searched in that entry, the class ID of the ordinance can
+	// also match unrelated data in the other records.
+	constexpr uint32_t OrdinanceSimulatorEntryType = static_cast<uint32_t>(GZCLSID::kcSC4OrdinanceSimulator);
+
+	// A save game is rewritten instead of appended to when the old entries and indexes would
+	// take more than this fraction of the file.
+	constexpr uint64_t MaxUnusedSpaceDivisor = 4;
+
+	// The initialized, available, on and enabled flags that follow the property holder.
+	constexpr size_t TrailingFlagsSize = 4;
+
+	// The offset of the OrdinancePropertyHolder data in a serialized OrdinanceBase state:
+	// the version, class ID, name, description, five incomes, income factor and income flag.
+	size_t GetPropertyHolderOffset(const OrdinanceStateReader::OrdinanceState& state)
+	{
+		return sizeof(uint32_t)
+			+ sizeof(uint32_t)
+			+ sizeof(uint32_t) + state.name.size()
+			+ sizeof(uint32_t) + state.description.size()
+			+ (5 * sizeof(int64_t))
+			+ sizeof(float)
+			+ sizeof(uint8_t);
+	}
+
+	// The size of the directory and index that list the specified entries.
+	uint64_t GetIndexSize(uint64_t entryCount, uint64_t compressedEntryCount)
+	{
+		uint64_t size = entryCount * IndexEntrySize;
+
+		if (compressedEntryCount > 0)
+		{
+			size += IndexEntrySize + (compressedEntryCount * DirectoryEntrySize);
+		}
+
+		return size;
+	}
+}
+
+SaveGameMigrator::SaveGameMigrator(uint32_t threadCount, bool dryRun)
+	: pool(threadCount),
+	  dryRun(dryRun),
+	  statistics()
+{
+}
+
+void SaveGameMigrator::Migrate(const std::vector<std::filesystem::path>& paths, std::vector<FileResult>& results)
+{
+	Stopwatch stopwatch;
+	stopwatch.Start();
+
+	results.clear();
+	results.resize(paths.size());
+
+	std::error_code ec;
+
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		results[i].path = paths[i];
+		results[i].originalFileSize = std::filesystem::file_size(paths[i], ec);
+
+		if (ec)
+		{
+			results[i].originalFileSize = 0;
+		}
+	}
+
+	// The same ordering as the region scanner, the largest save games are started first.
+	std::vector<size_t> order(paths.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return results[a].originalFileSize > results[b].originalFileSize; });
+
+	std::vector<std::vector<uint8_t>> buffers(pool.GetThreadCount());
+
+	pool.ParallelFor(order.size(), [&](size_t index, uint32_t worker)
+	{
+		MigrateSaveGame(results[order[index]], buffers[worker]);
+	});
+
+	stopwatch.Stop();
+
+	statistics.threadCount = pool.GetThreadCount();
+	statistics.elapsedMilliseconds = stopwatch.ElapsedMilliseconds();
+	statistics.stolenItems = pool.GetStolenItemCount();
+}
+
+const SaveGameMigrator::Statistics& SaveGameMigrator::GetStatistics() const
+{
+	return statistics;
+}
+
+bool SaveGameMigrator::MigrateState(const uint8_t* data, size_t size, std::vector<uint8_t>& state, size_t& bytesRead)
+{
+	OrdinanceStateReader::OrdinanceState decoded;
+
+	if (!OrdinanceStateReader::Read(data, size, decoded, bytesRead))
+	{
+		return false;
+	}
+
+	state.assign(data, data + bytesRead);
+
+	// The OrdinanceBase format is still version 1, a new version would be converted here.
+
+	// OrdinancePropertyHolder::Write only uses version 2 when the holder has response curves,
+	// a version 2 holder without curves is written as version 1 without the curve count.
+	if (decoded.propertyHolderVersion == 2 && decoded.curvePropertyIDs.empty())
+	{
+		const uint32_t propertyHolderVersion = 1;
+		const size_t curveCountOffset = bytesRead - TrailingFlagsSize - sizeof(uint32_t);
+
+		std::memcpy(state.data() + GetPropertyHolderOffset(decoded), &propertyHolderVersion, sizeof(propertyHolderVersion));
+		state.erase(state.begin() + curveCountOffset, state.begin() + curveCountOffset + sizeof(uint32_t));
+	}
+
+	return true;
+}
+
+const char* SaveGameMigrator::GetMethodName(Method method)
+{
+	switch (method)
+	{
+	case Method::Unchanged:
+		return "unchanged";
+	case Method::InPlace:
+		return "updated in place";
+	case Method::Rewrite:
+		return "rewritten";
+	default:
+		return "unknown";
+	}
+}
+
+void SaveGameMigrator::MigrateSaveGame(FileResult& result, std::vector<uint8_t>& buffer) const
+{
+	result.error = nullptr;
+	result.states = 0;
+	result.migratedStates = 0;
+	result.method = Method::Unchanged;
+	result.stateBytesSaved = 0;
+	result.migratedFileSize = result.originalFileSize;
+
+	DBPFFile file;
+
+	if (!file.Open(result.path))
+	{
+		result.error = "The file is not a DBPF 1.0 file.";
+		return;
+	}
+
+	result.originalFileSize = file.GetFileSize();
+	result.migratedFileSize = result.originalFileSize;
+
+	std::vector<StoredEntry> storedEntries;
+	std::vector<ChangedEntry> changedEntries;
+	std::vector<uint8_t> migratedData;
+	// The size of the entry data if the file is rewritten, which removes any unused space.
+	uint64_t rewriteDataSize = 0;
+	// The size of the entry data that is appended to the file.
+	uint64_t appendDataSize = 0;
+	uint64_t compressedEntryCount = 0;
+
+	const uint32_t entryCount = file.GetIndexEntryCount();
+
+	for (uint32_t i = 0; i < entryCount; i++)
+	{
+		const DBPFFile::IndexEntry entry = file.GetIndexEntry(i);
+
+		// A new directory is written with the new index.
+		if (entry.key == DBPFFile::DirectoryKey)
+		{
+			continue;
+		}
+
+		StoredEntry stored{ entry, file.IsCompressed(entry), 0 };
+		uint64_t storedSize = entry.size;
+
+		if (stored.compressed)
+		{
+			const uint8_t* data = nullptr;
+
+			// Only the QFS header is read, the entry is not decompressed.
+			if (!file.GetEntryData(entry, data) || !QFSCompression::GetUncompressedSize(data, entry.size, stored.uncompressedSize))
+			{
+				result.error = "An entry could not be read.";
+				return;
+			}
+
+			compressedEntryCount++;
+		}
+
+		if (entry.key.type == OrdinanceSimulatorEntryType)
+		{
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+
+			if (!file.ReadEntryData(entry, buffer, data, size))
+			{
+				result.error = "The ordinance simulator entry could not be read.";
+				return;
+			}
+
+			if (MigrateEntry(data, size, migratedData, result.states, result.migratedStates, result.stateBytesSaved))
+			{
+				ChangedEntry changed{ storedEntries.size(), static_cast<uint32_t>(migratedData.size()), std::vector<uint8_t>() };
+
+				if (stored.compressed)
+				{
+					if (!QFSCompression::Compress(migratedData.data(), migratedData.size(), changed.storedData))
+					{
+						result.error = "A migrated entry could not be compressed.";
+						return;
+					}
+				}
+				else
+				{
+					changed.storedData = migratedData;
+				}
+
+				storedSize = changed.storedData.size();
+				appendDataSize += storedSize;
+				changedEntries.push_back(std::move(changed));
+			}
+		}
+
+		rewriteDataSize += storedSize;
+		storedEntries.push_back(stored);
+	}
+
+	if (changedEntries.empty())
+	{
+		return;
+	}
+
+	const uint64_t indexSize = GetIndexSize(storedEntries.size(), compressedEntryCount);
+	const uint64_t rewriteSize = HeaderSize + rewriteDataSize + indexSize;
+	const uint64_t appendSize = result.originalFileSize + appendDataSize + indexSize;
+
+	// The replaced entries, the old indexes and any earlier unused space stay in an appended file.
+	const uint64_t unusedSize = appendSize > rewriteSize ? appendSize - rewriteSize : 0;
+
+	if (unusedSize * MaxUnusedSpaceDivisor <= rewriteSize)
+	{
+		result.method = Method::InPlace;
+		result.migratedFileSize = appendSize;
+	}
+	else
+	{
+		result.method = Method::Rewrite;
+		result.migratedFileSize = rewriteSize;
+	}
+
+	if (dryRun)
+	{
+		return;
+	}
+
+	if (result.method == Method::InPlace)
+	{
+		// The mapping is closed before the file is written, Windows does not allow writing to a mapped file.
+		file.Close();
+		Append(storedEntries, changedEntries, result);
+	}
+	else
+	{
+		Rewrite(file, storedEntries, changedEntries, result);
+	}
+}
+
+bool SaveGameMigrator::MigrateEntry(
+	const uint8_t* data,
+	size_t size,
+	std::vector<uint8_t>& migratedData,
+	uint32_t& states,
+	uint32_t& migratedStates,
+	int64_t& stateBytesSaved)
+{
+	std::vector<uint8_t> state;
+	size_t copied = 0;
+	size_t offset = 0;
+
+	migratedData.clear();
+
+	while (OrdinanceStateReader::Find(data, size, kParknRideOrdinanceCLSID, offset))
+	{
+		size_t bytesRead = 0;
+
+		if (!MigrateState(data + offset, size - offset, state, bytesRead))
+		{
+			// The class ID also matched other data, continue after it.
+			offset++;
+			continue;
+		}
+
+		states++;
+
+		if (state.size() != bytesRead || std::memcmp(state.data(), data + offset, bytesRead) != 0)
+		{
+			migratedData.insert(migratedData.end(), data + copied, data + offset);
+			migratedData.insert(migratedData.end(), state.begin(), state.end());
+			copied = offset + bytesRead;
+
+			migratedStates++;
+			stateBytesSaved += static_cast<int64_t>(bytesRead) - static_cast<int64_t>(state.size());
+		}
+
+		offset += bytesRead;
+	}
+
+	if (copied == 0)
+	{
+		return false;
+	}
+
+	migratedData.insert(migratedData.end(), data + copied, data + size);
+	return true;
+}
+
+bool SaveGameMigrator::Append(
+	const std::vector<StoredEntry>& storedEntries,
+	const std::vector<ChangedEntry>& changedEntries,
+	FileResult& result)
+{
+	// The writer flushes the appended entries and index to the disk before it updates the
+	// index location in the header, an interrupted migration leaves the old index in use.
+	DBPFWriter writer;
+	bool succeeded = writer.OpenForAppend(result.path);
+	size_t nextChangedEntry = 0;
+
+	for (size_t i = 0; i < storedEntries.size() && succeeded; i++)
+	{
+		const StoredEntry& stored = storedEntries[i];
+
+		if (nextChangedEntry < changedEntries.size() && changedEntries[nextChangedEntry].index == i)
+		{
+			const ChangedEntry& changed = changedEntries[nextChangedEntry++];
+
+			succeeded = stored.compressed
+				? writer.AddCompressedEntry(stored.entry.key, changed.storedData.data(), changed.storedData.size(), changed.uncompressedSize)
+				: writer.AddEntry(stored.entry.key, changed.storedData.data(), changed.storedData.size(), /*compress*/false);
+		}
+		else
+		{
+			succeeded = writer.AddExistingEntry(stored.entry, stored.compressed, stored.uncompressedSize);
+		}
+	}
+
+	succeeded = writer.Close() && succeeded;
+
+	if (!succeeded)
+	{
+		result.error = "The file could not be written.";
+		return false;
+	}
+
+	return true;
+}
+
+bool SaveGameMigrator::Rewrite(
+	DBPFFile& file,
+	const std::vector<StoredEntry>& storedEntries,
+	const std::vector<ChangedEntry>& changedEntries,
+	FileResult& result)
+{
+	std::filesystem::path temporaryPath = result.path;
+	temporaryPath += ".migrating";
+
+	DBPFWriter writer;
+	bool succeeded = writer.Open(temporaryPath);
+	size_t nextChangedEntry = 0;
+
+	for (size_t i = 0; i < storedEntries.size() && succeeded; i++)
+	{
+		const StoredEntry& stored = storedEntries[i];
+		const uint8_t* data = nullptr;
+		size_t size = stored.entry.size;
+		uint32_t uncompressedSize = stored.uncompressedSize;
+
+		if (nextChangedEntry < changedEntries.size() && changedEntries[nextChangedEntry].index == i)
+		{
+			const ChangedEntry& changed = changedEntries[nextChangedEntry++];
+
+			data = changed.storedData.data();
+			size = changed.storedData.size();
+			uncompressedSize = changed.uncompressedSize;
+		}
+		else
+		{
+			// The other entries are copied from the mapping without decompressing them.
+			succeeded = file.GetEntryData(stored.entry, data);
+		}
+
+		if (succeeded)
+		{
+			succeeded = stored.compressed
+				? writer.AddCompressedEntry(stored.entry.key, data, size, uncompressedSize)
+				: writer.AddEntry(stored.entry.key, data, size, /*compress*/false);
+		}
+	}
+
+	succeeded = writer.Close() && succeeded;
+
+	file.Close();
+
+	// The new file must be on the disk before it replaces the save game, otherwise a crash
+	// after the rename could leave an empty or partially written save game.
+	succeeded = succeeded
+		&& Platform::FlushFile(temporaryPath)
+		&& Platform::ReplaceExistingFile(temporaryPath, result.path);
+
+	if (!succeeded)
+	{
+		std::error_code ec;
+		std::filesystem::remove(temporaryPath, ec);
+		result.error = "The file could not be rewritten.";
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,135 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+
+
+#pragma once
+#include "DBPFFile.h"
+#include "WorkStealingPool.h"
+#include <filesystem>
+#include <vector>
+
+// Rewrites the ordinance states in SimCity 4 save games in the format that OrdinanceBase::Write
+// and OrdinancePropertyHolder::Write currently use, without the game.
+//
+// The save games are processed on several threads. Each save game is memory-mapped and only the
+// ordinance simulator entry is searched, only the entries that contain a changed ordinance state
+// are copied into memory. A save game is never left half-written:
+// - When the file has little unused space the changed entries, a new directory and a new index
+//   are appended, and the header is switched to the new index once they are on the disk.
+// - Otherwise the file is rewritten in a single pass to a temporary file, which is flushed to the
+//   disk and renamed over the save game. This also removes the unused space.
+class SaveGameMigrator
+{
+public:
+
+	enum class Method
+	{
+		// The save game is already in the current format.
+		Unchanged,
+		// The changed entries and a new index were appended, the header was updated in place.
+		InPlace,
+		// The save game was copied to a new file with the changed entries.
+		Rewrite,
+	};
+
+	struct FileResult
+	{
+		std::filesystem::path path;
+		// The reason that the save game could not be migrated, or null on success.
+		const char* error;
+		uint32_t states;
+		uint32_t migratedStates;
+		Method method;
+		// The size difference of the migrated ordinance states, before compression.
+		int64_t stateBytesSaved;
+		uint64_t originalFileSize;
+		// The file size after the migration, in a dry run the size that it would have.
+		uint64_t migratedFileSize;
+	};
+
+	struct Statistics
+	{
+		uint32_t threadCount;
+		int64_t elapsedMilliseconds;
+		uint64_t stolenItems;
+	};
+
+	/**
+	 * @brief Initializes the migrator.
+	 * @param threadCount The number of worker threads, 0 uses the number of hardware threads.
+	 * @param dryRun True to report the changes and the byte savings without writing the save games.
+	 */
+	SaveGameMigrator(uint32_t threadCount, bool dryRun);
+
+	/**
+	 * @brief Migrates the save games.
+	 * @param paths The save game paths.
+	 * @param results Receives one result per save game, in the same order as the paths.
+	 */
+	void Migrate(const std::vector<std::filesystem::path>& paths, std::vector<FileResult>& results);
+
+	const Statistics& GetStatistics() const;
+
+	/**
+	 * @brief Converts a serialized ordinance state to the current format.
+	 * @param data The start of the serialized state.
+	 * @param size The number of bytes that are available.
+	 * @param state Receives the state in the current format.
+	 * @param bytesRead Receives the size of the original state.
+	 * @return True on success; otherwise, false if the data is not a supported ordinance state.
+	 */
+	static bool MigrateState(const uint8_t* data, size_t size, std::vector<uint8_t>& state, size_t& bytesRead);
+
+	static const char* GetMethodName(Method method);
+
+private:
+
+	// An entry of the save game as it is stored in the file.
+	struct StoredEntry
+	{
+		DBPFFile::IndexEntry entry;
+		bool compressed;
+		uint32_t uncompressedSize;
+	};
+
+	struct ChangedEntry
+	{
+		// The position of the entry in the stored entries.
+		size_t index;
+		uint32_t uncompressedSize;
+		// The new entry data as it is stored in the file.
+		std::vector<uint8_t> storedData;
+	};
+
+	void MigrateSaveGame(FileResult& result, std::vector<uint8_t>& buffer) const;
+	static bool MigrateEntry(
+		const uint8_t* data,
+		size_t size,
+		std::vector<uint8_t>& migratedData,
+		uint32_t& states,
+		uint32_t& migratedStates,
+		int64_t& stateBytesSaved);
+	static bool Append(
+		const std::vector<StoredEntry>& storedEntries,
+		const std::vector<ChangedEntry>& changedEntries,
+		FileResult& result);
+	static bool Rewrite(
+		DBPFFile& file,
+		const std::vector<StoredEntry>& storedEntries,
+		const std::vector<ChangedEntry>& changedEntries,
+		FileResult& result);
+
+	WorkStealingPool pool;
+	bool dryRun;
+	Statistics statistics;
+};
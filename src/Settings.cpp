@@ -0,0 +1,285 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "Settings.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace
+{
+	constexpr std::string_view SettingsSectionName = "ParknRideOrdinance";
+
+	std::string_view Trim(std::string_view value)
+	{
+		constexpr std::string_view Whitespace = " \t\r\n";
+
+		const size_t start = value.find_first_not_of(Whitespace);
+
+		if (start == std::string_view::npos)
+		{
+			return std::string_view();
+		}
+
+		const size_t end = value.find_last_not_of(Whitespace);
+
+		return value.substr(start, end - start + 1);
+	}
+
+	bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs)
+	{
+		return lhs.size() == rhs.size()
+			&& std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char a, char b)
+			{
+				return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+			});
+	}
+
+	bool ParseBool(std::string_view value, bool& result)
+	{
+		if (EqualsIgnoreCase(value, "true") || value == "1")
+		{
+			result = true;
+			return true;
+		}
+		else if (EqualsIgnoreCase(value, "false") || value == "0")
+		{
+			result = false;
+			return true;
+		}
+
+		return false;
+	}
+
+	bool ParseUInt32(std::string_view value, uint32_t& result)
+	{
+		uint32_t parsed = 0;
+		const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+
+		if (ec == std::errc() && ptr == value.data() + value.size())
+		{
+			result = parsed;
+			return true;
+		}
+
+		return false;
+	}
+
+	// Parses a comma separated list of hour ranges, e.g. 7-9,16-19.
+	// Each range starts at the first hour and ends before the second one, a range
+	// that ends before it starts wraps around midnight.
+	bool ParseHourRanges(std::string_view value, uint32_t& result)
+	{
+		uint32_t mask = 0;
+
+		while (!value.empty())
+		{
+			const size_t separator = value.find(',');
+			const std::string_view range = Trim(value.substr(0, separator));
+			value = separator == std::string_view::npos ? std::string_view() : value.substr(separator + 1);
+
+			const size_t dash = range.find('-');
+			uint32_t start = 0;
+			uint32_t end = 0;
+
+			if (dash == std::string_view::npos
+				|| !ParseUInt32(Trim(range.substr(0, dash)), start)
+				|| !ParseUInt32(Trim(range.substr(dash + 1)), end)
+				|| start > 23
+				|| end > 24
+				|| start == end)
+			{
+				return false;
+			}
+
+			// 0-24 is the only range that covers the whole day.
+			const uint32_t hourCount = end - start == 24 ? 24 : (end + 24 - start) % 24;
+
+			for (uint32_t i = 0; i < hourCount; i++)
+			{
+				mask |= 1u << ((start + i) % 24);
+			}
+		}
+
+		result = mask;
+		return true;
+	}
+}
+
+Settings::Settings()
+	: autoMode(false),
+	  congestionEnableThreshold(60),
+	  congestionDisableThreshold(45),
+	  congestionTractsPerDay(1024),
+	  seedTrafficMapsOnRestart(true),
+	  recordMetrics(false),
+	  impactReportMonths(12),
+	  experimentPeriodMonths(0),
+	  experimentWashoutMonths(1),
+	  rushHourMask(0),
+	  rushHourSwitchBudgetMicroseconds(5000),
+	  ridershipScaledEffects(false),
+	  ridershipPricing(false),
+	  ridershipCostPerThousandTrips(20),
+	  ridershipMaxMonthlyCost(5000),
+	  transitSwitchesPerDay(32)
+{
+}
+
+bool Settings::Load(const std::filesystem::path& path)
+{
+	Logger& logger = Logger::GetInstance();
+
+	std::ifstream stream(path);
+
+	if (!stream)
+	{
+		logger.WriteLine(LogOptions::Info, "The settings file was not found, using the default settings.");
+		return false;
+	}
+
+	bool inSettingsSection = false;
+	std::string line;
+
+	while (std::getline(stream, line))
+	{
+		const std::string_view trimmed = Trim(line);
+
+		if (trimmed.empty() || trimmed.front() == ';' || trimmed.front() == '#')
+		{
+			continue;
+		}
+
+		if (trimmed.front() == '[')
+		{
+			inSettingsSection = trimmed.back() == ']'
+				&& EqualsIgnoreCase(Trim(trimmed.substr(1, trimmed.size() - 2)), SettingsSectionName);
+			continue;
+		}
+
+		const size_t separator = trimmed.find('=');
+
+		if (!inSettingsSection || separator == std::string_view::npos)
+		{
+			continue;
+		}
+
+		const std::string_view name = Trim(trimmed.substr(0, separator));
+		const std::string_view value = Trim(trimmed.substr(separator + 1));
+
+		bool valid = true;
+
+		if (EqualsIgnoreCase(name, "AutoMode"))
+		{
+			valid = ParseBool(value, autoMode);
+		}
+		else if (EqualsIgnoreCase(name, "CongestionEnableThreshold"))
+		{
+			valid = ParseUInt32(value, congestionEnableThreshold);
+		}
+		else if (EqualsIgnoreCase(name, "CongestionDisableThreshold"))
+		{
+			valid = ParseUInt32(value, congestionDisableThreshold);
+		}
+		else if (EqualsIgnoreCase(name, "CongestionTractsPerDay"))
+		{
+			valid = ParseUInt32(value, congestionTractsPerDay) && congestionTractsPerDay > 0;
+		}
+		else if (EqualsIgnoreCase(name, "SeedTrafficMapsOnRestart"))
+		{
+			valid = ParseBool(value, seedTrafficMapsOnRestart);
+		}
+		else if (EqualsIgnoreCase(name, "RecordMetrics"))
+		{
+			valid = ParseBool(value, recordMetrics);
+		}
+		else if (EqualsIgnoreCase(name, "ImpactReportMonths"))
+		{
+			valid = ParseUInt32(value, impactReportMonths);
+		}
+		else if (EqualsIgnoreCase(name, "ExperimentPeriodMonths"))
+		{
+			valid = ParseUInt32(value, experimentPeriodMonths);
+		}
+		else if (EqualsIgnoreCase(name, "ExperimentWashoutMonths"))
+		{
+			valid = ParseUInt32(value, experimentWashoutMonths);
+		}
+		else if (EqualsIgnoreCase(name, "RushHours"))
+		{
+			valid = ParseHourRanges(value, rushHourMask);
+		}
+		else if (EqualsIgnoreCase(name, "RushHourSwitchBudgetMicroseconds"))
+		{
+			valid = ParseUInt32(value, rushHourSwitchBudgetMicroseconds);
+		}
+		else if (EqualsIgnoreCase(name, "RidershipScaledEffects"))
+		{
+			valid = ParseBool(value, ridershipScaledEffects);
+		}
+		else if (EqualsIgnoreCase(name, "RidershipPricing"))
+		{
+			valid = ParseBool(value, ridershipPricing);
+		}
+		else if (EqualsIgnoreCase(name, "RidershipCostPerThousandTrips"))
+		{
+			valid = ParseUInt32(value, ridershipCostPerThousandTrips);
+		}
+		else if (EqualsIgnoreCase(name, "RidershipMaxMonthlyCost"))
+		{
+			valid = ParseUInt32(value, ridershipMaxMonthlyCost);
+		}
+		else if (EqualsIgnoreCase(name, "TransitSwitchesPerDay"))
+		{
+			valid = ParseUInt32(value, transitSwitchesPerDay) && transitSwitchesPerDay > 0;
+		}
+
+		if (!valid)
+		{
+			logger.WriteLineFormatted(
+				LogOptions::Errors,
+				"Invalid settings value: %.*s=%.*s",
+				static_cast<int>(name.size()),
+				name.data(),
+				static_cast<int>(value.size()),
+				value.data());
+		}
+	}
+
+	if (congestionDisableThreshold >= congestionEnableThreshold)
+	{
+		logger.WriteLineFormatted(
+			LogOptions::Errors,
+			"CongestionDisableThreshold (%u) must be less than CongestionEnableThreshold (%u), using %u.",
+			congestionDisableThreshold,
+			congestionEnableThreshold,
+			congestionEnableThreshold > 0 ? congestionEnableThreshold - 1 : 0);
+
+		congestionDisableThreshold = congestionEnableThreshold > 0 ? congestionEnableThreshold - 1 : 0;
+	}
+
+	if (congestionTractsPerDay == 0)
+	{
+		congestionTractsPerDay = 1;
+	}
+
+	if (transitSwitchesPerDay == 0)
+	{
+		transitSwitchesPerDay = 1;
+	}
+
+	return true;
+}
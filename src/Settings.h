@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <filesystem>
+#include <stdint.h>
+
+// The user-configurable plugin options, loaded from SC4ParknRideOrdinance.ini.
+//
+// The file uses the usual INI format: a [ParknRideOrdinance] section that contains
+// Name=Value lines, and comment lines that start with a semicolon.
+// Missing or invalid values keep their defaults.
+class Settings
+{
+public:
+
+	Settings();
+
+	/**
+	 * @brief Loads the settings from the specified INI file.
+	 * @param path The path of the INI file.
+	 * @return True if the file was read; otherwise, false.
+	 */
+	bool Load(const std::filesystem::path& path);
+
+	// When enabled the ordinance only restricts cars while the city-wide
+	// congestion is above the threshold.
+	bool autoMode;
+	// The average congestion that makes the ordinance restrict cars in auto mode.
+	uint32_t congestionEnableThreshold;
+	// The average congestion below which the car restriction is lifted in auto mode.
+	// This must be lower than the enable threshold to prevent the ordinance from
+	// toggling every time the congestion changes slightly.
+	uint32_t congestionDisableThreshold;
+	// The number of congestion map tracts that are sampled per simulation day.
+	uint32_t congestionTractsPerDay;
+	// Restores the traffic maps after the traffic simulator is restarted, otherwise
+	// the city has no traffic until the traffic simulator rebuilds its maps.
+	bool seedTrafficMapsOnRestart;
+	// Writes the monthly traffic statistics of each city to a metrics file.
+	bool recordMetrics;
+	// The number of months after an ordinance toggle that the impact report covers, zero disables the reports.
+	uint32_t impactReportMonths;
+	// The number of months in each period of the A/B experiment, zero disables the experiment.
+	uint32_t experimentPeriodMonths;
+	// The number of months at the start of each experiment period that are not measured,
+	// this allows the traffic to settle after the ordinance is toggled.
+	uint32_t experimentWashoutMonths;
+	// The hours of the day in which the enacted ordinance restricts cars, bit N is set when the
+	// restriction is active from N:00 to N:59. Zero restricts cars for the whole day.
+	uint32_t rushHourMask;
+	// The longest time that a rush hour switch may take before the scheduler falls back to
+	// switching once per day.
+	uint32_t rushHourSwitchBudgetMicroseconds;
+	// Scales the strength of the ordinance effects with the transit ridership and congestion relief.
+	bool ridershipScaledEffects;
+	// Makes the monthly cost of the ordinance depend on the number of trips that arrive at the transit switches.
+	bool ridershipPricing;
+	// The monthly cost of every 1000 trips that arrive at the transit switches.
+	uint32_t ridershipCostPerThousandTrips;
+	// The largest monthly cost of the ordinance, zero removes the limit.
+	uint32_t ridershipMaxMonthlyCost;
+	// The number of transit switches whose traffic is read per simulation day for the ridership pricing
+	// and the traffic reports.
+	uint32_t transitSwitchesPerDay;
+};
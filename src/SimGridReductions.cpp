@@ -0,0 +1,410 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "SimGridReductions.h"
+#include <algorithm>
+#include <iterator>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define SIMGRID_REDUCTIONS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+#endif
+
+#if defined(SIMGRID_REDUCTIONS_X86) && (defined(__GNUC__) || defined(__clang__))
+// GCC and Clang require the AVX2 functions to be marked, so that the rest of the
+// plugin can run on CPUs without AVX2. MSVC allows the intrinsics in any function.
+#define SIMGRID_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMGRID_TARGET_AVX2
+#endif
+
+using namespace SimGridReductions;
+
+namespace
+{
+	// The scalar reference kernels.
+
+	uint64_t SumScalar(const uint8_t* data, size_t count)
+	{
+		uint64_t sum = 0;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			sum += data[i];
+		}
+
+		return sum;
+	}
+
+	MinMax GetMinMaxScalar(const uint8_t* data, size_t count, MinMax result)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			result.min = std::min(result.min, data[i]);
+			result.max = std::max(result.max, data[i]);
+		}
+
+		return result;
+	}
+
+	size_t CountAtLeastScalar(const uint8_t* data, size_t count, uint8_t threshold)
+	{
+		size_t result = 0;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			result += data[i] >= threshold;
+		}
+
+		return result;
+	}
+
+	void BuildHistogramScalar(const uint8_t* data, size_t count, Histogram& histogram)
+	{
+		histogram.fill(0);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			histogram[data[i]]++;
+		}
+	}
+
+	// Scatter increments cannot be vectorized with SSE2 or AVX2, the vector levels use four
+	// sub-histograms instead. This avoids the store-to-load stalls that occur when adjacent
+	// tracts have the same value, which is common in the traffic maps.
+	void BuildHistogramUnrolled(const uint8_t* data, size_t count, Histogram& histogram)
+	{
+		uint32_t partial[4][256] = {};
+
+		size_t i = 0;
+
+		for (; i + 4 <= count; i += 4)
+		{
+			partial[0][data[i]]++;
+			partial[1][data[i + 1]]++;
+			partial[2][data[i + 2]]++;
+			partial[3][data[i + 3]]++;
+		}
+
+		for (; i < count; i++)
+		{
+			partial[0][data[i]]++;
+		}
+
+		for (size_t value = 0; value < 256; value++)
+		{
+			histogram[value] = partial[0][value] + partial[1][value] + partial[2][value] + partial[3][value];
+		}
+	}
+
+#ifdef SIMGRID_REDUCTIONS_X86
+
+	// The SSE2 kernels.
+
+	uint64_t SumSSE2(const uint8_t* data, size_t count)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i accumulator = _mm_setzero_si128();
+
+		size_t i = 0;
+
+		for (; i + 16 <= count; i += 16)
+		{
+			const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+			// The sum of absolute differences against zero adds each group of 8 bytes into a 64-bit lane.
+			accumulator = _mm_add_epi64(accumulator, _mm_sad_epu8(values, zero));
+		}
+
+		uint64_t lanes[2];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+
+		return lanes[0] + lanes[1] + SumScalar(data + i, count - i);
+	}
+
+	MinMax GetMinMaxSSE2(const uint8_t* data, size_t count)
+	{
+		MinMax result{ data[0], data[0] };
+
+		size_t i = 0;
+
+		if (count >= 16)
+		{
+			__m128i minimum = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+			__m128i maximum = minimum;
+
+			for (i = 16; i + 16 <= count; i += 16)
+			{
+				const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+				minimum = _mm_min_epu8(minimum, values);
+				maximum = _mm_max_epu8(maximum, values);
+			}
+
+			alignas(16) uint8_t minimumLanes[16];
+			alignas(16) uint8_t maximumLanes[16];
+			_mm_store_si128(reinterpret_cast<__m128i*>(minimumLanes), minimum);
+			_mm_store_si128(reinterpret_cast<__m128i*>(maximumLanes), maximum);
+
+			result.min = *std::min_element(std::begin(minimumLanes), std::end(minimumLanes));
+			result.max = *std::max_element(std::begin(maximumLanes), std::end(maximumLanes));
+		}
+
+		return GetMinMaxScalar(data + i, count - i, result);
+	}
+
+	size_t CountAtLeastSSE2(const uint8_t* data, size_t count, uint8_t threshold)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi8(1);
+		const __m128i thresholdVector = _mm_set1_epi8(static_cast<char>(threshold));
+		__m128i accumulator = _mm_setzero_si128();
+
+		size_t i = 0;
+
+		for (; i + 16 <= count; i += 16)
+		{
+			const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+			// SSE2 does not have an unsigned byte comparison, max(value, threshold) == value
+			// is equivalent to value >= threshold.
+			const __m128i mask = _mm_cmpeq_epi8(_mm_max_epu8(values, thresholdVector), values);
+
+			accumulator = _mm_add_epi64(accumulator, _mm_sad_epu8(_mm_and_si128(mask, one), zero));
+		}
+
+		uint64_t lanes[2];
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+
+		return static_cast<size_t>(lanes[0] + lanes[1]) + CountAtLeastScalar(data + i, count - i, threshold);
+	}
+
+	// The AVX2 kernels.
+
+	SIMGRID_TARGET_AVX2 uint64_t SumAVX2(const uint8_t* data, size_t count)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		__m256i accumulator = _mm256_setzero_si256();
+
+		size_t i = 0;
+
+		for (; i + 32 <= count; i += 32)
+		{
+			const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+			accumulator = _mm256_add_epi64(accumulator, _mm256_sad_epu8(values, zero));
+		}
+
+		uint64_t lanes[4];
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), accumulator);
+
+		return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumSSE2(data + i, count - i);
+	}
+
+	SIMGRID_TARGET_AVX2 MinMax GetMinMaxAVX2(const uint8_t* data, size_t count)
+	{
+		if (count < 32)
+		{
+			return GetMinMaxSSE2(data, count);
+		}
+
+		__m256i minimum = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+		__m256i maximum = minimum;
+
+		size_t i = 32;
+
+		for (; i + 32 <= count; i += 32)
+		{
+			const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+			minimum = _mm256_min_epu8(minimum, values);
+			maximum = _mm256_max_epu8(maximum, values);
+		}
+
+		alignas(32) uint8_t minimumLanes[32];
+		alignas(32) uint8_t maximumLanes[32];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(minimumLanes), minimum);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(maximumLanes), maximum);
+
+		MinMax result
+		{
+			*std::min_element(std::begin(minimumLanes), std::end(minimumLanes)),
+			*std::max_element(std::begin(maximumLanes), std::end(maximumLanes))
+		};
+
+		return GetMinMaxScalar(data + i, count - i, result);
+	}
+
+	SIMGRID_TARGET_AVX2 size_t CountAtLeastAVX2(const uint8_t* data, size_t count, uint8_t threshold)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i one = _mm256_set1_epi8(1);
+		const __m256i thresholdVector = _mm256_set1_epi8(static_cast<char>(threshold));
+		__m256i accumulator = _mm256_setzero_si256();
+
+		size_t i = 0;
+
+		for (; i + 32 <= count; i += 32)
+		{
+			const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			const __m256i mask = _mm256_cmpeq_epi8(_mm256_max_epu8(values, thresholdVector), values);
+
+			accumulator = _mm256_add_epi64(accumulator, _mm256_sad_epu8(_mm256_and_si256(mask, one), zero));
+		}
+
+		uint64_t lanes[4];
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), accumulator);
+
+		return static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3])
+			+ CountAtLeastSSE2(data + i, count - i, threshold);
+	}
+
+	bool IsAVX2Supported()
+	{
+#ifdef _MSC_VER
+		int info[4]{};
+
+		__cpuid(info, 0);
+
+		if (info[0] < 7)
+		{
+			return false;
+		}
+
+		__cpuid(info, 1);
+
+		// The OS must save the AVX registers on a context switch.
+		constexpr int OSXSAVE = 1 << 27;
+		constexpr int AVX = 1 << 28;
+
+		if ((info[2] & (OSXSAVE | AVX)) != (OSXSAVE | AVX)
+			|| (_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		__cpuidex(info, 7, 0);
+
+		constexpr int AVX2 = 1 << 5;
+
+		return (info[1] & AVX2) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif // _MSC_VER
+	}
+
+#endif // SIMGRID_REDUCTIONS_X86
+
+	SimdLevel DetectSimdLevel()
+	{
+#ifdef SIMGRID_REDUCTIONS_X86
+		// SSE2 is part of the x64 baseline, and it is required by the x86 Visual C++ runtime.
+		return IsAVX2Supported() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#else
+		return SimdLevel::Scalar;
+#endif // SIMGRID_REDUCTIONS_X86
+	}
+
+	SimdLevel ClampSimdLevel(SimdLevel level)
+	{
+		return std::min(level, GetSupportedSimdLevel());
+	}
+}
+
+SimdLevel SimGridReductions::GetSupportedSimdLevel()
+{
+	static const SimdLevel supportedLevel = DetectSimdLevel();
+
+	return supportedLevel;
+}
+
+const char* SimGridReductions::GetSimdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::AVX2:
+		return "AVX2";
+	case SimdLevel::SSE2:
+		return "SSE2";
+	case SimdLevel::Scalar:
+	default:
+		return "Scalar";
+	}
+}
+
+uint64_t SimGridReductions::Sum(const uint8_t* data, size_t count, SimdLevel level)
+{
+	switch (ClampSimdLevel(level))
+	{
+#ifdef SIMGRID_REDUCTIONS_X86
+	case SimdLevel::AVX2:
+		return SumAVX2(data, count);
+	case SimdLevel::SSE2:
+		return SumSSE2(data, count);
+#endif // SIMGRID_REDUCTIONS_X86
+	case SimdLevel::Scalar:
+	default:
+		return SumScalar(data, count);
+	}
+}
+
+MinMax SimGridReductions::GetMinMax(const uint8_t* data, size_t count, SimdLevel level)
+{
+	if (count == 0)
+	{
+		return MinMax{ 0, 0 };
+	}
+
+	switch (ClampSimdLevel(level))
+	{
+#ifdef SIMGRID_REDUCTIONS_X86
+	case SimdLevel::AVX2:
+		return GetMinMaxAVX2(data, count);
+	case SimdLevel::SSE2:
+		return GetMinMaxSSE2(data, count);
+#endif // SIMGRID_REDUCTIONS_X86
+	case SimdLevel::Scalar:
+	default:
+		return GetMinMaxScalar(data, count, MinMax{ data[0], data[0] });
+	}
+}
+
+size_t SimGridReductions::CountAtLeast(const uint8_t* data, size_t count, uint8_t threshold, SimdLevel level)
+{
+	switch (ClampSimdLevel(level))
+	{
+#ifdef SIMGRID_REDUCTIONS_X86
+	case SimdLevel::AVX2:
+		return CountAtLeastAVX2(data, count, threshold);
+	case SimdLevel::SSE2:
+		return CountAtLeastSSE2(data, count, threshold);
+#endif // SIMGRID_REDUCTIONS_X86
+	case SimdLevel::Scalar:
+	default:
+		return CountAtLeastScalar(data, count, threshold);
+	}
+}
+
+void SimGridReductions::BuildHistogram(const uint8_t* data, size_t count, Histogram& histogram, SimdLevel level)
+{
+	if (ClampSimdLevel(level) == SimdLevel::Scalar)
+	{
+		BuildHistogramScalar(data, count, histogram);
+	}
+	else
+	{
+		BuildHistogramUnrolled(data, count, histogram);
+	}
+}
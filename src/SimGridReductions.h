@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "SimGridView.h"
+#include <array>
+#include <stddef.h>
+
+// Bulk reductions over the 8-bit traffic simulator maps, e.g. the congestion and trip length maps.
+//
+// The reductions read the grid buffer directly and use SSE2 or AVX2 kernels when the
+// CPU supports them. The scalar kernels are the reference implementation, all of the
+// kernels produce identical results.
+namespace SimGridReductions
+{
+	enum class SimdLevel : uint32_t
+	{
+		Scalar = 0,
+		SSE2 = 1,
+		AVX2 = 2,
+	};
+
+	struct MinMax
+	{
+		uint8_t min;
+		uint8_t max;
+	};
+
+	using Histogram = std::array<uint32_t, 256>;
+
+	/**
+	 * @brief Gets the best kernel set that the current CPU supports.
+	 */
+	SimdLevel GetSupportedSimdLevel();
+
+	const char* GetSimdLevelName(SimdLevel level);
+
+	/**
+	 * @brief Computes the sum of the values.
+	 * @param data The values.
+	 * @param count The number of values.
+	 * @param level The kernel set to use, it is clamped to the supported level.
+	 */
+	uint64_t Sum(const uint8_t* data, size_t count, SimdLevel level = GetSupportedSimdLevel());
+
+	/**
+	 * @brief Computes the minimum and maximum values.
+	 * @return The minimum and maximum values, or {0, 0} if count is zero.
+	 */
+	MinMax GetMinMax(const uint8_t* data, size_t count, SimdLevel level = GetSupportedSimdLevel());
+
+	/**
+	 * @brief Counts the values that are greater than or equal to the threshold.
+	 */
+	size_t CountAtLeast(const uint8_t* data, size_t count, uint8_t threshold, SimdLevel level = GetSupportedSimdLevel());
+
+	/**
+	 * @brief Counts the occurrences of every value.
+	 * @param histogram Receives the number of occurrences of each value.
+	 */
+	void BuildHistogram(const uint8_t* data, size_t count, Histogram& histogram, SimdLevel level = GetSupportedSimdLevel());
+
+	inline uint64_t Sum(const SimGridView<uint8_t>& grid, SimdLevel level = GetSupportedSimdLevel())
+	{
+		return Sum(grid.Data(), grid.Size(), level);
+	}
+
+	inline MinMax GetMinMax(const SimGridView<uint8_t>& grid, SimdLevel level = GetSupportedSimdLevel())
+	{
+		return GetMinMax(grid.Data(), grid.Size(), level);
+	}
+
+	inline size_t CountAtLeast(const SimGridView<uint8_t>& grid, uint8_t threshold, SimdLevel level = GetSupportedSimdLevel())
+	{
+		return CountAtLeast(grid.Data(), grid.Size(), threshold, level);
+	}
+
+	inline void BuildHistogram(const SimGridView<uint8_t>& grid, Histogram& histogram, SimdLevel level = GetSupportedSimdLevel())
+	{
+		BuildHistogram(grid.Data(), grid.Size(), histogram, level);
+	}
+}
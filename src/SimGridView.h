@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cISC4SimGrid.h"
+#include <stddef.h>
+
+// A read-only view of the tract values in a cISC4SimGrid.
+//
+// GetGridData returns the grid's value buffer, which stores the tracts in row-major
+// order with GetTractCountX values per row. Reading the buffer directly avoids the
+// virtual GetTractValue/GetCellValue call per tract.
+// The view must not outlive the grid, and it becomes invalid when the grid is
+// reinitialized, e.g. when the traffic simulator is restarted.
+template<typename T>
+class SimGridView
+{
+public:
+
+	SimGridView()
+		: data(nullptr), countX(0), countZ(0), tractShift(0)
+	{
+	}
+
+	SimGridView(const T* data, int32_t countX, int32_t countZ, int32_t tractShift)
+		: data(data), countX(countX), countZ(countZ), tractShift(tractShift)
+	{
+	}
+
+	/**
+	 * @brief Creates a view of the specified grid.
+	 * @param pGrid The grid, may be null.
+	 * @return The view, or an invalid view if the grid is null or empty.
+	 */
+	static SimGridView FromGrid(cISC4SimGrid<T>* pGrid)
+	{
+		if (pGrid)
+		{
+			const T* data = reinterpret_cast<const T*>(pGrid->GetGridData());
+			const int32_t countX = pGrid->GetTractCountX();
+			const int32_t countZ = pGrid->GetTractCountZ();
+
+			if (data && countX > 0 && countZ > 0)
+			{
+				return SimGridView(data, countX, countZ, pGrid->GetTractShift());
+			}
+		}
+
+		return SimGridView();
+	}
+
+	bool IsValid() const
+	{
+		return data != nullptr;
+	}
+
+	const T* Data() const
+	{
+		return data;
+	}
+
+	size_t Size() const
+	{
+		return static_cast<size_t>(countX) * static_cast<size_t>(countZ);
+	}
+
+	int32_t CountX() const
+	{
+		return countX;
+	}
+
+	int32_t CountZ() const
+	{
+		return countZ;
+	}
+
+	// The number of bits that a cell coordinate is shifted right by to get the tract coordinate.
+	int32_t TractShift() const
+	{
+		return tractShift;
+	}
+
+	const T* Row(int32_t z) const
+	{
+		return data + (static_cast<size_t>(z) * static_cast<size_t>(countX));
+	}
+
+	T At(int32_t x, int32_t z) const
+	{
+		return Row(z)[x];
+	}
+
+	bool operator==(const SimGridView& other) const
+	{
+		return data == other.data && countX == other.countX && countZ == other.countZ;
+	}
+
+	bool operator!=(const SimGridView& other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+
+	const T* data;
+	int32_t countX;
+	int32_t countZ;
+	int32_t tractShift;
+};
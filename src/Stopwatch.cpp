@@ -11,7 +11,7 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "Stopwatch.h"
-#include <Windows.h>
+#include "Platform.h"
 
 // This code is based on the .NET runtime Stopwatch and TimeSpan types.
 
@@ -21,6 +21,7 @@ namespace
 	constexpr int64_t SecondsPerMinute = 60;
 	constexpr int64_t MinutesPerHour = 60;
 
+	constexpr int64_t TicksPerMicrosecond = 10;
 	constexpr int64_t TicksPerMillisecond = 10000;
 	constexpr int64_t TicksPerSecond = TicksPerMillisecond * MillisecondsPerSecond;
 	constexpr int64_t TicksPerMinute = TicksPerSecond * SecondsPerMinute;
@@ -28,20 +29,15 @@ namespace
 
 	int64_t GetTimeStamp()
 	{
-		LARGE_INTEGER li{};
-
-		QueryPerformanceCounter(&li);
-
-		return li.QuadPart;
+		return Platform::GetTimestamp();
 	}
 
-	int64_t GetTickFrequency()
+	double GetTickFrequency()
 	{
-		LARGE_INTEGER li{};
-
-		QueryPerformanceFrequency(&li);
-
-		return TicksPerSecond / li.QuadPart;
+		// The ratio is a floating point value because the performance counter
+		// frequency can be higher than TicksPerSecond, e.g. the POSIX monotonic
+		// clock uses nanoseconds.
+		return static_cast<double>(TicksPerSecond) / static_cast<double>(Platform::GetTimestampFrequency());
 	}
 }
 
@@ -50,6 +46,11 @@ Stopwatch::Stopwatch() noexcept
 {
 }
 
+int64_t Stopwatch::ElapsedMicroseconds() const
+{
+	return (GetElapsedTicks() / TicksPerMicrosecond);
+}
+
 int64_t Stopwatch::ElapsedMilliseconds() const
 {
 	return (GetElapsedTicks() / TicksPerMillisecond);
@@ -114,5 +115,5 @@ int64_t Stopwatch::GetElapsedTicks() const
 		timeElapsed += elapsedThisPeriod;
 	}
 
-	return timeElapsed * tickFrequency;
+	return static_cast<int64_t>(static_cast<double>(timeElapsed) * tickFrequency);
 }
@@ -20,6 +20,8 @@ public:
 
 	Stopwatch() noexcept;
 
+	int64_t ElapsedMicroseconds() const;
+
 	int64_t ElapsedMilliseconds() const;
 
 	int64_t ElapsedSeconds() const;
@@ -40,7 +42,7 @@ private:
 
 	int64_t GetElapsedTicks() const;
 
-	const int64_t tickFrequency;
+	const double tickFrequency;
 	int64_t elapsed;
 	int64_t startTimeStamp;
 	bool isRunning;
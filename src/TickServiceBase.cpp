@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+
+#include "TickServiceBase.h"
+#include "cIGZFrameWork.h"
+#include "cRZCOMDllDirector.h"
+
+static constexpr uint32_t GZIID_cIGZSystemService = 0x287fb697;
+
+TickServiceBase::TickServiceBase(uint32_t serviceID, int32_t servicePriority)
+	: refCount(0),
+	  serviceID(serviceID),
+	  servicePriority(servicePriority),
+	  serviceRunning(false),
+	  tickRegistered(false)
+{
+}
+
+bool TickServiceBase::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cIGZSystemService)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZSystemService*>(this);
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t TickServiceBase::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t TickServiceBase::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+	return refCount;
+}
+
+uint32_t TickServiceBase::GetServiceID()
+{
+	return serviceID;
+}
+
+cIGZSystemService* TickServiceBase::SetServiceID(uint32_t dwServiceId)
+{
+	serviceID = dwServiceId;
+	return this;
+}
+
+int32_t TickServiceBase::GetServicePriority()
+{
+	return servicePriority;
+}
+
+bool TickServiceBase::IsServiceRunning()
+{
+	return serviceRunning;
+}
+
+cIGZSystemService* TickServiceBase::SetServiceRunning(bool bRunning)
+{
+	serviceRunning = bRunning;
+	return this;
+}
+
+bool TickServiceBase::Init()
+{
+	return true;
+}
+
+bool TickServiceBase::Shutdown()
+{
+	UnregisterTick();
+	return true;
+}
+
+bool TickServiceBase::OnIdle()
+{
+	return true;
+}
+
+bool TickServiceBase::RegisterTick()
+{
+	if (!tickRegistered)
+	{
+		cIGZFrameWork* const pFramework = RZGetFrameWork();
+
+		if (pFramework && pFramework->AddSystemService(this))
+		{
+			if (pFramework->AddToTick(this))
+			{
+				tickRegistered = true;
+			}
+			else
+			{
+				pFramework->RemoveSystemService(this);
+			}
+		}
+	}
+
+	return tickRegistered;
+}
+
+void TickServiceBase::UnregisterTick()
+{
+	if (tickRegistered)
+	{
+		cIGZFrameWork* const pFramework = RZGetFrameWork();
+
+		pFramework->RemoveFromTick(this);
+		pFramework->RemoveSystemService(this);
+		tickRegistered = false;
+	}
+}
+
+bool TickServiceBase::IsTickRegistered() const
+{
+	return tickRegistered;
+}
@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include "cIGZSystemService.h"
+
+// The base class for a framework system service that is called every frame.
+//
+// The service is only registered with the framework while it has work to do, a derived
+// class calls RegisterTick when it starts and UnregisterTick when it stops. The framework
+// does not own the service, so the reference count does not control its lifetime.
+class TickServiceBase : public cIGZSystemService
+{
+public:
+
+	/**
+	 * @brief Constructs an instance of the class.
+	 * @param serviceID The unique ID of the service.
+	 * @param servicePriority The service priority, the services with a higher priority are called first.
+	 */
+	TickServiceBase(uint32_t serviceID, int32_t servicePriority);
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	uint32_t GetServiceID() override;
+	cIGZSystemService* SetServiceID(uint32_t dwServiceId) override;
+	int32_t GetServicePriority() override;
+	bool IsServiceRunning() override;
+	cIGZSystemService* SetServiceRunning(bool bRunning) override;
+	bool Init() override;
+	bool Shutdown() override;
+	bool OnIdle() override;
+
+protected:
+
+	/**
+	 * @brief Adds the service to the framework and to the tick list.
+	 * @return True if the service is registered; otherwise, false.
+	 */
+	bool RegisterTick();
+
+	/**
+	 * @brief Removes the service from the tick list and from the framework.
+	 */
+	void UnregisterTick();
+
+	bool IsTickRegistered() const;
+
+private:
+
+	uint32_t refCount;
+	uint32_t serviceID;
+	int32_t servicePriority;
+	bool serviceRunning;
+	bool tickRegistered;
+};
@@ -0,0 +1,201 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "TrafficMapSnapshot.h"
+#include "SimGridView.h"
+#include "cISC4SimGrid.h"
+#include "cISC4TrafficSimulator.h"
+
+TrafficMapSnapshot::TrafficMapSnapshot()
+	: maps()
+{
+	Clear();
+}
+
+bool TrafficMapSnapshot::Capture(cISC4TrafficSimulator* pTrafficSimulator)
+{
+	bool result = false;
+
+	for (uint32_t i = 0; i < TrafficMapCount; i++)
+	{
+		EncodedMap& encoded = maps[i];
+
+		Encode(GetMap(pTrafficSimulator, static_cast<TrafficMap>(i)), encoded);
+
+		result |= encoded.valid;
+	}
+
+	return result;
+}
+
+bool TrafficMapSnapshot::Restore(cISC4TrafficSimulator* pTrafficSimulator) const
+{
+	bool result = false;
+
+	for (uint32_t i = 0; i < TrafficMapCount; i++)
+	{
+		const EncodedMap& encoded = maps[i];
+
+		if (encoded.valid)
+		{
+			result |= Decode(encoded, GetMap(pTrafficSimulator, static_cast<TrafficMap>(i)));
+		}
+	}
+
+	return result;
+}
+
+void TrafficMapSnapshot::Clear()
+{
+	for (EncodedMap& encoded : maps)
+	{
+		encoded.valid = false;
+		encoded.countX = 0;
+		encoded.countZ = 0;
+		encoded.runs.clear();
+	}
+}
+
+size_t TrafficMapSnapshot::GetEncodedSize() const
+{
+	size_t size = 0;
+
+	for (const EncodedMap& encoded : maps)
+	{
+		size += encoded.runs.size();
+	}
+
+	return size;
+}
+
+size_t TrafficMapSnapshot::GetMapSize() const
+{
+	size_t size = 0;
+
+	for (const EncodedMap& encoded : maps)
+	{
+		if (encoded.valid)
+		{
+			size += static_cast<size_t>(encoded.countX) * static_cast<size_t>(encoded.countZ);
+		}
+	}
+
+	return size;
+}
+
+cISC4SimGrid<uint8_t>* TrafficMapSnapshot::GetMap(cISC4TrafficSimulator* pTrafficSimulator, TrafficMap map)
+{
+	if (!pTrafficSimulator)
+	{
+		return nullptr;
+	}
+
+	intptr_t pGrid = 0;
+
+	switch (map)
+	{
+	case AirPollutingTraffic:
+		pGrid = pTrafficSimulator->GetAirPollutingTrafficMap();
+		break;
+	case CommercialTraffic:
+		pGrid = pTrafficSimulator->GetCommercialTrafficMap();
+		break;
+	case Congestion:
+		pGrid = pTrafficSimulator->GetCongestionMap();
+		break;
+	case TripLength:
+		pGrid = pTrafficSimulator->GetTripLengthMap();
+		break;
+	default:
+		break;
+	}
+
+	return reinterpret_cast<cISC4SimGrid<uint8_t>*>(pGrid);
+}
+
+void TrafficMapSnapshot::Encode(cISC4SimGrid<uint8_t>* pGrid, EncodedMap& encoded)
+{
+	encoded.runs.clear();
+
+	const SimGridView<uint8_t> grid = SimGridView<uint8_t>::FromGrid(pGrid);
+
+	encoded.valid = grid.IsValid();
+	encoded.countX = grid.CountX();
+	encoded.countZ = grid.CountZ();
+
+	if (!encoded.valid)
+	{
+		return;
+	}
+
+	const uint8_t* const data = grid.Data();
+	const size_t count = grid.Size();
+
+	size_t i = 0;
+
+	while (i < count)
+	{
+		const uint8_t value = data[i];
+		size_t runLength = 1;
+
+		while (runLength < 255 && i + runLength < count && data[i + runLength] == value)
+		{
+			runLength++;
+		}
+
+		encoded.runs.push_back(static_cast<uint8_t>(runLength));
+		encoded.runs.push_back(value);
+
+		i += runLength;
+	}
+}
+
+bool TrafficMapSnapshot::Decode(const EncodedMap& encoded, cISC4SimGrid<uint8_t>* pGrid)
+{
+	if (!pGrid
+		|| pGrid->GetTractCountX() != encoded.countX
+		|| pGrid->GetTractCountZ() != encoded.countZ)
+	{
+		return false;
+	}
+
+	// The restarted map is cleared first so that only the tracts with traffic
+	// need to be written individually.
+	pGrid->SetTractValues(0);
+
+	int32_t x = 0;
+	int32_t z = 0;
+
+	for (size_t i = 0; i + 1 < encoded.runs.size(); i += 2)
+	{
+		const uint8_t runLength = encoded.runs[i];
+		const uint8_t value = encoded.runs[i + 1];
+
+		for (uint8_t j = 0; j < runLength; j++)
+		{
+			if (value != 0)
+			{
+				pGrid->SetTractValue(x, z, value);
+			}
+
+			x++;
+
+			if (x == encoded.countX)
+			{
+				x = 0;
+				z++;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class cISC4TrafficSimulator;
+template<typename T> class cISC4SimGrid;
+
+// An in-memory copy of the traffic simulator maps that are cleared when the
+// traffic simulator is restarted.
+//
+// The maps are run-length encoded, most of a city tile has no traffic so the
+// snapshot is usually a small fraction of the map size. Restoring the maps after
+// the restart prevents the city from appearing to have no traffic until the
+// traffic simulator has rebuilt them.
+class TrafficMapSnapshot
+{
+public:
+
+	TrafficMapSnapshot();
+
+	/**
+	 * @brief Copies the traffic maps.
+	 * @param pTrafficSimulator The traffic simulator.
+	 * @return True if at least one map was copied; otherwise, false.
+	 */
+	bool Capture(cISC4TrafficSimulator* pTrafficSimulator);
+
+	/**
+	 * @brief Writes the copied values back into the traffic maps.
+	 *
+	 * A map is skipped if its size changed since the snapshot was captured.
+	 * @param pTrafficSimulator The traffic simulator.
+	 * @return True if at least one map was restored; otherwise, false.
+	 */
+	bool Restore(cISC4TrafficSimulator* pTrafficSimulator) const;
+
+	void Clear();
+
+	size_t GetEncodedSize() const;
+	size_t GetMapSize() const;
+
+private:
+
+	enum TrafficMap : uint32_t
+	{
+		AirPollutingTraffic = 0,
+		CommercialTraffic,
+		Congestion,
+		TripLength,
+		TrafficMapCount
+	};
+
+	struct EncodedMap
+	{
+		bool valid;
+		int32_t countX;
+		int32_t countZ;
+		// Pairs of a run length and a value, the run length is between 1 and 255.
+		std::vector<uint8_t> runs;
+	};
+
+	static cISC4SimGrid<uint8_t>* GetMap(cISC4TrafficSimulator* pTrafficSimulator, TrafficMap map);
+	static void Encode(cISC4SimGrid<uint8_t>* pGrid, EncodedMap& encoded);
+	static bool Decode(const EncodedMap& encoded, cISC4SimGrid<uint8_t>* pGrid);
+
+	std::array<EncodedMap, TrafficMapCount> maps;
+};
@@ -0,0 +1,34 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <stdint.h>
+
+// The traffic simulator tuning exemplar values that the plugin and the offline tools use.
+namespace TrafficSimulatorTuning
+{
+	// The resource key of the traffic simulator tuning exemplar.
+	constexpr uint32_t kType = 0x6534284a;
+	constexpr uint32_t kGroup = 0xe7e2c2db;
+	constexpr uint32_t kInstance = 0xc9133286;
+
+	// Travel type can reach destination, a Boolean array with one item per travel type.
+	constexpr uint32_t kTravelTypeCanReachDestination = 0xA92356B5;
+	// The property order is walk, car, bus...
+	constexpr uint32_t kCarTravelTypeIndex = 1;
+	constexpr uint32_t kTravelTypeCount = 9;
+
+	// A Uint32 property that the BuildTuningOverride tool adds to the exemplar it writes,
+	// the value is kOverrideVersion. The game ignores the properties that it does not use.
+	constexpr uint32_t kParknRideOverrideVersion = 0x6a3f1c2d;
+	constexpr uint32_t kOverrideVersion = 1;
+}
@@ -0,0 +1,228 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "TrafficSummary.h"
+#include "SimGridReductions.h"
+#include "TransitSwitchIndex.h"
+#include "cISC4City.h"
+#include "cISC4SimGrid.h"
+#include "cISC4TrafficSimulator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	constexpr double kShareScale = 65535.0;
+	constexpr double kFixedPointScale = 256.0;
+	constexpr double kUsageScale = 10000.0;
+
+	uint16_t Quantize(double value, double scale)
+	{
+		return static_cast<uint16_t>(std::clamp(std::round(value * scale), 0.0, 65535.0));
+	}
+
+	uint16_t RoundedAverage(uint64_t sum, uint32_t count)
+	{
+		return static_cast<uint16_t>((sum + (count / 2)) / count);
+	}
+
+	SimGridView<uint8_t> GetMapView(intptr_t map)
+	{
+		return SimGridView<uint8_t>::FromGrid(reinterpret_cast<cISC4SimGrid<uint8_t>*>(map));
+	}
+}
+
+TrafficSummary::TrafficSummary()
+	: congestionShares(),
+	  averageCongestion(0),
+	  averageTripLength(0),
+	  transitSwitchUsage(0),
+	  flags(None),
+	  transitSwitchTrafficArrived(0)
+{
+}
+
+bool TrafficSummary::Capture(cISC4City* pCity, const TransitSwitchIndex* pTransitSwitches)
+{
+	*this = TrafficSummary();
+
+	cISC4TrafficSimulator* pTrafficSimulator = pCity ? pCity->GetTrafficSimulator() : nullptr;
+
+	if (!pTrafficSimulator)
+	{
+		return false;
+	}
+
+	const SimGridView<uint8_t> congestion = GetMapView(pTrafficSimulator->GetCongestionMap());
+	const SimGridView<uint8_t> tripLength = GetMapView(pTrafficSimulator->GetTripLengthMap());
+
+	if (congestion.IsValid() && tripLength.IsValid())
+	{
+		SimGridReductions::Histogram histogram;
+		SimGridReductions::BuildHistogram(congestion, histogram);
+
+		std::array<uint64_t, CongestionBucketCount> bucketTracts{};
+		uint64_t congestionSum = 0;
+
+		for (size_t value = 0; value < histogram.size(); value++)
+		{
+			bucketTracts[value >> CongestionBucketShift] += histogram[value];
+			congestionSum += value * histogram[value];
+		}
+
+		const double tractCount = static_cast<double>(congestion.Size());
+
+		for (uint32_t i = 0; i < CongestionBucketCount; i++)
+		{
+			congestionShares[i] = Quantize(static_cast<double>(bucketTracts[i]) / tractCount, kShareScale);
+		}
+
+		const uint64_t congestedTracts = congestion.Size() - histogram[0];
+
+		if (congestedTracts > 0)
+		{
+			averageCongestion = Quantize(static_cast<double>(congestionSum) / static_cast<double>(congestedTracts), kFixedPointScale);
+		}
+
+		const size_t tripTracts = SimGridReductions::CountAtLeast(tripLength, 1);
+
+		if (tripTracts > 0)
+		{
+			const uint64_t tripLengthSum = SimGridReductions::Sum(tripLength);
+
+			averageTripLength = Quantize(static_cast<double>(tripLengthSum) / static_cast<double>(tripTracts), kFixedPointScale);
+		}
+
+		flags |= TrafficMaps;
+	}
+
+	// The index keeps the city-wide totals as the switches are sampled, so the
+	// summary does not visit the transit switches.
+	if (pTransitSwitches && pTransitSwitches->IsBuilt())
+	{
+		const TransitSwitchIndex::UtilizationTotals& totals = pTransitSwitches->GetTotalUtilization();
+
+		if (totals.capacity > 0)
+		{
+			transitSwitchUsage = Quantize(static_cast<double>(totals.arrived) / static_cast<double>(totals.capacity), kUsageScale);
+		}
+
+		transitSwitchTrafficArrived = static_cast<uint32_t>(std::min<uint64_t>(totals.arrived, UINT32_MAX));
+		flags |= TransitSwitches;
+	}
+
+	return (flags & TrafficMaps) != 0;
+}
+
+bool TrafficSummary::HasTrafficMaps() const
+{
+	return (flags & TrafficMaps) != 0;
+}
+
+bool TrafficSummary::HasTransitSwitches() const
+{
+	return (flags & TransitSwitches) != 0;
+}
+
+double TrafficSummary::GetCongestionShare(uint32_t bucket) const
+{
+	return bucket < CongestionBucketCount ? static_cast<double>(congestionShares[bucket]) / kShareScale : 0.0;
+}
+
+double TrafficSummary::GetCongestionShareAtLeast(uint32_t bucket) const
+{
+	double share = 0.0;
+
+	for (uint32_t i = bucket; i < CongestionBucketCount; i++)
+	{
+		share += GetCongestionShare(i);
+	}
+
+	return share;
+}
+
+double TrafficSummary::GetAverageCongestion() const
+{
+	return static_cast<double>(averageCongestion) / kFixedPointScale;
+}
+
+double TrafficSummary::GetAverageTripLength() const
+{
+	return static_cast<double>(averageTripLength) / kFixedPointScale;
+}
+
+double TrafficSummary::GetTransitSwitchUsage() const
+{
+	return static_cast<double>(transitSwitchUsage) / kUsageScale;
+}
+
+uint32_t TrafficSummary::GetTransitSwitchTrafficArrived() const
+{
+	return transitSwitchTrafficArrived;
+}
+
+TrafficSummaryAccumulator::TrafficSummaryAccumulator()
+	: congestionShares(),
+	  averageCongestion(0),
+	  averageTripLength(0),
+	  transitSwitchUsage(0),
+	  transitSwitchTrafficArrived(0),
+	  flags(TrafficSummary::TrafficMaps | TrafficSummary::TransitSwitches),
+	  count(0)
+{
+}
+
+void TrafficSummaryAccumulator::Add(const TrafficSummary& summary)
+{
+	for (uint32_t i = 0; i < TrafficSummary::CongestionBucketCount; i++)
+	{
+		congestionShares[i] += summary.congestionShares[i];
+	}
+
+	averageCongestion += summary.averageCongestion;
+	averageTripLength += summary.averageTripLength;
+	transitSwitchUsage += summary.transitSwitchUsage;
+	transitSwitchTrafficArrived += summary.transitSwitchTrafficArrived;
+	flags &= summary.flags;
+	count++;
+}
+
+void TrafficSummaryAccumulator::Clear()
+{
+	*this = TrafficSummaryAccumulator();
+}
+
+uint32_t TrafficSummaryAccumulator::GetCount() const
+{
+	return count;
+}
+
+TrafficSummary TrafficSummaryAccumulator::GetAverage() const
+{
+	TrafficSummary average;
+
+	if (count > 0)
+	{
+		for (uint32_t i = 0; i < TrafficSummary::CongestionBucketCount; i++)
+		{
+			average.congestionShares[i] = RoundedAverage(congestionShares[i], count);
+		}
+
+		average.averageCongestion = RoundedAverage(averageCongestion, count);
+		average.averageTripLength = RoundedAverage(averageTripLength, count);
+		average.transitSwitchUsage = RoundedAverage(transitSwitchUsage, count);
+		average.transitSwitchTrafficArrived = static_cast<uint32_t>((transitSwitchTrafficArrived + (count / 2)) / count);
+		average.flags = flags;
+	}
+
+	return average;
+}
@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <array>
+#include <stdint.h>
+
+class cISC4City;
+class TransitSwitchIndex;
+
+// A compact, fixed-size summary of the city traffic.
+//
+// The values are quantized to 16-bit fixed point so a summary is a few dozen bytes,
+// which allows the features that compare the traffic over time to keep one for
+// every month or ordinance toggle.
+class TrafficSummary
+{
+public:
+
+	// The congestion map values are grouped into 16 buckets of 16 values.
+	static constexpr uint32_t CongestionBucketCount = 16;
+	static constexpr uint32_t CongestionBucketShift = 4;
+
+	TrafficSummary();
+
+	/**
+	 * @brief Summarizes the current traffic simulator state.
+	 * @param pCity The city.
+	 * @param pTransitSwitches The transit switch index, or null to leave out the transit switches.
+	 * The index totals are used as they are, they are as current as the ridership meter's last sample.
+	 * @return True if the traffic maps were read; otherwise, false.
+	 */
+	bool Capture(cISC4City* pCity, const TransitSwitchIndex* pTransitSwitches);
+
+	bool HasTrafficMaps() const;
+	bool HasTransitSwitches() const;
+
+	/**
+	 * @brief Gets the fraction of the congestion map tracts in the specified bucket.
+	 * @param bucket The bucket index, bucket 0 includes the tracts without traffic.
+	 */
+	double GetCongestionShare(uint32_t bucket) const;
+
+	/**
+	 * @brief Gets the fraction of the congestion map tracts that are at or above the specified bucket.
+	 */
+	double GetCongestionShareAtLeast(uint32_t bucket) const;
+
+	/**
+	 * @brief Gets the average congestion of the tracts that have traffic.
+	 */
+	double GetAverageCongestion() const;
+
+	/**
+	 * @brief Gets the average trip length map value of the tracts that have traffic.
+	 */
+	double GetAverageTripLength() const;
+
+	/**
+	 * @brief Gets the traffic that arrived at the transit switches divided by their trip capacity.
+	 */
+	double GetTransitSwitchUsage() const;
+
+	uint32_t GetTransitSwitchTrafficArrived() const;
+
+private:
+
+	friend class TrafficSummaryAccumulator;
+
+	enum Flags : uint16_t
+	{
+		None = 0,
+		TrafficMaps = 1 << 0,
+		TransitSwitches = 1 << 1,
+	};
+
+	// The fraction of the tracts in each bucket, 65535 is every tract.
+	std::array<uint16_t, CongestionBucketCount> congestionShares;
+	// The map averages in 8.8 fixed point.
+	uint16_t averageCongestion;
+	uint16_t averageTripLength;
+	// The transit switch usage in 1/10000 units.
+	uint16_t transitSwitchUsage;
+	uint16_t flags;
+	uint32_t transitSwitchTrafficArrived;
+};
+
+// Averages a series of traffic summaries without storing them.
+class TrafficSummaryAccumulator
+{
+public:
+
+	TrafficSummaryAccumulator();
+
+	void Add(const TrafficSummary& summary);
+
+	void Clear();
+
+	uint32_t GetCount() const;
+
+	/**
+	 * @brief Gets the average of the added summaries.
+	 *
+	 * The average only has the traffic maps or transit switches if every summary had them.
+	 */
+	TrafficSummary GetAverage() const;
+
+private:
+
+	std::array<uint64_t, TrafficSummary::CongestionBucketCount> congestionShares;
+	uint64_t averageCongestion;
+	uint64_t averageTripLength;
+	uint64_t transitSwitchUsage;
+	uint64_t transitSwitchTrafficArrived;
+	uint16_t flags;
+	uint32_t count;
+};
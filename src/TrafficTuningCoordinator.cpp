@@ -0,0 +1,943 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "TrafficTuningCoordinator.h"
+#include "SimGridReductions.h"
+#include "SimGridView.h"
+#include "Stopwatch.h"
+#include "TrafficSimulatorTuning.h"
+#include "cGZPersistResourceKey.h"
+#include "cIGZMessageServer.h"
+#include "cIGZMessageServer2.h"
+#include "cIGZPersistResourceManager.h"
+#include "cIGZString.h"
+#include "cISC4App.h"
+#include "cISC4City.h"
+#include "cISC4SimGrid.h"
+#include "cISC4Simulator.h"
+#include "cISC4TrafficSimulator.h"
+#include "cISCProperty.h"
+#include "cISCPropertyHolder.h"
+#include "cIGZVariant.h"
+#include "cRZMessage2Standard.h"
+#include "GZServPtrs.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Runs after the other tick services, the game systems will have finished
+	// processing the current frame by that point.
+	constexpr int32_t kTrafficTuningCoordinatorServicePriority = -1000000;
+
+	// The congestion map is considered to have converged after a restart when the mean
+	// absolute change of its values from one simulation day to the next stays below the
+	// tolerance for a week. The change is averaged over the tracts that had traffic before
+	// the restart, so it does not depend on how much of the city has traffic.
+	constexpr double kMapConvergenceTolerance = 0.25;
+	constexpr int32_t kMapConvergenceStableDays = 7;
+	constexpr int32_t kMaxMapConvergenceDays = 365;
+
+	SimGridView<uint8_t> GetCongestionMapView(cISC4TrafficSimulator* pTrafficSim)
+	{
+		return SimGridView<uint8_t>::FromGrid(reinterpret_cast<cISC4SimGrid<uint8_t>*>(pTrafficSim->GetCongestionMap()));
+	}
+
+	void CopyValues(const SimGridView<uint8_t>& view, std::vector<uint8_t>& values)
+	{
+		if (view.IsValid())
+		{
+			values.assign(view.Data(), view.Data() + view.Size());
+		}
+		else
+		{
+			values.clear();
+		}
+	}
+
+	void RunMessageServerPump(int maxIterations, int maxTimeInMilliseconds)
+	{
+		cIGZMessageServerPtr pMsgServ;
+
+		if (pMsgServ)
+		{
+			Stopwatch timer;
+			timer.Start();
+
+			for (int i = 0; i < maxIterations; i++)
+			{
+				int queueSize = pMsgServ->GetMessageQueueSize();
+
+				if (queueSize == 0)
+				{
+					break;
+				}
+
+				pMsgServ->OnTick(0);
+
+				int64_t elapsedMilliseconds = timer.ElapsedMilliseconds();
+
+				if (elapsedMilliseconds > maxTimeInMilliseconds)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	void RunMessageServer2Pump(int maxIterations, int maxTimeInMilliseconds)
+	{
+		cIGZMessageServer2Ptr pMsgServ;
+
+		if (pMsgServ)
+		{
+			Stopwatch timer;
+			timer.Start();
+
+			for (int i = 0; i < maxIterations; i++)
+			{
+				int queueSize = pMsgServ->GetMessageQueueSize();
+
+				if (queueSize == 0)
+				{
+					break;
+				}
+
+				pMsgServ->OnTick(0);
+
+				int64_t elapsedMilliseconds = timer.ElapsedMilliseconds();
+
+				if (elapsedMilliseconds > maxTimeInMilliseconds)
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	bool* GetBoolArrayItem(cISCPropertyHolder* propertyHolder, uint32_t propertyID, uint32_t index)
+	{
+		bool* item = nullptr;
+
+		cISCProperty* property = propertyHolder->GetProperty(propertyID);
+
+		if (property)
+		{
+			cIGZVariant* data = property->GetPropertyValue();
+
+			if (data
+				&& data->GetType() == cIGZVariant::Type::BoolArray
+				&& index < data->GetCount())
+			{
+				item = data->RefBool() + index;
+			}
+		}
+
+		return item;
+	}
+}
+
+TrafficTuningCoordinator::TrafficTuningCoordinator()
+	: TickServiceBase(GZCLSID_cTrafficTuningCoordinator, kTrafficTuningCoordinatorServicePriority),
+	  logger(Logger::GetInstance()),
+	  pendingUpdateMode(TrafficSimulatorUpdateMode::None),
+	  participants(),
+	  pendingEdits(),
+	  lastEdits(),
+	  seedTrafficMapsOnRestart(true),
+	  trafficMapSnapshot(),
+	  mapConvergence(),
+	  lastMapConvergenceDays(-1)
+{
+}
+
+bool TrafficTuningCoordinator::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cITrafficTuningCoordinator)
+	{
+		AddRef();
+		*ppvObj = static_cast<cITrafficTuningCoordinator*>(this);
+
+		return true;
+	}
+	else if (riid == GZIID_cITrafficTuningCoordinatorTiming)
+	{
+		AddRef();
+		*ppvObj = static_cast<cITrafficTuningCoordinatorTiming*>(this);
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		AddRef();
+		*ppvObj = static_cast<cIGZUnknown*>(static_cast<cITrafficTuningCoordinator*>(this));
+
+		return true;
+	}
+
+	return TickServiceBase::QueryInterface(riid, ppvObj);
+}
+
+uint32_t TrafficTuningCoordinator::AddRef()
+{
+	return TickServiceBase::AddRef();
+}
+
+uint32_t TrafficTuningCoordinator::Release()
+{
+	return TickServiceBase::Release();
+}
+
+bool TrafficTuningCoordinator::RegisterParticipant(uint32_t participantID, cIGZString const& name)
+{
+	for (Participant& participant : participants)
+	{
+		if (participant.id == participantID)
+		{
+			participant.name.assign(name.ToChar(), name.Strlen());
+			return true;
+		}
+	}
+
+	participants.push_back(Participant{
+		participantID,
+		std::string(name.ToChar(), name.Strlen()),
+		BatchTimeState::None,
+		0 });
+
+	logger.WriteLineFormatted(
+		LogOptions::Info,
+		"Traffic tuning coordinator: registered participant '%s' (0x%08x).",
+		participants.back().name.c_str(),
+		participantID);
+
+	return true;
+}
+
+bool TrafficTuningCoordinator::QueueBoolArrayEdit(
+	uint32_t participantID,
+	uint32_t propertyID,
+	uint32_t index,
+	bool value,
+	TrafficSimulatorUpdateMode updateMode)
+{
+	pendingEdits.push_back(BoolArrayEdit{ participantID, propertyID, index, value });
+	pendingUpdateMode = std::max(pendingUpdateMode, updateMode);
+
+	ScheduleFlush();
+
+	return true;
+}
+
+bool TrafficTuningCoordinator::Flush(bool pauseGame)
+{
+	if (pendingEdits.empty())
+	{
+		return true;
+	}
+
+	bool batchTimed = false;
+
+	for (Participant& participant : participants)
+	{
+		if (participant.batchTimeState == BatchTimeState::Requested && HasPendingEdit(participant.id))
+		{
+			participant.batchTimeState = BatchTimeState::Measuring;
+			batchTimed = true;
+		}
+	}
+
+	Stopwatch stopwatch;
+	stopwatch.Start();
+
+	const bool result = ApplyPendingEdits(pauseGame);
+
+	stopwatch.Stop();
+
+	if (batchTimed)
+	{
+		const int64_t elapsedMicroseconds = stopwatch.ElapsedMicroseconds();
+
+		for (Participant& participant : participants)
+		{
+			if (participant.batchTimeState == BatchTimeState::Measuring)
+			{
+				participant.batchTimeState = BatchTimeState::Available;
+				participant.batchTimeMicroseconds = elapsedMicroseconds;
+			}
+		}
+	}
+
+	return result;
+}
+
+bool TrafficTuningCoordinator::ApplyPendingEdits(bool pauseGame)
+{
+	const TrafficSimulatorUpdateMode updateMode = pendingUpdateMode;
+	pendingUpdateMode = TrafficSimulatorUpdateMode::None;
+
+	LogConflictingEdits();
+
+	cISC4SimulatorPtr pSimulator;
+
+	if (!pSimulator)
+	{
+		logger.WriteLine(LogOptions::Errors, "The cISC4Simulator pointer was null.");
+		pendingEdits.clear();
+		return false;
+	}
+
+	// Pause the game before restarting the traffic simulator, this prevents the other
+	// simulators from using it while it is shut down.
+	// A caller can skip the pause for a batch that only reloads the tunable values.
+	if (updateMode == TrafficSimulatorUpdateMode::Restart)
+	{
+		pauseGame = true;
+	}
+
+	if (pauseGame)
+	{
+		if (!pSimulator->HiddenPause())
+		{
+			logger.WriteLine(LogOptions::Errors, "Failed to pause the game.");
+			pendingEdits.clear();
+			return false;
+		}
+
+		constexpr int maxIterations = 500;
+		constexpr int maxTimeInMilliseconds = 5000;
+
+		// Process messages for a few seconds, this allows the pause
+		// message subscribers time to process to the message.
+		RunMessageServerPump(maxIterations, maxTimeInMilliseconds);
+		RunMessageServer2Pump(maxIterations, maxTimeInMilliseconds);
+	}
+
+	bool result = false;
+
+	cIGZPersistResourceManagerPtr pResourceManager;
+	if (pResourceManager)
+	{
+		cGZPersistResourceKey key(TrafficSimulatorTuning::kType, TrafficSimulatorTuning::kGroup, TrafficSimulatorTuning::kInstance);
+		cISCPropertyHolder* propertyHolder = nullptr;
+		bool valueChanged = false;
+
+		// Load the traffic simulator tuning exemplar.
+		// The game will temporarily cache the loaded exemplar, which allows us
+		// to modify the in-memory copy.
+
+		result = pResourceManager->GetResource(
+			key,
+			GZIID_cISCPropertyHolder,
+			reinterpret_cast<void**>(&propertyHolder),
+			0,
+			nullptr);
+
+		if (result)
+		{
+			CheckForExternalChanges(propertyHolder);
+			valueChanged = ApplyEdits(propertyHolder);
+
+			propertyHolder->Release();
+			propertyHolder = nullptr;
+		}
+		else
+		{
+			logger.WriteLine(LogOptions::Errors, "Failed to load the traffic simulator tuning exemplar.");
+		}
+
+		if (valueChanged)
+		{
+			// If we modified the in-memory copy of the traffic simulator tuning exemplar
+			// we notify the traffic simulator once for the entire batch.
+			// After that message is sent we verify that the in-memory modifications are
+			// still present.
+			UpdateTrafficSimulator(updateMode);
+
+			if (pResourceManager->GetResource(
+				key,
+				GZIID_cISCPropertyHolder,
+				reinterpret_cast<void**>(&propertyHolder),
+				0,
+				nullptr))
+			{
+				CheckForExternalChanges(propertyHolder);
+
+				propertyHolder->Release();
+				propertyHolder = nullptr;
+			}
+		}
+	}
+
+	pendingEdits.clear();
+
+	if (pauseGame && !pSimulator->HiddenResume())
+	{
+		logger.WriteLine(LogOptions::Errors, "Failed to resume the game.");
+	}
+
+	return result;
+}
+
+void TrafficTuningCoordinator::SetSeedTrafficMapsOnRestart(bool value)
+{
+	seedTrafficMapsOnRestart = value;
+}
+
+int32_t TrafficTuningCoordinator::GetLastMapConvergenceDays() const
+{
+	return lastMapConvergenceDays;
+}
+
+bool TrafficTuningCoordinator::IsPrecompiledOverrideInstalled()
+{
+	bool result = false;
+
+	cIGZPersistResourceManagerPtr pResourceManager;
+	if (pResourceManager)
+	{
+		cGZPersistResourceKey key(TrafficSimulatorTuning::kType, TrafficSimulatorTuning::kGroup, TrafficSimulatorTuning::kInstance);
+		cISCPropertyHolder* propertyHolder = nullptr;
+
+		if (pResourceManager->GetResource(
+			key,
+			GZIID_cISCPropertyHolder,
+			reinterpret_cast<void**>(&propertyHolder),
+			0,
+			nullptr))
+		{
+			const bool* carCanReachDestination = GetBoolArrayItem(
+				propertyHolder,
+				TrafficSimulatorTuning::kTravelTypeCanReachDestination,
+				TrafficSimulatorTuning::kCarTravelTypeIndex);
+
+			// The car value is checked as well, a plugin that loads after the override
+			// could have replaced it with a copy that still has the marker.
+			result = propertyHolder->HasProperty(TrafficSimulatorTuning::kParknRideOverrideVersion)
+				&& carCanReachDestination
+				&& !*carCanReachDestination;
+
+			propertyHolder->Release();
+		}
+	}
+
+	return result;
+}
+
+bool TrafficTuningCoordinator::GetLastEditor(uint32_t propertyID, uint32_t index, uint32_t& participantID) const
+{
+	for (const BoolArrayEdit& edit : lastEdits)
+	{
+		if (edit.propertyID == propertyID && edit.index == index)
+		{
+			participantID = edit.participantID;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TrafficTuningCoordinator::RequestBatchTime(uint32_t participantID)
+{
+	Participant* participant = FindParticipant(participantID);
+
+	if (!participant)
+	{
+		return false;
+	}
+
+	participant->batchTimeState = BatchTimeState::Requested;
+	participant->batchTimeMicroseconds = 0;
+
+	return true;
+}
+
+bool TrafficTuningCoordinator::GetBatchTime(uint32_t participantID, int64_t& elapsedMicroseconds)
+{
+	Participant* participant = FindParticipant(participantID);
+
+	if (!participant || participant->batchTimeState != BatchTimeState::Available)
+	{
+		return false;
+	}
+
+	elapsedMicroseconds = participant->batchTimeMicroseconds;
+	participant->batchTimeState = BatchTimeState::None;
+
+	return true;
+}
+
+bool TrafficTuningCoordinator::Shutdown()
+{
+	pendingEdits.clear();
+	pendingUpdateMode = TrafficSimulatorUpdateMode::None;
+
+	return TickServiceBase::Shutdown();
+}
+
+bool TrafficTuningCoordinator::OnTick()
+{
+	if (!pendingEdits.empty())
+	{
+		Flush(/*pauseGame*/true);
+	}
+
+	if (mapConvergence.active)
+	{
+		UpdateMapConvergenceMeasurement();
+	}
+
+	return true;
+}
+
+const char* TrafficTuningCoordinator::GetParticipantName(uint32_t participantID) const
+{
+	for (const Participant& participant : participants)
+	{
+		if (participant.id == participantID)
+		{
+			return participant.name.c_str();
+		}
+	}
+
+	return "<unregistered>";
+}
+
+TrafficTuningCoordinator::Participant* TrafficTuningCoordinator::FindParticipant(uint32_t participantID)
+{
+	for (Participant& participant : participants)
+	{
+		if (participant.id == participantID)
+		{
+			return &participant;
+		}
+	}
+
+	return nullptr;
+}
+
+bool TrafficTuningCoordinator::HasPendingEdit(uint32_t participantID) const
+{
+	for (const BoolArrayEdit& edit : pendingEdits)
+	{
+		if (edit.participantID == participantID)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+TrafficTuningCoordinator::BoolArrayEdit* TrafficTuningCoordinator::FindLastEdit(uint32_t propertyID, uint32_t index)
+{
+	for (BoolArrayEdit& edit : lastEdits)
+	{
+		if (edit.propertyID == propertyID && edit.index == index)
+		{
+			return &edit;
+		}
+	}
+
+	return nullptr;
+}
+
+void TrafficTuningCoordinator::LogConflictingEdits() const
+{
+	// Edits are applied in the order they were queued, so the last participant wins.
+	// Two participants that disagree within the same batch is reported as a conflict.
+	const size_t editCount = pendingEdits.size();
+
+	for (size_t i = 1; i < editCount; i++)
+	{
+		const BoolArrayEdit& edit = pendingEdits[i];
+
+		for (size_t j = 0; j < i; j++)
+		{
+			const BoolArrayEdit& earlierEdit = pendingEdits[j];
+
+			if (earlierEdit.propertyID == edit.propertyID
+				&& earlierEdit.index == edit.index
+				&& earlierEdit.participantID != edit.participantID
+				&& earlierEdit.value != edit.value)
+			{
+				logger.WriteLineFormatted(
+					LogOptions::Errors,
+					"Traffic tuning conflict: '%s' set property 0x%08x[%u] to %s, overriding '%s'.",
+					GetParticipantName(edit.participantID),
+					edit.propertyID,
+					edit.index,
+					edit.value ? "true" : "false",
+					GetParticipantName(earlierEdit.participantID));
+			}
+		}
+	}
+}
+
+void TrafficTuningCoordinator::CheckForExternalChanges(cISCPropertyHolder* propertyHolder) const
+{
+	for (const BoolArrayEdit& edit : lastEdits)
+	{
+		const bool* item = GetBoolArrayItem(propertyHolder, edit.propertyID, edit.index);
+
+		if (item && *item != edit.value)
+		{
+			logger.WriteLineFormatted(
+				LogOptions::Errors,
+				"Someone else changed property 0x%08x[%u] after '%s' set it to %s, cache refresh?.",
+				edit.propertyID,
+				edit.index,
+				GetParticipantName(edit.participantID),
+				edit.value ? "true" : "false");
+		}
+	}
+}
+
+bool TrafficTuningCoordinator::ApplyEdits(cISCPropertyHolder* propertyHolder)
+{
+	bool valueChanged = false;
+
+	for (const BoolArrayEdit& edit : pendingEdits)
+	{
+		cISCProperty* property = propertyHolder->GetProperty(edit.propertyID);
+
+		if (!property)
+		{
+			logger.WriteLineFormatted(
+				LogOptions::Errors,
+				"The property 0x%08x requested by '%s' does not exist.",
+				edit.propertyID,
+				GetParticipantName(edit.participantID));
+			continue;
+		}
+
+		cIGZVariant* data = property->GetPropertyValue();
+
+		if (!data)
+		{
+			logger.WriteLineFormatted(
+				LogOptions::Errors,
+				"The property 0x%08x data was null.",
+				edit.propertyID);
+			continue;
+		}
+
+		const uint16_t type = data->GetType();
+		const uint32_t count = data->GetCount();
+
+		if (type != cIGZVariant::Type::BoolArray || edit.index >= count)
+		{
+			logger.WriteLineFormatted(
+				LogOptions::Errors,
+				"The property 0x%08x data has an unexpected type and/or count, type=0x%04x, count=%u."
+				" '%s' expected type=0x8001 with at least %u items.",
+				edit.propertyID,
+				type,
+				count,
+				GetParticipantName(edit.participantID),
+				edit.index + 1);
+			continue;
+		}
+
+		bool* item = data->RefBool() + edit.index;
+
+		if (*item != edit.value)
+		{
+			logger.WriteLineFormatted(
+				LogOptions::Info,
+				"'%s' is setting property 0x%08x[%u] to %s.",
+				GetParticipantName(edit.participantID),
+				edit.propertyID,
+				edit.index,
+				edit.value ? "true" : "false");
+
+			*item = edit.value;
+			valueChanged = true;
+		}
+
+		BoolArrayEdit* lastEdit = FindLastEdit(edit.propertyID, edit.index);
+
+		if (lastEdit)
+		{
+			*lastEdit = edit;
+		}
+		else
+		{
+			lastEdits.push_back(edit);
+		}
+	}
+
+	return valueChanged;
+}
+
+void TrafficTuningCoordinator::UpdateTrafficSimulator(TrafficSimulatorUpdateMode updateMode)
+{
+	if (updateMode == TrafficSimulatorUpdateMode::None)
+	{
+		return;
+	}
+
+	cISC4AppPtr pSC4App;
+	cISC4City* pCity = pSC4App ? pSC4App->GetCity() : nullptr;
+
+	if (!pCity)
+	{
+		logger.WriteLine(
+			LogOptions::Errors,
+			"The city pointer was null.");
+		return;
+	}
+
+	cISC4TrafficSimulator* pTrafficSim = pCity->GetTrafficSimulator();
+
+	if (!pTrafficSim)
+	{
+		logger.WriteLine(
+			LogOptions::Errors,
+			"The traffic simulator pointer was null.");
+		return;
+	}
+
+	if (updateMode == TrafficSimulatorUpdateMode::ReloadTunables)
+	{
+		// A number of the games's simulators support a message that forces
+		// them to reload their tunable values.
+		// The message takes 2 integer parameters that identify the intended
+		// target. These values appear to be the group and instance IDs of
+		// the simulator's tuning exemplar.
+		//
+		// This feature was likely used during SC4's development to allow
+		// the tuning values to be applied after they were modified in the
+		// in-game editor.
+
+		constexpr uint32_t kSC4MessageReloadTunableValues = 0xC53D10AA;
+
+		logger.WriteLine(
+			LogOptions::Info,
+			"Sending the updated tuning values to the traffic simulator.");
+
+		// We bypass the game's messaging system and dispatch the message directly to the
+		// target method in the traffic simulator.
+		cIGZMessageTarget2* target = static_cast<cIGZMessageTarget2*>(pTrafficSim);
+		cRZMessage2Standard message;
+
+		message.SetType(kSC4MessageReloadTunableValues);
+		message.SetData1(TrafficSimulatorTuning::kGroup);
+		message.SetData2(TrafficSimulatorTuning::kInstance);
+
+		target->DoMessage(static_cast<cIGZMessage2*>(static_cast<cIGZMessage2Standard*>(&message)));
+	}
+	else
+	{
+		// Restarting the traffic simulator in PostCityInit crashes the game, callers
+		// that run from that message must request TrafficSimulatorUpdateMode::ReloadTunables.
+
+		logger.WriteLine(
+			LogOptions::Info,
+			"Restarting the traffic simulator for the tuning value changes.");
+
+		RestartTrafficSimulator(pCity, pTrafficSim);
+	}
+}
+
+void TrafficTuningCoordinator::RestartTrafficSimulator(cISC4City* pCity, cISC4TrafficSimulator* pTrafficSim)
+{
+	// The traffic simulator clears its maps when it is shut down, and it takes several
+	// simulation months to rebuild them. A copy of the maps is written back after the
+	// restart, so the city does not appear to be free of traffic in the meantime.
+	Stopwatch stopwatch;
+	stopwatch.Start();
+
+	const bool captured = trafficMapSnapshot.Capture(pTrafficSim);
+
+	stopwatch.Stop();
+
+	// The convergence is measured relative to the tracts that had traffic before the restart.
+	const SimGridView<uint8_t> previousCongestionMap = GetCongestionMapView(pTrafficSim);
+	const size_t previousMapSize = previousCongestionMap.Size();
+	const size_t trafficTractCount = previousCongestionMap.IsValid() ? SimGridReductions::CountAtLeast(previousCongestionMap, 1) : 0;
+
+	if (captured)
+	{
+		logger.WriteLineFormatted(
+			LogOptions::Profiling,
+			"Captured the traffic maps, %zu tracts encoded as %zu bytes in %lld us.",
+			trafficMapSnapshot.GetMapSize(),
+			trafficMapSnapshot.GetEncodedSize(),
+			stopwatch.ElapsedMicroseconds());
+	}
+
+	pTrafficSim->Shutdown();
+	pTrafficSim->Init();
+
+	// Dispatch a PostCityInit message directly to the traffic simulator.
+	// This is required for it to reinitialize its data after we restarted it.
+	// This bypasses the game's messaging system, because broadcasting that message
+	// to the other game systems would probably cause more issues.
+	constexpr uint32_t kSC4MessagePostCityInit = 0x26D31EC1;
+
+	cIGZMessageTarget2* target = static_cast<cIGZMessageTarget2*>(pTrafficSim);
+	cRZMessage2Standard message;
+
+	message.SetType(kSC4MessagePostCityInit);
+	message.SetVoid1(pCity); // The first parameter is always a pointer to the city.
+	message.SetIGZUnknown(pCity);
+	message.SetData2(1); // This parameter is always 1 for a city that has been loaded.
+	message.SetData3(0); // This parameter is always 0.
+
+	target->DoMessage(static_cast<cIGZMessage2*>(static_cast<cIGZMessage2Standard*>(&message)));
+
+	bool seeded = false;
+
+	if (captured && seedTrafficMapsOnRestart)
+	{
+		stopwatch.Restart();
+
+		seeded = trafficMapSnapshot.Restore(pTrafficSim);
+
+		stopwatch.Stop();
+
+		logger.WriteLineFormatted(
+			LogOptions::Profiling,
+			"%s the traffic maps in %lld us.",
+			seeded ? "Restored" : "Failed to restore",
+			stopwatch.ElapsedMicroseconds());
+	}
+
+	cISC4Simulator* pSimulator = pCity->GetSimulator();
+
+	mapConvergence.active = false;
+	mapConvergence.trafficTractCount = trafficTractCount;
+
+	CopyValues(GetCongestionMapView(pTrafficSim), mapConvergence.lastValues);
+
+	if (pSimulator
+		&& trafficTractCount > 0
+		&& mapConvergence.lastValues.size() == previousMapSize)
+	{
+		const int32_t simDate = pSimulator->GetSimDateNumber();
+
+		mapConvergence.active = true;
+		mapConvergence.seeded = seeded;
+		mapConvergence.startDate = simDate;
+		mapConvergence.lastDate = simDate;
+		mapConvergence.stableDays = 0;
+		lastMapConvergenceDays = -1;
+	}
+	else
+	{
+		mapConvergence.lastValues.clear();
+	}
+
+	trafficMapSnapshot.Clear();
+}
+
+void TrafficTuningCoordinator::UpdateMapConvergenceMeasurement()
+{
+	cISC4AppPtr pSC4App;
+	cISC4City* pCity = pSC4App ? pSC4App->GetCity() : nullptr;
+	cISC4Simulator* pSimulator = pCity ? pCity->GetSimulator() : nullptr;
+	cISC4TrafficSimulator* pTrafficSim = pCity ? pCity->GetTrafficSimulator() : nullptr;
+
+	if (!pSimulator || !pTrafficSim)
+	{
+		// The city was closed.
+		mapConvergence.active = false;
+		mapConvergence.lastValues.clear();
+		return;
+	}
+
+	// The congestion map is checked once per simulation day.
+	const int32_t simDate = pSimulator->GetSimDateNumber();
+
+	if (simDate == mapConvergence.lastDate)
+	{
+		return;
+	}
+
+	mapConvergence.lastDate = simDate;
+
+	const SimGridView<uint8_t> congestionMap = GetCongestionMapView(pTrafficSim);
+
+	if (!congestionMap.IsValid() || congestionMap.Size() != mapConvergence.lastValues.size())
+	{
+		mapConvergence.active = false;
+		mapConvergence.lastValues.clear();
+		return;
+	}
+
+	const uint8_t* values = congestionMap.Data();
+	uint64_t changeSum = 0;
+
+	for (size_t i = 0; i < congestionMap.Size(); i++)
+	{
+		const uint8_t lastValue = mapConvergence.lastValues[i];
+
+		changeSum += values[i] > lastValue ? values[i] - lastValue : lastValue - values[i];
+		mapConvergence.lastValues[i] = values[i];
+	}
+
+	const int32_t elapsedDays = simDate - mapConvergence.startDate;
+	const double meanChange = static_cast<double>(changeSum) / static_cast<double>(mapConvergence.trafficTractCount);
+
+	if (meanChange < kMapConvergenceTolerance)
+	{
+		mapConvergence.stableDays++;
+	}
+	else
+	{
+		mapConvergence.stableDays = 0;
+	}
+
+	if (mapConvergence.stableDays >= kMapConvergenceStableDays)
+	{
+		// The map converged on the day before the first day of the stable run.
+		lastMapConvergenceDays = elapsedDays - mapConvergence.stableDays;
+
+		logger.WriteLineFormatted(
+			LogOptions::Profiling,
+			"The congestion map converged %d days after the traffic simulator restart (%s).",
+			lastMapConvergenceDays,
+			mapConvergence.seeded ? "seeded" : "not seeded");
+
+		mapConvergence.active = false;
+	}
+	else if (elapsedDays >= kMaxMapConvergenceDays)
+	{
+		logger.WriteLineFormatted(
+			LogOptions::Profiling,
+			"The congestion map did not converge within %d days of the traffic simulator restart (%s),"
+			" the mean daily change is %.2f.",
+			kMaxMapConvergenceDays,
+			mapConvergence.seeded ? "seeded" : "not seeded",
+			meanChange);
+
+		mapConvergence.active = false;
+	}
+
+	if (!mapConvergence.active)
+	{
+		mapConvergence.lastValues.clear();
+	}
+}
+
+void TrafficTuningCoordinator::ScheduleFlush()
+{
+	if (!RegisterTick())
+	{
+		// Without a tick callback the edits are applied immediately, this
+		// matches the behavior of a plugin that does not use a coordinator.
+		logger.WriteLine(LogOptions::Errors, "Failed to register the traffic tuning coordinator tick service.");
+		Flush(/*pauseGame*/true);
+	}
+}
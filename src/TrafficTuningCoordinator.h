@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cITrafficTuningCoordinator.h"
+#include "Logger.h"
+#include "TickServiceBase.h"
+#include "TrafficMapSnapshot.h"
+#include <string>
+#include <vector>
+
+class cISC4City;
+class cISC4TrafficSimulator;
+class cISCPropertyHolder;
+
+// The coordinator that is used when this plugin is the first participant to load.
+// It is registered with the framework as a tick service so that the edits queued
+// during a frame are applied together at the start of the next frame.
+class TrafficTuningCoordinator final
+	: public cITrafficTuningCoordinator,
+	  public cITrafficTuningCoordinatorTiming,
+	  public TickServiceBase
+{
+public:
+
+	TrafficTuningCoordinator();
+
+	bool QueryInterface(uint32_t riid, void** ppvObj) override;
+	uint32_t AddRef() override;
+	uint32_t Release() override;
+
+	bool RegisterParticipant(uint32_t participantID, cIGZString const& name) override;
+
+	bool QueueBoolArrayEdit(
+		uint32_t participantID,
+		uint32_t propertyID,
+		uint32_t index,
+		bool value,
+		TrafficSimulatorUpdateMode updateMode) override;
+
+	bool Flush(bool pauseGame) override;
+
+	bool GetLastEditor(uint32_t propertyID, uint32_t index, uint32_t& participantID) const override;
+
+	bool RequestBatchTime(uint32_t participantID) override;
+	bool GetBatchTime(uint32_t participantID, int64_t& elapsedMicroseconds) override;
+
+	// Controls whether the traffic maps are restored after the traffic simulator is restarted.
+	void SetSeedTrafficMapsOnRestart(bool value);
+
+	// Gets the number of simulation days that the congestion map took to converge after the
+	// last restart, or -1 if it has not converged yet. The map has converged once its values
+	// stop changing from one simulation day to the next.
+	int32_t GetLastMapConvergenceDays() const;
+
+	// Determines whether the loaded traffic simulator tuning exemplar is the precompiled override
+	// that the BuildTuningOverride tool writes, in which case cars are always restricted and the
+	// cached exemplar does not need to be edited.
+	static bool IsPrecompiledOverrideInstalled();
+
+	bool Shutdown() override;
+	bool OnTick() override;
+
+private:
+
+	enum class BatchTimeState : uint32_t
+	{
+		None = 0,
+		Requested,
+		Measuring,
+		Available,
+	};
+
+	struct Participant
+	{
+		uint32_t id;
+		std::string name;
+		BatchTimeState batchTimeState;
+		int64_t batchTimeMicroseconds;
+	};
+
+	struct BoolArrayEdit
+	{
+		uint32_t participantID;
+		uint32_t propertyID;
+		uint32_t index;
+		bool value;
+	};
+
+	// Tracks the congestion map after a restart until the traffic simulator has converged.
+	struct MapConvergenceMeasurement
+	{
+		bool active;
+		bool seeded;
+		int32_t startDate;
+		int32_t lastDate;
+		// The congestion map values on the last measured day.
+		std::vector<uint8_t> lastValues;
+		// The number of tracts that had traffic before the restart.
+		size_t trafficTractCount;
+		// The number of consecutive days that the map changed less than the tolerance.
+		int32_t stableDays;
+	};
+
+	const char* GetParticipantName(uint32_t participantID) const;
+	Participant* FindParticipant(uint32_t participantID);
+	bool HasPendingEdit(uint32_t participantID) const;
+	bool ApplyPendingEdits(bool pauseGame);
+	BoolArrayEdit* FindLastEdit(uint32_t propertyID, uint32_t index);
+	void LogConflictingEdits() const;
+	void CheckForExternalChanges(cISCPropertyHolder* propertyHolder) const;
+	bool ApplyEdits(cISCPropertyHolder* propertyHolder);
+	void UpdateTrafficSimulator(TrafficSimulatorUpdateMode updateMode);
+	void RestartTrafficSimulator(cISC4City* pCity, cISC4TrafficSimulator* pTrafficSim);
+	void UpdateMapConvergenceMeasurement();
+	void ScheduleFlush();
+
+	Logger& logger;
+	TrafficSimulatorUpdateMode pendingUpdateMode;
+	std::vector<Participant> participants;
+	std::vector<BoolArrayEdit> pendingEdits;
+	// The most recent value that each participant wrote to an exemplar item.
+	// This allows changes made without going through the coordinator to be detected.
+	std::vector<BoolArrayEdit> lastEdits;
+	bool seedTrafficMapsOnRestart;
+	TrafficMapSnapshot trafficMapSnapshot;
+	MapConvergenceMeasurement mapConvergence;
+	int32_t lastMapConvergenceDays;
+};
@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "TrafficTuningOverride.h"
+#include "TrafficSimulatorTuning.h"
+#include <cstring>
+
+namespace
+{
+	bool IsValidTravelTypeArray(const DBPFExemplar::Property* property)
+	{
+		return property
+			&& property->type == DBPFExemplar::ValueType::Bool
+			&& property->isArray
+			&& property->count == TrafficSimulatorTuning::kTravelTypeCount;
+	}
+}
+
+bool TrafficTuningOverride::Apply(DBPFExemplar& exemplar)
+{
+	const DBPFExemplar::Property* installed = exemplar.FindProperty(TrafficSimulatorTuning::kTravelTypeCanReachDestination);
+
+	if (!IsValidTravelTypeArray(installed))
+	{
+		return false;
+	}
+
+	DBPFExemplar::Property travelTypes = *installed;
+	travelTypes.values[TrafficSimulatorTuning::kCarTravelTypeIndex] = 0;
+
+	DBPFExemplar::Property marker
+	{
+		TrafficSimulatorTuning::kParknRideOverrideVersion,
+		DBPFExemplar::ValueType::Uint32,
+		false,
+		1,
+		std::vector<uint8_t>(sizeof(uint32_t)),
+	};
+
+	std::memcpy(marker.values.data(), &TrafficSimulatorTuning::kOverrideVersion, sizeof(uint32_t));
+
+	return exemplar.SetProperty(travelTypes) && exemplar.SetProperty(marker);
+}
+
+bool TrafficTuningOverride::IsApplied(const DBPFExemplar& exemplar)
+{
+	const DBPFExemplar::Property* travelTypes = exemplar.FindProperty(TrafficSimulatorTuning::kTravelTypeCanReachDestination);
+	const DBPFExemplar::Property* marker = exemplar.FindProperty(TrafficSimulatorTuning::kParknRideOverrideVersion);
+
+	return IsValidTravelTypeArray(travelTypes)
+		&& travelTypes->values[TrafficSimulatorTuning::kCarTravelTypeIndex] == 0
+		&& marker
+		&& marker->type == DBPFExemplar::ValueType::Uint32
+		&& marker->count == 1;
+}
@@ -0,0 +1,35 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "DBPFExemplar.h"
+
+// Creates the precompiled traffic simulator tuning exemplar that restricts cars permanently.
+//
+// A plugin DAT with this exemplar replaces the game's copy when SimCity 4 loads, so the plugin
+// does not need to edit the cached exemplar and reload the traffic simulator when a city loads.
+namespace TrafficTuningOverride
+{
+	/**
+	 * @brief Applies the Park & Ride car restriction to a copy of the installed tuning exemplar.
+	 * The car travel type is made unable to reach its destination and the override marker is added,
+	 * the other properties are kept.
+	 * @param exemplar The installed traffic simulator tuning exemplar.
+	 * @return True on success; otherwise, false if the exemplar does not have a valid travel type array.
+	 */
+	bool Apply(DBPFExemplar& exemplar);
+
+	/**
+	 * @brief Determines whether an exemplar is a precompiled override with the car restriction.
+	 */
+	bool IsApplied(const DBPFExemplar& exemplar);
+}
@@ -0,0 +1,464 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "TransitSwitchIndex.h"
+#include "SC4Rect.h"
+#include "cISC4City.h"
+#include "cISC4Occupant.h"
+#include "cISC4TrafficSimulator.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr uint32_t kTravelTypeCount = 9;
+
+	// The occupant type of the buildings, the transit switches are always building occupants.
+	constexpr int32_t kBuildingOccupantType = 0x278128A0;
+
+	bool IsWithinRadius(const TransitSwitchIndex::Entry& entry, int32_t cellX, int32_t cellZ, uint32_t radius)
+	{
+		const int64_t dx = static_cast<int64_t>(entry.cellX) - cellX;
+		const int64_t dz = static_cast<int64_t>(entry.cellZ) - cellZ;
+
+		return (dx * dx) + (dz * dz) <= static_cast<int64_t>(radius) * static_cast<int64_t>(radius);
+	}
+}
+
+double TransitSwitchIndex::UtilizationTotals::GetUtilization() const
+{
+	return capacity > 0 ? static_cast<double>(arrived) / static_cast<double>(capacity) : 0.0;
+}
+
+TransitSwitchIndex::TransitSwitchIndex()
+	: logger(Logger::GetInstance()),
+	  pCity(nullptr),
+	  built(false),
+	  entries(),
+	  entryIndices(),
+	  buckets(),
+	  bucketCountX(0),
+	  bucketCountZ(0),
+	  pendingOccupants(),
+	  listReadCount(0),
+	  totals(),
+	  sampleCursor(0)
+{
+}
+
+TransitSwitchIndex::~TransitSwitchIndex()
+{
+	Clear();
+}
+
+bool TransitSwitchIndex::Build(cISC4City* pCity)
+{
+	Clear();
+
+	if (!pCity)
+	{
+		return false;
+	}
+
+	this->pCity = pCity;
+
+	bucketCountX = (pCity->CellCountX() + (1u << BucketShift) - 1) >> BucketShift;
+	bucketCountZ = (pCity->CellCountZ() + (1u << BucketShift) - 1) >> BucketShift;
+	buckets.resize(static_cast<size_t>(bucketCountX) * static_cast<size_t>(bucketCountZ));
+
+	std::vector<cISC4Occupant*> occupants;
+
+	if (!ReadTransitSwitches(occupants))
+	{
+		Clear();
+		return false;
+	}
+
+	entries.reserve(occupants.size());
+	entryIndices.reserve(occupants.size());
+
+	for (cISC4Occupant* pOccupant : occupants)
+	{
+		AddEntry(pOccupant);
+	}
+
+	built = true;
+
+	logger.WriteLineFormatted(LogOptions::Info, "Indexed %u transit switches.", static_cast<uint32_t>(entries.size()));
+
+	return true;
+}
+
+void TransitSwitchIndex::Clear()
+{
+	for (Entry& entry : entries)
+	{
+		entry.pOccupant->Release();
+	}
+
+	entries.clear();
+	entryIndices.clear();
+	buckets.clear();
+	bucketCountX = 0;
+	bucketCountZ = 0;
+	pendingOccupants.clear();
+	pCity = nullptr;
+	built = false;
+	totals = UtilizationTotals{};
+	sampleCursor = 0;
+}
+
+bool TransitSwitchIndex::IsBuilt() const
+{
+	return built;
+}
+
+void TransitSwitchIndex::OccupantInserted(cISC4Occupant* pOccupant)
+{
+	// The game sends this notification for every prop, tree and network piece,
+	// so everything other than a building is rejected before any other work.
+	if (built
+		&& pOccupant
+		&& pOccupant->GetType() == kBuildingOccupantType
+		&& entryIndices.find(pOccupant) == entryIndices.end())
+	{
+		pendingOccupants.push_back(pOccupant);
+	}
+}
+
+void TransitSwitchIndex::OccupantRemoved(cISC4Occupant* pOccupant)
+{
+	if (!built || !pOccupant)
+	{
+		return;
+	}
+
+	const auto it = entryIndices.find(pOccupant);
+
+	if (it != entryIndices.end())
+	{
+		RemoveEntry(it->second);
+	}
+	else if (!pendingOccupants.empty())
+	{
+		pendingOccupants.erase(
+			std::remove(pendingOccupants.begin(), pendingOccupants.end(), pOccupant),
+			pendingOccupants.end());
+	}
+}
+
+bool TransitSwitchIndex::Update()
+{
+	if (!built)
+	{
+		return false;
+	}
+
+	if (pendingOccupants.empty())
+	{
+		return true;
+	}
+
+	std::vector<cISC4Occupant*> occupants;
+
+	if (!ReadTransitSwitches(occupants))
+	{
+		return false;
+	}
+
+	std::sort(occupants.begin(), occupants.end());
+
+	for (cISC4Occupant* pOccupant : pendingOccupants)
+	{
+		if (std::binary_search(occupants.begin(), occupants.end(), pOccupant)
+			&& entryIndices.find(pOccupant) == entryIndices.end())
+		{
+			AddEntry(pOccupant);
+		}
+	}
+
+	pendingOccupants.clear();
+
+	return true;
+}
+
+bool TransitSwitchIndex::UpdateUtilization()
+{
+	cISC4TrafficSimulator* pTrafficSimulator = pCity ? pCity->GetTrafficSimulator() : nullptr;
+
+	if (!pTrafficSimulator)
+	{
+		return false;
+	}
+
+	for (Entry& entry : entries)
+	{
+		SampleEntry(entry, pTrafficSimulator);
+	}
+
+	return true;
+}
+
+uint32_t TransitSwitchIndex::SampleUtilization(uint32_t maxSwitches)
+{
+	cISC4TrafficSimulator* pTrafficSimulator = pCity ? pCity->GetTrafficSimulator() : nullptr;
+
+	if (!pTrafficSimulator || entries.empty())
+	{
+		return 0;
+	}
+
+	const uint32_t count = static_cast<uint32_t>(std::min<size_t>(maxSwitches, entries.size()));
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		// Removing a switch moves the last entry into its slot, so the cursor can be past the end.
+		if (sampleCursor >= entries.size())
+		{
+			sampleCursor = 0;
+		}
+
+		SampleEntry(entries[sampleCursor], pTrafficSimulator);
+		sampleCursor++;
+	}
+
+	return count;
+}
+
+size_t TransitSwitchIndex::GetCount() const
+{
+	return entries.size();
+}
+
+const std::vector<TransitSwitchIndex::Entry>& TransitSwitchIndex::GetEntries() const
+{
+	return entries;
+}
+
+const TransitSwitchIndex::Entry* TransitSwitchIndex::Find(cISC4Occupant* pOccupant) const
+{
+	const auto it = entryIndices.find(pOccupant);
+
+	return it != entryIndices.end() ? &entries[it->second] : nullptr;
+}
+
+size_t TransitSwitchIndex::FindWithinTiles(int32_t cellX, int32_t cellZ, uint32_t radius, std::vector<const Entry*>& results) const
+{
+	results.clear();
+
+	ForEachWithinTiles(cellX, cellZ, radius, [&](const Entry& entry)
+	{
+		results.push_back(&entry);
+	});
+
+	return results.size();
+}
+
+TransitSwitchIndex::UtilizationTotals TransitSwitchIndex::GetUtilizationWithinTiles(int32_t cellX, int32_t cellZ, uint32_t radius) const
+{
+	UtilizationTotals totals{};
+
+	ForEachWithinTiles(cellX, cellZ, radius, [&](const Entry& entry)
+	{
+		totals.switchCount++;
+		totals.capacity += entry.capacity;
+		totals.arrived += entry.arrived;
+	});
+
+	return totals;
+}
+
+const TransitSwitchIndex::UtilizationTotals& TransitSwitchIndex::GetTotalUtilization() const
+{
+	return totals;
+}
+
+uint32_t TransitSwitchIndex::GetListReadCount() const
+{
+	return listReadCount;
+}
+
+bool TransitSwitchIndex::ReadTransitSwitches(std::vector<cISC4Occupant*>& occupants)
+{
+	cISC4TrafficSimulator* pTrafficSimulator = pCity ? pCity->GetTrafficSimulator() : nullptr;
+
+	if (!pTrafficSimulator)
+	{
+		logger.WriteLine(LogOptions::Errors, "The traffic simulator pointer was null.");
+		return false;
+	}
+
+	ilist<cISC4Occupant*> transitSwitches;
+
+	if (!pTrafficSimulator->GetTransitSwitches(transitSwitches))
+	{
+		logger.WriteLine(LogOptions::Errors, "Failed to get the transit switch list.");
+		return false;
+	}
+
+	listReadCount++;
+
+	occupants.clear();
+	occupants.reserve(transitSwitches.size());
+
+	for (cISC4Occupant* pOccupant : transitSwitches)
+	{
+		if (pOccupant)
+		{
+			occupants.push_back(pOccupant);
+		}
+	}
+
+	return true;
+}
+
+void TransitSwitchIndex::AddEntry(cISC4Occupant* pOccupant)
+{
+	Entry entry{ pOccupant, -1, -1, 0, 0 };
+
+	SC4Rect<long> cells{};
+
+	if (pOccupant->GetBoundingCityCells(cells))
+	{
+		entry.cellX = static_cast<int32_t>((cells.topLeftX + cells.bottomRightX) / 2);
+		entry.cellZ = static_cast<int32_t>((cells.topLeftY + cells.bottomRightY) / 2);
+	}
+
+	pOccupant->AddRef();
+
+	const uint32_t index = static_cast<uint32_t>(entries.size());
+
+	entries.push_back(entry);
+	entryIndices.emplace(pOccupant, index);
+	totals.switchCount++;
+
+	std::vector<uint32_t>* bucket = GetBucket(entry);
+
+	if (bucket)
+	{
+		bucket->push_back(index);
+	}
+}
+
+void TransitSwitchIndex::RemoveEntry(uint32_t index)
+{
+	const uint32_t lastIndex = static_cast<uint32_t>(entries.size() - 1);
+	Entry& entry = entries[index];
+
+	std::vector<uint32_t>* bucket = GetBucket(entry);
+
+	if (bucket)
+	{
+		bucket->erase(std::find(bucket->begin(), bucket->end(), index));
+	}
+
+	entryIndices.erase(entry.pOccupant);
+	entry.pOccupant->Release();
+
+	totals.switchCount--;
+	totals.capacity -= entry.capacity;
+	totals.arrived -= entry.arrived;
+
+	// The last entry is moved into the free slot, so its index changes in the map and its bucket.
+	if (index != lastIndex)
+	{
+		Entry& lastEntry = entries[lastIndex];
+		std::vector<uint32_t>* lastBucket = GetBucket(lastEntry);
+
+		if (lastBucket)
+		{
+			*std::find(lastBucket->begin(), lastBucket->end(), lastIndex) = index;
+		}
+
+		entryIndices[lastEntry.pOccupant] = index;
+		entry = lastEntry;
+	}
+
+	entries.pop_back();
+}
+
+void TransitSwitchIndex::SampleEntry(Entry& entry, cISC4TrafficSimulator* pTrafficSimulator)
+{
+	cISCPropertyHolder* pPropertyHolder = entry.pOccupant->AsPropertyHolder();
+	uint64_t capacity = 0;
+	uint64_t arrived = 0;
+
+	if (pPropertyHolder)
+	{
+		for (uint32_t travelType = 0; travelType < kTravelTypeCount; travelType++)
+		{
+			capacity += pTrafficSimulator->GetMaxTripCapacity(pPropertyHolder, travelType);
+			arrived += pTrafficSimulator->GetTrafficArrived(pPropertyHolder, travelType);
+		}
+	}
+
+	// The totals are adjusted by the change of this switch, so they never need to be summed again.
+	totals.capacity -= entry.capacity;
+	totals.arrived -= entry.arrived;
+
+	entry.capacity = static_cast<uint32_t>(std::min<uint64_t>(capacity, UINT32_MAX));
+	entry.arrived = static_cast<uint32_t>(std::min<uint64_t>(arrived, UINT32_MAX));
+	totals.capacity += entry.capacity;
+	totals.arrived += entry.arrived;
+}
+
+std::vector<uint32_t>* TransitSwitchIndex::GetBucket(const Entry& entry)
+{
+	if (entry.cellX < 0 || entry.cellZ < 0)
+	{
+		return nullptr;
+	}
+
+	const uint32_t bucketX = static_cast<uint32_t>(entry.cellX) >> BucketShift;
+	const uint32_t bucketZ = static_cast<uint32_t>(entry.cellZ) >> BucketShift;
+
+	if (bucketX >= bucketCountX || bucketZ >= bucketCountZ)
+	{
+		return nullptr;
+	}
+
+	return &buckets[(static_cast<size_t>(bucketZ) * bucketCountX) + bucketX];
+}
+
+template <typename Callback>
+void TransitSwitchIndex::ForEachWithinTiles(int32_t cellX, int32_t cellZ, uint32_t radius, Callback&& callback) const
+{
+	if (bucketCountX == 0 || bucketCountZ == 0)
+	{
+		return;
+	}
+
+	const int64_t maxBucketX = static_cast<int64_t>(bucketCountX) - 1;
+	const int64_t maxBucketZ = static_cast<int64_t>(bucketCountZ) - 1;
+
+	const int64_t firstX = std::clamp<int64_t>((static_cast<int64_t>(cellX) - radius) >> BucketShift, 0, maxBucketX);
+	const int64_t lastX = std::clamp<int64_t>((static_cast<int64_t>(cellX) + radius) >> BucketShift, 0, maxBucketX);
+	const int64_t firstZ = std::clamp<int64_t>((static_cast<int64_t>(cellZ) - radius) >> BucketShift, 0, maxBucketZ);
+	const int64_t lastZ = std::clamp<int64_t>((static_cast<int64_t>(cellZ) + radius) >> BucketShift, 0, maxBucketZ);
+
+	for (int64_t z = firstZ; z <= lastZ; z++)
+	{
+		const std::vector<uint32_t>* row = &buckets[static_cast<size_t>(z) * bucketCountX];
+
+		for (int64_t x = firstX; x <= lastX; x++)
+		{
+			for (uint32_t index : row[x])
+			{
+				const Entry& entry = entries[index];
+
+				if (IsWithinRadius(entry, cellX, cellZ, radius))
+				{
+					callback(entry);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "Logger.h"
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+class cISC4City;
+class cISC4Occupant;
+class cISC4TrafficSimulator;
+
+// An index of the city's transit switch (park and ride) lots by occupant and by location.
+//
+// The traffic simulator only provides the transit switches as a complete list, so the
+// index is built from that list once when the city is loaded and then kept current from
+// the occupant insert and remove notifications. A removed switch is dropped immediately,
+// an inserted building is only confirmed as a transit switch by the next Update call,
+// which reads the list once for all of the buildings inserted since the previous call.
+class TransitSwitchIndex
+{
+public:
+
+	struct Entry
+	{
+		cISC4Occupant* pOccupant;
+		// The center of the lot in city cells, or -1 if the occupant has no location.
+		int32_t cellX;
+		int32_t cellZ;
+		// The totals over all travel types from the last UpdateUtilization call.
+		uint32_t capacity;
+		uint32_t arrived;
+	};
+
+	struct UtilizationTotals
+	{
+		uint32_t switchCount;
+		uint64_t capacity;
+		uint64_t arrived;
+
+		double GetUtilization() const;
+	};
+
+	TransitSwitchIndex();
+	~TransitSwitchIndex();
+
+	TransitSwitchIndex(const TransitSwitchIndex&) = delete;
+	TransitSwitchIndex& operator=(const TransitSwitchIndex&) = delete;
+
+	/**
+	 * @brief Builds the index from the traffic simulator transit switch list.
+	 * @param pCity The city.
+	 * @return True on success; otherwise, false.
+	 */
+	bool Build(cISC4City* pCity);
+
+	/**
+	 * @brief Removes all of the entries, this must be called when the city is shut down.
+	 */
+	void Clear();
+
+	bool IsBuilt() const;
+
+	/**
+	 * @brief Called when an occupant is added to the city.
+	 * Buildings are queued until the next Update call, other occupants are ignored.
+	 * @param pOccupant The occupant.
+	 */
+	void OccupantInserted(cISC4Occupant* pOccupant);
+
+	/**
+	 * @brief Called when an occupant is removed from the city.
+	 * @param pOccupant The occupant.
+	 */
+	void OccupantRemoved(cISC4Occupant* pOccupant);
+
+	/**
+	 * @brief Adds the inserted buildings that the traffic simulator lists as transit switches.
+	 * The transit switch list is only read if a building was inserted since the last call.
+	 * @return True if the index is current; otherwise, false.
+	 */
+	bool Update();
+
+	/**
+	 * @brief Reads the trip capacity and arrived traffic of every transit switch.
+	 * @return True on success; otherwise, false.
+	 */
+	bool UpdateUtilization();
+
+	/**
+	 * @brief Reads the trip capacity and arrived traffic of the next transit switches.
+	 * The switches are visited in turn, so repeated calls cover the whole index while
+	 * keeping the cost of each call bounded.
+	 * @param maxSwitches The largest number of switches to read.
+	 * @return The number of switches that were read.
+	 */
+	uint32_t SampleUtilization(uint32_t maxSwitches);
+
+	size_t GetCount() const;
+	const std::vector<Entry>& GetEntries() const;
+
+	/**
+	 * @brief Gets the entry of the specified occupant.
+	 * @param pOccupant The occupant.
+	 * @return The entry, or null if the occupant is not an indexed transit switch.
+	 */
+	const Entry* Find(cISC4Occupant* pOccupant) const;
+
+	/**
+	 * @brief Gets the transit switches whose lot center is within the specified distance of a cell.
+	 * @param cellX The X coordinate of the cell.
+	 * @param cellZ The Z coordinate of the cell.
+	 * @param radius The distance in cells.
+	 * @param results Receives the entries, the vector is cleared first.
+	 * @return The number of entries.
+	 */
+	size_t FindWithinTiles(int32_t cellX, int32_t cellZ, uint32_t radius, std::vector<const Entry*>& results) const;
+
+	/**
+	 * @brief Gets the capacity and arrived traffic totals of the transit switches within the specified distance of a cell.
+	 * @param cellX The X coordinate of the cell.
+	 * @param cellZ The Z coordinate of the cell.
+	 * @param radius The distance in cells.
+	 * @return The totals from the last UpdateUtilization call.
+	 */
+	UtilizationTotals GetUtilizationWithinTiles(int32_t cellX, int32_t cellZ, uint32_t radius) const;
+
+	// Gets the totals of every transit switch in the city, the totals are kept as the switches
+	// are added, removed and updated so this does not visit the switches.
+	const UtilizationTotals& GetTotalUtilization() const;
+
+	// The number of times that the index read the traffic simulator transit switch list.
+	uint32_t GetListReadCount() const;
+
+private:
+
+	// Each spatial bucket covers 16x16 city cells.
+	static constexpr uint32_t BucketShift = 4;
+
+	bool ReadTransitSwitches(std::vector<cISC4Occupant*>& occupants);
+	void AddEntry(cISC4Occupant* pOccupant);
+	void RemoveEntry(uint32_t index);
+	void SampleEntry(Entry& entry, cISC4TrafficSimulator* pTrafficSimulator);
+	std::vector<uint32_t>* GetBucket(const Entry& entry);
+
+	template <typename Callback>
+	void ForEachWithinTiles(int32_t cellX, int32_t cellZ, uint32_t radius, Callback&& callback) const;
+
+	Logger& logger;
+	cISC4City* pCity;
+	bool built;
+	std::vector<Entry> entries;
+	std::unordered_map<cISC4Occupant*, uint32_t> entryIndices;
+	// The indices of the entries in each bucket, in row order.
+	std::vector<std::vector<uint32_t>> buckets;
+	uint32_t bucketCountX;
+	uint32_t bucketCountZ;
+	// The buildings that were inserted since the last Update call.
+	std::vector<cISC4Occupant*> pendingOccupants;
+	uint32_t listReadCount;
+	UtilizationTotals totals;
+	// The entry that the next SampleUtilization call starts at.
+	size_t sampleCursor;
+};
@@ -0,0 +1,279 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+
+#include "TuningExemplarValidator.h"
+#include "Stopwatch.h"
+#include "TrafficSimulatorTuning.h"
+#include "TrafficTuningOverride.h"
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <system_error>
+
+namespace
+{
+	constexpr DBPFFile::ResourceKey kTuningExemplarKey
+	{
+		TrafficSimulatorTuning::kType,
+		TrafficSimulatorTuning::kGroup,
+		TrafficSimulatorTuning::kInstance,
+	};
+
+	// The game enumerates the files with the Win32 API, which returns NTFS folders in
+	// case-insensitive order. The exact names only break ties on case-sensitive file systems.
+	bool LoadsBefore(const std::filesystem::path& a, const std::filesystem::path& b)
+	{
+		const std::string first = a.filename().string();
+		const std::string second = b.filename().string();
+
+		const auto [firstMismatch, secondMismatch] = std::mismatch(
+			first.begin(),
+			first.end(),
+			second.begin(),
+			second.end(),
+			[](unsigned char x, unsigned char y) { return std::toupper(x) == std::toupper(y); });
+
+		if (firstMismatch == first.end() || secondMismatch == second.end())
+		{
+			return first.size() != second.size() ? first.size() < second.size() : first < second;
+		}
+
+		return std::toupper(static_cast<unsigned char>(*firstMismatch)) < std::toupper(static_cast<unsigned char>(*secondMismatch));
+	}
+
+	bool ListFolder(
+		const std::filesystem::path& folder,
+		std::vector<std::filesystem::path>& folders,
+		std::vector<std::filesystem::path>& files)
+	{
+		std::error_code ec;
+		std::filesystem::directory_iterator iterator(folder, ec);
+
+		if (ec)
+		{
+			return false;
+		}
+
+		for (const std::filesystem::directory_entry& item : iterator)
+		{
+			if (item.is_directory(ec))
+			{
+				folders.push_back(item.path());
+			}
+			else if (item.is_regular_file(ec))
+			{
+				files.push_back(item.path());
+			}
+		}
+
+		std::sort(folders.begin(), folders.end(), LoadsBefore);
+		std::sort(files.begin(), files.end(), LoadsBefore);
+		return true;
+	}
+}
+
+TuningExemplarValidator::TuningExemplarValidator(uint32_t threadCount)
+	: pool(threadCount),
+	  statistics()
+{
+}
+
+bool TuningExemplarValidator::FindGameFiles(const std::filesystem::path& folder, std::vector<std::filesystem::path>& paths)
+{
+	std::vector<std::filesystem::path> folders;
+	std::vector<std::filesystem::path> files;
+
+	if (!ListFolder(folder, folders, files))
+	{
+		return false;
+	}
+
+	paths.insert(paths.end(), files.begin(), files.end());
+	return true;
+}
+
+bool TuningExemplarValidator::FindPluginFiles(const std::filesystem::path& folder, std::vector<std::filesystem::path>& paths)
+{
+	std::vector<std::filesystem::path> folders;
+	std::vector<std::filesystem::path> files;
+
+	if (!ListFolder(folder, folders, files))
+	{
+		return false;
+	}
+
+	for (const std::filesystem::path& subfolder : folders)
+	{
+		if (!FindPluginFiles(subfolder, paths))
+		{
+			return false;
+		}
+	}
+
+	paths.insert(paths.end(), files.begin(), files.end());
+	return true;
+}
+
+void TuningExemplarValidator::Validate(const std::vector<std::filesystem::path>& paths, Result& result)
+{
+	Stopwatch stopwatch;
+	stopwatch.Start();
+
+	std::vector<FileResult> fileResults(paths.size());
+	std::vector<std::vector<uint8_t>> buffers(pool.GetThreadCount());
+
+	pool.ParallelFor(paths.size(), [&](size_t index, uint32_t worker)
+	{
+		IndexFile(paths[index], fileResults[index], buffers[worker]);
+	});
+
+	result.sources.clear();
+	result.dbpfFiles = 0;
+	result.skippedFiles = 0;
+	result.indexEntries = 0;
+
+	// The results are merged in load order, so the last source is the copy that the game uses.
+	for (FileResult& fileResult : fileResults)
+	{
+		if (!fileResult.dbpf)
+		{
+			result.skippedFiles++;
+			continue;
+		}
+
+		result.dbpfFiles++;
+		result.indexEntries += fileResult.indexEntries;
+
+		if (fileResult.hasExemplar)
+		{
+			result.sources.push_back(std::move(fileResult.source));
+		}
+	}
+
+	stopwatch.Stop();
+
+	statistics.threadCount = pool.GetThreadCount();
+	statistics.elapsedMilliseconds = stopwatch.ElapsedMilliseconds();
+	statistics.stolenItems = pool.GetStolenItemCount();
+}
+
+const TuningExemplarValidator::Statistics& TuningExemplarValidator::GetStatistics() const
+{
+	return statistics;
+}
+
+const char* TuningExemplarValidator::GetStatusName(Status status)
+{
+	switch (status)
+	{
+	case Status::Valid:
+		return "valid";
+	case Status::Unreadable:
+		return "the entry could not be read";
+	case Status::NotBinaryExemplar:
+		return "not a binary exemplar";
+	case Status::MissingProperty:
+		return "the Travel type can reach destination property is missing";
+	case Status::WrongType:
+		return "the Travel type can reach destination property is not a Boolean array";
+	case Status::WrongCount:
+		return "the Travel type can reach destination property has the wrong number of items";
+	default:
+		return "unknown";
+	}
+}
+
+void TuningExemplarValidator::IndexFile(const std::filesystem::path& path, FileResult& result, std::vector<uint8_t>& buffer)
+{
+	result.dbpf = false;
+	result.indexEntries = 0;
+	result.hasExemplar = false;
+
+	DBPFFile file;
+
+	if (!file.Open(path))
+	{
+		return;
+	}
+
+	result.dbpf = true;
+	result.indexEntries = file.GetIndexEntryCount();
+
+	DBPFFile::IndexEntry entry{};
+
+	if (!file.FindEntry(kTuningExemplarKey, entry))
+	{
+		return;
+	}
+
+	result.hasExemplar = true;
+	result.source = ExemplarSource{};
+	result.source.path = path;
+
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+
+	if (file.ReadEntryData(entry, buffer, data, size))
+	{
+		ValidateExemplar(data, size, result.source);
+	}
+	else
+	{
+		result.source.status = Status::Unreadable;
+	}
+}
+
+void TuningExemplarValidator::ValidateExemplar(const uint8_t* data, size_t size, ExemplarSource& source)
+{
+	DBPFExemplar exemplar;
+
+	if (!exemplar.Parse(data, size))
+	{
+		source.status = Status::NotBinaryExemplar;
+		return;
+	}
+
+	const DBPFExemplar::Property* property = exemplar.FindProperty(TrafficSimulatorTuning::kTravelTypeCanReachDestination);
+
+	if (!property)
+	{
+		source.status = Status::MissingProperty;
+		return;
+	}
+
+	source.type = property->type;
+	source.isArray = property->isArray;
+	source.count = property->count;
+
+	if (property->type != DBPFExemplar::ValueType::Bool || !property->isArray)
+	{
+		source.status = Status::WrongType;
+		return;
+	}
+
+	source.travelTypeCanReachDestination.reserve(property->values.size());
+
+	for (uint8_t value : property->values)
+	{
+		source.travelTypeCanReachDestination.push_back(value != 0);
+	}
+
+	if (property->count != TrafficSimulatorTuning::kTravelTypeCount)
+	{
+		source.status = Status::WrongCount;
+		return;
+	}
+
+	source.status = Status::Valid;
+	source.precompiledOverride = TrafficTuningOverride::IsApplied(exemplar);
+}
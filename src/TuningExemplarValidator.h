@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+
+#pragma once
+#include "DBPFExemplar.h"
+#include "WorkStealingPool.h"
+#include <filesystem>
+#include <vector>
+
+// Finds the copy of the traffic simulator tuning exemplar that SimCity 4 will use with a set
+// of plugins, and checks that it has the properties that the plugin edits.
+//
+// The files are indexed on several threads, each file is memory-mapped and only its index
+// table is read. The exemplar is only decompressed and parsed in the files that have it.
+class TuningExemplarValidator
+{
+public:
+
+	enum class Status
+	{
+		Valid,
+		// The entry is outside of the file or cannot be decompressed.
+		Unreadable,
+		// The entry is not a binary exemplar, text exemplars are not supported.
+		NotBinaryExemplar,
+		// The exemplar does not have the Travel type can reach destination property.
+		MissingProperty,
+		// The property is not a Boolean array.
+		WrongType,
+		// The property does not have one item per travel type.
+		WrongCount,
+	};
+
+	// A file that has the traffic simulator tuning exemplar.
+	struct ExemplarSource
+	{
+		std::filesystem::path path;
+		Status status;
+		DBPFExemplar::ValueType type;
+		bool isArray;
+		uint32_t count;
+		std::vector<bool> travelTypeCanReachDestination;
+		// The exemplar was written by the BuildTuningOverride tool.
+		bool precompiledOverride;
+	};
+
+	struct Result
+	{
+		// The files that have the exemplar in load order, the last one is used by the game.
+		std::vector<ExemplarSource> sources;
+		uint32_t dbpfFiles;
+		// The files that are not DBPF files, or use a DBPF version that the game does not load.
+		uint32_t skippedFiles;
+		uint64_t indexEntries;
+	};
+
+	struct Statistics
+	{
+		uint32_t threadCount;
+		int64_t elapsedMilliseconds;
+		uint64_t stolenItems;
+	};
+
+	/**
+	 * @brief Initializes the validator.
+	 * @param threadCount The number of worker threads, 0 uses the number of hardware threads.
+	 */
+	explicit TuningExemplarValidator(uint32_t threadCount);
+
+	/**
+	 * @brief Lists the files in the root of the game folder in load order.
+	 * @param folder The SimCity 4 installation folder that contains the SimCity_1.dat file.
+	 * @param paths Receives the file paths, sorted by name.
+	 * @return True on success; otherwise, false if the folder could not be read.
+	 */
+	static bool FindGameFiles(const std::filesystem::path& folder, std::vector<std::filesystem::path>& paths);
+
+	/**
+	 * @brief Lists the files in a plugins folder and its subfolders in load order.
+	 * The names are compared without regard to case. The subfolders of a folder are loaded before
+	 * the files in the folder, so the files in the root of the plugins folder are loaded last.
+	 * @param folder The plugins folder.
+	 * @param paths Receives the file paths, they are appended to the existing paths.
+	 * @return True on success; otherwise, false if a folder could not be read.
+	 */
+	static bool FindPluginFiles(const std::filesystem::path& folder, std::vector<std::filesystem::path>& paths);
+
+	/**
+	 * @brief Indexes the files and validates every copy of the traffic simulator tuning exemplar.
+	 * @param paths The files in load order.
+	 * @param result Receives the exemplar copies and the index totals.
+	 */
+	void Validate(const std::vector<std::filesystem::path>& paths, Result& result);
+
+	const Statistics& GetStatistics() const;
+
+	static const char* GetStatusName(Status status);
+
+private:
+
+	// The per-file state that a worker fills in.
+	struct FileResult
+	{
+		bool dbpf;
+		uint32_t indexEntries;
+		bool hasExemplar;
+		ExemplarSource source;
+	};
+
+	static void IndexFile(const std::filesystem::path& path, FileResult& result, std::vector<uint8_t>& buffer);
+	static void ValidateExemplar(const uint8_t* data, size_t size, ExemplarSource& source);
+
+	WorkStealingPool pool;
+	Statistics statistics;
+};
@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <thread>
+
+WorkStealingPool::WorkStealingPool(uint32_t threadCount)
+	: threadCount(threadCount > 0 ? threadCount : std::max(std::thread::hardware_concurrency(), 1u)),
+	  queues(),
+	  statisticsMutex(),
+	  stolenItemCount(0)
+{
+	queues.reserve(this->threadCount);
+
+	for (uint32_t i = 0; i < this->threadCount; i++)
+	{
+		queues.push_back(std::make_unique<WorkerQueue>());
+	}
+}
+
+uint32_t WorkStealingPool::GetThreadCount() const
+{
+	return threadCount;
+}
+
+void WorkStealingPool::ParallelFor(size_t count, const std::function<void(size_t index, uint32_t worker)>& function)
+{
+	stolenItemCount = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		queues[i % threadCount]->items.push_back(i);
+	}
+
+	// The items are never added after the workers start, so a worker can exit
+	// when it finds every queue empty.
+	const uint32_t workerCount = static_cast<uint32_t>(std::min<size_t>(threadCount, count));
+	std::vector<std::thread> threads;
+	threads.reserve(workerCount > 0 ? workerCount - 1 : 0);
+
+	for (uint32_t worker = 1; worker < workerCount; worker++)
+	{
+		threads.emplace_back(&WorkStealingPool::RunWorker, this, worker, std::cref(function));
+	}
+
+	if (workerCount > 0)
+	{
+		RunWorker(0, function);
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+uint64_t WorkStealingPool::GetStolenItemCount() const
+{
+	return stolenItemCount;
+}
+
+bool WorkStealingPool::TakeItem(uint32_t worker, size_t& index)
+{
+	WorkerQueue& queue = *queues[worker];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+
+	if (queue.items.empty())
+	{
+		return false;
+	}
+
+	index = queue.items.front();
+	queue.items.pop_front();
+	return true;
+}
+
+bool WorkStealingPool::StealItems(uint32_t thief)
+{
+	// Start with the next worker so that the thieves do not all pick the same victim.
+	for (uint32_t i = 1; i < threadCount; i++)
+	{
+		const uint32_t victim = (thief + i) % threadCount;
+		std::vector<size_t> stolen;
+
+		{
+			WorkerQueue& victimQueue = *queues[victim];
+			std::lock_guard<std::mutex> lock(victimQueue.mutex);
+
+			const size_t stealCount = (victimQueue.items.size() + 1) / 2;
+
+			for (size_t j = 0; j < stealCount; j++)
+			{
+				stolen.push_back(victimQueue.items.back());
+				victimQueue.items.pop_back();
+			}
+		}
+
+		if (!stolen.empty())
+		{
+			{
+				WorkerQueue& thiefQueue = *queues[thief];
+				std::lock_guard<std::mutex> lock(thiefQueue.mutex);
+
+				// Keep the original order, the cheaper items are at the back.
+				thiefQueue.items.insert(thiefQueue.items.end(), stolen.rbegin(), stolen.rend());
+			}
+
+			std::lock_guard<std::mutex> lock(statisticsMutex);
+			stolenItemCount += stolen.size();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void WorkStealingPool::RunWorker(uint32_t worker, const std::function<void(size_t index, uint32_t worker)>& function)
+{
+	size_t index = 0;
+
+	while (true)
+	{
+		if (TakeItem(worker, index))
+		{
+			function(index, worker);
+		}
+		else if (!StealItems(worker))
+		{
+			// The items that another thief is moving are run by that thief.
+			break;
+		}
+	}
+}
@@ -0,0 +1,69 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Runs a loop on several threads, the workers that run out of items steal from the others.
+//
+// The items are dealt to the worker queues in turn, so a list that is sorted from the most
+// to the least expensive item starts out balanced. A worker takes the items from the front of
+// its own queue and steals half of the remaining items from the back of another queue.
+// The calling thread is used as the first worker.
+class WorkStealingPool
+{
+public:
+
+	/**
+	 * @brief Initializes the pool.
+	 * @param threadCount The number of workers, 0 uses the number of hardware threads.
+	 */
+	explicit WorkStealingPool(uint32_t threadCount);
+
+	uint32_t GetThreadCount() const;
+
+	/**
+	 * @brief Calls the function once for every index, and returns when all of the calls have finished.
+	 * @param count The number of items.
+	 * @param function The function that is called with the item index and the worker index.
+	 * The worker index is less than GetThreadCount, it can be used to select per-worker buffers.
+	 */
+	void ParallelFor(size_t count, const std::function<void(size_t index, uint32_t worker)>& function);
+
+	/**
+	 * @brief Gets the number of items that were stolen in the last ParallelFor call.
+	 */
+	uint64_t GetStolenItemCount() const;
+
+private:
+
+	struct WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<size_t> items;
+	};
+
+	bool TakeItem(uint32_t worker, size_t& index);
+	bool StealItems(uint32_t thief);
+	void RunWorker(uint32_t worker, const std::function<void(size_t index, uint32_t worker)>& function);
+
+	uint32_t threadCount;
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::mutex statisticsMutex;
+	uint64_t stolenItemCount;
+};
@@ -15,6 +15,14 @@ class TransitSwitchQueryData;
 // This version of the cISC4TrafficSimulator header implements cIGZMessageTarget2.
 // This is a hack that allows messages to be sent directly to the traffic simulator
 // without using the game's messaging system.
+//
+// cIGZMessageTarget2 also derives from cIGZUnknown, which GCC and Clang warn about.
+// That is how the game declares the interface, so the warning is only disabled here.
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winaccessible-base"
+#endif // __GNUC__
 
 class cISC4TrafficSimulator : public cIGZUnknown, public cIGZMessageTarget2
 {
@@ -72,3 +80,7 @@ public:
 	virtual bool GetSubnetworksInRegion(intptr_t cellRegion, std::vector<uint32_t>& unknown2) = 0; // cellRegion is SC4CellRegion<long> const&
 	virtual bool GetOccupantCountForAllSubnetworks(uint32_t unknown1, std::vector<uint32_t>& unknown2) = 0;
 };
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif // __GNUC__
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "cIGZUnknown.h"
+
+class cIGZString;
+
+// The class and interface IDs are shared by every plugin that participates in the
+// traffic simulator tuning exemplar arbitration, they must never be changed.
+static constexpr uint32_t GZCLSID_cTrafficTuningCoordinator = 0x7e1c5a3b;
+static constexpr uint32_t GZIID_cITrafficTuningCoordinator = 0x2f4b9d61;
+static constexpr uint32_t GZIID_cITrafficTuningCoordinatorTiming = 0x6a3d81f4;
+
+// Controls how the traffic simulator is notified after its tuning exemplar was changed.
+// The values are ordered by strength, when a batch contains several requests the
+// strongest one is used.
+enum class TrafficSimulatorUpdateMode : uint32_t
+{
+	// The traffic simulator is not notified.
+	None = 0,
+	// The traffic simulator is sent a message that makes it reload its tunable values.
+	// This is the only mode that is safe to use from a PostCityInit message handler.
+	ReloadTunables = 1,
+	// The traffic simulator is shut down and restarted.
+	Restart = 2,
+};
+
+// Arbitrates the edits that multiple plugins make to the cached copy of the
+// traffic simulator tuning exemplar.
+//
+// Every participating plugin registers a class object using GZCLSID_cTrafficTuningCoordinator,
+// the framework keeps the first registration so the first plugin to load becomes the coordinator.
+// The edits that are queued during a frame are applied as a single batch, and the traffic simulator
+// is only reloaded or restarted once per batch.
+class cITrafficTuningCoordinator : public cIGZUnknown
+{
+public:
+
+	/**
+	 * @brief Registers a plugin with the coordinator.
+	 * @param participantID The unique ID of the plugin, usually the DLL director ID.
+	 * @param name The plugin name that is used in the diagnostic output.
+	 * @return True on success; otherwise, false.
+	 */
+	virtual bool RegisterParticipant(uint32_t participantID, cIGZString const& name) = 0;
+
+	/**
+	 * @brief Queues a change to one item of a Boolean array property in the tuning exemplar.
+	 * @param participantID The unique ID of the plugin that requested the change.
+	 * @param propertyID The ID of the exemplar property.
+	 * @param index The index of the item in the property array.
+	 * @param value The new value.
+	 * @param updateMode The traffic simulator notification that the change requires.
+	 * @return True on success; otherwise, false.
+	 */
+	virtual bool QueueBoolArrayEdit(
+		uint32_t participantID,
+		uint32_t propertyID,
+		uint32_t index,
+		bool value,
+		TrafficSimulatorUpdateMode updateMode) = 0;
+
+	/**
+	 * @brief Applies the queued edits immediately instead of waiting for the end of the frame.
+	 * @param pauseGame True to pause the game while the edits are applied; otherwise, false.
+	 * The game is always paused when the batch restarts the traffic simulator.
+	 * @return True on success; otherwise, false.
+	 */
+	virtual bool Flush(bool pauseGame) = 0;
+
+	/**
+	 * @brief Gets the plugin that last changed the specified Boolean array item.
+	 * @param propertyID The ID of the exemplar property.
+	 * @param index The index of the item in the property array.
+	 * @param participantID Receives the unique ID of the plugin.
+	 * @return True if a plugin changed the item; otherwise, false.
+	 */
+	virtual bool GetLastEditor(uint32_t propertyID, uint32_t index, uint32_t& participantID) const = 0;
+};
+
+// An optional coordinator interface that reports how long a batch of edits took to apply.
+// Coordinators from older plugin versions do not implement it, a participant must query
+// for it and handle its absence.
+class cITrafficTuningCoordinatorTiming : public cIGZUnknown
+{
+public:
+
+	/**
+	 * @brief Requests the duration of the next batch that applies an edit from the plugin.
+	 * The duration covers pausing the game, applying the edits and updating the traffic simulator.
+	 * @param participantID The unique ID of the plugin.
+	 * @return True on success; otherwise, false.
+	 */
+	virtual bool RequestBatchTime(uint32_t participantID) = 0;
+
+	/**
+	 * @brief Gets the requested batch duration, the request is complete once the value has been read.
+	 * @param participantID The unique ID of the plugin.
+	 * @param elapsedMicroseconds Receives the batch duration, in microseconds.
+	 * @return True if the batch has been applied; otherwise, false.
+	 */
+	virtual bool GetBatchTime(uint32_t participantID, int64_t& elapsedMicroseconds) = 0;
+};
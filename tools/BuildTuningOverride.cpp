@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Writes a plugin DAT with a copy of the traffic simulator tuning exemplar that always
+// restricts cars. When the plugin finds this exemplar at city load it skips the runtime
+// edits of the cached exemplar and the traffic simulator reload.
+//
+// The input files are listed in load order, the exemplar is read from the last file that has it.
+
+#include "DBPFExemplar.h"
+#include "DBPFFile.h"
+#include "DBPFWriter.h"
+#include "TrafficSimulatorTuning.h"
+#include "TrafficTuningOverride.h"
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+	constexpr DBPFFile::ResourceKey kTuningExemplarKey
+	{
+		TrafficSimulatorTuning::kType,
+		TrafficSimulatorTuning::kGroup,
+		TrafficSimulatorTuning::kInstance,
+	};
+
+	enum class ReadResult
+	{
+		Found,
+		NotFound,
+		Error,
+	};
+
+	ReadResult ReadTuningExemplar(const std::filesystem::path& path, DBPFExemplar& exemplar)
+	{
+		DBPFFile file;
+
+		if (!file.Open(path))
+		{
+			std::fprintf(stderr, "%s is not a DBPF file.\n", path.string().c_str());
+			return ReadResult::Error;
+		}
+
+		DBPFFile::IndexEntry entry{};
+
+		if (!file.FindEntry(kTuningExemplarKey, entry))
+		{
+			return ReadResult::NotFound;
+		}
+
+		std::vector<uint8_t> buffer;
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+
+		if (!file.ReadEntryData(entry, buffer, data, size) || !exemplar.Parse(data, size))
+		{
+			std::fprintf(stderr, "The traffic simulator tuning exemplar in %s could not be read.\n", path.string().c_str());
+			return ReadResult::Error;
+		}
+
+		return ReadResult::Found;
+	}
+
+	void PrintTravelTypes(const char* label, const DBPFExemplar& exemplar)
+	{
+		const DBPFExemplar::Property* property = exemplar.FindProperty(TrafficSimulatorTuning::kTravelTypeCanReachDestination);
+
+		std::printf("%s:", label);
+
+		if (property)
+		{
+			for (uint8_t value : property->values)
+			{
+				std::printf(" %s", value != 0 ? "true" : "false");
+			}
+		}
+
+		std::printf("\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::printf(
+			"Usage: %s <output DAT> <input DAT>...\n"
+			"The input files are listed in load order, for example the SimCity_1.dat file in the game\n"
+			"folder followed by the plugins that change the traffic simulator tuning exemplar.\n"
+			"The output DAT must be loaded after all of them.\n",
+			argv[0]);
+		return 2;
+	}
+
+	const std::filesystem::path outputPath = argv[1];
+	std::filesystem::path sourcePath;
+	DBPFExemplar exemplar;
+
+	for (int i = 2; i < argc; i++)
+	{
+		const std::filesystem::path inputPath = argv[i];
+		std::error_code ec;
+
+		if (std::filesystem::equivalent(inputPath, outputPath, ec))
+		{
+			std::fprintf(stderr, "The output file cannot be one of the input files.\n");
+			return 1;
+		}
+
+		DBPFExemplar inputExemplar;
+		const ReadResult result = ReadTuningExemplar(inputPath, inputExemplar);
+
+		if (result == ReadResult::Error)
+		{
+			return 1;
+		}
+		else if (result == ReadResult::Found)
+		{
+			exemplar = std::move(inputExemplar);
+			sourcePath = inputPath;
+		}
+	}
+
+	if (sourcePath.empty())
+	{
+		std::fprintf(stderr, "None of the input files have the traffic simulator tuning exemplar.\n");
+		return 1;
+	}
+
+	std::printf("Using the traffic simulator tuning exemplar from %s\n", sourcePath.string().c_str());
+	PrintTravelTypes("Installed travel types", exemplar);
+
+	if (!TrafficTuningOverride::Apply(exemplar))
+	{
+		std::fprintf(
+			stderr,
+			"The exemplar does not have a %u item Boolean array for property 0x%08x.\n",
+			TrafficSimulatorTuning::kTravelTypeCount,
+			TrafficSimulatorTuning::kTravelTypeCanReachDestination);
+		return 1;
+	}
+
+	PrintTravelTypes("Override travel types", exemplar);
+
+	std::vector<uint8_t> data;
+	exemplar.Write(data);
+
+	DBPFWriter writer;
+
+	if (!writer.Open(outputPath)
+		|| !writer.AddEntry(kTuningExemplarKey, data.data(), data.size(), /*compress*/false)
+		|| !writer.Close())
+	{
+		std::fprintf(stderr, "Failed to write %s.\n", outputPath.string().c_str());
+		return 1;
+	}
+
+	std::printf("Wrote %s\n", outputPath.string().c_str());
+
+	return 0;
+}
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Converts a metrics file that the plugin recorded to CSV.
+
+#include "MetricsFileReader.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+	if (argc < 2 || argc > 3)
+	{
+		std::printf(
+			"Usage: %s <metrics file> [output file]\n"
+			"The CSV is written to the standard output when the output file is not specified.\n",
+			argv[0]);
+		return 2;
+	}
+
+	MetricsFileReader reader;
+
+	if (!reader.Open(argv[1]))
+	{
+		std::fprintf(stderr, "%s is not a valid metrics file.\n", argv[1]);
+		return 1;
+	}
+
+	bool result = false;
+
+	if (argc == 3)
+	{
+		std::ofstream output(argv[2], std::ios::trunc);
+
+		result = output && reader.WriteCsv(output);
+	}
+	else
+	{
+		result = reader.WriteCsv(std::cout);
+	}
+
+	if (!result)
+	{
+		std::fprintf(stderr, "Failed to write the CSV.\n");
+		return 1;
+	}
+
+	return 0;
+}
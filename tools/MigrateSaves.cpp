@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Converts the Park & Ride ordinance state in a save game, or in every save game of a region
+// folder, to the format that the current plugin writes. With --dry-run the save games are only
+// checked, and the byte savings of the migration are reported.
+
+#include "RegionScanner.h"
+#include "SaveGameMigrator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+
+namespace
+{
+	struct Options
+	{
+		const char* path = nullptr;
+		uint32_t threads = 0;
+		bool dryRun = false;
+	};
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* name = argv[i];
+
+			if (std::strcmp(name, "--threads") == 0 && i + 1 < argc)
+			{
+				const int value = std::atoi(argv[++i]);
+
+				if (value <= 0)
+				{
+					return false;
+				}
+
+				options.threads = static_cast<uint32_t>(value);
+			}
+			else if (std::strcmp(name, "--dry-run") == 0)
+			{
+				options.dryRun = true;
+			}
+			else if (!options.path && name[0] != '-')
+			{
+				options.path = name;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return options.path != nullptr;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::printf(
+			"Usage: %s <save game or region folder> [--dry-run] [--threads <n>]\n"
+			"  --dry-run      Report the changes and the byte savings without writing the save games.\n"
+			"  --threads <n>  The number of worker threads (default: the number of hardware threads).\n"
+			"Back up the region before migrating the save games.\n",
+			argv[0]);
+		return 2;
+	}
+
+	std::vector<std::filesystem::path> paths;
+	std::error_code ec;
+
+	if (std::filesystem::is_directory(options.path, ec))
+	{
+		RegionScanner::FindSaveGames(options.path, paths);
+	}
+	else
+	{
+		paths.push_back(options.path);
+	}
+
+	if (paths.empty())
+	{
+		std::fprintf(stderr, "%s does not contain any save games.\n", options.path);
+		return 1;
+	}
+
+	SaveGameMigrator migrator(options.threads, options.dryRun);
+	std::vector<SaveGameMigrator::FileResult> results;
+
+	migrator.Migrate(paths, results);
+
+	uint32_t migratedFiles = 0;
+	uint32_t errors = 0;
+	int64_t stateBytesSaved = 0;
+	int64_t fileBytesSaved = 0;
+
+	for (const SaveGameMigrator::FileResult& result : results)
+	{
+		if (result.error)
+		{
+			std::printf("%s: %s\n", result.path.string().c_str(), result.error);
+			errors++;
+			continue;
+		}
+
+		const int64_t fileSaving = static_cast<int64_t>(result.originalFileSize) - static_cast<int64_t>(result.migratedFileSize);
+
+		std::printf(
+			"%s: %u of %u ordinance states %s, %s%s, %lld state bytes and %lld file bytes %s\n",
+			result.path.string().c_str(),
+			result.migratedStates,
+			result.states,
+			options.dryRun ? "are outdated" : "migrated",
+			options.dryRun && result.method != SaveGameMigrator::Method::Unchanged ? "would be " : "",
+			SaveGameMigrator::GetMethodName(result.method),
+			static_cast<long long>(result.stateBytesSaved),
+			static_cast<long long>(fileSaving),
+			options.dryRun ? "would be saved" : "saved");
+
+		if (result.method != SaveGameMigrator::Method::Unchanged)
+		{
+			migratedFiles++;
+		}
+
+		stateBytesSaved += result.stateBytesSaved;
+		fileBytesSaved += fileSaving;
+	}
+
+	const SaveGameMigrator::Statistics& statistics = migrator.GetStatistics();
+
+	std::printf(
+		"%s %u of %zu save games in %lld ms with %u threads, %lld state bytes and %lld file bytes %s.\n",
+		options.dryRun ? "Would change" : "Changed",
+		migratedFiles,
+		results.size(),
+		static_cast<long long>(statistics.elapsedMilliseconds),
+		statistics.threadCount,
+		static_cast<long long>(stateBytesSaved),
+		static_cast<long long>(fileBytesSaved),
+		options.dryRun ? "would be saved" : "saved");
+
+	if (errors > 0)
+	{
+		std::printf("%u save games could not be migrated.\n", errors);
+	}
+
+	return errors > 0 ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Lists the Park & Ride ordinance state of a save game, or of every save game in a region folder.
+
+#include "ParknRideOrdinance.h"
+#include "SaveGameInspector.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+	struct Totals
+	{
+		uint32_t cities = 0;
+		uint32_t enacted = 0;
+		uint32_t notFound = 0;
+		uint32_t errors = 0;
+	};
+
+	bool IsSaveGame(const std::filesystem::path& path)
+	{
+		std::string extension = path.extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+
+		return extension == ".sc4";
+	}
+
+	const char* YesNo(bool value)
+	{
+		return value ? "yes" : "no";
+	}
+
+	void PrintState(const OrdinanceStateReader::OrdinanceState& state)
+	{
+		std::printf(
+			"  %s: %s\n"
+			"  State version %u, property holder version %u\n"
+			"  Enacted: %s, available: %s, enabled: %s, initialized: %s\n"
+			"  Monthly income: constant %lld, adjusted %lld, factor %g\n",
+			state.name.c_str(),
+			state.on ? "enacted" : "not enacted",
+			state.version,
+			state.propertyHolderVersion,
+			YesNo(state.on),
+			YesNo(state.available),
+			YesNo(state.enabled),
+			YesNo(state.initialized),
+			static_cast<long long>(state.monthlyConstantIncome),
+			static_cast<long long>(state.monthlyAdjustedIncome),
+			state.monthlyIncomeFactor);
+
+		std::printf("  Effects:\n");
+
+		for (const OrdinanceStateReader::Effect& effect : state.effects)
+		{
+			const bool isCurve = std::find(
+				state.curvePropertyIDs.begin(),
+				state.curvePropertyIDs.end(),
+				effect.propertyID) != state.curvePropertyIDs.end();
+
+			std::printf("    0x%08x%s", effect.propertyID, isCurve ? " (curve)" : "");
+
+			for (double value : effect.values)
+			{
+				std::printf(" %g", value);
+			}
+
+			std::printf("\n");
+		}
+	}
+
+	void InspectSaveGame(const std::filesystem::path& path, Totals& totals)
+	{
+		std::printf("%s\n", path.filename().string().c_str());
+
+		DBPFFile file;
+
+		if (!file.Open(path))
+		{
+			std::fprintf(stderr, "%s is not a valid save game.\n", path.string().c_str());
+			totals.errors++;
+			return;
+		}
+
+		totals.cities++;
+
+		SaveGameInspector::Result result{};
+
+		if (SaveGameInspector::FindOrdinance(file, kParknRideOrdinanceCLSID, result))
+		{
+			if (result.state.on)
+			{
+				totals.enacted++;
+			}
+
+			PrintState(result.state);
+		}
+		else
+		{
+			totals.notFound++;
+
+			if (result.invalidEntries > 0)
+			{
+				std::printf(
+					"  Not found, %u entries could not be read.\n",
+					result.invalidEntries);
+			}
+			else
+			{
+				std::printf("  Not found.\n");
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		std::printf(
+			"Usage: %s <save game or region folder>\n"
+			"Lists the Park & Ride ordinance state of each .sc4 file.\n",
+			argv[0]);
+		return 2;
+	}
+
+	const std::filesystem::path path(argv[1]);
+	std::vector<std::filesystem::path> saveGames;
+	std::error_code ec;
+
+	if (std::filesystem::is_directory(path, ec))
+	{
+		for (const auto& item : std::filesystem::directory_iterator(path, ec))
+		{
+			if (item.is_regular_file(ec) && IsSaveGame(item.path()))
+			{
+				saveGames.push_back(item.path());
+			}
+		}
+
+		std::sort(saveGames.begin(), saveGames.end());
+	}
+	else if (std::filesystem::is_regular_file(path, ec))
+	{
+		saveGames.push_back(path);
+	}
+
+	if (saveGames.empty())
+	{
+		std::fprintf(stderr, "%s does not contain any save games.\n", argv[1]);
+		return 1;
+	}
+
+	Totals totals;
+
+	for (const std::filesystem::path& saveGame : saveGames)
+	{
+		InspectSaveGame(saveGame, totals);
+	}
+
+	if (saveGames.size() > 1)
+	{
+		std::printf(
+			"\n%u cities, the ordinance is enacted in %u, not found in %u.\n",
+			totals.cities,
+			totals.enacted,
+			totals.notFound);
+	}
+
+	if (totals.errors > 0)
+	{
+		std::fprintf(stderr, "%u files could not be read.\n", totals.errors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,140 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+// Inspects every save game in a region folder and its subfolders on several threads,
+// and writes the ordinance state of each city as JSON or CSV.
+
+#include "RegionScanner.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	struct Options
+	{
+		const char* folder = nullptr;
+		const char* output = nullptr;
+		uint32_t threads = 0;
+		bool csv = false;
+	};
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* name = argv[i];
+
+			if (std::strcmp(name, "--threads") == 0 && i + 1 < argc)
+			{
+				const int value = std::atoi(argv[++i]);
+
+				if (value <= 0)
+				{
+					return false;
+				}
+
+				options.threads = static_cast<uint32_t>(value);
+			}
+			else if (std::strcmp(name, "--format") == 0 && i + 1 < argc)
+			{
+				const char* format = argv[++i];
+
+				if (std::strcmp(format, "csv") == 0)
+				{
+					options.csv = true;
+				}
+				else if (std::strcmp(format, "json") != 0)
+				{
+					return false;
+				}
+			}
+			else if (std::strcmp(name, "--output") == 0 && i + 1 < argc)
+			{
+				options.output = argv[++i];
+			}
+			else if (!options.folder && name[0] != '-')
+			{
+				options.folder = name;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return options.folder != nullptr;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::printf(
+			"Usage: %s <region folder> [--threads <n>] [--format json|csv] [--output <file>]\n"
+			"  --threads <n>      The number of worker threads (default: the number of hardware threads).\n"
+			"  --format json|csv  The summary format (default json).\n"
+			"  --output <file>    The summary file, the standard output is used when it is not specified.\n",
+			argv[0]);
+		return 2;
+	}
+
+	std::vector<std::filesystem::path> paths;
+
+	if (!RegionScanner::FindSaveGames(options.folder, paths) || paths.empty())
+	{
+		std::fprintf(stderr, "%s does not contain any save games.\n", options.folder);
+		return 1;
+	}
+
+	RegionScanner scanner(options.threads);
+	std::vector<RegionScanner::CityResult> results;
+
+	scanner.Scan(paths, results);
+
+	bool written = false;
+
+	if (options.output)
+	{
+		std::ofstream output(options.output, std::ios::trunc);
+
+		written = output && (options.csv ? RegionScanner::WriteCsv(output, results) : RegionScanner::WriteJson(output, results));
+	}
+	else
+	{
+		written = options.csv ? RegionScanner::WriteCsv(std::cout, results) : RegionScanner::WriteJson(std::cout, results);
+	}
+
+	if (!written)
+	{
+		std::fprintf(stderr, "Failed to write the summary.\n");
+		return 1;
+	}
+
+	const RegionScanner::Statistics& statistics = scanner.GetStatistics();
+
+	std::fprintf(
+		stderr,
+		"Scanned %zu save games (%.1f MB) in %lld ms with %u threads, %llu save games were stolen by idle threads.\n",
+		results.size(),
+		static_cast<double>(statistics.totalBytes) / (1024.0 * 1024.0),
+		static_cast<long long>(statistics.elapsedMilliseconds),
+		statistics.threadCount,
+		static_cast<unsigned long long>(statistics.stolenItems));
+
+	return 0;
+}
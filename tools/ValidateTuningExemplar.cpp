@@ -0,0 +1,217 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// This file is part of sc4-park-and-ride-ordinance, a DLL Plugin for
+// SimCity 4 that adds a Park and Ride ordinance to the game.
+//
+// Copyright (c) 2023, 2024 Nicholas Hayes
+//
+// This file is licensed under terms of the MIT License.
+// See LICENSE.txt for more information.
+//
+////////////////////////////////////////////////////////////////////////////
+
+
+// Indexes the game DATs and the plugins folders, reports which file provides the traffic
+// simulator tuning exemplar that SimCity 4 will use, and checks that its Travel type can
+// reach destination property is a Boolean array with one item per travel type.
+//
+// The exit status is 0 when the exemplar that the game uses is valid, 1 when it is not,
+// and 2 when the arguments are wrong. It is intended to be run after every plugin change.
+
+#include "TrafficSimulatorTuning.h"
+#include "TuningExemplarValidator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	struct Options
+	{
+		const char* gameFolder = nullptr;
+		std::vector<const char*> pluginFolders;
+		uint32_t threads = 0;
+		bool list = false;
+	};
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const char* name = argv[i];
+
+			if (std::strcmp(name, "--threads") == 0 && i + 1 < argc)
+			{
+				const int value = std::atoi(argv[++i]);
+
+				if (value <= 0)
+				{
+					return false;
+				}
+
+				options.threads = static_cast<uint32_t>(value);
+			}
+			else if (std::strcmp(name, "--game") == 0 && i + 1 < argc)
+			{
+				options.gameFolder = argv[++i];
+			}
+			else if (std::strcmp(name, "--list") == 0)
+			{
+				options.list = true;
+			}
+			else if (name[0] != '-')
+			{
+				options.pluginFolders.push_back(name);
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return options.gameFolder != nullptr || !options.pluginFolders.empty();
+	}
+
+	void PrintSource(const char* label, const TuningExemplarValidator::ExemplarSource& source)
+	{
+		std::printf("  %-10s %s\n", label, source.path.string().c_str());
+
+		switch (source.status)
+		{
+		case TuningExemplarValidator::Status::WrongType:
+		case TuningExemplarValidator::Status::WrongCount:
+			std::printf(
+				"             %s, type=0x%04x (%s%s), count=%u. Expected a Bool array with %u items.\n",
+				TuningExemplarValidator::GetStatusName(source.status),
+				static_cast<uint32_t>(source.type),
+				DBPFExemplar::GetValueTypeName(source.type),
+				source.isArray ? " array" : "",
+				source.count,
+				TrafficSimulatorTuning::kTravelTypeCount);
+			break;
+		default:
+			std::printf("             %s\n", TuningExemplarValidator::GetStatusName(source.status));
+			break;
+		}
+
+		if (!source.travelTypeCanReachDestination.empty())
+		{
+			std::printf("             travel types:");
+
+			for (bool value : source.travelTypeCanReachDestination)
+			{
+				std::printf(" %s", value ? "true" : "false");
+			}
+
+			std::printf("%s\n", source.precompiledOverride ? " (Park & Ride precompiled override)" : "");
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::printf(
+			"Usage: %s [--game <folder>] [--threads <n>] [--list] <plugins folder>...\n"
+			"  --game <folder>   The SimCity 4 installation folder, its DAT files are loaded first.\n"
+			"  --threads <n>     The number of worker threads (default: the number of hardware threads).\n"
+			"  --list            Print every file in load order.\n"
+			"The plugins folders are listed in load order, usually the Plugins folder in the installation\n"
+			"folder followed by the one in the user's SimCity 4 documents folder.\n",
+			argv[0]);
+		return 2;
+	}
+
+	std::vector<std::filesystem::path> paths;
+
+	if (options.gameFolder && !TuningExemplarValidator::FindGameFiles(options.gameFolder, paths))
+	{
+		std::fprintf(stderr, "The game folder %s could not be read.\n", options.gameFolder);
+		return 1;
+	}
+
+	for (const char* folder : options.pluginFolders)
+	{
+		if (!TuningExemplarValidator::FindPluginFiles(folder, paths))
+		{
+			std::fprintf(stderr, "The plugins folder %s could not be read.\n", folder);
+			return 1;
+		}
+	}
+
+	if (options.list)
+	{
+		for (const std::filesystem::path& path : paths)
+		{
+			std::printf("%s\n", path.string().c_str());
+		}
+	}
+
+	TuningExemplarValidator validator(options.threads);
+	TuningExemplarValidator::Result result;
+
+	validator.Validate(paths, result);
+
+	const TuningExemplarValidator::Statistics& statistics = validator.GetStatistics();
+
+	std::printf(
+		"Indexed %u DBPF files with %llu entries in %lld ms with %u threads, %u other files were skipped.\n",
+		result.dbpfFiles,
+		static_cast<unsigned long long>(result.indexEntries),
+		static_cast<long long>(statistics.elapsedMilliseconds),
+		statistics.threadCount,
+		result.skippedFiles);
+
+	if (result.sources.empty())
+	{
+		if (options.gameFolder)
+		{
+			std::printf("None of the files have the traffic simulator tuning exemplar.\n");
+			return 1;
+		}
+
+		std::printf("No plugin replaces the traffic simulator tuning exemplar, the game's copy is used.\n");
+		return 0;
+	}
+
+	std::printf("The traffic simulator tuning exemplar is in %zu files, in load order:\n", result.sources.size());
+
+	for (size_t i = 0; i < result.sources.size(); i++)
+	{
+		PrintSource(i + 1 < result.sources.size() ? "replaced" : "used", result.sources[i]);
+	}
+
+	const TuningExemplarValidator::ExemplarSource& used = result.sources.back();
+
+	for (size_t i = 0; i + 1 < result.sources.size(); i++)
+	{
+		if (result.sources[i].precompiledOverride)
+		{
+			std::printf(
+				"Warning: the precompiled override in %s is replaced by a file that loads later,"
+				" the plugin will edit the tuning exemplar at runtime.\n",
+				result.sources[i].path.string().c_str());
+		}
+	}
+
+	if (used.status != TuningExemplarValidator::Status::Valid)
+	{
+		std::printf("The exemplar that the game uses is not valid, the Park & Ride car restriction cannot be applied.\n");
+		return 1;
+	}
+
+	if (!used.precompiledOverride && !used.travelTypeCanReachDestination[TrafficSimulatorTuning::kCarTravelTypeIndex])
+	{
+		std::printf(
+			"Note: %s restricts cars without the precompiled override marker,"
+			" the plugin will enable cars again when the ordinance is not enacted.\n",
+			used.path.string().c_str());
+	}
+
+	std::printf("The exemplar that the game uses is valid.\n");
+	return 0;
+}